@@ -343,6 +343,13 @@ def ray_deps_setup():
         sha256 = "8e00c38829d6785a2dfb951bb87c6974fa07dfe488aa5b25deec4b8bc0f6a3ab",
     )
 
+    auto_http_archive(
+        name = "com_github_lz4_lz4",
+        url = "https://github.com/lz4/lz4/archive/v1.9.4.tar.gz",
+        build_file = True,
+        sha256 = "0b0e3aa07c8c063ddf40b082bdf7e37a1562bda40a0ff5272957f3e987e0e54b",
+    )
+
     # Hedron's Compile Commands Extractor for Bazel
     # https://github.com/hedronvision/bazel-compile-commands-extractor
     http_archive(
@@ -17,21 +17,29 @@
 #include <ray/api/actor_creator.h>
 #include <ray/api/actor_handle.h>
 #include <ray/api/actor_task_caller.h>
+#include <ray/api/channel.h>
 #include <ray/api/function_manager.h>
+#include <ray/api/generator.h>
 #include <ray/api/logging.h>
 #include <ray/api/object_ref.h>
+#include <ray/api/object_ref_stream.h>
+#include <ray/api/object_view.h>
 #include <ray/api/ray_config.h>
 #include <ray/api/ray_remote.h>
 #include <ray/api/ray_runtime.h>
 #include <ray/api/ray_runtime_holder.h>
 #include <ray/api/runtime_env.h>
+#include <ray/api/span.h>
 #include <ray/api/task_caller.h>
 #include <ray/api/wait_result.h>
 
+#include <algorithm>
 #include <boost/callable_traits.hpp>
+#include <future>
 #include <memory>
 #include <msgpack.hpp>
 #include <mutex>
+#include <thread>
 
 namespace ray {
 
@@ -54,11 +62,24 @@ void Shutdown();
 
 /// Store an object in the object store.
 ///
+/// Objects of flat serializable types (see flat_codec.h) are stored in the flat
+/// encoding, which only C++ workers can read. Passing an ObjectRef to a Python or Java
+/// task is rejected with `std::invalid_argument`; pass the value instead, which is
+/// serialized with msgpack.
+///
 /// \param[in] obj The object which should be stored.
 /// \return ObjectRef A reference to the object in the object store.
 template <typename T>
 ray::ObjectRef<T> Put(const T &obj);
 
+/// Store a list of objects in the object store with a single object store call.
+/// Large batches are serialized in parallel.
+///
+/// \param[in] objs The objects which should be stored.
+/// \return References to the objects, in the same order.
+template <typename T>
+std::vector<ray::ObjectRef<T>> PutBatch(const std::vector<T> &objs);
+
 /// Get a single object from the object store.
 /// This method will be blocked until the object is ready.
 ///
@@ -96,6 +117,40 @@ template <typename T>
 std::vector<std::shared_ptr<T>> Get(const std::vector<ray::ObjectRef<T>> &objects,
                                     const int &timeout_ms);
 
+/// Get a list of objects from the object store with a single object store call,
+/// without copying them out of the store first. Large batches are deserialized in
+/// parallel.
+///
+/// \param[in] objects The object array which should be got.
+/// \param[in] timeout_ms The maximum wait time in milliseconds, -1 waits forever.
+/// \return shared pointer array of the result.
+template <typename T>
+std::vector<std::shared_ptr<T>> GetBatch(const std::vector<ray::ObjectRef<T>> &objects,
+                                         const int &timeout_ms = -1);
+
+/// Get a view of a single object that borrows the object store's buffer instead of
+/// copying it. The buffer stays pinned until the view is destroyed.
+/// This method will be blocked until the object is ready.
+///
+/// \param[in] object The object reference which should be returned.
+/// \param[in] timeout_ms The maximum amount of time in miliseconds to wait before
+/// returning.
+/// \return a view of the result.
+template <typename T>
+ray::ObjectView<T> GetView(const ray::ObjectRef<T> &object, const int &timeout_ms = -1);
+
+/// Get views of a list of objects that borrow the object store's buffers instead of
+/// copying them. Each buffer stays pinned until its view is destroyed.
+/// This method will be blocked until all the objects are ready.
+///
+/// \param[in] objects The object array which should be got.
+/// \param[in] timeout_ms The maximum amount of time in miliseconds to wait before
+/// returning.
+/// \return views of the results.
+template <typename T>
+std::vector<ray::ObjectView<T>> GetView(const std::vector<ray::ObjectRef<T>> &objects,
+                                        const int &timeout_ms = -1);
+
 /// Wait for a list of objects to be locally available,
 /// until specified number of objects are ready, or specified timeout has passed.
 ///
@@ -206,9 +261,17 @@ inline std::vector<std::string> ObjectRefsToObjectIDs(
 
 template <typename T>
 inline ray::ObjectRef<T> Put(const T &obj) {
-  auto buffer =
-      std::make_shared<msgpack::sbuffer>(ray::internal::Serializer::Serialize(obj));
-  auto id = ray::internal::GetRayRuntime()->Put(buffer);
+  std::string id;
+  if constexpr (ray::internal::is_flat_v<T>) {
+    // Flat objects are written straight into the object store.
+    id = ray::internal::GetRayRuntime()->Put(
+        ray::internal::Serializer::FlatSize(obj),
+        [&obj](char *data) { ray::internal::Serializer::SerializeFlat(obj, data); });
+  } else {
+    auto buffer =
+        std::make_shared<msgpack::sbuffer>(ray::internal::Serializer::Serialize(obj));
+    id = ray::internal::GetRayRuntime()->Put(buffer);
+  }
   auto ref = ObjectRef<T>(id);
   // The core worker will add an initial ref to the put ID to
   // keep it in scope. Now that we've created the frontend
@@ -217,6 +280,73 @@ inline ray::ObjectRef<T> Put(const T &obj) {
   return ref;
 }
 
+namespace internal {
+
+/// Batches with fewer objects than this per thread are handled on the calling thread.
+constexpr size_t kMinBatchObjectsPerThread = 1024;
+
+/// Call `fn(begin, end)` on contiguous chunks of [0, size), spread over up to one
+/// thread per core. The calling thread handles the first chunk. Exceptions thrown by
+/// `fn` are rethrown here.
+template <typename F>
+inline void ParallelFor(size_t size, const F &fn) {
+  size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+  size_t num_threads = std::min(
+      max_threads, (size + kMinBatchObjectsPerThread - 1) / kMinBatchObjectsPerThread);
+  if (num_threads <= 1) {
+    fn(0, size);
+    return;
+  }
+  size_t chunk = (size + num_threads - 1) / num_threads;
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_threads - 1);
+  for (size_t begin = chunk; begin < size; begin += chunk) {
+    futures.push_back(
+        std::async(std::launch::async, fn, begin, std::min(size, begin + chunk)));
+  }
+  fn(0, chunk);
+  for (auto &future : futures) {
+    future.get();
+  }
+}
+
+}  // namespace internal
+
+template <typename T>
+inline std::vector<ray::ObjectRef<T>> PutBatch(const std::vector<T> &objs) {
+  std::vector<std::shared_ptr<msgpack::sbuffer>> buffers(objs.size());
+  ray::internal::ParallelFor(objs.size(), [&objs, &buffers](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      buffers[i] = std::make_shared<msgpack::sbuffer>(
+          ray::internal::Serializer::Serialize(objs[i]));
+    }
+  });
+  auto ids = ray::internal::GetRayRuntime()->PutBatch(buffers);
+  std::vector<ray::ObjectRef<T>> refs;
+  refs.reserve(ids.size());
+  for (const auto &id : ids) {
+    refs.push_back(ObjectRef<T>(id));
+    // Drop the initial ref the core worker added, as Put does.
+    ray::internal::GetRayRuntime()->RemoveLocalReference(id);
+  }
+  return refs;
+}
+
+template <typename T>
+inline std::vector<std::shared_ptr<T>> GetBatch(
+    const std::vector<ray::ObjectRef<T>> &objects, const int &timeout_ms) {
+  auto buffers = ray::internal::GetRayRuntime()->GetBuffers(
+      ObjectRefsToObjectIDs<T>(objects), timeout_ms);
+  std::vector<std::shared_ptr<T>> return_objects(buffers.size());
+  ray::internal::ParallelFor(
+      buffers.size(), [&buffers, &return_objects](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          return_objects[i] = DeserializeBuffer<T>(*buffers[i]);
+        }
+      });
+  return return_objects;
+}
+
 template <typename T>
 inline std::shared_ptr<T> Get(const ray::ObjectRef<T> &object, const int &timeout_ms) {
   return GetFromRuntime(object, timeout_ms);
@@ -243,6 +373,26 @@ inline std::vector<std::shared_ptr<T>> Get(const std::vector<ray::ObjectRef<T>>
   return Get<T>(object_ids, timeout_ms);
 }
 
+template <typename T>
+inline ray::ObjectView<T> GetView(const ray::ObjectRef<T> &object,
+                                  const int &timeout_ms) {
+  return object.GetView(timeout_ms);
+}
+
+template <typename T>
+inline std::vector<ray::ObjectView<T>> GetView(
+    const std::vector<ray::ObjectRef<T>> &objects, const int &timeout_ms) {
+  auto buffers =
+      ray::internal::GetRayRuntime()->GetBuffers(ObjectRefsToObjectIDs<T>(objects),
+                                                 timeout_ms);
+  std::vector<ray::ObjectView<T>> views;
+  views.reserve(buffers.size());
+  for (auto &buffer : buffers) {
+    views.push_back(ToObjectView<T>(std::move(buffer)));
+  }
+  return views;
+}
+
 template <typename T>
 inline std::shared_ptr<T> Get(const ray::ObjectRef<T> &object) {
   return Get<T>(object, -1);
@@ -16,6 +16,7 @@
 
 #include <ray/api/arguments.h>
 #include <ray/api/object_ref.h>
+#include <ray/api/object_ref_stream.h>
 #include <ray/api/static_check.h>
 #include <ray/api/task_options.h>
 namespace ray {
@@ -34,7 +35,7 @@ class ActorTaskCaller {
         remote_function_holder_(std::move(remote_function_holder)) {}
 
   template <typename... Args>
-  ObjectRef<boost::callable_traits::return_type_t<F>> Remote(Args &&...args);
+  RemoteResult_t<F> Remote(Args &&...args);
 
   ActorTaskCaller &SetName(std::string name) {
     task_options_.name = std::move(name);
@@ -51,6 +52,12 @@ class ActorTaskCaller {
     return *this;
   }
 
+  /// Pause a streaming generator task while `num_objects` of its items are unconsumed.
+  ActorTaskCaller &SetGeneratorBackpressure(int64_t num_objects) {
+    task_options_.generator_backpressure_num_objects = num_objects;
+    return *this;
+  }
+
  private:
   RayRuntime *runtime_;
   std::string id_;
@@ -63,8 +70,7 @@ class ActorTaskCaller {
 
 template <typename F>
 template <typename... Args>
-ObjectRef<boost::callable_traits::return_type_t<F>> ActorTaskCaller<F>::Remote(
-    Args &&...args) {
+RemoteResult_t<F> ActorTaskCaller<F>::Remote(Args &&...args) {
   CheckTaskOptions(task_options_.resources);
 
   if constexpr (is_x_lang_v<F>) {
@@ -83,9 +89,10 @@ ObjectRef<boost::callable_traits::return_type_t<F>> ActorTaskCaller<F>::Remote(
   }
 
   using ReturnType = boost::callable_traits::return_type_t<F>;
+  task_options_.streaming_generator = is_generator_v<ReturnType>;
   auto returned_object_id =
       runtime_->CallActor(remote_function_holder_, id_, args_, task_options_);
-  auto return_ref = ObjectRef<ReturnType>(returned_object_id);
+  auto return_ref = RemoteResult_t<F>(returned_object_id);
   // The core worker will add an initial ref to each return ID to keep it in
   // scope. Now that we've created the frontend ObjectRef, remove this initial
   // ref.
@@ -36,20 +36,17 @@ class Arguments {
         PushReferenceArg(task_args, std::forward<InputArgTypes>(arg));
       } else {
         // After the Object Ref parameter is supported, this exception will be deleted.
+        // Cross-language callees will then need flat objects put by ray::Put converted
+        // to msgpack, as TaskExecutor does for flat return values.
         throw std::invalid_argument(
             "At present, the Ray C++ API does not support the passing of "
             "`ray::ObjectRef` parameters. Will support later.");
       }
     } else if constexpr (is_object_ref_v<InputArgTypes>) {
-      // core_worker submitting task callback will get the value of an ObjectRef arg, but
-      // local mode we don't call core_worker submit task, so we need get the value of an
-      // ObjectRef arg only for local mode.
-      if (RayRuntimeHolder::Instance().Runtime()->IsLocalMode()) {
-        auto buffer = RayRuntimeHolder::Instance().Runtime()->Get(arg.ID());
-        PushValueArg(task_args, std::move(*buffer));
-      } else {
-        PushReferenceArg(task_args, std::forward<InputArgTypes>(arg));
-      }
+      // The callee takes the value of this ObjectRef arg. core_worker resolves it before
+      // the task runs, and so does the local mode submitter, without blocking the caller.
+      PushReferenceArg(
+          task_args, std::forward<InputArgTypes>(arg), /*resolve_value=*/true);
     } else {
       if (lang_type == LangType::CPP) {
         if constexpr (is_actor_handle_v<InputArgTypes>) {
@@ -70,7 +67,7 @@ class Arguments {
           PushValueArg(task_args, std::move(dummy_buf), METADATA_STR_RAW);
         }
         // Below applies to both PYTHON and JAVA.
-        auto data_buf = Serializer::Serialize(std::forward<InputArgTypes>(arg));
+        auto data_buf = Serializer::SerializeMsgpack(std::forward<InputArgTypes>(arg));
         auto len_buf = Serializer::Serialize(data_buf.size());
 
         msgpack::sbuffer buffer(XLANG_HEADER_LEN + data_buf.size());
@@ -111,10 +108,13 @@ class Arguments {
   }
 
   template <typename TaskArg, typename T>
-  static void PushReferenceArg(std::vector<TaskArg> *task_args, T &&arg) {
+  static void PushReferenceArg(std::vector<TaskArg> *task_args,
+                               T &&arg,
+                               bool resolve_value = false) {
     /// Pass by reference.
     TaskArg task_arg{};
     task_arg.id = arg.ID();
+    task_arg.resolve_value = resolve_value;
     task_args->emplace_back(std::move(task_arg));
   }
 };
@@ -0,0 +1,181 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <ray/api/object_ref.h>
+#include <ray/api/ray_runtime_holder.h>
+#include <ray/api/serializer.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <msgpack.hpp>
+#include <string>
+
+namespace ray {
+namespace experimental {
+
+/// A single-writer channel that passes values of type T through a mutable object in the
+/// shared-memory object store. Unlike `ray::Put`, writes reuse the same buffer, so
+/// passing a value between actors costs no object creation or RPC. A write blocks until
+/// all readers have released the previous value.
+///
+/// The writer and readers must run on the node that created the channel. A channel can
+/// be passed to actors as a task argument; every copy refers to the same channel.
+///
+/// \code
+/// auto channel = ray::experimental::CreateChannel<int>(1024);
+/// auto done = reader.Task(&Reader::Consume).Remote(channel);
+/// channel.Write(42);
+/// \endcode
+template <typename T>
+class Channel {
+ public:
+  Channel() = default;
+
+  Channel(const std::string &id, size_t buffer_size, int64_t num_readers)
+      : ref_(id), buffer_size_(buffer_size), num_readers_(num_readers) {}
+
+  /// Write a value to the channel. Flat values are written straight into the shared
+  /// buffer, others are serialized first and then copied in.
+  /// This method will be blocked until every reader has released the previous value.
+  ///
+  /// Write a value to the channel. This method will be blocked until all readers have
+  /// released the previous value. If writing the value into the channel throws, the
+  /// channel is closed so that readers never see a partial value, and the exception is
+  /// rethrown.
+  ///
+  /// \param[in] value The value to write.
+  /// \param[in] timeout_ms The maximum wait time in milliseconds, -1 to wait forever.
+  void Write(const T &value, int timeout_ms = -1) const;
+
+  /// Read the next value from the channel and copy it out.
+  /// This method will be blocked until the writer has written a new value.
+  ///
+  /// \param[in] timeout_ms The maximum wait time in milliseconds, -1 to wait forever.
+  /// \return shared pointer of the value.
+  std::shared_ptr<T> Read(int timeout_ms = -1) const;
+
+  /// Read the next value from the channel without copying it. The writer can't write
+  /// the next value until the view is destroyed, and the view must be destroyed before
+  /// the channel is read again.
+  /// This method will be blocked until the writer has written a new value.
+  ///
+  /// \param[in] timeout_ms The maximum wait time in milliseconds, -1 to wait forever.
+  /// \return a view of the value.
+  ObjectView<T> ReadView(int timeout_ms = -1) const;
+
+  /// Close the channel. Blocked and later reads and writes throw
+  /// `RayChannelException`, on every worker that uses the channel.
+  void Close() const;
+
+  /// Get a untyped ID of the channel.
+  const std::string &ID() const { return ref_.ID(); }
+
+  /// The maximum size in bytes of a serialized value.
+  size_t BufferSize() const { return buffer_size_; }
+
+  /// The number of readers that must release a value before the next one is written.
+  int64_t NumReaders() const { return num_readers_; }
+
+  /// Make Channel serializable
+  MSGPACK_DEFINE(ref_, buffer_size_, num_readers_);
+
+ private:
+  void EnsureRegisteredAsWriter() const;
+  void EnsureRegisteredAsReader() const;
+
+  /// Keeps the channel's mutable object alive in the creating worker.
+  ObjectRef<void> ref_;
+  size_t buffer_size_ = 0;
+  int64_t num_readers_ = 1;
+  /// Registration with this worker's runtime is idempotent, these only skip the call.
+  mutable bool registered_as_writer_ = false;
+  mutable bool registered_as_reader_ = false;
+};
+
+/// Create a channel in this node's object store.
+///
+/// \param[in] buffer_size The maximum size in bytes of a serialized value.
+/// \param[in] num_readers The number of readers that must read each value.
+/// \return The channel.
+template <typename T>
+inline Channel<T> CreateChannel(size_t buffer_size, int64_t num_readers = 1) {
+  auto id = ray::internal::GetRayRuntime()->CreateChannel(buffer_size);
+  Channel<T> channel(id, buffer_size, num_readers);
+  // The runtime adds an initial ref to the channel to keep it in scope. Now that the
+  // channel holds its own reference, remove this initial ref.
+  ray::internal::GetRayRuntime()->RemoveLocalReference(id);
+  return channel;
+}
+
+// ---------- implementation ----------
+template <typename T>
+inline void Channel<T>::EnsureRegisteredAsWriter() const {
+  if (!registered_as_writer_) {
+    ray::internal::GetRayRuntime()->RegisterChannelWriter(ID());
+    registered_as_writer_ = true;
+  }
+}
+
+template <typename T>
+inline void Channel<T>::EnsureRegisteredAsReader() const {
+  if (!registered_as_reader_) {
+    ray::internal::GetRayRuntime()->RegisterChannelReader(ID());
+    registered_as_reader_ = true;
+  }
+}
+
+template <typename T>
+inline void Channel<T>::Write(const T &value, int timeout_ms) const {
+  EnsureRegisteredAsWriter();
+  auto runtime = ray::internal::GetRayRuntime();
+  if constexpr (ray::internal::is_flat_v<T>) {
+    runtime->WriteChannel(ID(),
+                          ray::internal::Serializer::FlatSize(value),
+                          num_readers_,
+                          timeout_ms,
+                          [&value](char *data) {
+                            ray::internal::Serializer::SerializeFlat(value, data);
+                          });
+  } else {
+    auto buffer = ray::internal::Serializer::Serialize(value);
+    runtime->WriteChannel(
+        ID(), buffer.size(), num_readers_, timeout_ms, [&buffer](char *data) {
+          std::memcpy(data, buffer.data(), buffer.size());
+        });
+  }
+}
+
+template <typename T>
+inline std::shared_ptr<T> Channel<T>::Read(int timeout_ms) const {
+  EnsureRegisteredAsReader();
+  auto buffer = ray::internal::GetRayRuntime()->ReadChannel(ID(), timeout_ms);
+  return DeserializeBuffer<T>(*buffer);
+}
+
+template <typename T>
+inline ObjectView<T> Channel<T>::ReadView(int timeout_ms) const {
+  EnsureRegisteredAsReader();
+  return ToObjectView<T>(ray::internal::GetRayRuntime()->ReadChannel(ID(), timeout_ms));
+}
+
+template <typename T>
+inline void Channel<T>::Close() const {
+  ray::internal::GetRayRuntime()->CloseChannel(ID());
+}
+
+}  // namespace experimental
+}  // namespace ray
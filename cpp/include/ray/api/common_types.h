@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <msgpack.hpp>
 #include <string_view>
@@ -27,6 +28,7 @@ struct TaskArg {
   TaskArg(TaskArg &&rhs) {
     buf = std::move(rhs.buf);
     id = rhs.id;
+    resolve_value = rhs.resolve_value;
     meta_str = std::move(rhs.meta_str);
   }
 
@@ -38,13 +40,41 @@ struct TaskArg {
   boost::optional<msgpack::sbuffer> buf;
   /// If the id is initialized shows it is a reference argument.
   boost::optional<std::string> id;
+  /// Whether the callee takes the value of the referenced object rather than the
+  /// ObjectRef itself, so the value must be resolved before the task runs.
+  bool resolve_value = false;
 
   std::string_view meta_str;
 };
 
-using ArgsBuffer = msgpack::sbuffer;
+/// A read-only view of one serialized task argument. The bytes belong to the task spec
+/// or the object store and outlive the invocation, so the invoker unpacks them in place.
+class ArgsBuffer {
+ public:
+  ArgsBuffer() = default;
+  ArgsBuffer(const char *data, size_t size) : data_(data), size_(size) {}
+
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+};
 using ArgsBufferList = std::vector<ArgsBuffer>;
 
+/// Stable 64-bit FNV-1a hash of a remote function name. The submitter puts it in the
+/// task spec so the executing worker can dispatch without a string lookup. 0 is reserved
+/// for "not set".
+inline uint64_t HashFunctionName(std::string_view name) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : name) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash == 0 ? 1 : hash;
+}
+
 using RemoteFunction = std::function<msgpack::sbuffer(const ArgsBufferList &)>;
 using RemoteFunctionMap_t = std::unordered_map<std::string, RemoteFunction>;
 
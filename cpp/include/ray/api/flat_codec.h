@@ -0,0 +1,203 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <ray/api/ray_exception.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ray {
+namespace internal {
+
+/// Flat payloads are msgpack ext32 objects of this ext type, so that they can be told
+/// apart from ordinary msgpack payloads (and from error and cross-language payloads).
+inline constexpr int8_t FLAT_EXT_TYPE = 82;
+/// Padding at the start of the ext body so that the flat bytes are 8-byte aligned. The
+/// first padding byte holds the `FlatElementKind`.
+inline constexpr size_t FLAT_PADDING_LEN = 2;
+/// ext32 marker (1) + body length (4) + ext type (1) + padding.
+inline constexpr size_t FLAT_HEADER_LEN = 6 + FLAT_PADDING_LEN;
+
+/// Element type of a flat payload. It is recorded in the first padding byte so that a
+/// flat payload can be converted to a msgpack array for other languages; opaque
+/// payloads are converted to msgpack bin instead.
+enum class FlatElementKind : uint8_t {
+  OPAQUE = 0,
+  INT8,
+  UINT8,
+  INT16,
+  UINT16,
+  INT32,
+  UINT32,
+  INT64,
+  UINT64,
+  FLOAT,
+  DOUBLE,
+};
+
+template <typename E>
+constexpr FlatElementKind GetFlatElementKind() {
+  if constexpr (std::is_floating_point_v<E>) {
+    if constexpr (sizeof(E) == 4) {
+      return FlatElementKind::FLOAT;
+    } else if constexpr (sizeof(E) == 8) {
+      return FlatElementKind::DOUBLE;
+    }
+  } else if constexpr (std::is_integral_v<E> && !std::is_same_v<E, bool>) {
+    constexpr bool is_signed = std::is_signed_v<E>;
+    if constexpr (sizeof(E) == 1) {
+      return is_signed ? FlatElementKind::INT8 : FlatElementKind::UINT8;
+    } else if constexpr (sizeof(E) == 2) {
+      return is_signed ? FlatElementKind::INT16 : FlatElementKind::UINT16;
+    } else if constexpr (sizeof(E) == 4) {
+      return is_signed ? FlatElementKind::INT32 : FlatElementKind::UINT32;
+    } else if constexpr (sizeof(E) == 8) {
+      return is_signed ? FlatElementKind::INT64 : FlatElementKind::UINT64;
+    }
+  }
+  return FlatElementKind::OPAQUE;
+}
+
+template <typename T>
+struct FlatKind {
+  static constexpr FlatElementKind value = FlatElementKind::OPAQUE;
+};
+
+template <typename E>
+struct FlatKind<std::vector<E>> {
+  static constexpr FlatElementKind value = GetFlatElementKind<E>();
+};
+
+/// Whether values of T, and vectors of them, are serialized by copying their bytes.
+/// Use `RAY_FLAT_SERIALIZABLE` to opt a trivially copyable type in.
+template <typename T>
+struct IsFlatSerializable : std::false_type {};
+
+template <typename T>
+inline constexpr bool is_flat_element_v =
+    (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) || IsFlatSerializable<T>::value;
+
+/// Serializes T as one contiguous run of bytes instead of through msgpack. Specialize it
+/// to plug a custom flat layout in for a type. A specialization sets `enabled` and
+/// provides:
+///   static std::pair<const char *, size_t> Bytes(const T &value);
+///   static T Read(const char *data, size_t size);
+template <typename T, typename Enable = void>
+struct FlatCodec {
+  static constexpr bool enabled = false;
+};
+
+template <typename T>
+struct FlatCodec<T, std::enable_if_t<IsFlatSerializable<T>::value>> {
+  static constexpr bool enabled = true;
+
+  static std::pair<const char *, size_t> Bytes(const T &value) {
+    return {reinterpret_cast<const char *>(&value), sizeof(T)};
+  }
+
+  static T Read(const char *data, size_t size) {
+    if (size != sizeof(T)) {
+      throw RayException("Flat payload size does not match the type.");
+    }
+    T value;
+    std::memcpy(static_cast<void *>(&value), data, sizeof(T));
+    return value;
+  }
+};
+
+// Vectors of char and unsigned char are left to msgpack, which already packs them as a
+// bin that other languages read as bytes.
+template <typename E>
+struct FlatCodec<std::vector<E>,
+                 std::enable_if_t<is_flat_element_v<E> && !std::is_same_v<E, char> &&
+                                  !std::is_same_v<E, unsigned char>>> {
+  static constexpr bool enabled = true;
+
+  static std::pair<const char *, size_t> Bytes(const std::vector<E> &value) {
+    return {reinterpret_cast<const char *>(value.data()), value.size() * sizeof(E)};
+  }
+
+  static std::vector<E> Read(const char *data, size_t size) {
+    if (size % sizeof(E) != 0) {
+      throw RayException("Flat payload size does not match the element type.");
+    }
+    size_t num_elements = size / sizeof(E);
+    if (reinterpret_cast<uintptr_t>(data) % alignof(E) == 0) {
+      auto begin = reinterpret_cast<const E *>(data);
+      return std::vector<E>(begin, begin + num_elements);
+    }
+    std::vector<E> value(num_elements);
+    std::memcpy(static_cast<void *>(value.data()), data, size);
+    return value;
+  }
+};
+
+template <typename T>
+inline constexpr bool is_flat_v = FlatCodec<T>::enabled;
+
+/// Write the header of a flat payload of `size` bytes into `dest`, which must have
+/// room for `FLAT_HEADER_LEN` bytes.
+inline void WriteFlatHeader(char *dest,
+                            size_t size,
+                            FlatElementKind kind = FlatElementKind::OPAQUE) {
+  if (size > UINT32_MAX - FLAT_PADDING_LEN - 1) {
+    throw RayException("Flat payload is too large: " + std::to_string(size));
+  }
+  // The ext32 length counts the body after the ext type byte.
+  uint32_t length = static_cast<uint32_t>(size + FLAT_PADDING_LEN);
+  dest[0] = static_cast<char>(0xc9);
+  dest[1] = static_cast<char>(length >> 24);
+  dest[2] = static_cast<char>(length >> 16);
+  dest[3] = static_cast<char>(length >> 8);
+  dest[4] = static_cast<char>(length);
+  dest[5] = static_cast<char>(FLAT_EXT_TYPE);
+  dest[6] = static_cast<char>(kind);
+  dest[7] = 0;
+}
+
+/// Whether `data` holds exactly one flat payload.
+inline bool IsFlatPayload(const char *data, size_t size) {
+  if (size < FLAT_HEADER_LEN || static_cast<uint8_t>(data[0]) != 0xc9 ||
+      static_cast<int8_t>(data[5]) != FLAT_EXT_TYPE) {
+    return false;
+  }
+  auto byte = [data](int i) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(data[i]));
+  };
+  uint32_t length = (byte(1) << 24) | (byte(2) << 16) | (byte(3) << 8) | byte(4);
+  return length == size - 6;
+}
+
+}  // namespace internal
+}  // namespace ray
+
+/// Serialize a trivially copyable type, and vectors of it, by copying its bytes instead
+/// of through msgpack. The type's layout must be the same in every worker that reads it,
+/// so only use it for types shared by C++ code. Must be used at global scope.
+#define RAY_FLAT_SERIALIZABLE(T)                                               \
+  namespace ray {                                                              \
+  namespace internal {                                                         \
+  template <>                                                                  \
+  struct IsFlatSerializable<T> : std::true_type {                              \
+    static_assert(std::is_trivially_copyable_v<T>,                             \
+                  #T " must be trivially copyable to be flat serializable."); \
+  };                                                                           \
+  }                                                                            \
+  }
@@ -15,8 +15,10 @@
 #pragma once
 
 #include <ray/api/common_types.h>
+#include <ray/api/generator.h>
 #include <ray/api/ray_runtime_holder.h>
 #include <ray/api/serializer.h>
+#include <ray/api/span.h>
 #include <ray/api/type_traits.h>
 
 #include <boost/callable_traits.hpp>
@@ -24,6 +26,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
@@ -52,8 +55,27 @@ inline static msgpack::sbuffer PackVoid() {
   return Serializer::Serialize(msgpack::type::nil_t());
 }
 
+/// Drain a streaming generator, sending each item to the caller as it is produced. The
+/// task itself returns nothing.
+template <typename T>
+inline static msgpack::sbuffer PackGenerator(Generator<T> generator) {
+  auto runtime = RayRuntimeHolder::Instance().Runtime();
+  while (auto item = generator.Next()) {
+    runtime->ReportGeneratorItem(
+        std::make_shared<msgpack::sbuffer>(PackReturnValue(std::move(*item))));
+  }
+  return PackVoid();
+}
+
 msgpack::sbuffer PackError(std::string error_msg);
 
+/// Names of the profile events of the phases of a task. The argument and execution
+/// events have the same names as the Python worker's.
+inline constexpr std::string_view kDeserializeArgumentsEvent =
+    "task:deserialize_arguments";
+inline constexpr std::string_view kExecuteEvent = "task:execute";
+inline constexpr std::string_view kSerializeOutputsEvent = "task:serialize_outputs";
+
 /// It's help to invoke functions and member functions, the class Invoker<Function> help
 /// do type erase.
 template <typename Function>
@@ -70,11 +92,13 @@ struct Invoker {
 
     msgpack::sbuffer result;
     ArgsTuple tp{};
+    Span deserialize_span(kDeserializeArgumentsEvent);
     bool is_ok = GetArgsTuple(
         tp, args_buffer, std::make_index_sequence<std::tuple_size<ArgsTuple>::value>{});
     if (!is_ok) {
       throw std::invalid_argument("Arguments error");
     }
+    deserialize_span.End();
 
     result = Invoker<Function>::Call<RetrunType>(func, std::move(tp));
     return result;
@@ -92,11 +116,13 @@ struct Invoker {
 
     msgpack::sbuffer result;
     ArgsTuple tp{};
+    Span deserialize_span(kDeserializeArgumentsEvent);
     bool is_ok = GetArgsTuple(
         tp, args_buffer, std::make_index_sequence<std::tuple_size<ArgsTuple>::value>{});
     if (!is_ok) {
       throw std::invalid_argument("Arguments error");
     }
+    deserialize_span.End();
 
     uint64_t actor_ptr = Serializer::Deserialize<uint64_t>(ptr->data(), ptr->size());
     using Self = boost::callable_traits::class_of_t<Function>;
@@ -144,16 +170,26 @@ struct Invoker {
   template <typename R, typename F, typename... Args>
   static std::enable_if_t<std::is_void<R>::value, msgpack::sbuffer> Call(
       const F &f, std::tuple<Args...> args) {
+    Span execute_span(kExecuteEvent);
     CallInternal<R>(f, std::make_index_sequence<sizeof...(Args)>{}, std::move(args));
+    execute_span.End();
     return PackVoid();
   }
 
   template <typename R, typename F, typename... Args>
   static std::enable_if_t<!std::is_void<R>::value, msgpack::sbuffer> Call(
       const F &f, std::tuple<Args...> args) {
+    Span execute_span(kExecuteEvent);
     auto r =
         CallInternal<R>(f, std::make_index_sequence<sizeof...(Args)>{}, std::move(args));
-    return PackReturnValue(r);
+    if constexpr (is_generator_v<R>) {
+      // The user code runs as the generator is drained.
+      return PackGenerator(std::move(r));
+    } else {
+      execute_span.End();
+      Span serialize_span(kSerializeOutputsEvent);
+      return PackReturnValue(r);
+    }
   }
 
   template <typename R, typename F, size_t... I, typename... Args>
@@ -168,17 +204,27 @@ struct Invoker {
   template <typename R, typename F, typename Self, typename... Args>
   static std::enable_if_t<std::is_void<R>::value, msgpack::sbuffer> CallMember(
       const F &f, Self *self, std::tuple<Args...> args) {
+    Span execute_span(kExecuteEvent);
     CallMemberInternal<R>(
         f, self, std::make_index_sequence<sizeof...(Args)>{}, std::move(args));
+    execute_span.End();
     return PackVoid();
   }
 
   template <typename R, typename F, typename Self, typename... Args>
   static std::enable_if_t<!std::is_void<R>::value, msgpack::sbuffer> CallMember(
       const F &f, Self *self, std::tuple<Args...> args) {
+    Span execute_span(kExecuteEvent);
     auto r = CallMemberInternal<R>(
         f, self, std::make_index_sequence<sizeof...(Args)>{}, std::move(args));
-    return PackReturnValue(r);
+    if constexpr (is_generator_v<R>) {
+      // The user code runs as the generator is drained.
+      return PackGenerator(std::move(r));
+    } else {
+      execute_span.End();
+      Span serialize_span(kSerializeOutputsEvent);
+      return PackReturnValue(r);
+    }
   }
 
   template <typename R, typename F, typename Self, size_t... I, typename... Args>
@@ -217,6 +263,13 @@ class FunctionManager {
     return &it->second;
   }
 
+  /// Look up a remote function by the name hash carried in the task spec. Returns
+  /// nullptr if the hash isn't known or is shared by several names, in which case the
+  /// caller should look the function up by name.
+  RemoteFunction *GetFunctionByHash(uint64_t func_hash, const std::string &func_name) {
+    return FindByHash(hash_to_invoker_, func_hash, func_name);
+  }
+
   template <typename Function>
   std::enable_if_t<!std::is_member_function_pointer<Function>::value, bool>
   RegisterRemoteFunction(std::string const &name, const Function &f) {
@@ -284,6 +337,11 @@ class FunctionManager {
     return &it->second;
   }
 
+  RemoteMemberFunction *GetMemberFunctionByHash(uint64_t func_hash,
+                                                const std::string &func_name) {
+    return FindByHash(hash_to_mem_func_invoker_, func_hash, func_name);
+  }
+
   static std::string GetClassNameByFuncName(const std::string &func_name) {
     if (func_name.empty()) {
       return "";
@@ -311,22 +369,64 @@ class FunctionManager {
 
   template <typename Function>
   bool RegisterNonMemberFunc(std::string const &name, Function f) {
-    return map_invokers_
-        .emplace(
-            name,
-            std::bind(&Invoker<Function>::Apply, std::move(f), std::placeholders::_1))
-        .second;
+    auto pair = map_invokers_.emplace(
+        name, std::bind(&Invoker<Function>::Apply, std::move(f), std::placeholders::_1));
+    if (!pair.second) {
+      return false;
+    }
+
+    RegisterHash(pair.first->first, &pair.first->second, hash_to_invoker_);
+    return true;
   }
 
   template <typename Function>
   bool RegisterMemberFunc(std::string const &name, Function f) {
-    return map_mem_func_invokers_
-        .emplace(name,
-                 std::bind(&Invoker<Function>::ApplyMember,
-                           std::move(f),
-                           std::placeholders::_1,
-                           std::placeholders::_2))
-        .second;
+    auto pair = map_mem_func_invokers_.emplace(name,
+                                               std::bind(&Invoker<Function>::ApplyMember,
+                                                         std::move(f),
+                                                         std::placeholders::_1,
+                                                         std::placeholders::_2));
+    if (!pair.second) {
+      return false;
+    }
+
+    RegisterHash(pair.first->first, &pair.first->second, hash_to_mem_func_invoker_);
+    return true;
+  }
+
+  /// An invoker indexed by its name hash. `invoker` is null if several names share the
+  /// hash, so that they are dispatched by name.
+  template <typename F>
+  struct HashedInvoker {
+    const std::string *name;
+    F *invoker;
+  };
+
+  /// Index an invoker by its name hash. `name` and `invoker` must point into the
+  /// invoker map, whose nodes are stable, so they stay valid for the life of the process.
+  template <typename F>
+  void RegisterHash(std::string const &name,
+                    F *invoker,
+                    std::unordered_map<uint64_t, HashedInvoker<F>> &hash_to_invoker) {
+    auto pair =
+        hash_to_invoker.emplace(HashFunctionName(name), HashedInvoker<F>{&name, invoker});
+    if (!pair.second) {
+      pair.first->second.invoker = nullptr;
+    }
+  }
+
+  template <typename F>
+  static F *FindByHash(
+      const std::unordered_map<uint64_t, HashedInvoker<F>> &hash_to_invoker,
+      uint64_t func_hash,
+      const std::string &func_name) {
+    auto it = hash_to_invoker.find(func_hash);
+    if (it == hash_to_invoker.end() || it->second.invoker == nullptr ||
+        *it->second.name != func_name) {
+      return nullptr;
+    }
+
+    return it->second.invoker;
   }
 
   template <class Dest, class Source>
@@ -347,6 +447,9 @@ class FunctionManager {
 
   RemoteFunctionMap_t map_invokers_;
   RemoteMemberFunctionMap_t map_mem_func_invokers_;
+  std::unordered_map<uint64_t, HashedInvoker<RemoteFunction>> hash_to_invoker_;
+  std::unordered_map<uint64_t, HashedInvoker<RemoteMemberFunction>>
+      hash_to_mem_func_invoker_;
   std::unordered_map<std::string, std::string> func_ptr_to_key_map_;
   std::map<std::pair<std::string, std::string>, std::string> mem_func_to_key_map_;
 };
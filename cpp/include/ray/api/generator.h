@@ -0,0 +1,66 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace ray {
+
+/// The return type of a streaming generator task. It wraps a function that produces the
+/// task's items one at a time and returns std::nullopt after the last one. Each item is
+/// sent to the caller as soon as it is produced, so the caller can consume it while the
+/// task keeps running. The caller gets an ObjectRefStream<T> from `Remote()`.
+///
+/// \code
+/// ray::Generator<int> Count(int n) {
+///   return ray::Generator<int>([i = 0, n]() mutable -> std::optional<int> {
+///     if (i == n) {
+///       return std::nullopt;
+///     }
+///     return i++;
+///   });
+/// }
+/// RAY_REMOTE(Count);
+/// \endcode
+template <typename T>
+class Generator {
+ public:
+  using ValueType = T;
+
+  explicit Generator(std::function<std::optional<T>()> next) : next_(std::move(next)) {}
+
+  /// Produce the next item, or std::nullopt if there are no more.
+  std::optional<T> Next() { return next_(); }
+
+ private:
+  std::function<std::optional<T>()> next_;
+};
+
+namespace internal {
+
+template <typename T>
+struct is_generator_t : std::false_type {};
+
+template <typename T>
+struct is_generator_t<Generator<T>> : std::true_type {};
+
+template <typename T>
+auto constexpr is_generator_v = is_generator_t<std::decay_t<T>>::value;
+
+}  // namespace internal
+}  // namespace ray
@@ -20,6 +20,31 @@
 #include <vector>
 
 namespace ray {
+
+/// A metric with its tag values fixed up front, so that recording through it doesn't
+/// resolve the tags again on every call. Get one with `Metric::Bind`. It must not
+/// outlive its metric.
+class BoundMetric {
+ public:
+  BoundMetric(BoundMetric &&other) noexcept;
+  BoundMetric &operator=(BoundMetric &&other) noexcept;
+  ~BoundMetric();
+
+  BoundMetric(const BoundMetric &) = delete;
+  BoundMetric &operator=(const BoundMetric &) = delete;
+
+  /// Record the value with the bound tags. This is thread-safe.
+  ///
+  /// \param value The value that we record.
+  void Record(double value);
+
+ private:
+  friend class Metric;
+  explicit BoundMetric(void *bound_metric) : bound_metric_(bound_metric) {}
+
+  void *bound_metric_ = nullptr;
+};  // class BoundMetric
+
 class Metric {
  public:
   virtual ~Metric() = 0;
@@ -33,8 +58,18 @@ class Metric {
   /// \param tags The map tag values that we want to record for this metric record.
   void Record(double value, const std::unordered_map<std::string, std::string> &tags);
 
+  /// Bind tag values to this metric. Use this to record with the same tags many
+  /// times.
+  ///
+  /// \param tags The map tag values that the returned handle records with.
+  /// \return The bound metric.
+  BoundMetric Bind(const std::unordered_map<std::string, std::string> &tags);
+
  protected:
   void *metric_ = nullptr;
+  /// Whether values recorded through bound handles can be added up before they are
+  /// recorded, which lets the handles accumulate them per thread without locking.
+  bool accumulates_ = false;
 };  // class Metric
 
 class Gauge : public Metric {
@@ -104,6 +139,9 @@ class Counter : public Metric {
   /// \param[in] description The Description of the metric.
   /// \param[in] unit The unit of the metric
   /// \param[in] tag_keys Tag keys of the metric.
+  ///
+  /// Increments recorded through a bound counter are added up per thread and recorded
+  /// at the stats harvest interval, so recording through it takes no lock.
   Counter(const std::string &name,
           const std::string &description,
           const std::string &unit,
@@ -126,6 +164,9 @@ class Sum : public Metric {
   /// \param[in] description The Description of the metric.
   /// \param[in] unit The unit of the metric
   /// \param[in] tag_keys Tag keys of the metric.
+  ///
+  /// Values recorded through a bound sum are added up per thread and recorded at the
+  /// stats harvest interval, so recording through it takes no lock.
   Sum(const std::string &name,
       const std::string &description,
       const std::string &unit,
@@ -0,0 +1,179 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+namespace ray {
+
+template <typename T>
+class ObjectFuture;
+
+namespace internal {
+
+/// The state shared by an ObjectFuture and the runtime callback that completes it.
+template <typename T>
+class FutureState {
+ public:
+  void SetValue(std::shared_ptr<T> value) { Complete(std::move(value), nullptr); }
+
+  void SetError(std::exception_ptr error) { Complete(nullptr, std::move(error)); }
+
+  bool IsReady() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ready_;
+  }
+
+  bool WaitFor(int timeout_ms) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (timeout_ms < 0) {
+      cv_.wait(lock, [this] { return ready_; });
+      return true;
+    }
+    return cv_.wait_for(
+        lock, std::chrono::milliseconds(timeout_ms), [this] { return ready_; });
+  }
+
+  /// Must only be called once the state is ready.
+  std::shared_ptr<T> Result() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    return value_;
+  }
+
+  /// Run `continuation` once the state is ready, right away if it already is.
+  void OnReady(std::function<void()> continuation) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!ready_) {
+        continuations_.push_back(std::move(continuation));
+        return;
+      }
+    }
+    continuation();
+  }
+
+ private:
+  void Complete(std::shared_ptr<T> value, std::exception_ptr error) {
+    std::vector<std::function<void()>> continuations;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      value_ = std::move(value);
+      error_ = std::move(error);
+      ready_ = true;
+      continuations = std::move(continuations_);
+    }
+    cv_.notify_all();
+    for (auto &continuation : continuations) {
+      continuation();
+    }
+  }
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable cv_;
+  bool ready_ = false;
+  std::shared_ptr<T> value_;
+  std::exception_ptr error_;
+  std::vector<std::function<void()>> continuations_;
+};
+
+}  // namespace internal
+
+/// The result of ObjectRef<T>::GetAsync. It doesn't hold a thread while the object is
+/// pending, so one thread can keep many of them in flight. With C++20 it can also be
+/// `co_await`ed.
+///
+/// In cluster mode the object is deserialized, and callbacks and resumed coroutines
+/// run, on the core worker io thread that completes the get. That thread also handles
+/// this worker's RPCs, so continuations must not block on other objects and should
+/// hand large objects or heavy work to another thread. `Get()` and `WaitFor()` can be
+/// called from any thread.
+template <typename T>
+class ObjectFuture {
+ public:
+  explicit ObjectFuture(std::shared_ptr<internal::FutureState<T>> state)
+      : state_(std::move(state)) {}
+
+  /// Whether the object is ready, or failed to be fetched.
+  bool IsReady() const { return state_->IsReady(); }
+
+  /// Block until the object is ready or the timeout expires.
+  ///
+  /// \param timeout_ms The maximum time to wait in milliseconds, -1 to wait forever.
+  /// \return Whether the object is ready.
+  bool WaitFor(int timeout_ms) const { return state_->WaitFor(timeout_ms); }
+
+  /// Block until the object is ready and return it, or throw the error that prevented
+  /// fetching it.
+  std::shared_ptr<T> Get() const {
+    state_->WaitFor(-1);
+    return state_->Result();
+  }
+
+  /// Call `callback` with the object, or with the error that prevented fetching it.
+  ///
+  /// \return A future that is ready once the callback has run, and holds the exception
+  /// the callback threw, if any.
+  ObjectFuture<void> Then(
+      std::function<void(std::shared_ptr<T>, std::exception_ptr)> callback) const {
+    auto state = state_;
+    auto done = std::make_shared<internal::FutureState<void>>();
+    state_->OnReady([state, done, callback = std::move(callback)]() {
+      std::shared_ptr<T> value;
+      std::exception_ptr error;
+      try {
+        value = state->Result();
+      } catch (...) {
+        error = std::current_exception();
+      }
+      try {
+        callback(std::move(value), std::move(error));
+      } catch (...) {
+        done->SetError(std::current_exception());
+        return;
+      }
+      done->SetValue(nullptr);
+    });
+    return ObjectFuture<void>(std::move(done));
+  }
+
+#if defined(__cpp_impl_coroutine)
+  bool await_ready() const { return IsReady(); }
+
+  void await_suspend(std::coroutine_handle<> handle) const {
+    state_->OnReady([handle]() { handle.resume(); });
+  }
+
+  std::shared_ptr<T> await_resume() const { return state_->Result(); }
+#endif
+
+ private:
+  std::shared_ptr<internal::FutureState<T>> state_;
+};
+
+}  // namespace ray
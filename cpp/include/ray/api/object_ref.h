@@ -14,10 +14,14 @@
 
 #pragma once
 
+#include <ray/api/object_future.h>
+#include <ray/api/object_view.h>
 #include <ray/api/ray_runtime_holder.h>
 #include <ray/api/serializer.h>
 #include <ray/api/type_traits.h>
 
+#include <exception>
+#include <functional>
 #include <memory>
 #include <msgpack.hpp>
 #include <utility>
@@ -28,17 +32,20 @@ template <typename T>
 class ObjectRef;
 
 /// Common helper functions used by ObjectRef<T> and ObjectRef<void>;
-inline void CheckResult(const std::shared_ptr<msgpack::sbuffer> &packed_object) {
-  bool has_error =
-      ray::internal::Serializer::HasError(packed_object->data(), packed_object->size());
+inline void CheckResult(const char *data, size_t size) {
+  bool has_error = ray::internal::Serializer::HasError(data, size);
   if (has_error) {
     auto tp = ray::internal::Serializer::Deserialize<std::tuple<int, std::string>>(
-        packed_object->data(), packed_object->size(), 1);
+        data, size, 1);
     std::string err_msg = std::get<1>(tp);
     throw ray::internal::RayTaskException(err_msg);
   }
 }
 
+inline void CheckResult(const std::shared_ptr<msgpack::sbuffer> &packed_object) {
+  CheckResult(packed_object->data(), packed_object->size());
+}
+
 inline void CopyAndAddReference(std::string &dest_id, const std::string &id) {
   dest_id = id;
   ray::internal::GetRayRuntime()->AddLocalReference(id);
@@ -48,6 +55,26 @@ inline void SubReference(const std::string &id) {
   ray::internal::GetRayRuntime()->RemoveLocalReference(id);
 }
 
+template <typename Packer>
+inline void PackObjectRef(Packer &packer, const std::string &id) {
+  auto runtime = ray::internal::GetRayRuntime();
+  if (runtime->IsLocalMode()) {
+    // Local mode doesn't track the references held by serialized objects, so it keeps
+    // the objects they point to.
+    runtime->AddLocalReference(id);
+  }
+  msgpack::type::make_define_array(id).msgpack_pack(packer);
+}
+
+/// Unpacking adds a reference, like constructing an ObjectRef from an id does, so that
+/// the destructor's removal is balanced.
+inline void UnpackObjectRef(const msgpack::object &object, std::string &dest_id) {
+  std::string id;
+  msgpack::type::make_define_array(id).msgpack_unpack(object);
+  SubReference(dest_id);
+  CopyAndAddReference(dest_id, id);
+}
+
 /// Represents an object in the object store..
 /// \param T The type of object.
 template <typename T>
@@ -111,8 +138,47 @@ class ObjectRef {
   /// \return shared pointer of the result.
   std::shared_ptr<T> Get(const int &timeout_ms) const;
 
+  /// Get a view of the object that borrows the object store's buffer instead of
+  /// copying it. The buffer stays pinned until the view is destroyed.
+  /// This method will be blocked until the object is ready.
+  ///
+  /// \return a view of the result.
+  ObjectView<T> GetView() const;
+
+  /// Get a view of the object that borrows the object store's buffer instead of
+  /// copying it. The buffer stays pinned until the view is destroyed.
+  /// This method will be blocked until the object is ready.
+  ///
+  /// \param timeout_ms The maximum amount of time in miliseconds to wait before
+  /// returning.
+  /// \return a view of the result.
+  ObjectView<T> GetView(const int &timeout_ms) const;
+
+  /// Get the object from the object store without blocking.
+  ///
+  /// \return a future of the result.
+  ObjectFuture<T> GetAsync() const;
+
+  /// Get the object from the object store without blocking, and call `callback` with it
+  /// or with the error that prevented getting it. The callback runs on a runtime
+  /// thread, so it must not block (see ObjectFuture).
+  ///
+  /// \return a future that holds the exception the callback threw, if any.
+  ObjectFuture<void> GetAsync(
+      std::function<void(std::shared_ptr<T>, std::exception_ptr)> callback) const;
+
   /// Make ObjectRef serializable
-  MSGPACK_DEFINE(id_);
+  template <typename Packer>
+  void msgpack_pack(Packer &packer) const {
+    PackObjectRef(packer, id_);
+  }
+
+  void msgpack_unpack(const msgpack::object &object) { UnpackObjectRef(object, id_); }
+
+  template <typename MsgpackObject>
+  void msgpack_object(MsgpackObject *object, msgpack::zone &zone) const {
+    msgpack::type::make_define_array(id_).msgpack_object(object, zone);
+  }
 
  private:
   std::string id_;
@@ -120,24 +186,48 @@ class ObjectRef {
 
 // ---------- implementation ----------
 template <typename T>
-inline static std::shared_ptr<T> GetFromRuntime(const ObjectRef<T> &object,
-                                                const int &timeout_ms) {
-  auto packed_object = internal::GetRayRuntime()->Get(object.ID(), timeout_ms);
-  CheckResult(packed_object);
+inline static std::shared_ptr<T> DeserializeObject(const char *data, size_t size) {
+  CheckResult(data, size);
 
-  if (ray::internal::Serializer::IsXLang(packed_object->data(), packed_object->size())) {
+  if (ray::internal::Serializer::IsXLang(data, size)) {
     return ray::internal::Serializer::Deserialize<std::shared_ptr<T>>(
-        packed_object->data(), packed_object->size(), internal::XLANG_HEADER_LEN);
+        data, size, internal::XLANG_HEADER_LEN);
   }
 
   if constexpr (ray::internal::is_actor_handle_v<T>) {
-    auto actor_handle = ray::internal::Serializer::Deserialize<std::string>(
-        packed_object->data(), packed_object->size());
+    auto actor_handle = ray::internal::Serializer::Deserialize<std::string>(data, size);
     return std::make_shared<T>(T::FromBytes(actor_handle));
   }
 
-  return ray::internal::Serializer::Deserialize<std::shared_ptr<T>>(
-      packed_object->data(), packed_object->size());
+  return ray::internal::Serializer::Deserialize<std::shared_ptr<T>>(data, size);
+}
+
+/// Deserialize an object from a buffer pinned in the object store. Raw payloads are
+/// wrapped as msgpack bin first, like the copying Get does.
+template <typename T>
+inline static std::shared_ptr<T> DeserializeBuffer(const internal::ObjectBuffer &buffer) {
+  if (buffer.is_raw) {
+    auto packed = internal::Serializer::Serialize(buffer.data, buffer.size);
+    return DeserializeObject<T>(packed.data(), packed.size());
+  }
+  return DeserializeObject<T>(buffer.data, buffer.size);
+}
+
+template <typename T>
+inline static std::shared_ptr<T> GetFromRuntime(const ObjectRef<T> &object,
+                                                const int &timeout_ms) {
+  auto packed_object = internal::GetRayRuntime()->Get(object.ID(), timeout_ms);
+  return DeserializeObject<T>(packed_object->data(), packed_object->size());
+}
+
+template <typename T>
+inline ObjectView<T> ToObjectView(std::shared_ptr<internal::ObjectBuffer> buffer) {
+  static_assert(!ray::internal::is_actor_handle_v<T>,
+                "Actor handles can not be viewed in place, use Get instead.");
+  if (!buffer->is_raw) {
+    CheckResult(buffer->data, buffer->size);
+  }
+  return ObjectView<T>(std::move(buffer));
 }
 
 template <typename T>
@@ -173,6 +263,43 @@ inline std::shared_ptr<T> ObjectRef<T>::Get(const int &timeout_ms) const {
   return GetFromRuntime(*this, timeout_ms);
 }
 
+template <typename T>
+inline ObjectView<T> ObjectRef<T>::GetView() const {
+  return GetView(-1);
+}
+
+template <typename T>
+inline ObjectView<T> ObjectRef<T>::GetView(const int &timeout_ms) const {
+  return ToObjectView<T>(internal::GetRayRuntime()->GetBuffer(id_, timeout_ms));
+}
+
+template <typename T>
+inline ObjectFuture<T> ObjectRef<T>::GetAsync() const {
+  auto state = std::make_shared<internal::FutureState<T>>();
+  // The callback holds a copy of this ref, so the object stays in scope until it's got.
+  internal::GetRayRuntime()->GetAsync(
+      id_,
+      [state, ref = *this](std::shared_ptr<internal::ObjectBuffer> buffer,
+                           std::exception_ptr error) {
+        if (error) {
+          state->SetError(std::move(error));
+          return;
+        }
+        try {
+          state->SetValue(DeserializeBuffer<T>(*buffer));
+        } catch (...) {
+          state->SetError(std::current_exception());
+        }
+      });
+  return ObjectFuture<T>(std::move(state));
+}
+
+template <typename T>
+inline ObjectFuture<void> ObjectRef<T>::GetAsync(
+    std::function<void(std::shared_ptr<T>, std::exception_ptr)> callback) const {
+  return GetAsync().Then(std::move(callback));
+}
+
 template <>
 class ObjectRef<void> {
  public:
@@ -216,7 +343,17 @@ class ObjectRef<void> {
   }
 
   /// Make ObjectRef serializable
-  MSGPACK_DEFINE(id_);
+  template <typename Packer>
+  void msgpack_pack(Packer &packer) const {
+    PackObjectRef(packer, id_);
+  }
+
+  void msgpack_unpack(const msgpack::object &object) { UnpackObjectRef(object, id_); }
+
+  template <typename MsgpackObject>
+  void msgpack_object(MsgpackObject *object, msgpack::zone &zone) const {
+    msgpack::type::make_define_array(id_).msgpack_object(object, zone);
+  }
 
  private:
   std::string id_;
@@ -0,0 +1,138 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <ray/api/generator.h>
+#include <ray/api/object_ref.h>
+#include <ray/api/ray_runtime_holder.h>
+
+#include <boost/callable_traits.hpp>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace ray {
+
+/// The items of a streaming generator task, in the order the task produced them. Items
+/// can be read while the task is still running. A stream should be read from one thread
+/// at a time.
+///
+/// \code
+/// for (auto &ref : ray::Task(Count).Remote(10)) {
+///   std::cout << *ref.Get() << std::endl;
+/// }
+/// \endcode
+template <typename T>
+class ObjectRefStream {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = ObjectRef<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const ObjectRef<T> *;
+    using reference = const ObjectRef<T> &;
+
+    Iterator() = default;
+
+    reference operator*() const { return *current_; }
+    pointer operator->() const { return &*current_; }
+
+    Iterator &operator++() {
+      current_ = stream_->Next();
+      if (!current_) {
+        stream_ = nullptr;
+      }
+      return *this;
+    }
+
+    bool operator==(const Iterator &other) const { return stream_ == other.stream_; }
+    bool operator!=(const Iterator &other) const { return !(*this == other); }
+
+   private:
+    friend class ObjectRefStream<T>;
+    explicit Iterator(ObjectRefStream<T> *stream) : stream_(stream) { ++*this; }
+
+    ObjectRefStream<T> *stream_ = nullptr;
+    std::optional<ObjectRef<T>> current_;
+  };
+
+  ObjectRefStream() = default;
+
+  explicit ObjectRefStream(const std::string &generator_id)
+      : state_(std::make_shared<State>(generator_id)) {}
+
+  /// Block until the task produces its next item and return a reference to it. Returns
+  /// std::nullopt once all items have been read, and throws the task's error if it
+  /// failed after producing the items read so far.
+  std::optional<ObjectRef<T>> Next() {
+    if (state_->finished) {
+      return std::nullopt;
+    }
+    const auto &generator_id = state_->generator_ref.ID();
+    auto item_id = internal::GetRayRuntime()->ReadGeneratorItem(generator_id);
+    if (item_id.empty()) {
+      state_->finished = true;
+      // The generator's own object holds the task's error, if there was one.
+      state_->generator_ref.Get();
+      return std::nullopt;
+    }
+    ObjectRef<T> ref(item_id);
+    // The runtime added a ref to the item for us. Now that we've created the frontend
+    // ObjectRef, remove it.
+    internal::GetRayRuntime()->RemoveLocalReference(item_id);
+    return ref;
+  }
+
+  Iterator begin() { return Iterator(this); }
+  Iterator end() { return Iterator(); }
+
+  /// The id of the generator task's own return object.
+  const std::string &ID() const { return state_->generator_ref.ID(); }
+
+ private:
+  struct State {
+    explicit State(const std::string &generator_id) : generator_ref(generator_id) {}
+    ~State() { internal::GetRayRuntime()->DeleteGeneratorStream(generator_ref.ID()); }
+
+    ObjectRef<void> generator_ref;
+    bool finished = false;
+  };
+
+  std::shared_ptr<State> state_;
+};
+
+namespace internal {
+
+/// What `Remote()` returns for a function returning R: a reference to the result, or the
+/// stream of items of a streaming generator.
+template <typename R>
+struct RemoteResult {
+  using type = ObjectRef<R>;
+};
+
+template <typename T>
+struct RemoteResult<Generator<T>> {
+  using type = ObjectRefStream<T>;
+};
+
+template <typename F>
+using RemoteResult_t =
+    typename RemoteResult<boost::callable_traits::return_type_t<F>>::type;
+
+}  // namespace internal
+}  // namespace ray
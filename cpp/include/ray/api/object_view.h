@@ -0,0 +1,168 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <ray/api/ray_exception.h>
+#include <ray/api/serializer.h>
+#include <ray/api/xlang_function.h>
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <msgpack.hpp>
+#include <string_view>
+#include <type_traits>
+
+namespace ray {
+namespace internal {
+
+/// A serialized object borrowed from the object store. `holder` owns the store's
+/// buffer (a pinned plasma object in cluster mode), so `data` stays valid for as long
+/// as this struct is alive.
+struct ObjectBuffer {
+  const char *data = nullptr;
+  size_t size = 0;
+  /// Whether `data` holds raw bytes (e.g. put by another language) rather than a
+  /// msgpack payload.
+  bool is_raw = false;
+  std::shared_ptr<void> holder;
+};
+
+/// Receives an object fetched asynchronously, or the error that prevented fetching it,
+/// in which case `buffer` is null.
+using ObjectBufferCallback =
+    std::function<void(std::shared_ptr<ObjectBuffer> buffer, std::exception_ptr error)>;
+
+/// Tell msgpack to reference str, bin and ext bodies in the source buffer instead of
+/// copying them into the unpacked zone.
+inline bool ReferenceInPlace(msgpack::type::object_type, std::size_t, void *) {
+  return true;
+}
+
+}  // namespace internal
+
+/// A read-only view over a contiguous array that lives in the object store.
+/// \param E The element type.
+template <typename E>
+class ArrayView {
+ public:
+  ArrayView() = default;
+  ArrayView(const E *data, size_t size) : data_(data), size_(size) {}
+
+  const E *data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const E *begin() const { return data_; }
+  const E *end() const { return data_ + size_; }
+  const E &operator[](size_t i) const { return data_[i]; }
+
+ private:
+  const E *data_ = nullptr;
+  size_t size_ = 0;
+};
+
+/// A view of an object that keeps its object store buffer pinned for as long as the
+/// view, or any copy of it, is alive. Unlike `ObjectRef<T>::Get`, the object is not
+/// copied out of the store, and msgpack str/bin/ext values are referenced in place.
+/// \param T The type of object.
+template <typename T>
+class ObjectView {
+ public:
+  explicit ObjectView(std::shared_ptr<internal::ObjectBuffer> buffer);
+
+  /// The unpacked msgpack object. Its str/bin/ext values point into the pinned
+  /// buffer, so it must not outlive this view.
+  const msgpack::object &Object() const { return object_; }
+
+  /// Convert the view to a value of type T. This is the only copy made.
+  T Get() const { return internal::Serializer::Convert<T>(object_); }
+
+  /// The bytes of a raw object, of a flat object or of a msgpack str/bin value, without
+  /// copying.
+  /// Throws `RayException` if the object is not a byte payload.
+  std::string_view Bytes() const;
+
+  /// Reinterpret the bytes of a byte payload as an array of `E`.
+  /// Throws `RayException` if the bytes are not a whole number of suitably aligned
+  /// elements.
+  template <typename E>
+  ArrayView<E> AsArray() const;
+
+  /// The serialized buffer backing this view.
+  const internal::ObjectBuffer &Buffer() const { return *buffer_; }
+
+ private:
+  std::shared_ptr<internal::ObjectBuffer> buffer_;
+  /// Owns the nodes of `object_`. Null for raw objects.
+  std::shared_ptr<msgpack::zone> zone_;
+  msgpack::object object_;
+};
+
+// ---------- implementation ----------
+template <typename T>
+ObjectView<T>::ObjectView(std::shared_ptr<internal::ObjectBuffer> buffer)
+    : buffer_(std::move(buffer)) {
+  if (buffer_->is_raw) {
+    if (buffer_->size > UINT32_MAX) {
+      throw internal::RayException("Raw object is too large to view as msgpack bin.");
+    }
+    object_.type = msgpack::type::BIN;
+    object_.via.bin.size = static_cast<uint32_t>(buffer_->size);
+    object_.via.bin.ptr = buffer_->data;
+    return;
+  }
+  size_t offset = 0;
+  if (internal::Serializer::IsXLang(buffer_->data, buffer_->size)) {
+    offset = internal::XLANG_HEADER_LEN;
+  }
+  auto handle = msgpack::unpack(
+      buffer_->data + offset, buffer_->size - offset, internal::ReferenceInPlace);
+  object_ = handle.get();
+  zone_.reset(handle.zone().release());
+}
+
+template <typename T>
+std::string_view ObjectView<T>::Bytes() const {
+  if (object_.type == msgpack::type::BIN) {
+    return std::string_view(object_.via.bin.ptr, object_.via.bin.size);
+  }
+  if (object_.type == msgpack::type::STR) {
+    return std::string_view(object_.via.str.ptr, object_.via.str.size);
+  }
+  if (object_.type == msgpack::type::EXT &&
+      object_.via.ext.type() == internal::FLAT_EXT_TYPE &&
+      object_.via.ext.size >= internal::FLAT_PADDING_LEN) {
+    return std::string_view(object_.via.ext.data() + internal::FLAT_PADDING_LEN,
+                            object_.via.ext.size - internal::FLAT_PADDING_LEN);
+  }
+  throw internal::RayException("Object is not a byte payload.");
+}
+
+template <typename T>
+template <typename E>
+ArrayView<E> ObjectView<T>::AsArray() const {
+  static_assert(std::is_trivially_copyable_v<E>,
+                "Only arrays of trivially copyable types can be viewed in place.");
+  auto bytes = Bytes();
+  if (bytes.size() % sizeof(E) != 0 ||
+      reinterpret_cast<uintptr_t>(bytes.data()) % alignof(E) != 0) {
+    throw internal::RayException("Object bytes are not an aligned array of the type.");
+  }
+  return ArrayView<E>(reinterpret_cast<const E *>(bytes.data()),
+                      bytes.size() / sizeof(E));
+}
+
+}  // namespace ray
@@ -64,5 +64,10 @@ class RayTimeoutException : public RayException {
   RayTimeoutException(const std::string &msg) : RayException(msg){};
 };
 
+class RayChannelException : public RayException {
+ public:
+  RayChannelException(const std::string &msg) : RayException(msg){};
+};
+
 }  // namespace internal
 }  // namespace ray
\ No newline at end of file
@@ -15,12 +15,15 @@
 #pragma once
 
 #include <ray/api/common_types.h>
+#include <ray/api/object_view.h>
 #include <ray/api/task_options.h>
 #include <ray/api/xlang_function.h>
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <msgpack.hpp>
+#include <string_view>
 #include <typeinfo>
 #include <vector>
 
@@ -55,6 +58,14 @@ struct RemoteFunctionHolder {
 class RayRuntime {
  public:
   virtual std::string Put(std::shared_ptr<msgpack::sbuffer> data) = 0;
+  /// Create an object of `data_size` bytes in the object store, let `writer` fill it in
+  /// place and seal it.
+  virtual std::string Put(size_t data_size,
+                          const std::function<void(char *data)> &writer) = 0;
+  /// Store a list of objects with a single object store call and return their ids in
+  /// order.
+  virtual std::vector<std::string> PutBatch(
+      const std::vector<std::shared_ptr<msgpack::sbuffer>> &data) = 0;
   virtual std::shared_ptr<msgpack::sbuffer> Get(const std::string &id) = 0;
 
   virtual std::vector<std::shared_ptr<msgpack::sbuffer>> Get(
@@ -66,10 +77,62 @@ class RayRuntime {
   virtual std::vector<std::shared_ptr<msgpack::sbuffer>> Get(
       const std::vector<std::string> &ids, const int &timeout_ms) = 0;
 
+  virtual std::shared_ptr<ObjectBuffer> GetBuffer(const std::string &object_id,
+                                                  const int &timeout_ms) = 0;
+
+  virtual std::vector<std::shared_ptr<ObjectBuffer>> GetBuffers(
+      const std::vector<std::string> &ids, const int &timeout_ms) = 0;
+
+  /// Call `callback` once the object is available, without blocking the caller. The
+  /// callback runs on a runtime thread, so it must not block.
+  virtual void GetAsync(const std::string &object_id, ObjectBufferCallback callback) = 0;
+
   virtual std::vector<bool> Wait(const std::vector<std::string> &ids,
                                  int num_objects,
                                  int timeout_ms) = 0;
 
+  /// Send an item produced by the streaming generator task running on this thread to
+  /// its caller. This may block until the caller has consumed earlier items.
+  virtual void ReportGeneratorItem(std::shared_ptr<msgpack::sbuffer> item) = 0;
+
+  /// Block until the streaming generator task that returned `generator_id` produces its
+  /// next item and return the item's id, or an empty string once there are no more.
+  virtual std::string ReadGeneratorItem(const std::string &generator_id) = 0;
+
+  /// Release the stream of a streaming generator once nothing reads it anymore.
+  virtual void DeleteGeneratorStream(const std::string &generator_id) = 0;
+
+  /// Create a channel backed by a mutable object of `buffer_size` bytes in this node's
+  /// object store and return its id.
+  virtual std::string CreateChannel(size_t buffer_size) = 0;
+
+  virtual void RegisterChannelWriter(const std::string &channel_id) = 0;
+
+  virtual void RegisterChannelReader(const std::string &channel_id) = 0;
+
+  /// Block until the previous value has been released by all of its `num_readers`
+  /// readers, let `writer` fill `data_size` bytes of the channel in place and publish
+  /// them. If `writer` throws, nothing is published: the channel is closed and the
+  /// exception is rethrown.
+  virtual void WriteChannel(const std::string &channel_id,
+                            size_t data_size,
+                            int64_t num_readers,
+                            int timeout_ms,
+                            const std::function<void(char *data)> &writer) = 0;
+
+  /// Block until a new value is written to the channel. The returned buffer points into
+  /// the channel, and the writer can't overwrite it until the buffer is destroyed.
+  virtual std::shared_ptr<ObjectBuffer> ReadChannel(const std::string &channel_id,
+                                                    int timeout_ms) = 0;
+
+  /// Close the channel, so that its blocked and future reads and writes throw.
+  virtual void CloseChannel(const std::string &channel_id) = 0;
+
+  /// Start a profile event of the current task, which is recorded when the returned
+  /// handle is destroyed. Returns null when the timeline is disabled.
+  virtual std::shared_ptr<void> StartProfileEvent(std::string_view event_name,
+                                                  std::string_view extra_data) = 0;
+
   virtual std::string Call(const RemoteFunctionHolder &remote_function_holder,
                            std::vector<TaskArg> &args,
                            const CallOptions &task_options) = 0;
@@ -14,8 +14,10 @@
 
 #pragma once
 
+#include <ray/api/flat_codec.h>
 #include <ray/api/msgpack_adaptor.h>
 #include <ray/api/ray_exception.h>
+#include <ray/api/type_traits.h>
 #include <ray/api/xlang_function.h>
 
 #include <msgpack.hpp>
@@ -27,11 +29,41 @@ class Serializer {
  public:
   template <typename T>
   static msgpack::sbuffer Serialize(const T &t) {
+    if constexpr (is_flat_v<T>) {
+      auto [data, size] = FlatCodec<T>::Bytes(t);
+      char header[FLAT_HEADER_LEN];
+      WriteFlatHeader(header, size, FlatKind<T>::value);
+      msgpack::sbuffer buffer(FLAT_HEADER_LEN + size);
+      buffer.write(header, FLAT_HEADER_LEN);
+      buffer.write(data, size);
+      return buffer;
+    } else {
+      return SerializeMsgpack(t);
+    }
+  }
+
+  /// Serialize with msgpack even if T has a flat encoding, e.g. for other languages.
+  template <typename T>
+  static msgpack::sbuffer SerializeMsgpack(const T &t) {
     msgpack::sbuffer buffer;
     msgpack::pack(buffer, t);
     return buffer;
   }
 
+  /// Size of the flat encoding of `t`.
+  template <typename T>
+  static size_t FlatSize(const T &t) {
+    return FLAT_HEADER_LEN + FlatCodec<T>::Bytes(t).second;
+  }
+
+  /// Write the flat encoding of `t` into `dest`, which must hold `FlatSize(t)` bytes.
+  template <typename T>
+  static void SerializeFlat(const T &t, char *dest) {
+    auto [data, size] = FlatCodec<T>::Bytes(t);
+    WriteFlatHeader(dest, size, FlatKind<T>::value);
+    std::memcpy(dest + FLAT_HEADER_LEN, data, size);
+  }
+
   static msgpack::sbuffer Serialize(const char *data, size_t size) {
     msgpack::sbuffer buffer;
     msgpack::packer<msgpack::sbuffer> packer(&buffer);
@@ -42,9 +74,89 @@ class Serializer {
 
   template <typename T>
   static T Deserialize(const char *data, size_t size) {
+    if constexpr (is_flat_v<T>) {
+      if (IsFlatPayload(data, size)) {
+        return FlatCodec<T>::Read(data + FLAT_HEADER_LEN, size - FLAT_HEADER_LEN);
+      }
+    } else if constexpr (is_shared_ptr_v<T>) {
+      using E = typename T::element_type;
+      if constexpr (is_flat_v<E>) {
+        if (IsFlatPayload(data, size)) {
+          return std::make_shared<E>(
+              FlatCodec<E>::Read(data + FLAT_HEADER_LEN, size - FLAT_HEADER_LEN));
+        }
+      }
+    }
     msgpack::unpacked unpacked;
     msgpack::unpack(unpacked, data, size);
-    return unpacked.get().as<T>();
+    return Convert<T>(unpacked.get());
+  }
+
+  /// Convert an unpacked msgpack object to T. Flat types are also read from flat ext
+  /// objects and from msgpack bin objects, e.g. raw bytes put by another language.
+  template <typename T>
+  static T Convert(const msgpack::object &object) {
+    if constexpr (is_flat_v<T>) {
+      if (object.type == msgpack::type::EXT && object.via.ext.type() == FLAT_EXT_TYPE &&
+          object.via.ext.size >= FLAT_PADDING_LEN) {
+        return FlatCodec<T>::Read(object.via.ext.data() + FLAT_PADDING_LEN,
+                                  object.via.ext.size - FLAT_PADDING_LEN);
+      }
+      if (object.type == msgpack::type::BIN) {
+        return FlatCodec<T>::Read(object.via.bin.ptr, object.via.bin.size);
+      }
+      if constexpr (FlatKind<T>::value != FlatElementKind::OPAQUE) {
+        // A msgpack array of numbers.
+        return object.as<T>();
+      } else {
+        // Types opted in with RAY_FLAT_SERIALIZABLE may have no msgpack adaptor.
+        throw RayException("Object is not a flat payload of the requested type.");
+      }
+    } else if constexpr (is_shared_ptr_v<T>) {
+      using E = typename T::element_type;
+      if constexpr (is_flat_v<E>) {
+        if (object.is_nil()) {
+          return nullptr;
+        }
+        return std::make_shared<E>(Convert<E>(object));
+      } else {
+        return object.as<T>();
+      }
+    } else {
+      return object.as<T>();
+    }
+  }
+
+  /// Convert a flat payload to an equivalent msgpack payload that other languages can
+  /// read: an array for vectors of numbers, a bin otherwise.
+  static msgpack::sbuffer FlatToMsgpack(const char *data, size_t size) {
+    auto kind = static_cast<FlatElementKind>(data[6]);
+    data += FLAT_HEADER_LEN;
+    size -= FLAT_HEADER_LEN;
+    switch (kind) {
+    case FlatElementKind::INT8:
+      return PackFlatArray<int8_t>(data, size);
+    case FlatElementKind::UINT8:
+      return PackFlatArray<uint8_t>(data, size);
+    case FlatElementKind::INT16:
+      return PackFlatArray<int16_t>(data, size);
+    case FlatElementKind::UINT16:
+      return PackFlatArray<uint16_t>(data, size);
+    case FlatElementKind::INT32:
+      return PackFlatArray<int32_t>(data, size);
+    case FlatElementKind::UINT32:
+      return PackFlatArray<uint32_t>(data, size);
+    case FlatElementKind::INT64:
+      return PackFlatArray<int64_t>(data, size);
+    case FlatElementKind::UINT64:
+      return PackFlatArray<uint64_t>(data, size);
+    case FlatElementKind::FLOAT:
+      return PackFlatArray<float>(data, size);
+    case FlatElementKind::DOUBLE:
+      return PackFlatArray<double>(data, size);
+    default:
+      return Serialize(data, size);
+    }
   }
 
   template <typename T>
@@ -60,25 +172,59 @@ class Serializer {
 
   template <typename T>
   static std::pair<bool, T> DeserializeWhenNil(const char *data, size_t size) {
-    T val;
-    size_t off = 0;
-    msgpack::unpacked unpacked = msgpack::unpack(data, size, off);
-    if (!unpacked.get().convert_if_not_nil(val)) {
-      return {false, {}};
+    if constexpr (is_flat_v<T>) {
+      if (IsFlatPayload(data, size)) {
+        return {true,
+                FlatCodec<T>::Read(data + FLAT_HEADER_LEN, size - FLAT_HEADER_LEN)};
+      }
+      size_t off = 0;
+      msgpack::unpacked unpacked = msgpack::unpack(data, size, off);
+      if (unpacked.get().is_nil()) {
+        return {false, {}};
+      }
+      return {true, Convert<T>(unpacked.get())};
+    } else {
+      T val;
+      size_t off = 0;
+      msgpack::unpacked unpacked = msgpack::unpack(data, size, off);
+      if (!unpacked.get().convert_if_not_nil(val)) {
+        return {false, {}};
+      }
+
+      return {true, val};
     }
+  }
 
-    return {true, val};
+  // HasError and IsXLang only look at the leading msgpack type byte, so that checking
+  // a large payload doesn't unpack all of it.
+  static bool HasError(const char *data, size_t size) {
+    // nil
+    return size > 1 && static_cast<uint8_t>(data[0]) == 0xc0;
   }
 
-  static bool HasError(char *data, size_t size) {
-    msgpack::unpacked unpacked = msgpack::unpack(data, size);
-    return unpacked.get().is_nil() && size > 1;
+  static bool IsXLang(const char *data, size_t size) {
+    if (size < XLANG_HEADER_LEN) {
+      return false;
+    }
+    auto type = static_cast<uint8_t>(data[0]);
+    // positive fixint, uint 8/16/32/64, or a non-negative int 8/16/32/64.
+    return type <= 0x7f || (type >= 0xcc && type <= 0xcf) ||
+           (type >= 0xd0 && type <= 0xd3 && static_cast<uint8_t>(data[1]) < 0x80);
   }
 
-  static bool IsXLang(char *data, size_t size) {
-    msgpack::unpacked unpacked = msgpack::unpack(data, size);
-    return unpacked.get().type == msgpack::type::POSITIVE_INTEGER &&
-           size >= XLANG_HEADER_LEN;
+ private:
+  template <typename E>
+  static msgpack::sbuffer PackFlatArray(const char *data, size_t size) {
+    msgpack::sbuffer buffer;
+    msgpack::packer<msgpack::sbuffer> packer(&buffer);
+    size_t num_elements = size / sizeof(E);
+    packer.pack_array(static_cast<uint32_t>(num_elements));
+    for (size_t i = 0; i < num_elements; i++) {
+      E element;
+      std::memcpy(&element, data + i * sizeof(E), sizeof(E));
+      packer.pack(element);
+    }
+    return buffer;
   }
 };
 
@@ -0,0 +1,52 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <ray/api/ray_runtime_holder.h>
+
+#include <memory>
+#include <string_view>
+
+namespace ray {
+
+/// Records the time from its construction to its destruction as a profile event of the
+/// current task, so that it shows up in the Ray timeline. It does nothing when the
+/// timeline is disabled or Ray isn't initialized.
+///
+/// \code
+/// {
+///   ray::Span span("load_model");
+///   LoadModel();
+/// }
+/// \endcode
+class Span {
+ public:
+  explicit Span(std::string_view name, std::string_view extra_data = {}) {
+    if (auto runtime = internal::GetRayRuntime()) {
+      event_ = runtime->StartProfileEvent(name, extra_data);
+    }
+  }
+
+  Span(const Span &) = delete;
+  Span &operator=(const Span &) = delete;
+
+  /// Record the span now instead of when it is destroyed.
+  void End() { event_.reset(); }
+
+ private:
+  std::shared_ptr<void> event_;
+};
+
+}  // namespace ray
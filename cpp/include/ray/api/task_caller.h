@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <ray/api/object_ref_stream.h>
 #include <ray/api/runtime_env.h>
 #include <ray/api/static_check.h>
 #include <ray/api/task_options.h>
@@ -29,7 +30,7 @@ class TaskCaller {
   TaskCaller(RayRuntime *runtime, RemoteFunctionHolder remote_function_holder);
 
   template <typename... Args>
-  ObjectRef<boost::callable_traits::return_type_t<F>> Remote(Args &&...args);
+  RemoteResult_t<F> Remote(Args &&...args);
 
   TaskCaller &SetName(std::string name) {
     task_options_.name = std::move(name);
@@ -57,6 +58,12 @@ class TaskCaller {
     return *this;
   }
 
+  /// Pause a streaming generator task while `num_objects` of its items are unconsumed.
+  TaskCaller &SetGeneratorBackpressure(int64_t num_objects) {
+    task_options_.generator_backpressure_num_objects = num_objects;
+    return *this;
+  }
+
  private:
   RayRuntime *runtime_;
   RemoteFunctionHolder remote_function_holder_{};
@@ -77,8 +84,7 @@ TaskCaller<F>::TaskCaller(RayRuntime *runtime,
 
 template <typename F>
 template <typename... Args>
-ObjectRef<boost::callable_traits::return_type_t<F>> TaskCaller<F>::Remote(
-    Args &&...args) {
+RemoteResult_t<F> TaskCaller<F>::Remote(Args &&...args) {
   CheckTaskOptions(task_options_.resources);
 
   if constexpr (is_x_lang_v<F>) {
@@ -96,9 +102,10 @@ ObjectRef<boost::callable_traits::return_type_t<F>> TaskCaller<F>::Remote(
                                    std::forward<Args>(args)...);
   }
 
-  auto returned_object_id = runtime_->Call(remote_function_holder_, args_, task_options_);
   using ReturnType = boost::callable_traits::return_type_t<F>;
-  auto return_ref = ObjectRef<ReturnType>(returned_object_id);
+  task_options_.streaming_generator = is_generator_v<ReturnType>;
+  auto returned_object_id = runtime_->Call(remote_function_holder_, args_, task_options_);
+  auto return_ref = RemoteResult_t<F>(returned_object_id);
   // The core worker will add an initial ref to each return ID to keep it in
   // scope. Now that we've created the frontend ObjectRef, remove this initial
   // ref.
@@ -17,6 +17,7 @@
 #include <ray/api/ray_exception.h>
 
 #include <cmath>
+#include <cstdint>
 
 namespace ray {
 namespace internal {
@@ -99,6 +100,11 @@ struct CallOptions {
   PlacementGroup group;
   int bundle_index;
   std::string serialized_runtime_env_info;
+  /// Whether the function returns a ray::Generator and streams its items.
+  bool streaming_generator = false;
+  /// The number of unconsumed items a streaming generator may produce before it pauses,
+  /// -1 means unlimited.
+  int64_t generator_backpressure_num_objects = -1;
 };
 
 struct ActorCreationOptions {
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <memory>
 #include <type_traits>
 
 namespace ray {
@@ -61,6 +62,15 @@ struct is_actor_handle_t<T, std::void_t<decltype(std::declval<T>().IsActorHandle
 template <typename T>
 auto constexpr is_actor_handle_v = is_actor_handle_t<T>::value;
 
+template <class>
+struct is_shared_ptr_t : std::false_type {};
+
+template <class T>
+struct is_shared_ptr_t<std::shared_ptr<T>> : std::true_type {};
+
+template <typename T>
+auto constexpr is_shared_ptr_v = is_shared_ptr_t<T>::value;
+
 template <class, class = void>
 struct is_python_t : std::false_type {};
 
@@ -23,6 +23,7 @@
 #include "../config_internal.h"
 #include "../util/function_helper.h"
 #include "local_mode_ray_runtime.h"
+#include "metric/metric_flusher.h"
 #include "native_ray_runtime.h"
 
 namespace ray {
@@ -62,6 +63,7 @@ std::shared_ptr<AbstractRayRuntime> AbstractRayRuntime::DoInit() {
         ConfigInternal::Instance().code_search_path);
   }
   abstract_ray_runtime_ = runtime;
+  StartMetricFlusher();
   return runtime;
 }
 
@@ -70,6 +72,8 @@ std::shared_ptr<AbstractRayRuntime> AbstractRayRuntime::GetInstance() {
 }
 
 void AbstractRayRuntime::DoShutdown() {
+  // Record what bound metrics accumulated while the stats exporter is still up.
+  StopMetricFlusher();
   abstract_ray_runtime_ = nullptr;
   if (ConfigInternal::Instance().run_mode == RunMode::CLUSTER) {
     ProcessHelper::GetInstance().RayStop();
@@ -92,6 +96,25 @@ std::string AbstractRayRuntime::Put(std::shared_ptr<msgpack::sbuffer> data) {
   return object_id.Binary();
 }
 
+std::string AbstractRayRuntime::Put(size_t data_size,
+                                    const std::function<void(char *data)> &writer) {
+  ObjectID object_id;
+  object_store_->Put(data_size, writer, &object_id);
+  return object_id.Binary();
+}
+
+std::vector<std::string> AbstractRayRuntime::PutBatch(
+    const std::vector<std::shared_ptr<msgpack::sbuffer>> &data) {
+  std::vector<ObjectID> object_ids;
+  object_store_->PutBatch(data, &object_ids);
+  std::vector<std::string> ids;
+  ids.reserve(object_ids.size());
+  for (const auto &object_id : object_ids) {
+    ids.push_back(object_id.Binary());
+  }
+  return ids;
+}
+
 std::shared_ptr<msgpack::sbuffer> AbstractRayRuntime::Get(const std::string &object_id) {
   return Get(object_id, -1);
 }
@@ -120,12 +143,76 @@ std::vector<std::shared_ptr<msgpack::sbuffer>> AbstractRayRuntime::Get(
   return object_store_->Get(StringIDsToObjectIDs(ids), timeout_ms);
 }
 
+std::shared_ptr<ObjectBuffer> AbstractRayRuntime::GetBuffer(const std::string &object_id,
+                                                            const int &timeout_ms) {
+  return object_store_->GetBuffer(ObjectID::FromBinary(object_id), timeout_ms);
+}
+
+std::vector<std::shared_ptr<ObjectBuffer>> AbstractRayRuntime::GetBuffers(
+    const std::vector<std::string> &ids, const int &timeout_ms) {
+  return object_store_->GetBuffers(StringIDsToObjectIDs(ids), timeout_ms);
+}
+
+void AbstractRayRuntime::GetAsync(const std::string &object_id,
+                                  ObjectBufferCallback callback) {
+  object_store_->GetAsync(ObjectID::FromBinary(object_id), std::move(callback));
+}
+
 std::vector<bool> AbstractRayRuntime::Wait(const std::vector<std::string> &ids,
                                            int num_objects,
                                            int timeout_ms) {
   return object_store_->Wait(StringIDsToObjectIDs(ids), num_objects, timeout_ms);
 }
 
+void AbstractRayRuntime::ReportGeneratorItem(std::shared_ptr<msgpack::sbuffer> item) {
+  auto reporter = GeneratorItemReporter::Current();
+  if (reporter == nullptr) {
+    throw RayException(
+        "Generator items can only be reported by a streaming generator task, call the "
+        "function with Remote() to stream its items.");
+  }
+  reporter->Report(std::move(item));
+}
+
+std::string AbstractRayRuntime::ReadGeneratorItem(const std::string &generator_id) {
+  auto item_id = object_store_->ReadGeneratorItem(ObjectID::FromBinary(generator_id));
+  return item_id.IsNil() ? "" : item_id.Binary();
+}
+
+void AbstractRayRuntime::DeleteGeneratorStream(const std::string &generator_id) {
+  object_store_->DeleteGeneratorStream(ObjectID::FromBinary(generator_id));
+}
+
+std::string AbstractRayRuntime::CreateChannel(size_t buffer_size) {
+  return object_store_->CreateChannel(buffer_size).Binary();
+}
+
+void AbstractRayRuntime::RegisterChannelWriter(const std::string &channel_id) {
+  object_store_->RegisterChannelWriter(ObjectID::FromBinary(channel_id));
+}
+
+void AbstractRayRuntime::RegisterChannelReader(const std::string &channel_id) {
+  object_store_->RegisterChannelReader(ObjectID::FromBinary(channel_id));
+}
+
+void AbstractRayRuntime::WriteChannel(const std::string &channel_id,
+                                      size_t data_size,
+                                      int64_t num_readers,
+                                      int timeout_ms,
+                                      const std::function<void(char *data)> &writer) {
+  object_store_->WriteChannel(
+      ObjectID::FromBinary(channel_id), data_size, num_readers, timeout_ms, writer);
+}
+
+std::shared_ptr<ObjectBuffer> AbstractRayRuntime::ReadChannel(
+    const std::string &channel_id, int timeout_ms) {
+  return object_store_->ReadChannel(ObjectID::FromBinary(channel_id), timeout_ms);
+}
+
+void AbstractRayRuntime::CloseChannel(const std::string &channel_id) {
+  object_store_->CloseChannel(ObjectID::FromBinary(channel_id));
+}
+
 std::vector<std::unique_ptr<::ray::TaskArg>> TransformArgs(
     std::vector<ray::internal::TaskArg> &args, bool cross_lang) {
   std::vector<std::unique_ptr<::ray::TaskArg>> ray_args;
@@ -173,6 +260,11 @@ InvocationSpec BuildInvocationSpec1(TaskType task_type,
   invocation_spec.actor_id = actor;
   invocation_spec.args =
       TransformArgs(args, remote_function_holder.lang_type != LangType::CPP);
+  for (size_t i = 0; i < args.size(); i++) {
+    if (args[i].id && args[i].resolve_value) {
+      invocation_spec.value_ref_args.push_back(i);
+    }
+  }
   return invocation_spec;
 }
 
@@ -239,17 +331,11 @@ const ActorID &AbstractRayRuntime::GetCurrentActorID() {
 }
 
 void AbstractRayRuntime::AddLocalReference(const std::string &id) {
-  if (CoreWorkerProcess::IsInitialized()) {
-    auto &core_worker = CoreWorkerProcess::GetCoreWorker();
-    core_worker.AddLocalReference(ObjectID::FromBinary(id));
-  }
+  object_store_->AddLocalReference(id);
 }
 
 void AbstractRayRuntime::RemoveLocalReference(const std::string &id) {
-  if (CoreWorkerProcess::IsInitialized()) {
-    auto &core_worker = CoreWorkerProcess::GetCoreWorker();
-    core_worker.RemoveLocalReference(ObjectID::FromBinary(id));
-  }
+  object_store_->RemoveLocalReference(id);
 }
 
 std::string AbstractRayRuntime::GetActorId(const std::string &actor_name,
@@ -50,6 +50,11 @@ class AbstractRayRuntime : public RayRuntime {
 
   std::string Put(std::shared_ptr<msgpack::sbuffer> data);
 
+  std::string Put(size_t data_size, const std::function<void(char *data)> &writer);
+
+  std::vector<std::string> PutBatch(
+      const std::vector<std::shared_ptr<msgpack::sbuffer>> &data);
+
   std::shared_ptr<msgpack::sbuffer> Get(const std::string &id);
 
   std::vector<std::shared_ptr<msgpack::sbuffer>> Get(const std::vector<std::string> &ids);
@@ -60,10 +65,41 @@ class AbstractRayRuntime : public RayRuntime {
   std::vector<std::shared_ptr<msgpack::sbuffer>> Get(const std::vector<std::string> &ids,
                                                      const int &timeout_ms);
 
+  std::shared_ptr<ObjectBuffer> GetBuffer(const std::string &object_id,
+                                          const int &timeout_ms);
+
+  std::vector<std::shared_ptr<ObjectBuffer>> GetBuffers(
+      const std::vector<std::string> &ids, const int &timeout_ms);
+
+  void GetAsync(const std::string &object_id, ObjectBufferCallback callback);
+
   std::vector<bool> Wait(const std::vector<std::string> &ids,
                          int num_objects,
                          int timeout_ms);
 
+  void ReportGeneratorItem(std::shared_ptr<msgpack::sbuffer> item);
+
+  std::string ReadGeneratorItem(const std::string &generator_id);
+
+  void DeleteGeneratorStream(const std::string &generator_id);
+
+  std::string CreateChannel(size_t buffer_size);
+
+  void RegisterChannelWriter(const std::string &channel_id);
+
+  void RegisterChannelReader(const std::string &channel_id);
+
+  void WriteChannel(const std::string &channel_id,
+                    size_t data_size,
+                    int64_t num_readers,
+                    int timeout_ms,
+                    const std::function<void(char *data)> &writer);
+
+  std::shared_ptr<ObjectBuffer> ReadChannel(const std::string &channel_id,
+                                            int timeout_ms);
+
+  void CloseChannel(const std::string &channel_id);
+
   std::string Call(const RemoteFunctionHolder &remote_function_holder,
                    std::vector<ray::internal::TaskArg> &args,
                    const CallOptions &task_options);
@@ -30,7 +30,7 @@ const JobID kUnusedJobId = JobID::FromInt(1);
 LocalModeRayRuntime::LocalModeRayRuntime()
     : job_id_(kUnusedJobId),
       worker_(ray::core::WorkerType::DRIVER, ComputeDriverIdFromJob(job_id_), job_id_) {
-  object_store_ = std::unique_ptr<ObjectStore>(new LocalModeObjectStore(*this));
+  object_store_ = std::unique_ptr<ObjectStore>(new LocalModeObjectStore());
   task_submitter_ = std::unique_ptr<TaskSubmitter>(new LocalModeTaskSubmitter(*this));
 }
 
@@ -43,6 +43,10 @@ ActorID LocalModeRayRuntime::GetNextActorID() {
 
 const WorkerContext &LocalModeRayRuntime::GetWorkerContext() { return worker_; }
 
+LocalModeObjectStore &LocalModeRayRuntime::GetLocalObjectStore() {
+  return static_cast<LocalModeObjectStore &>(*object_store_);
+}
+
 std::string LocalModeRayRuntime::Put(std::shared_ptr<msgpack::sbuffer> data) {
   ObjectID object_id =
       ObjectID::FromIndex(worker_.GetCurrentTaskID(), worker_.GetNextPutIndex());
@@ -21,6 +21,8 @@
 namespace ray {
 namespace internal {
 
+class LocalModeObjectStore;
+
 class LocalModeRayRuntime : public AbstractRayRuntime {
  public:
   LocalModeRayRuntime();
@@ -29,6 +31,12 @@ class LocalModeRayRuntime : public AbstractRayRuntime {
   std::string Put(std::shared_ptr<msgpack::sbuffer> data);
   const WorkerContext &GetWorkerContext();
   bool IsLocalMode() { return true; }
+  LocalModeObjectStore &GetLocalObjectStore();
+  /// Local mode has no timeline, so profile events are dropped.
+  std::shared_ptr<void> StartProfileEvent(std::string_view event_name,
+                                          std::string_view extra_data) {
+    return nullptr;
+  }
 
  private:
   JobID job_id_;
@@ -14,11 +14,170 @@
 
 #include "ray/api/metric.h"
 
+#include <thread>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "metric_accumulator.h"
+#include "metric_flusher.h"
 #include "ray/stats/metric.h"
 #include "ray/util/logging.h"
 
 namespace ray {
 
+namespace {
+
+/// Records the values of a metric with tags that were resolved once.
+class BoundMetricImpl {
+ public:
+  BoundMetricImpl(stats::Metric *metric, stats::TagsType tags)
+      : metric_(metric), tags_(std::move(tags)) {}
+
+  virtual ~BoundMetricImpl() = default;
+
+  virtual void Record(double value) { metric_->Record(value, tags_); }
+
+ protected:
+  stats::Metric *metric_;
+  const stats::TagsType tags_;
+};
+
+class AccumulatingBoundMetric;
+
+/// Flushes the accumulating bound metrics of the process at the stats harvest
+/// interval, while the runtime is up.
+class MetricFlusher {
+ public:
+  static MetricFlusher &Instance() {
+    // Leaked so that bound metrics destroyed during exit can still unregister.
+    static auto *instance = new MetricFlusher();
+    return *instance;
+  }
+
+  void Add(AccumulatingBoundMetric *metric) {
+    absl::MutexLock lock(&mutex_);
+    metrics_.insert(metric);
+  }
+
+  /// Once this returns, the flusher doesn't touch `metric` anymore.
+  void Remove(AccumulatingBoundMetric *metric) {
+    absl::MutexLock lock(&mutex_);
+    metrics_.erase(metric);
+  }
+
+  void Start() {
+    absl::MutexLock thread_lock(&thread_mutex_);
+    if (thread_.joinable()) {
+      return;
+    }
+    {
+      absl::MutexLock lock(&mutex_);
+      stopped_ = false;
+    }
+    thread_ = std::thread([this] { Run(); });
+  }
+
+  void Stop() {
+    absl::MutexLock thread_lock(&thread_mutex_);
+    if (!thread_.joinable()) {
+      return;
+    }
+    {
+      absl::MutexLock lock(&mutex_);
+      stopped_ = true;
+    }
+    thread_.join();
+  }
+
+ private:
+  MetricFlusher() = default;
+
+  /// Flush every harvest interval until stopped, then flush one last time.
+  void Run();
+
+  /// Serializes starting and stopping the thread.
+  absl::Mutex thread_mutex_;
+  std::thread thread_ ABSL_GUARDED_BY(thread_mutex_);
+
+  absl::Mutex mutex_;
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::flat_hash_set<AccumulatingBoundMetric *> metrics_ ABSL_GUARDED_BY(mutex_);
+};
+
+/// Adds values up per recording thread, without locking, and records the totals when
+/// flushed. Only metrics whose values can be added up before they are recorded may
+/// accumulate.
+class AccumulatingBoundMetric : public BoundMetricImpl {
+ public:
+  AccumulatingBoundMetric(stats::Metric *metric, stats::TagsType tags)
+      : BoundMetricImpl(metric, std::move(tags)) {
+    MetricFlusher::Instance().Add(this);
+  }
+
+  ~AccumulatingBoundMetric() override {
+    MetricFlusher::Instance().Remove(this);
+    Flush();
+  }
+
+  void Record(double value) override { accumulator_.Add(value); }
+
+  /// Record what was added up since the last flush.
+  void Flush() {
+    double delta = accumulator_.Flush();
+    if (delta != 0) {
+      metric_->Record(delta, tags_);
+    }
+  }
+
+ private:
+  internal::MetricAccumulator accumulator_;
+};
+
+void MetricFlusher::Run() {
+  const auto interval = stats::StatsConfig::instance().GetHarvestInterval();
+  absl::MutexLock lock(&mutex_);
+  bool stopped = false;
+  while (!stopped) {
+    // Wakes up early when stopped.
+    stopped = mutex_.AwaitWithTimeout(absl::Condition(&stopped_), interval);
+    for (auto *metric : metrics_) {
+      metric->Flush();
+    }
+  }
+}
+
+}  // namespace
+
+namespace internal {
+
+void StartMetricFlusher() { MetricFlusher::Instance().Start(); }
+
+void StopMetricFlusher() { MetricFlusher::Instance().Stop(); }
+
+}  // namespace internal
+
+BoundMetric::BoundMetric(BoundMetric &&other) noexcept
+    : bound_metric_(other.bound_metric_) {
+  other.bound_metric_ = nullptr;
+}
+
+BoundMetric &BoundMetric::operator=(BoundMetric &&other) noexcept {
+  if (this != &other) {
+    delete reinterpret_cast<BoundMetricImpl *>(bound_metric_);
+    bound_metric_ = other.bound_metric_;
+    other.bound_metric_ = nullptr;
+  }
+  return *this;
+}
+
+BoundMetric::~BoundMetric() { delete reinterpret_cast<BoundMetricImpl *>(bound_metric_); }
+
+void BoundMetric::Record(double value) {
+  RAY_CHECK(bound_metric_ != nullptr) << "The bound_metric_ must not be nullptr.";
+  reinterpret_cast<BoundMetricImpl *>(bound_metric_)->Record(value);
+}
+
 Metric::~Metric() {
   if (metric_ != nullptr) {
     stats::Metric *metric = reinterpret_cast<stats::Metric *>(metric_);
@@ -40,6 +199,20 @@ void Metric::Record(double value,
   metric->Record(value, tags);
 }
 
+BoundMetric Metric::Bind(const std::unordered_map<std::string, std::string> &tags) {
+  RAY_CHECK(metric_ != nullptr) << "The metric_ must not be nullptr.";
+  stats::Metric *metric = reinterpret_cast<stats::Metric *>(metric_);
+  stats::TagsType resolved_tags;
+  resolved_tags.reserve(tags.size());
+  for (const auto &[key, value] : tags) {
+    resolved_tags.emplace_back(stats::TagKeyType::Register(key), value);
+  }
+  if (accumulates_) {
+    return BoundMetric(new AccumulatingBoundMetric(metric, std::move(resolved_tags)));
+  }
+  return BoundMetric(new BoundMetricImpl(metric, std::move(resolved_tags)));
+}
+
 Gauge::Gauge(const std::string &name,
              const std::string &description,
              const std::string &unit,
@@ -69,6 +242,7 @@ Counter::Counter(const std::string &name,
                  const std::string &unit,
                  const std::vector<std::string> &tag_str_keys) {
   metric_ = new stats::Count(name, description, unit, tag_str_keys);
+  accumulates_ = true;
 }
 
 void Counter::Inc(double value,
@@ -81,6 +255,7 @@ Sum::Sum(const std::string &name,
          const std::string &unit,
          const std::vector<std::string> &tag_str_keys) {
   metric_ = new stats::Sum(name, description, unit, tag_str_keys);
+  accumulates_ = true;
 }
 
 }  // namespace ray
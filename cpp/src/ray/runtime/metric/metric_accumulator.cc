@@ -0,0 +1,112 @@
+// Copyright 2020-2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "metric_accumulator.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+
+namespace ray {
+namespace internal {
+
+namespace {
+
+/// The cells of the calling thread, by accumulator id.
+struct ThreadCells {
+  /// The raw pointer is only used by the accumulator itself, which keeps the cell alive.
+  /// The weak reference tells whether the accumulator was destroyed.
+  absl::flat_hash_map<uint64_t, std::pair<MetricAccumulator::Cell *,
+                                          std::weak_ptr<MetricAccumulator::Cell>>>
+      cells;
+  /// The number of cells left after dropping those of destroyed accumulators.
+  size_t live_cells = 0;
+
+  /// Tell the accumulators still alive that this thread won't add to its cells anymore.
+  ~ThreadCells() {
+    for (auto &[id, entry] : cells) {
+      if (auto cell = entry.second.lock()) {
+        cell->exited.store(true, std::memory_order_release);
+      }
+    }
+  }
+
+  /// Drop the cells of destroyed accumulators once the map has doubled since the last
+  /// time, which keeps the map within twice the live cells at amortized constant cost.
+  void MaybeDropDestroyed() {
+    if (cells.size() < std::max<size_t>(2 * live_cells, 16)) {
+      return;
+    }
+    absl::erase_if(cells,
+                   [](const auto &entry) { return entry.second.second.expired(); });
+    live_cells = cells.size();
+  }
+};
+
+thread_local ThreadCells thread_cells;
+
+}  // namespace
+
+void MetricAccumulator::Add(double value) {
+  auto &total = GetCell().total;
+  // Only this thread writes the cell, so there is no need for an atomic add.
+  total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_release);
+}
+
+double MetricAccumulator::Flush() {
+  double delta = 0;
+  absl::MutexLock lock(&mutex_);
+  for (size_t i = 0; i < cells_.size();) {
+    auto &cell = cells_[i];
+    // Check for the exit first, so that the total read after it is final.
+    bool exited = cell->exited.load(std::memory_order_acquire);
+    double total = cell->total.load(std::memory_order_acquire);
+    delta += total - cell->flushed;
+    cell->flushed = total;
+    if (exited) {
+      // Everything the thread added is in `delta` now, so its cell can go.
+      cell = std::move(cells_.back());
+      cells_.pop_back();
+    } else {
+      i++;
+    }
+  }
+  return delta;
+}
+
+size_t MetricAccumulator::NumThreadCells() { return thread_cells.cells.size(); }
+
+size_t MetricAccumulator::NumCells() {
+  absl::MutexLock lock(&mutex_);
+  return cells_.size();
+}
+
+MetricAccumulator::Cell &MetricAccumulator::GetCell() {
+  auto it = thread_cells.cells.find(id_);
+  if (it != thread_cells.cells.end()) {
+    return *it->second.first;
+  }
+  thread_cells.MaybeDropDestroyed();
+  auto cell = std::make_shared<Cell>();
+  {
+    absl::MutexLock lock(&mutex_);
+    cells_.push_back(cell);
+  }
+  thread_cells.cells.emplace(id_, std::make_pair(cell.get(), std::weak_ptr<Cell>(cell)));
+  return *cell;
+}
+
+}  // namespace internal
+}  // namespace ray
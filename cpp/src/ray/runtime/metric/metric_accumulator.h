@@ -0,0 +1,70 @@
+// Copyright 2020-2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+
+namespace ray {
+namespace internal {
+
+/// Adds values up in one cell per adding thread, without locking, and hands out what
+/// was added since the last flush.
+class MetricAccumulator {
+ public:
+  MetricAccumulator() : id_(next_id_.fetch_add(1)) {}
+
+  /// Add a value. Values added by one thread are seen by the next flush in order.
+  void Add(double value);
+
+  /// Return the sum of the values added since the last call, by any thread.
+  double Flush();
+
+  /// The number of accumulators the calling thread keeps a cell of, for tests.
+  static size_t NumThreadCells();
+
+  /// The number of threads the accumulator keeps a cell of, for tests.
+  size_t NumCells();
+
+  struct Cell {
+    /// The sum of the values added by the cell's thread, written only by it.
+    std::atomic<double> total{0};
+    /// The part of `total` that was already flushed, used only while flushing.
+    double flushed = 0;
+    /// Set when the cell's thread exits, after its last write to `total`.
+    std::atomic<bool> exited{false};
+  };
+
+ private:
+  Cell &GetCell();
+
+  static inline std::atomic<uint64_t> next_id_{0};
+
+  /// Identifies the accumulator in the thread local cell maps. Unlike the address, it
+  /// isn't reused by an accumulator allocated where a destroyed one lived.
+  const uint64_t id_;
+  absl::Mutex mutex_;
+  /// The thread local maps only hold weak references, so the cells are freed with the
+  /// accumulator and the maps drop them the next time they grow. The cells of exited
+  /// threads are released by the next flush.
+  std::vector<std::shared_ptr<Cell>> cells_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal
+}  // namespace ray
@@ -0,0 +1,29 @@
+// Copyright 2020-2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+namespace ray {
+namespace internal {
+
+/// Start recording what bound metrics accumulate at the stats harvest interval. Does
+/// nothing if already started.
+void StartMetricFlusher();
+
+/// Stop the flushing thread, after recording what bound metrics accumulated so far.
+/// Bound metrics destroyed while it is stopped still record what they accumulated.
+void StopMetricFlusher();
+
+}  // namespace internal
+}  // namespace ray
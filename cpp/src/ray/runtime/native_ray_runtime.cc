@@ -41,5 +41,18 @@ const WorkerContext &NativeRayRuntime::GetWorkerContext() {
   return core::CoreWorkerProcess::GetCoreWorker().GetWorkerContext();
 }
 
+std::shared_ptr<void> NativeRayRuntime::StartProfileEvent(std::string_view event_name,
+                                                          std::string_view extra_data) {
+  if (!::RayConfig::instance().enable_timeline()) {
+    return nullptr;
+  }
+  auto event = core::CoreWorkerProcess::GetCoreWorker().CreateProfileEvent(
+      std::string(event_name));
+  if (!extra_data.empty()) {
+    event->SetExtraData(std::string(extra_data));
+  }
+  return event;
+}
+
 }  // namespace internal
 }  // namespace ray
@@ -26,6 +26,9 @@ class NativeRayRuntime : public AbstractRayRuntime {
   NativeRayRuntime();
 
   const WorkerContext &GetWorkerContext();
+
+  std::shared_ptr<void> StartProfileEvent(std::string_view event_name,
+                                          std::string_view extra_data);
 };
 
 }  // namespace internal
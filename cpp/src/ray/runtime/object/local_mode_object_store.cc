@@ -21,31 +21,231 @@
 #include <list>
 #include <thread>
 
+#include "absl/time/time.h"
+
 #include "../abstract_ray_runtime.h"
 
 namespace ray {
 namespace internal {
-LocalModeObjectStore::LocalModeObjectStore(LocalModeRayRuntime &local_mode_ray_tuntime)
-    : io_context_("LocalModeObjectStore"),
-      local_mode_ray_tuntime_(local_mode_ray_tuntime) {
-  memory_store_ = std::make_unique<CoreWorkerMemoryStore>(io_context_.GetIoService());
-}
+
+namespace {
+/// A store buffer that shares a serialized object instead of copying it.
+class SbufferObjectBuffer : public Buffer {
+ public:
+  explicit SbufferObjectBuffer(std::shared_ptr<msgpack::sbuffer> sbuffer)
+      : sbuffer_(std::move(sbuffer)) {}
+
+  uint8_t *Data() const override { return reinterpret_cast<uint8_t *>(sbuffer_->data()); }
+
+  size_t Size() const override { return sbuffer_->size(); }
+
+  bool OwnsData() const override { return true; }
+
+  bool IsPlasmaBuffer() const override { return false; }
+
+  const std::shared_ptr<msgpack::sbuffer> &Sbuffer() const { return sbuffer_; }
+
+ private:
+  std::shared_ptr<msgpack::sbuffer> sbuffer_;
+};
+}  // namespace
 
 void LocalModeObjectStore::PutRaw(std::shared_ptr<msgpack::sbuffer> data,
                                   ObjectID *object_id) {
   *object_id = ObjectID::FromRandom();
+  // The initial reference, which the caller removes once it holds an ObjectRef.
+  AddReference(*object_id);
   PutRaw(data, *object_id);
 }
 
 void LocalModeObjectStore::PutRaw(std::shared_ptr<msgpack::sbuffer> data,
                                   const ObjectID &object_id) {
-  auto buffer = std::make_shared<::ray::LocalMemoryBuffer>(
-      reinterpret_cast<uint8_t *>(data->data()), data->size(), true);
-  auto status = memory_store_->Put(
-      ::ray::RayObject(buffer, nullptr, std::vector<rpc::ObjectReference>()), object_id);
-  if (!status) {
-    throw RayException("Put object error");
+  auto buffer = std::make_shared<SbufferObjectBuffer>(std::move(data));
+  PutObject(std::make_shared<::ray::RayObject>(
+                buffer, nullptr, std::vector<rpc::ObjectReference>()),
+            object_id);
+}
+
+void LocalModeObjectStore::PutRaw(size_t data_size,
+                                  const std::function<void(char *data)> &writer,
+                                  ObjectID *object_id) {
+  *object_id = ObjectID::FromRandom();
+  AddReference(*object_id);
+  auto buffer = std::make_shared<::ray::LocalMemoryBuffer>(data_size);
+  writer(reinterpret_cast<char *>(buffer->Data()));
+  PutObject(std::make_shared<::ray::RayObject>(
+                buffer, nullptr, std::vector<rpc::ObjectReference>()),
+            *object_id);
+}
+
+void LocalModeObjectStore::PutBatchRaw(
+    const std::vector<std::shared_ptr<msgpack::sbuffer>> &data,
+    std::vector<ObjectID> *object_ids) {
+  object_ids->clear();
+  object_ids->reserve(data.size());
+  for (const auto &sbuffer : data) {
+    object_ids->push_back(ObjectID::FromRandom());
+    AddReference(object_ids->back());
+    PutRaw(sbuffer, object_ids->back());
+  }
+}
+
+void LocalModeObjectStore::PutObject(std::shared_ptr<RayObject> object,
+                                     const ObjectID &object_id) {
+  std::vector<std::pair<uint64_t, ObjectCallback>> callbacks;
+  {
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mutex);
+    auto ref_it = shard.reference_counts.find(object_id);
+    if (ref_it != shard.reference_counts.end() && ref_it->second == 0) {
+      // All references were removed before the put, only hand the object to the
+      // callbacks that are still waiting for it.
+      shard.reference_counts.erase(ref_it);
+    } else if (!shard.objects.emplace(object_id, object).second) {
+      // Objects are immutable, the first put wins.
+      return;
+    }
+    auto it = shard.callbacks.find(object_id);
+    if (it != shard.callbacks.end()) {
+      callbacks = std::move(it->second);
+      shard.callbacks.erase(it);
+    }
+  }
+  for (const auto &[callback_id, callback] : callbacks) {
+    callback(object);
+  }
+}
+
+void LocalModeObjectStore::GetObjectAsync(const ObjectID &object_id,
+                                          ObjectCallback callback) {
+  GetObjectAsync(object_id, std::move(callback), next_callback_id_.fetch_add(1));
+}
+
+void LocalModeObjectStore::GetObjectAsync(const ObjectID &object_id,
+                                          ObjectCallback callback,
+                                          uint64_t callback_id) {
+  std::shared_ptr<RayObject> object;
+  {
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mutex);
+    auto it = shard.objects.find(object_id);
+    if (it == shard.objects.end()) {
+      shard.callbacks[object_id].emplace_back(callback_id, std::move(callback));
+      return;
+    }
+    object = it->second;
+  }
+  callback(std::move(object));
+}
+
+void LocalModeObjectStore::RemoveCallbacks(const ObjectID &object_id,
+                                           uint64_t callback_id) {
+  auto &shard = GetShard(object_id);
+  absl::MutexLock lock(&shard.mutex);
+  auto it = shard.callbacks.find(object_id);
+  if (it == shard.callbacks.end()) {
+    return;
+  }
+  auto &callbacks = it->second;
+  callbacks.erase(std::remove_if(callbacks.begin(),
+                                 callbacks.end(),
+                                 [callback_id](const auto &entry) {
+                                   return entry.first == callback_id;
+                                 }),
+                  callbacks.end());
+  if (callbacks.empty()) {
+    shard.callbacks.erase(it);
+  }
+}
+
+void LocalModeObjectStore::AddReference(const ObjectID &object_id) {
+  auto &shard = GetShard(object_id);
+  absl::MutexLock lock(&shard.mutex);
+  shard.reference_counts[object_id]++;
+}
+
+void LocalModeObjectStore::RemoveReference(const ObjectID &object_id) {
+  // Destroy the object outside of the lock.
+  std::shared_ptr<RayObject> object;
+  auto &shard = GetShard(object_id);
+  absl::MutexLock lock(&shard.mutex);
+  auto it = shard.reference_counts.find(object_id);
+  if (it == shard.reference_counts.end() || it->second == 0) {
+    return;
+  }
+  if (--it->second > 0) {
+    return;
+  }
+  auto object_it = shard.objects.find(object_id);
+  if (object_it == shard.objects.end()) {
+    // Not put yet, keep the entry so that the put drops the object.
+    return;
+  }
+  object = std::move(object_it->second);
+  shard.objects.erase(object_it);
+  shard.reference_counts.erase(it);
+}
+
+std::vector<std::shared_ptr<RayObject>> LocalModeObjectStore::WaitObjects(
+    const std::vector<ObjectID> &ids, size_t num_objects, int timeout_ms) {
+  struct Waiter {
+    absl::Mutex mutex;
+    std::vector<std::shared_ptr<RayObject>> objects ABSL_GUARDED_BY(mutex);
+    size_t num_ready ABSL_GUARDED_BY(mutex) = 0;
+  };
+  // A callback may still run after this call returns, if the object is put while its
+  // callback is being removed.
+  auto waiter = std::make_shared<Waiter>();
+  {
+    absl::MutexLock lock(&waiter->mutex);
+    waiter->objects.resize(ids.size());
+  }
+  uint64_t callback_id = next_callback_id_.fetch_add(1);
+  for (size_t i = 0; i < ids.size(); i++) {
+    GetObjectAsync(
+        ids[i],
+        [waiter, i](std::shared_ptr<RayObject> object) {
+          absl::MutexLock lock(&waiter->mutex);
+          waiter->objects[i] = std::move(object);
+          waiter->num_ready++;
+        },
+        callback_id);
+  }
+
+  std::vector<std::shared_ptr<RayObject>> objects;
+  {
+    absl::MutexLock lock(&waiter->mutex);
+    auto ready = [&waiter, num_objects]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(waiter->mutex) {
+      return waiter->num_ready >= num_objects;
+    };
+    if (timeout_ms < 0) {
+      waiter->mutex.Await(absl::Condition(&ready));
+    } else {
+      waiter->mutex.AwaitWithTimeout(absl::Condition(&ready),
+                                     absl::Milliseconds(timeout_ms));
+    }
+    objects = waiter->objects;
   }
+  // Don't leave the callbacks of the objects that aren't ready behind, e.g. on a
+  // timeout.
+  for (size_t i = 0; i < ids.size(); i++) {
+    if (objects[i] == nullptr) {
+      RemoveCallbacks(ids[i], callback_id);
+    }
+  }
+  return objects;
+}
+
+std::vector<std::shared_ptr<RayObject>> LocalModeObjectStore::GetObjects(
+    const std::vector<ObjectID> &ids, int timeout_ms) {
+  auto objects = WaitObjects(ids, ids.size(), timeout_ms);
+  for (const auto &object : objects) {
+    if (object == nullptr) {
+      throw RayTimeoutException(
+          "Get object error: Get timed out: some object(s) not ready.");
+    }
+  }
+  return objects;
 }
 
 std::shared_ptr<msgpack::sbuffer> LocalModeObjectStore::GetRaw(const ObjectID &object_id,
@@ -59,59 +259,140 @@ std::shared_ptr<msgpack::sbuffer> LocalModeObjectStore::GetRaw(const ObjectID &o
 
 std::vector<std::shared_ptr<msgpack::sbuffer>> LocalModeObjectStore::GetRaw(
     const std::vector<ObjectID> &ids, int timeout_ms) {
-  std::vector<std::shared_ptr<::ray::RayObject>> results;
-  ::ray::Status status = memory_store_->Get(ids,
-                                            (int)ids.size(),
-                                            timeout_ms,
-                                            local_mode_ray_tuntime_.GetWorkerContext(),
-                                            false,
-                                            &results);
-  if (!status.ok()) {
-    throw RayException("Get object error: " + status.ToString());
-  }
-  RAY_CHECK(results.size() == ids.size());
+  auto objects = GetObjects(ids, timeout_ms);
   std::vector<std::shared_ptr<msgpack::sbuffer>> result_sbuffers;
-  result_sbuffers.reserve(results.size());
-  for (size_t i = 0; i < results.size(); i++) {
-    auto data_buffer = results[i]->GetData();
-    auto sbuffer = std::make_shared<msgpack::sbuffer>(data_buffer->Size());
-    sbuffer->write(reinterpret_cast<const char *>(data_buffer->Data()),
-                   data_buffer->Size());
-    result_sbuffers.push_back(sbuffer);
+  result_sbuffers.reserve(objects.size());
+  for (const auto &object : objects) {
+    // Objects put from a msgpack buffer are handed out as is, readers don't modify them.
+    auto sbuffer_buffer =
+        std::dynamic_pointer_cast<SbufferObjectBuffer>(object->GetData());
+    if (sbuffer_buffer != nullptr) {
+      result_sbuffers.push_back(sbuffer_buffer->Sbuffer());
+      continue;
+    }
+    ObjectBuffer buffer;
+    buffer.data = reinterpret_cast<const char *>(object->GetData()->Data());
+    buffer.size = object->GetData()->Size();
+    result_sbuffers.push_back(CopyToSbuffer(buffer));
   }
   return result_sbuffers;
 }
 
+std::shared_ptr<ObjectBuffer> LocalModeObjectStore::ToObjectBuffer(
+    std::shared_ptr<RayObject> object) {
+  const auto &data_buffer = object->GetData();
+  auto buffer = std::make_shared<ObjectBuffer>();
+  buffer->data = reinterpret_cast<const char *>(data_buffer->Data());
+  buffer->size = data_buffer->Size();
+  buffer->holder = std::move(object);
+  return buffer;
+}
+
+std::vector<std::shared_ptr<ObjectBuffer>> LocalModeObjectStore::GetBuffersRaw(
+    const std::vector<ObjectID> &ids, int timeout_ms) {
+  auto results = GetObjects(ids, timeout_ms);
+  std::vector<std::shared_ptr<ObjectBuffer>> buffers;
+  buffers.reserve(results.size());
+  for (auto &result : results) {
+    buffers.push_back(ToObjectBuffer(std::move(result)));
+  }
+  return buffers;
+}
+
+void LocalModeObjectStore::GetAsyncRaw(const ObjectID &object_id,
+                                       ObjectBufferCallback callback) {
+  GetObjectAsync(object_id,
+                 [callback = std::move(callback)](std::shared_ptr<RayObject> object) {
+                   callback(ToObjectBuffer(std::move(object)), nullptr);
+                 });
+}
+
 std::vector<bool> LocalModeObjectStore::Wait(const std::vector<ObjectID> &ids,
                                              int num_objects,
                                              int timeout_ms) {
-  absl::flat_hash_set<ObjectID> memory_object_ids;
-  for (const auto &object_id : ids) {
-    memory_object_ids.insert(object_id);
-  }
-  absl::flat_hash_set<ObjectID> ready;
-  ::ray::Status status = memory_store_->Wait(memory_object_ids,
-                                             num_objects,
-                                             timeout_ms,
-                                             local_mode_ray_tuntime_.GetWorkerContext(),
-                                             &ready);
-  if (!status.ok()) {
-    throw RayException("Wait object error: " + status.ToString());
-  }
+  auto objects = WaitObjects(ids, num_objects, timeout_ms);
   std::vector<bool> result;
   result.reserve(ids.size());
-  for (size_t i = 0; i < ids.size(); i++) {
-    if (ready.find(ids[i]) != ready.end()) {
-      result.push_back(true);
-    } else {
-      result.push_back(false);
-    }
+  for (const auto &object : objects) {
+    result.push_back(object != nullptr);
   }
   return result;
 }
 
-void LocalModeObjectStore::AddLocalReference(const std::string &id) { return; }
+std::shared_ptr<RayObject> LocalModeObjectStore::GetIfExists(const ObjectID &object_id) {
+  auto &shard = GetShard(object_id);
+  absl::MutexLock lock(&shard.mutex);
+  auto it = shard.objects.find(object_id);
+  return it == shard.objects.end() ? nullptr : it->second;
+}
+
+ObjectID LocalModeObjectStore::ReadGeneratorItem(const ObjectID &generator_id) {
+  int64_t item_index;
+  {
+    absl::MutexLock lock(&generators_mutex_);
+    item_index = generator_next_index_[generator_id];
+  }
+  auto item_id = GeneratorItemId(generator_id, item_index);
+  if (GetIfExists(item_id) == nullptr) {
+    // The generator's return object is put after all of its items, so once it's there
+    // a missing item means the stream has ended.
+    WaitObjects({item_id, generator_id}, 1, -1);
+    if (GetIfExists(item_id) == nullptr) {
+      return ObjectID::Nil();
+    }
+  }
+  // The reference the caller removes once it holds an ObjectRef to the item.
+  AddReference(item_id);
+  absl::MutexLock lock(&generators_mutex_);
+  generator_next_index_[generator_id] = item_index + 1;
+  return item_id;
+}
+
+void LocalModeObjectStore::DeleteGeneratorStream(const ObjectID &generator_id) {
+  absl::MutexLock lock(&generators_mutex_);
+  generator_next_index_.erase(generator_id);
+}
+
+ObjectID LocalModeObjectStore::CreateChannel(size_t buffer_size) {
+  throw RayException("Ray doesn't support channels in local mode.");
+}
+
+void LocalModeObjectStore::RegisterChannelWriter(const ObjectID &channel_id) {
+  throw RayException("Ray doesn't support channels in local mode.");
+}
+
+void LocalModeObjectStore::RegisterChannelReader(const ObjectID &channel_id) {
+  throw RayException("Ray doesn't support channels in local mode.");
+}
+
+void LocalModeObjectStore::WriteChannel(const ObjectID &channel_id,
+                                        size_t data_size,
+                                        int64_t num_readers,
+                                        int timeout_ms,
+                                        const std::function<void(char *data)> &writer) {
+  throw RayException("Ray doesn't support channels in local mode.");
+}
+
+std::shared_ptr<ObjectBuffer> LocalModeObjectStore::ReadChannel(
+    const ObjectID &channel_id, int timeout_ms) {
+  throw RayException("Ray doesn't support channels in local mode.");
+}
+
+void LocalModeObjectStore::CloseChannel(const ObjectID &channel_id) {
+  throw RayException("Ray doesn't support channels in local mode.");
+}
+
+void LocalModeObjectStore::AddLocalReference(const std::string &id) {
+  if (!id.empty()) {
+    AddReference(ObjectID::FromBinary(id));
+  }
+}
+
+void LocalModeObjectStore::RemoveLocalReference(const std::string &id) {
+  if (!id.empty()) {
+    RemoveReference(ObjectID::FromBinary(id));
+  }
+}
 
-void LocalModeObjectStore::RemoveLocalReference(const std::string &id) { return; }
 }  // namespace internal
 }  // namespace ray
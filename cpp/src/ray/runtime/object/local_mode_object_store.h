@@ -14,44 +14,150 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <functional>
 #include <unordered_map>
+#include <utility>
 
-#include "../local_mode_ray_runtime.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include "object_store.h"
-#include "ray/common/asio/asio_util.h"
-#include "ray/core_worker/store_provider/memory_store/memory_store.h"
+#include "ray/common/ray_object.h"
 
 namespace ray {
 namespace internal {
 
-using ray::core::CoreWorkerMemoryStore;
+using ObjectCallback = std::function<void(std::shared_ptr<RayObject>)>;
 
+/// The object store of local mode. Objects are kept in memory and spread over shards by
+/// object id, so that tasks running in parallel don't serialize on one lock. Serialized
+/// objects are shared with readers by pointer instead of being copied. An object is
+/// freed when its last local reference is removed.
 class LocalModeObjectStore : public ObjectStore {
  public:
-  explicit LocalModeObjectStore(LocalModeRayRuntime &local_mode_ray_tuntime);
+  LocalModeObjectStore() = default;
 
   std::vector<bool> Wait(const std::vector<ObjectID> &ids,
                          int num_objects,
                          int timeout_ms);
 
+  ObjectID ReadGeneratorItem(const ObjectID &generator_id);
+
+  void DeleteGeneratorStream(const ObjectID &generator_id);
+
+  ObjectID CreateChannel(size_t buffer_size);
+
+  void RegisterChannelWriter(const ObjectID &channel_id);
+
+  void RegisterChannelReader(const ObjectID &channel_id);
+
+  void WriteChannel(const ObjectID &channel_id,
+                    size_t data_size,
+                    int64_t num_readers,
+                    int timeout_ms,
+                    const std::function<void(char *data)> &writer);
+
+  std::shared_ptr<ObjectBuffer> ReadChannel(const ObjectID &channel_id, int timeout_ms);
+
+  void CloseChannel(const ObjectID &channel_id);
+
   void AddLocalReference(const std::string &id);
 
   void RemoveLocalReference(const std::string &id);
 
+  /// Run `callback` once the object is available. It runs right away in the calling
+  /// thread if the object is already in the store, otherwise in the thread that puts it.
+  void GetObjectAsync(const ObjectID &object_id, ObjectCallback callback);
+
+  /// Increase the local reference count of an object. Unlike AddLocalReference, this
+  /// takes the object id rather than its binary.
+  void AddReference(const ObjectID &object_id);
+
+  /// Decrease the local reference count of an object, and free it once no references
+  /// are left. Objects that were never referenced are kept.
+  void RemoveReference(const ObjectID &object_id);
+
+  /// Get a list of objects, blocking until they are all available or the timeout
+  /// expires.
+  std::vector<std::shared_ptr<RayObject>> GetObjects(const std::vector<ObjectID> &ids,
+                                                     int timeout_ms);
+
+  /// The id a streaming generator task puts its item at `item_index` at. Items are
+  /// numbered after the task's return object, the generator itself.
+  static ObjectID GeneratorItemId(const ObjectID &generator_id, int64_t item_index) {
+    return ObjectID::FromIndex(generator_id.TaskId(), 2 + item_index);
+  }
+
  private:
+  static constexpr size_t kNumShards = 64;
+
+  struct Shard {
+    absl::Mutex mutex;
+    absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> objects
+        ABSL_GUARDED_BY(mutex);
+    /// Callbacks waiting for objects that haven't been put yet, with the ids they were
+    /// added with.
+    absl::flat_hash_map<ObjectID, std::vector<std::pair<uint64_t, ObjectCallback>>>
+        callbacks ABSL_GUARDED_BY(mutex);
+    /// The local reference counts of objects. An entry without references marks an
+    /// object that was released before it was put, so that the put doesn't keep it.
+    absl::flat_hash_map<ObjectID, int64_t> reference_counts ABSL_GUARDED_BY(mutex);
+  };
+
+  Shard &GetShard(const ObjectID &object_id) {
+    return shards_[object_id.Hash() % kNumShards];
+  }
+
+  void PutObject(std::shared_ptr<RayObject> object, const ObjectID &object_id);
+
+  void GetObjectAsync(const ObjectID &object_id,
+                      ObjectCallback callback,
+                      uint64_t callback_id);
+
+  /// Remove the callbacks added with `callback_id` that are still waiting for an object.
+  void RemoveCallbacks(const ObjectID &object_id, uint64_t callback_id);
+
+  /// Get the object if it's in the store, without waiting for it.
+  std::shared_ptr<RayObject> GetIfExists(const ObjectID &object_id);
+
+  static std::shared_ptr<ObjectBuffer> ToObjectBuffer(std::shared_ptr<RayObject> object);
+
+  /// Wait until `num_objects` of `ids` are available or the timeout expires, and return
+  /// the available ones. Unavailable entries are null.
+  std::vector<std::shared_ptr<RayObject>> WaitObjects(const std::vector<ObjectID> &ids,
+                                                      size_t num_objects,
+                                                      int timeout_ms);
+
   void PutRaw(std::shared_ptr<msgpack::sbuffer> data, ObjectID *object_id);
 
   void PutRaw(std::shared_ptr<msgpack::sbuffer> data, const ObjectID &object_id);
 
+  void PutRaw(size_t data_size,
+              const std::function<void(char *data)> &writer,
+              ObjectID *object_id);
+
+  void PutBatchRaw(const std::vector<std::shared_ptr<msgpack::sbuffer>> &data,
+                   std::vector<ObjectID> *object_ids);
+
   std::shared_ptr<msgpack::sbuffer> GetRaw(const ObjectID &object_id, int timeout_ms);
 
   std::vector<std::shared_ptr<msgpack::sbuffer>> GetRaw(const std::vector<ObjectID> &ids,
                                                         int timeout_ms);
 
-  InstrumentedIOContextWithThread io_context_;
-  std::unique_ptr<CoreWorkerMemoryStore> memory_store_;
+  std::vector<std::shared_ptr<ObjectBuffer>> GetBuffersRaw(
+      const std::vector<ObjectID> &ids, int timeout_ms);
+
+  void GetAsyncRaw(const ObjectID &object_id, ObjectBufferCallback callback);
+
+  std::array<Shard, kNumShards> shards_;
+
+  std::atomic<uint64_t> next_callback_id_{0};
 
-  LocalModeRayRuntime &local_mode_ray_tuntime_;
+  absl::Mutex generators_mutex_;
+  /// The index of the next item to read of each streaming generator that is read.
+  absl::flat_hash_map<ObjectID, int64_t> generator_next_index_
+      ABSL_GUARDED_BY(generators_mutex_);
 };
 
 }  // namespace internal
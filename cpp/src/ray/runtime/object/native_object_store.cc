@@ -58,6 +58,56 @@ void NativeObjectStore::PutRaw(std::shared_ptr<msgpack::sbuffer> data,
   return;
 }
 
+void NativeObjectStore::PutRaw(size_t data_size,
+                               const std::function<void(char *data)> &writer,
+                               ObjectID *object_id) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  std::shared_ptr<Buffer> buffer;
+  // The core worker reads the metadata size, so pass an empty buffer rather than null.
+  auto metadata = std::make_shared<::ray::LocalMemoryBuffer>(nullptr, 0);
+  auto status = core_worker.CreateOwnedAndIncrementLocalRef(
+      /*is_experimental_mutable_object=*/false,
+      metadata,
+      data_size,
+      /*contained_object_ids=*/{},
+      object_id,
+      &buffer,
+      /*created_by_worker=*/true);
+  if (!status.ok()) {
+    throw RayException("Put object error: " + status.ToString());
+  }
+  try {
+    writer(reinterpret_cast<char *>(buffer->Data()));
+  } catch (...) {
+    // Don't leave a half-written object pinned in the store with a dangling reference.
+    buffer.reset();
+    RAY_UNUSED(core_worker.AbortOwned(*object_id));
+    throw;
+  }
+  status = core_worker.SealOwned(*object_id, /*pin_object=*/true);
+  if (!status.ok()) {
+    throw RayException("Put object error: " + status.ToString());
+  }
+}
+
+void NativeObjectStore::PutBatchRaw(
+    const std::vector<std::shared_ptr<msgpack::sbuffer>> &data,
+    std::vector<ObjectID> *object_ids) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  std::vector<std::shared_ptr<::ray::RayObject>> objects;
+  objects.reserve(data.size());
+  for (const auto &sbuffer : data) {
+    auto buffer = std::make_shared<::ray::LocalMemoryBuffer>(
+        reinterpret_cast<uint8_t *>(sbuffer->data()), sbuffer->size(), true);
+    objects.push_back(std::make_shared<::ray::RayObject>(
+        buffer, nullptr, std::vector<rpc::ObjectReference>()));
+  }
+  auto status = core_worker.PutBatch(objects, object_ids);
+  if (!status.ok()) {
+    throw RayException("Put object error: " + status.ToString());
+  }
+}
+
 std::shared_ptr<msgpack::sbuffer> NativeObjectStore::GetRaw(const ObjectID &object_id,
                                                             int timeout_ms) {
   std::vector<ObjectID> object_ids;
@@ -89,6 +139,17 @@ void NativeObjectStore::CheckException(const std::string &meta_str,
 
 std::vector<std::shared_ptr<msgpack::sbuffer>> NativeObjectStore::GetRaw(
     const std::vector<ObjectID> &ids, int timeout_ms) {
+  auto buffers = GetBuffersRaw(ids, timeout_ms);
+  std::vector<std::shared_ptr<msgpack::sbuffer>> result_sbuffers;
+  result_sbuffers.reserve(buffers.size());
+  for (const auto &buffer : buffers) {
+    result_sbuffers.push_back(CopyToSbuffer(*buffer));
+  }
+  return result_sbuffers;
+}
+
+std::vector<std::shared_ptr<ObjectBuffer>> NativeObjectStore::GetBuffersRaw(
+    const std::vector<ObjectID> &ids, int timeout_ms) {
   auto &core_worker = CoreWorkerProcess::GetCoreWorker();
   std::vector<std::shared_ptr<::ray::RayObject>> results;
   ::ray::Status status = core_worker.Get(ids, timeout_ms, results);
@@ -99,38 +160,53 @@ std::vector<std::shared_ptr<msgpack::sbuffer>> NativeObjectStore::GetRaw(
     throw RayException("Get object error: " + status.ToString());
   }
   RAY_CHECK(results.size() == ids.size());
-  std::vector<std::shared_ptr<msgpack::sbuffer>> result_sbuffers;
-  result_sbuffers.reserve(results.size());
-  for (size_t i = 0; i < results.size(); i++) {
-    const auto &meta = results[i]->GetMetadata();
-    const auto &data_buffer = results[i]->GetData();
-    std::string meta_str = "";
-    if (meta != nullptr) {
-      meta_str = std::string((char *)meta->Data(), meta->Size());
-      CheckException(meta_str, data_buffer);
-    }
+  std::vector<std::shared_ptr<ObjectBuffer>> buffers;
+  buffers.reserve(results.size());
+  for (auto &result : results) {
+    buffers.push_back(ToObjectBuffer(std::move(result)));
+  }
+  return buffers;
+}
 
-    const char *data = nullptr;
-    size_t data_size = 0;
-    if (data_buffer) {
-      data = reinterpret_cast<const char *>(data_buffer->Data());
-      data_size = data_buffer->Size();
-    }
-    if (meta_str == METADATA_STR_RAW) {
-      // TODO(LarryLian) In order to minimize the modification,
-      // there is an extra serialization here, but the performance will be a little worse.
-      // This code can be optimized later to improve performance
-      auto raw_buffer = Serializer::Serialize(data, data_size);
-      auto sbuffer = std::make_shared<msgpack::sbuffer>(raw_buffer.size());
-      sbuffer->write(raw_buffer.data(), raw_buffer.size());
-      result_sbuffers.push_back(sbuffer);
-    } else {
-      auto sbuffer = std::make_shared<msgpack::sbuffer>(data_size);
-      sbuffer->write(data, data_size);
-      result_sbuffers.push_back(sbuffer);
-    }
+std::shared_ptr<ObjectBuffer> NativeObjectStore::ToObjectBuffer(
+    std::shared_ptr<RayObject> object) {
+  const auto &meta = object->GetMetadata();
+  const auto &data_buffer = object->GetData();
+  std::string meta_str = "";
+  if (meta != nullptr) {
+    meta_str = std::string((char *)meta->Data(), meta->Size());
+    CheckException(meta_str, data_buffer);
   }
-  return result_sbuffers;
+
+  auto buffer = std::make_shared<ObjectBuffer>();
+  if (data_buffer) {
+    buffer->data = reinterpret_cast<const char *>(data_buffer->Data());
+    buffer->size = data_buffer->Size();
+  }
+  buffer->is_raw = meta_str == METADATA_STR_RAW;
+  // The RayObject holds the plasma buffer, which stays pinned in this worker until
+  // the last reference to it goes away.
+  buffer->holder = std::move(object);
+  return buffer;
+}
+
+void NativeObjectStore::GetAsyncRaw(const ObjectID &object_id,
+                                    ObjectBufferCallback callback) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  core_worker.GetAsync(
+      object_id,
+      [callback = std::move(callback)](
+          std::shared_ptr<RayObject> object, ObjectID object_id, void *) {
+        std::shared_ptr<ObjectBuffer> buffer;
+        try {
+          buffer = ToObjectBuffer(std::move(object));
+        } catch (...) {
+          callback(nullptr, std::current_exception());
+          return;
+        }
+        callback(std::move(buffer), nullptr);
+      },
+      nullptr);
 }
 
 std::vector<bool> NativeObjectStore::Wait(const std::vector<ObjectID> &ids,
@@ -147,6 +223,134 @@ std::vector<bool> NativeObjectStore::Wait(const std::vector<ObjectID> &ids,
   return results;
 }
 
+ObjectID NativeObjectStore::ReadGeneratorItem(const ObjectID &generator_id) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  auto [next_ref, is_ready] = core_worker.PeekObjectRefStream(generator_id);
+  if (!is_ready) {
+    // The object at the next index is written either when the item is reported or when
+    // the stream ends.
+    auto next_id = ObjectID::FromBinary(next_ref.object_id());
+    std::vector<bool> results;
+    core_worker.AddLocalReference(next_id);
+    auto status = core_worker.Wait({next_id}, 1, -1, &results, /*fetch_local=*/false);
+    core_worker.RemoveLocalReference(next_id);
+    if (!status.ok()) {
+      throw RayException("Wait object error: " + status.ToString());
+    }
+  }
+  rpc::ObjectReference item_ref;
+  auto status = core_worker.TryReadObjectRefStream(generator_id, &item_ref);
+  if (status.IsObjectRefEndOfStream()) {
+    return ObjectID::Nil();
+  }
+  if (!status.ok()) {
+    throw RayException("Read generator item error: " + status.ToString());
+  }
+  return ObjectID::FromBinary(item_ref.object_id());
+}
+
+void NativeObjectStore::DeleteGeneratorStream(const ObjectID &generator_id) {
+  if (CoreWorkerProcess::IsInitialized()) {
+    auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+    core_worker.AsyncDelObjectRefStream(generator_id);
+  }
+}
+
+void NativeObjectStore::CheckChannelStatus(const ::ray::Status &status) {
+  if (status.ok()) {
+    return;
+  }
+  if (status.IsTimedOut() || status.IsChannelTimeoutError()) {
+    throw RayTimeoutException("Channel error: " + status.message());
+  } else if (status.IsChannelError()) {
+    throw RayChannelException("Channel error: " + status.message());
+  }
+  throw RayException("Channel error: " + status.ToString());
+}
+
+ObjectID NativeObjectStore::CreateChannel(size_t buffer_size) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  auto metadata = std::make_shared<::ray::LocalMemoryBuffer>(nullptr, 0);
+  ObjectID channel_id;
+  std::shared_ptr<Buffer> buffer;
+  auto status = core_worker.CreateOwnedAndIncrementLocalRef(
+      /*is_experimental_mutable_object=*/true,
+      metadata,
+      buffer_size,
+      /*contained_object_ids=*/{},
+      &channel_id,
+      &buffer,
+      /*created_by_worker=*/true);
+  if (!status.ok()) {
+    throw RayException("Create channel error: " + status.ToString());
+  }
+  // The buffer can't be read until the writer writes to it, so there is nothing to
+  // fill in before sealing.
+  status = core_worker.SealOwned(channel_id, /*pin_object=*/true);
+  if (!status.ok()) {
+    throw RayException("Create channel error: " + status.ToString());
+  }
+  return channel_id;
+}
+
+void NativeObjectStore::RegisterChannelWriter(const ObjectID &channel_id) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  // Readers share the writer's node, so there are no remote readers to push values to.
+  CheckChannelStatus(core_worker.ExperimentalRegisterMutableObjectWriter(
+      channel_id, /*remote_reader_node_ids=*/{}));
+}
+
+void NativeObjectStore::RegisterChannelReader(const ObjectID &channel_id) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  CheckChannelStatus(core_worker.ExperimentalRegisterMutableObjectReader(channel_id));
+}
+
+void NativeObjectStore::WriteChannel(const ObjectID &channel_id,
+                                     size_t data_size,
+                                     int64_t num_readers,
+                                     int timeout_ms,
+                                     const std::function<void(char *data)> &writer) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  static const auto metadata = std::make_shared<::ray::LocalMemoryBuffer>(nullptr, 0);
+  std::shared_ptr<Buffer> data;
+  CheckChannelStatus(core_worker.ExperimentalChannelWriteAcquire(
+      channel_id, metadata, data_size, num_readers, timeout_ms, &data));
+  try {
+    writer(reinterpret_cast<char *>(data->Data()));
+  } catch (...) {
+    // Close the channel instead of publishing the partially written value, so that no
+    // reader sees it. A closed channel doesn't need the matching WriteRelease.
+    RAY_UNUSED(core_worker.ExperimentalChannelSetError(channel_id));
+    throw;
+  }
+  CheckChannelStatus(core_worker.ExperimentalChannelWriteRelease(channel_id));
+}
+
+std::shared_ptr<ObjectBuffer> NativeObjectStore::ReadChannel(const ObjectID &channel_id,
+                                                             int timeout_ms) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  std::vector<std::shared_ptr<RayObject>> results;
+  // The core worker reads registered channels in place instead of fetching them.
+  CheckChannelStatus(core_worker.Get({channel_id}, timeout_ms, results));
+  RAY_CHECK(results.size() == 1);
+  auto object = std::move(results[0]);
+  // Destroying the holder releases the value, which lets the writer write the next one.
+  std::shared_ptr<void> release(object.get(), [object, channel_id](void *) {
+    if (CoreWorkerProcess::IsInitialized()) {
+      RAY_UNUSED(CoreWorkerProcess::GetCoreWorker().ExperimentalChannelReadRelease(
+          {channel_id}));
+    }
+  });
+  auto buffer = ToObjectBuffer(object);
+  buffer->holder = std::move(release);
+  return buffer;
+}
+
+void NativeObjectStore::CloseChannel(const ObjectID &channel_id) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  CheckChannelStatus(core_worker.ExperimentalChannelSetError(channel_id));
+}
+
 void NativeObjectStore::AddLocalReference(const std::string &id) {
   if (CoreWorkerProcess::IsInitialized()) {
     auto &core_worker = CoreWorkerProcess::GetCoreWorker();
@@ -28,6 +28,26 @@ class NativeObjectStore : public ObjectStore {
                          int num_objects,
                          int timeout_ms);
 
+  ObjectID ReadGeneratorItem(const ObjectID &generator_id);
+
+  void DeleteGeneratorStream(const ObjectID &generator_id);
+
+  ObjectID CreateChannel(size_t buffer_size);
+
+  void RegisterChannelWriter(const ObjectID &channel_id);
+
+  void RegisterChannelReader(const ObjectID &channel_id);
+
+  void WriteChannel(const ObjectID &channel_id,
+                    size_t data_size,
+                    int64_t num_readers,
+                    int timeout_ms,
+                    const std::function<void(char *data)> &writer);
+
+  std::shared_ptr<ObjectBuffer> ReadChannel(const ObjectID &channel_id, int timeout_ms);
+
+  void CloseChannel(const ObjectID &channel_id);
+
   void AddLocalReference(const std::string &id);
 
   void RemoveLocalReference(const std::string &id);
@@ -37,12 +57,31 @@ class NativeObjectStore : public ObjectStore {
 
   void PutRaw(std::shared_ptr<msgpack::sbuffer> data, const ObjectID &object_id);
 
+  void PutRaw(size_t data_size,
+              const std::function<void(char *data)> &writer,
+              ObjectID *object_id);
+
+  void PutBatchRaw(const std::vector<std::shared_ptr<msgpack::sbuffer>> &data,
+                   std::vector<ObjectID> *object_ids);
+
   std::shared_ptr<msgpack::sbuffer> GetRaw(const ObjectID &object_id, int timeout_ms);
 
   std::vector<std::shared_ptr<msgpack::sbuffer>> GetRaw(const std::vector<ObjectID> &ids,
                                                         int timeout_ms);
-  void CheckException(const std::string &meta_str,
-                      const std::shared_ptr<Buffer> &data_buffer);
+
+  std::vector<std::shared_ptr<ObjectBuffer>> GetBuffersRaw(
+      const std::vector<ObjectID> &ids, int timeout_ms);
+
+  void GetAsyncRaw(const ObjectID &object_id, ObjectBufferCallback callback);
+
+  /// Wrap an object got from the core worker, throwing if it holds an error.
+  static std::shared_ptr<ObjectBuffer> ToObjectBuffer(std::shared_ptr<RayObject> object);
+
+  /// Throw the exception that matches a failed channel operation.
+  static void CheckChannelStatus(const ::ray::Status &status);
+
+  static void CheckException(const std::string &meta_str,
+                             const std::shared_ptr<Buffer> &data_buffer);
 };
 
 }  // namespace internal
@@ -33,6 +33,17 @@ void ObjectStore::Put(std::shared_ptr<msgpack::sbuffer> data, const ObjectID &ob
   PutRaw(data, object_id);
 }
 
+void ObjectStore::Put(size_t data_size,
+                      const std::function<void(char *data)> &writer,
+                      ObjectID *object_id) {
+  PutRaw(data_size, writer, object_id);
+}
+
+void ObjectStore::PutBatch(const std::vector<std::shared_ptr<msgpack::sbuffer>> &data,
+                           std::vector<ObjectID> *object_ids) {
+  PutBatchRaw(data, object_ids);
+}
+
 std::shared_ptr<msgpack::sbuffer> ObjectStore::Get(const ObjectID &object_id,
                                                    int timeout_ms) {
   return GetRaw(object_id, timeout_ms);
@@ -43,6 +54,32 @@ std::vector<std::shared_ptr<msgpack::sbuffer>> ObjectStore::Get(
   return GetRaw(ids, timeout_ms);
 }
 
+std::shared_ptr<ObjectBuffer> ObjectStore::GetBuffer(const ObjectID &object_id,
+                                                     int timeout_ms) {
+  auto buffers = GetBuffersRaw(std::vector<ObjectID>{object_id}, timeout_ms);
+  RAY_CHECK(buffers.size() == 1);
+  return buffers[0];
+}
+
+std::vector<std::shared_ptr<ObjectBuffer>> ObjectStore::GetBuffers(
+    const std::vector<ObjectID> &ids, int timeout_ms) {
+  return GetBuffersRaw(ids, timeout_ms);
+}
+
+void ObjectStore::GetAsync(const ObjectID &object_id, ObjectBufferCallback callback) {
+  GetAsyncRaw(object_id, std::move(callback));
+}
+
+std::shared_ptr<msgpack::sbuffer> ObjectStore::CopyToSbuffer(const ObjectBuffer &buffer) {
+  if (buffer.is_raw) {
+    return std::make_shared<msgpack::sbuffer>(
+        Serializer::Serialize(buffer.data, buffer.size));
+  }
+  auto sbuffer = std::make_shared<msgpack::sbuffer>(buffer.size);
+  sbuffer->write(buffer.data, buffer.size);
+  return sbuffer;
+}
+
 std::unordered_map<ObjectID, std::pair<size_t, size_t>>
 ObjectStore::GetAllReferenceCounts() const {
   auto &core_worker = CoreWorkerProcess::GetCoreWorker();
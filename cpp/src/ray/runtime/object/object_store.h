@@ -14,8 +14,10 @@
 
 #pragma once
 
+#include <ray/api/object_view.h>
 #include <ray/api/wait_result.h>
 
+#include <functional>
 #include <memory>
 #include <msgpack.hpp>
 
@@ -43,6 +45,23 @@ class ObjectStore {
   /// \param[in] object_id The object which should be stored.
   void Put(std::shared_ptr<msgpack::sbuffer> data, const ObjectID &object_id);
 
+  /// Create an object in the object store and fill it in place, without staging the
+  /// data in an intermediate buffer.
+  ///
+  /// \param[in] data_size The size of the object data in bytes.
+  /// \param[in] writer Writes exactly `data_size` bytes of object data.
+  /// \param[out] The id which is allocated to the object.
+  void Put(size_t data_size,
+           const std::function<void(char *data)> &writer,
+           ObjectID *object_id);
+
+  /// Store a list of objects in the object store with a single core worker call.
+  ///
+  /// \param[in] data The serialized object data buffers to store.
+  /// \param[out] object_ids The ids which are allocated to the objects, in order.
+  void PutBatch(const std::vector<std::shared_ptr<msgpack::sbuffer>> &data,
+                std::vector<ObjectID> *object_ids);
+
   /// Get a single object from the object store.
   /// This method will be blocked until the object are ready or wait for timeout.
   ///
@@ -61,6 +80,34 @@ class ObjectStore {
   std::vector<std::shared_ptr<msgpack::sbuffer>> Get(
       const std::vector<ObjectID> &ids, int timeout_ms = default_get_timeout_ms);
 
+  /// Get a single object from the object store without copying it out of the store.
+  /// The returned buffer keeps the object pinned until it is destroyed.
+  /// This method will be blocked until the object are ready or wait for timeout.
+  ///
+  /// \param[in] object_id The object id which should be got.
+  /// \param[in] timeout_ms The maximum wait time in milliseconds.
+  /// \return shared pointer of the pinned buffer.
+  std::shared_ptr<ObjectBuffer> GetBuffer(const ObjectID &object_id,
+                                          int timeout_ms = default_get_timeout_ms);
+
+  /// Get a list of objects from the object store without copying them out of the
+  /// store. Each returned buffer keeps its object pinned until it is destroyed.
+  /// This method will be blocked until all the objects are ready or wait for timeout.
+  ///
+  /// \param[in] ids The object id array which should be got.
+  /// \param[in] timeout_ms The maximum wait time in milliseconds.
+  /// \return shared pointer array of the pinned buffers.
+  std::vector<std::shared_ptr<ObjectBuffer>> GetBuffers(
+      const std::vector<ObjectID> &ids, int timeout_ms = default_get_timeout_ms);
+
+  /// Get a single object from the object store without blocking. The callback gets the
+  /// pinned buffer once the object is ready, or the error if it can't be fetched. It
+  /// runs on a runtime thread, so it must not block.
+  ///
+  /// \param[in] object_id The object id which should be got.
+  /// \param[in] callback Called once with the buffer or the error.
+  void GetAsync(const ObjectID &object_id, ObjectBufferCallback callback);
+
   /// Wait for a list of ObjectRefs to be locally available,
   /// until specified number of objects are ready, or specified timeout has passed.
   ///
@@ -72,6 +119,64 @@ class ObjectStore {
                                  int num_objects,
                                  int timeout_ms) = 0;
 
+  /// Block until a streaming generator produces its next item.
+  ///
+  /// \param[in] generator_id The id of the generator task's return object.
+  /// \return The id of the item, with a local reference added for the caller, or Nil
+  /// once the generator has no more items.
+  virtual ObjectID ReadGeneratorItem(const ObjectID &generator_id) = 0;
+
+  /// Release the stream of a streaming generator once nothing reads it anymore.
+  ///
+  /// \param[in] generator_id The id of the generator task's return object.
+  virtual void DeleteGeneratorStream(const ObjectID &generator_id) = 0;
+
+  /// Create a channel backed by a mutable object in this node's object store. The
+  /// channel is owned by this worker and has a local reference added for the caller.
+  ///
+  /// \param[in] buffer_size The maximum size in bytes of a value written to the channel.
+  /// \return The id of the channel.
+  virtual ObjectID CreateChannel(size_t buffer_size) = 0;
+
+  /// Register this worker as the writer of a channel. Registering again is a no-op.
+  ///
+  /// \param[in] channel_id The id of the channel.
+  virtual void RegisterChannelWriter(const ObjectID &channel_id) = 0;
+
+  /// Register this worker as a reader of a channel. Registering again is a no-op.
+  ///
+  /// \param[in] channel_id The id of the channel.
+  virtual void RegisterChannelReader(const ObjectID &channel_id) = 0;
+
+  /// Write a value to a channel in place. This blocks until every reader has released
+  /// the previous value.
+  ///
+  /// \param[in] channel_id The id of the channel.
+  /// \param[in] data_size The size of the value in bytes.
+  /// \param[in] num_readers The number of reads that release the value.
+  /// \param[in] timeout_ms The maximum wait time in milliseconds, -1 to wait forever.
+  /// \param[in] writer Writes exactly `data_size` bytes of the value. If it throws, the
+  /// channel is closed and the exception is rethrown.
+  virtual void WriteChannel(const ObjectID &channel_id,
+                            size_t data_size,
+                            int64_t num_readers,
+                            int timeout_ms,
+                            const std::function<void(char *data)> &writer) = 0;
+
+  /// Read the next value written to a channel without copying it. The value is
+  /// released, and the writer unblocked, once the returned buffer is destroyed.
+  ///
+  /// \param[in] channel_id The id of the channel.
+  /// \param[in] timeout_ms The maximum wait time in milliseconds, -1 to wait forever.
+  /// \return The buffer of the value.
+  virtual std::shared_ptr<ObjectBuffer> ReadChannel(const ObjectID &channel_id,
+                                                    int timeout_ms) = 0;
+
+  /// Close a channel, waking up its blocked readers and writer with an error.
+  ///
+  /// \param[in] channel_id The id of the channel.
+  virtual void CloseChannel(const ObjectID &channel_id) = 0;
+
   /// Increase the reference count for this object ID.
   /// Increase the local reference count for this object ID. Should be called
   /// by the language frontend when a new reference is created.
@@ -89,17 +194,34 @@ class ObjectStore {
   /// (local, submitted_task) reference counts. For debugging purposes.
   std::unordered_map<ObjectID, std::pair<size_t, size_t>> GetAllReferenceCounts() const;
 
+ protected:
+  /// Copy a pinned buffer into a msgpack buffer owned by the caller. Raw payloads are
+  /// wrapped as msgpack bin so that they can be deserialized like any other object.
+  static std::shared_ptr<msgpack::sbuffer> CopyToSbuffer(const ObjectBuffer &buffer);
+
  private:
   virtual void PutRaw(std::shared_ptr<msgpack::sbuffer> data, ObjectID *object_id) = 0;
 
   virtual void PutRaw(std::shared_ptr<msgpack::sbuffer> data,
                       const ObjectID &object_id) = 0;
 
+  virtual void PutRaw(size_t data_size,
+                      const std::function<void(char *data)> &writer,
+                      ObjectID *object_id) = 0;
+
+  virtual void PutBatchRaw(const std::vector<std::shared_ptr<msgpack::sbuffer>> &data,
+                           std::vector<ObjectID> *object_ids) = 0;
+
   virtual std::shared_ptr<msgpack::sbuffer> GetRaw(const ObjectID &object_id,
                                                    int timeout_ms) = 0;
 
   virtual std::vector<std::shared_ptr<msgpack::sbuffer>> GetRaw(
       const std::vector<ObjectID> &ids, int timeout_ms) = 0;
+
+  virtual std::vector<std::shared_ptr<ObjectBuffer>> GetBuffersRaw(
+      const std::vector<ObjectID> &ids, int timeout_ms) = 0;
+
+  virtual void GetAsyncRaw(const ObjectID &object_id, ObjectBufferCallback callback) = 0;
 };
 }  // namespace internal
 }  // namespace ray
\ No newline at end of file
@@ -32,6 +32,9 @@ class InvocationSpec {
   int actor_counter;
   RemoteFunctionHolder remote_function_holder;
   std::vector<std::unique_ptr<::ray::TaskArg>> args;
+  /// Indexes of the by-reference args whose value the callee takes. Local mode resolves
+  /// them before running the task.
+  std::vector<size_t> value_ref_args;
 };
 }  // namespace internal
 }  // namespace ray
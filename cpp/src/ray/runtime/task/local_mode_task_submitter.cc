@@ -16,28 +16,41 @@
 
 #include <ray/api/ray_exception.h>
 
-#include <boost/asio/post.hpp>
+#include <algorithm>
 #include <memory>
+#include <thread>
 
 #include "../abstract_ray_runtime.h"
+#include "../object/local_mode_object_store.h"
 
 namespace ray {
 namespace internal {
 
+namespace {
+/// The size of the thread pool before it was sized to the machine.
+constexpr size_t kMinLocalModeThreads = 10;
+}  // namespace
+
 LocalModeTaskSubmitter::LocalModeTaskSubmitter(
     LocalModeRayRuntime &local_mode_ray_tuntime)
     : local_mode_ray_tuntime_(local_mode_ray_tuntime) {
-  thread_pool_.reset(new boost::asio::thread_pool(10));
+  // Size the pool to the machine, but keep enough threads for tasks that block on the
+  // results of other tasks.
+  size_t num_threads =
+      std::max<size_t>(std::thread::hardware_concurrency(), kMinLocalModeThreads);
+  thread_pool_.reset(new WorkStealingThreadPool(num_threads));
 }
 
 ObjectID LocalModeTaskSubmitter::Submit(InvocationSpec &invocation,
-                                        const ActorCreationOptions &options) {
+                                        const ActorCreationOptions &options,
+                                        bool is_streaming_generator) {
   /// TODO(SongGuyang): Make the information of TaskSpecification more reasonable
   /// We just reuse the TaskSpecification class and make the single process mode work.
   /// Maybe some infomation of TaskSpecification are not reasonable or invalid.
   /// We will enhance this after implement the cluster mode.
+  const auto &function_name = invocation.remote_function_holder.function_name;
   auto functionDescriptor = FunctionDescriptorBuilder::BuildCpp(
-      invocation.remote_function_holder.function_name);
+      function_name, "", "", HashFunctionName(function_name));
   rpc::Address address;
   std::unordered_map<std::string, double> required_resources;
   std::unordered_map<std::string, double> required_placement_resources;
@@ -60,8 +73,8 @@ ObjectID LocalModeTaskSubmitter::Submit(InvocationSpec &invocation,
                             local_mode_ray_tuntime_.GetCurrentTaskId(),
                             address,
                             1,
-                            /*returns_dynamic=*/false,
-                            /*is_streaming_generator*/ false,
+                            /*returns_dynamic=*/is_streaming_generator,
+                            is_streaming_generator,
                             /*generator_backpressure_num_objects*/ -1,
                             required_resources,
                             required_placement_resources,
@@ -101,41 +114,114 @@ ObjectID LocalModeTaskSubmitter::Submit(InvocationSpec &invocation,
   auto task_specification = builder.Build();
 
   ObjectID return_object_id = task_specification.ReturnId(0);
-
-  std::shared_ptr<msgpack::sbuffer> actor;
-  std::shared_ptr<absl::Mutex> mutex;
-  if (invocation.task_type == TaskType::ACTOR_TASK) {
-    absl::MutexLock lock(&actor_contexts_mutex_);
-    actor = actor_contexts_.at(invocation.actor_id).get()->current_actor;
-    mutex = actor_contexts_.at(invocation.actor_id).get()->actor_mutex;
+  if (invocation.task_type != TaskType::ACTOR_CREATION_TASK) {
+    // The initial reference, which the caller removes once it holds an ObjectRef.
+    local_mode_ray_tuntime_.GetLocalObjectStore().AddReference(return_object_id);
   }
+  AddArgReferences(task_specification);
+
   AbstractRayRuntime *runtime = &local_mode_ray_tuntime_;
   if (invocation.task_type == TaskType::ACTOR_CREATION_TASK ||
       invocation.task_type == TaskType::ACTOR_TASK) {
-    /// TODO(SongGuyang): Handle task dependencies.
+    std::shared_ptr<msgpack::sbuffer> actor;
+    if (invocation.task_type == TaskType::ACTOR_TASK) {
+      absl::MutexLock lock(&actor_contexts_mutex_);
+      actor = actor_contexts_.at(invocation.actor_id).get()->current_actor;
+    }
     /// Execute actor task directly in the main thread because we must guarantee the actor
     /// task executed by calling order.
-    TaskExecutor::Invoke(
-        task_specification, actor, runtime, actor_contexts_, actor_contexts_mutex_);
+    auto arg_values = ResolveArgValues(invocation, task_specification);
+    TaskExecutor::Invoke(task_specification,
+                         arg_values,
+                         actor,
+                         runtime,
+                         actor_contexts_,
+                         actor_contexts_mutex_);
+    RemoveArgReferences(task_specification);
   } else {
-    boost::asio::post(
-        *thread_pool_.get(),
-        std::bind(
-            [actor, mutex, runtime, this](TaskSpecification &ts) {
-              if (mutex) {
-                absl::MutexLock lock(mutex.get());
-              }
-              TaskExecutor::Invoke(
-                  ts, actor, runtime, this->actor_contexts_, this->actor_contexts_mutex_);
-            },
-            std::move(task_specification)));
+    SubmitWhenReady(invocation, std::move(task_specification));
   }
   return return_object_id;
 }
 
+std::vector<std::shared_ptr<RayObject>> LocalModeTaskSubmitter::ResolveArgValues(
+    const InvocationSpec &invocation, const TaskSpecification &task_spec) {
+  std::vector<std::shared_ptr<RayObject>> arg_values;
+  if (invocation.value_ref_args.empty()) {
+    return arg_values;
+  }
+  std::vector<ObjectID> ids;
+  ids.reserve(invocation.value_ref_args.size());
+  for (auto index : invocation.value_ref_args) {
+    ids.push_back(task_spec.ArgId(index));
+  }
+  auto objects = local_mode_ray_tuntime_.GetLocalObjectStore().GetObjects(ids, -1);
+  arg_values.resize(task_spec.NumArgs());
+  for (size_t i = 0; i < ids.size(); i++) {
+    const auto &data = objects[i]->GetData();
+    // Surface a failed dependency to the caller, like getting the ObjectRef would.
+    CheckResult(reinterpret_cast<const char *>(data->Data()), data->Size());
+    arg_values[invocation.value_ref_args[i]] = std::move(objects[i]);
+  }
+  return arg_values;
+}
+
+void LocalModeTaskSubmitter::AddArgReferences(const TaskSpecification &task_spec) {
+  auto &object_store = local_mode_ray_tuntime_.GetLocalObjectStore();
+  for (size_t i = 0; i < task_spec.NumArgs(); i++) {
+    if (task_spec.ArgByRef(i)) {
+      object_store.AddReference(task_spec.ArgId(i));
+    }
+  }
+}
+
+void LocalModeTaskSubmitter::RemoveArgReferences(const TaskSpecification &task_spec) {
+  auto &object_store = local_mode_ray_tuntime_.GetLocalObjectStore();
+  for (size_t i = 0; i < task_spec.NumArgs(); i++) {
+    if (task_spec.ArgByRef(i)) {
+      object_store.RemoveReference(task_spec.ArgId(i));
+    }
+  }
+}
+
+void LocalModeTaskSubmitter::SubmitWhenReady(const InvocationSpec &invocation,
+                                             TaskSpecification task_spec) {
+  auto task = std::make_shared<PendingTask>(std::move(task_spec));
+  auto run = [this, task]() {
+    thread_pool_->Post([this, task]() {
+      TaskExecutor::Invoke(task->task_spec,
+                           task->arg_values,
+                           nullptr,
+                           &local_mode_ray_tuntime_,
+                           actor_contexts_,
+                           actor_contexts_mutex_);
+      RemoveArgReferences(task->task_spec);
+    });
+  };
+  if (invocation.value_ref_args.empty()) {
+    run();
+    return;
+  }
+
+  // The last arg to become available posts the task. Each callback writes its own slot
+  // and the counter orders those writes before the task runs.
+  task->arg_values.resize(task->task_spec.NumArgs());
+  task->num_pending_args = invocation.value_ref_args.size();
+  auto &object_store = local_mode_ray_tuntime_.GetLocalObjectStore();
+  for (auto index : invocation.value_ref_args) {
+    object_store.GetObjectAsync(task->task_spec.ArgId(index),
+                                [task, index, run](std::shared_ptr<RayObject> object) {
+                                  task->arg_values[index] = std::move(object);
+                                  if (task->num_pending_args.fetch_sub(1) == 1) {
+                                    run();
+                                  }
+                                });
+  }
+}
+
 ObjectID LocalModeTaskSubmitter::SubmitTask(InvocationSpec &invocation,
                                             const CallOptions &call_options) {
-  return Submit(invocation, {});
+  return Submit(invocation, {}, call_options.streaming_generator);
 }
 
 ActorID LocalModeTaskSubmitter::CreateActor(InvocationSpec &invocation,
@@ -151,7 +237,7 @@ ActorID LocalModeTaskSubmitter::CreateActor(InvocationSpec &invocation,
 
 ObjectID LocalModeTaskSubmitter::SubmitActorTask(InvocationSpec &invocation,
                                                  const CallOptions &call_options) {
-  return Submit(invocation, {});
+  return Submit(invocation, {}, call_options.streaming_generator);
 }
 
 ActorID LocalModeTaskSubmitter::GetActor(const std::string &actor_name,
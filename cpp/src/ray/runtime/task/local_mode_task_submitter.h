@@ -14,7 +14,7 @@
 
 #pragma once
 
-#include <boost/asio/thread_pool.hpp>
+#include <atomic>
 #include <memory>
 #include <queue>
 
@@ -23,6 +23,7 @@
 #include "invocation_spec.h"
 #include "task_executor.h"
 #include "task_submitter.h"
+#include "work_stealing_thread_pool.h"
 
 namespace ray {
 namespace internal {
@@ -48,7 +49,31 @@ class LocalModeTaskSubmitter : public TaskSubmitter {
   PlacementGroup GetPlacementGroup(const std::string &name);
 
  private:
-  ObjectID Submit(InvocationSpec &invocation, const ActorCreationOptions &options);
+  /// A normal task waiting for the values of its by-reference args.
+  struct PendingTask {
+    explicit PendingTask(TaskSpecification spec) : task_spec(std::move(spec)) {}
+
+    TaskSpecification task_spec;
+    std::vector<std::shared_ptr<RayObject>> arg_values;
+    std::atomic<size_t> num_pending_args{0};
+  };
+
+  ObjectID Submit(InvocationSpec &invocation,
+                  const ActorCreationOptions &options,
+                  bool is_streaming_generator = false);
+
+  /// Run the task on the thread pool once all its arg values are in the object store.
+  void SubmitWhenReady(const InvocationSpec &invocation, TaskSpecification task_spec);
+
+  /// Get the values of the by-reference args the callee takes by value, blocking until
+  /// they are available.
+  std::vector<std::shared_ptr<RayObject>> ResolveArgValues(
+      const InvocationSpec &invocation, const TaskSpecification &task_spec);
+
+  /// Add or remove the references that keep the by-reference args of a task in the
+  /// object store until it has run.
+  void AddArgReferences(const TaskSpecification &task_spec);
+  void RemoveArgReferences(const TaskSpecification &task_spec);
 
   std::unordered_map<ActorID, std::unique_ptr<ActorContext>> actor_contexts_;
 
@@ -58,7 +83,7 @@ class LocalModeTaskSubmitter : public TaskSubmitter {
       ABSL_GUARDED_BY(named_actors_mutex_);
   mutable absl::Mutex named_actors_mutex_;
 
-  std::unique_ptr<boost::asio::thread_pool> thread_pool_;
+  std::unique_ptr<WorkStealingThreadPool> thread_pool_;
 
   LocalModeRayRuntime &local_mode_ray_tuntime_;
 
@@ -26,10 +26,12 @@ using ray::core::TaskOptions;
 
 RayFunction BuildRayFunction(InvocationSpec &invocation) {
   if (invocation.remote_function_holder.lang_type == LangType::CPP) {
-    auto function_descriptor = FunctionDescriptorBuilder::BuildCpp(
-        invocation.remote_function_holder.function_name,
-        "",
-        invocation.remote_function_holder.class_name);
+    const auto &function_name = invocation.remote_function_holder.function_name;
+    auto function_descriptor =
+        FunctionDescriptorBuilder::BuildCpp(function_name,
+                                            "",
+                                            invocation.remote_function_holder.class_name,
+                                            HashFunctionName(function_name));
     return RayFunction(ray::Language::CPP, function_descriptor);
   } else if (invocation.remote_function_holder.lang_type == LangType::PYTHON) {
     auto function_descriptor = FunctionDescriptorBuilder::BuildPython(
@@ -66,7 +68,13 @@ ObjectID NativeTaskSubmitter::Submit(InvocationSpec &invocation,
   options.name = call_options.name;
   options.resources = call_options.resources;
   options.serialized_runtime_env_info = call_options.serialized_runtime_env_info;
-  options.generator_backpressure_num_objects = -1;
+  if (call_options.streaming_generator) {
+    options.num_returns = kStreamingGeneratorReturn;
+    options.generator_backpressure_num_objects =
+        call_options.generator_backpressure_num_objects;
+  } else {
+    options.generator_backpressure_num_objects = -1;
+  }
   std::vector<rpc::ObjectReference> return_refs;
   if (invocation.task_type == TaskType::ACTOR_TASK) {
     // NOTE: Ray CPP doesn't support per-method max_retries and retry_exceptions
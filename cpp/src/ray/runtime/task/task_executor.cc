@@ -17,9 +17,13 @@
 #include <ray/api/common_types.h>
 
 #include <memory>
+#include <optional>
 
 #include "../../util/function_helper.h"
 #include "../abstract_ray_runtime.h"
+#include "../object/local_mode_object_store.h"
+#include "ray/common/ray_config.h"
+#include "ray/core_worker/generator_waiter.h"
 #include "ray/util/event.h"
 #include "ray/util/event_label.h"
 
@@ -73,6 +77,7 @@ void InitRayRuntime(std::shared_ptr<RayRuntime> runtime) {
 namespace internal {
 
 using ray::core::CoreWorkerProcess;
+using ray::core::GeneratorBackpressureWaiter;
 
 std::shared_ptr<msgpack::sbuffer> TaskExecutor::current_actor_ = nullptr;
 
@@ -80,18 +85,20 @@ std::shared_ptr<msgpack::sbuffer> TaskExecutor::current_actor_ = nullptr;
 /// task id etc.
 std::pair<Status, std::shared_ptr<msgpack::sbuffer>> GetExecuteResult(
     const std::string &func_name,
+    uint64_t func_hash,
     const ArgsBufferList &args_buffer,
     msgpack::sbuffer *actor_ptr) {
   try {
-    EntryFuntion entry_function;
+    msgpack::sbuffer result;
     if (actor_ptr == nullptr) {
-      entry_function = FunctionHelper::GetInstance().GetExecutableFunctions(func_name);
+      const auto &function =
+          FunctionHelper::GetInstance().GetExecutableFunction(func_hash, func_name);
+      result = function(args_buffer);
     } else {
-      entry_function =
-          FunctionHelper::GetInstance().GetExecutableMemberFunctions(func_name);
+      const auto &function =
+          FunctionHelper::GetInstance().GetExecutableMemberFunction(func_hash, func_name);
+      result = function(actor_ptr, args_buffer);
     }
-    RAY_LOG(DEBUG) << "Get executable function " << func_name << " ok.";
-    auto result = entry_function(func_name, args_buffer, actor_ptr);
     RAY_LOG(DEBUG) << "Execute function " << func_name << " ok.";
     return std::make_pair(ray::Status::OK(),
                           std::make_shared<msgpack::sbuffer>(std::move(result)));
@@ -118,6 +125,74 @@ std::pair<Status, std::shared_ptr<msgpack::sbuffer>> GetExecuteResult(
   }
 }
 
+namespace {
+thread_local GeneratorItemReporter *current_generator_reporter = nullptr;
+}  // namespace
+
+GeneratorItemReporter::GeneratorItemReporter(ReportFunc report)
+    : report_(std::move(report)), previous_(current_generator_reporter) {
+  current_generator_reporter = this;
+}
+
+GeneratorItemReporter::~GeneratorItemReporter() {
+  current_generator_reporter = previous_;
+}
+
+GeneratorItemReporter *GeneratorItemReporter::Current() {
+  return current_generator_reporter;
+}
+
+/// Store an item of a streaming generator as a return object of the running task and
+/// report it to the caller. Blocks while the caller is too far behind.
+static void ReportNativeGeneratorItem(
+    const msgpack::sbuffer &item,
+    const ObjectID &generator_id,
+    const rpc::Address &caller_address,
+    int64_t item_index,
+    const std::shared_ptr<GeneratorBackpressureWaiter> &waiter,
+    std::vector<std::pair<ObjectID, bool>> *streaming_generator_returns) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  // Items are numbered after the task's only static return, the generator itself.
+  auto item_id = core_worker.AllocateDynamicReturnId(
+      caller_address, generator_id.TaskId(), /*put_index=*/2 + item_index);
+  std::shared_ptr<RayObject> item_object;
+  int64_t task_output_inlined_bytes = 0;
+  RAY_CHECK_OK(core_worker.AllocateReturnObject(item_id,
+                                                item.size(),
+                                                /*metadata=*/nullptr,
+                                                std::vector<ray::ObjectID>(),
+                                                caller_address,
+                                                &task_output_inlined_bytes,
+                                                &item_object));
+  if (item_object->HasData()) {
+    memcpy(item_object->GetData()->Data(), item.data(), item.size());
+  }
+  RAY_CHECK_OK(
+      core_worker.SealReturnObject(item_id, item_object, generator_id, caller_address));
+  streaming_generator_returns->emplace_back(item_id,
+                                            item_object->GetData()->IsPlasmaBuffer());
+  auto status =
+      core_worker.ReportGeneratorItemReturns({item_id, item_object},
+                                             generator_id,
+                                             caller_address,
+                                             item_index,
+                                             core_worker.GetCurrentTaskAttemptNumber(),
+                                             waiter);
+  if (!status.ok()) {
+    throw RayException("Failed to report a generator item: " + status.ToString());
+  }
+}
+
+/// Start a profile event of the task being executed. Returns null when the timeline is
+/// disabled.
+static std::unique_ptr<ray::core::worker::ProfileEvent> StartTaskProfileEvent(
+    const std::string &event_name) {
+  if (!::RayConfig::instance().enable_timeline()) {
+    return nullptr;
+  }
+  return CoreWorkerProcess::GetCoreWorker().CreateProfileEvent(event_name);
+}
+
 Status TaskExecutor::ExecuteTask(
     const rpc::Address &caller_address,
     ray::TaskType task_type,
@@ -149,6 +224,8 @@ Status TaskExecutor::ExecuteTask(
   auto typed_descriptor = function_descriptor->As<ray::CppFunctionDescriptor>();
   std::string func_name = typed_descriptor->FunctionName();
   bool cross_lang = !typed_descriptor->Caller().empty();
+  // Covers the whole task, the invoker records the phases in between.
+  auto task_event = StartTaskProfileEvent("task::" + func_name);
   // TODO(Clark): Support retrying application-level errors for C++.
   // TODO(Clark): Support exception allowlist for retrying application-level
   // errors for C++.
@@ -156,15 +233,18 @@ Status TaskExecutor::ExecuteTask(
 
   Status status{};
   std::shared_ptr<msgpack::sbuffer> data = nullptr;
+  // Arguments are passed to the invoker as views of the object buffers. Only raw
+  // arguments need to be re-serialized, those are kept alive here.
   ArgsBufferList ray_args_buffer;
+  ray_args_buffer.reserve(args_buffer.size());
+  std::vector<msgpack::sbuffer> raw_args;
   for (size_t i = 0; i < args_buffer.size(); i++) {
     auto &arg = args_buffer.at(i);
-    std::string meta_str = "";
+    std::string_view meta_str;
     if (arg->GetMetadata() != nullptr) {
-      meta_str = std::string((const char *)arg->GetMetadata()->Data(),
-                             arg->GetMetadata()->Size());
+      meta_str = std::string_view((const char *)arg->GetMetadata()->Data(),
+                                  arg->GetMetadata()->Size());
     }
-    msgpack::sbuffer sbuf;
     const char *arg_data = nullptr;
     size_t arg_data_size = 0;
     if (arg->GetData()) {
@@ -175,20 +255,42 @@ Status TaskExecutor::ExecuteTask(
       // TODO(LarryLian) In order to minimize the modification,
       // there is an extra serialization here, but the performance will be a little worse.
       // This code can be optimized later to improve performance
-      const auto &raw_buffer = Serializer::Serialize(arg_data, arg_data_size);
-      sbuf.write(raw_buffer.data(), raw_buffer.size());
+      raw_args.push_back(Serializer::Serialize(arg_data, arg_data_size));
+      ray_args_buffer.emplace_back(raw_args.back().data(), raw_args.back().size());
     } else if (cross_lang) {
       RAY_CHECK(arg_data != nullptr)
           << "Task " << task_name << " no." << i << " arg data is null.";
-      sbuf.write(arg_data + XLANG_HEADER_LEN, arg_data_size - XLANG_HEADER_LEN);
+      ray_args_buffer.emplace_back(arg_data + XLANG_HEADER_LEN,
+                                   arg_data_size - XLANG_HEADER_LEN);
     } else {
-      sbuf.write(arg_data, arg_data_size);
+      ray_args_buffer.emplace_back(arg_data, arg_data_size);
     }
-
-    ray_args_buffer.push_back(std::move(sbuf));
   }
+  // The items of a streaming generator are reported while the function runs.
+  std::shared_ptr<GeneratorBackpressureWaiter> waiter;
+  std::optional<GeneratorItemReporter> generator_reporter;
+  if (is_streaming_generator) {
+    waiter = std::make_shared<GeneratorBackpressureWaiter>(
+        generator_backpressure_num_objects, [] { return Status::OK(); });
+    generator_reporter.emplace(
+        [&caller_address,
+         generator_id = (*returns)[0].first,
+         waiter,
+         streaming_generator_returns,
+         item_index = int64_t{0}](std::shared_ptr<msgpack::sbuffer> item) mutable {
+          ReportNativeGeneratorItem(*item,
+                                    generator_id,
+                                    caller_address,
+                                    item_index++,
+                                    waiter,
+                                    streaming_generator_returns);
+        });
+  }
+  // Cross-language callers don't set the hash, they are dispatched by name.
+  uint64_t func_hash = typed_descriptor->FunctionHash();
   if (task_type == ray::TaskType::ACTOR_CREATION_TASK) {
-    std::tie(status, data) = GetExecuteResult(func_name, ray_args_buffer, nullptr);
+    std::tie(status, data) =
+        GetExecuteResult(func_name, func_hash, ray_args_buffer, nullptr);
     current_actor_ = data;
   } else if (task_type == ray::TaskType::ACTOR_TASK) {
     if (cross_lang) {
@@ -200,9 +302,15 @@ Status TaskExecutor::ExecuteTask(
     }
     RAY_CHECK(current_actor_ != nullptr);
     std::tie(status, data) =
-        GetExecuteResult(func_name, ray_args_buffer, current_actor_.get());
+        GetExecuteResult(func_name, func_hash, ray_args_buffer, current_actor_.get());
   } else {  // NORMAL_TASK
-    std::tie(status, data) = GetExecuteResult(func_name, ray_args_buffer, nullptr);
+    std::tie(status, data) =
+        GetExecuteResult(func_name, func_hash, ray_args_buffer, nullptr);
+  }
+  if (waiter != nullptr) {
+    generator_reporter.reset();
+    // The caller must have every item before it learns that the task finished.
+    RAY_CHECK_OK(waiter->WaitAllObjectsReported());
   }
 
   std::shared_ptr<ray::LocalMemoryBuffer> meta_buffer = nullptr;
@@ -236,7 +344,14 @@ Status TaskExecutor::ExecuteTask(
     data = std::make_shared<msgpack::sbuffer>(std::move(buf));
   }
 
+  if (cross_lang && status.ok() && IsFlatPayload(data->data(), data->size())) {
+    // Other languages can't read flat payloads, hand them a msgpack one instead.
+    data = std::make_shared<msgpack::sbuffer>(
+        Serializer::FlatToMsgpack(data->data(), data->size()));
+  }
+
   if (task_type != ray::TaskType::ACTOR_CREATION_TASK) {
+    auto store_event = StartTaskProfileEvent("task:store_outputs");
     size_t data_size = data->size();
     auto &result_id = (*returns)[0].first;
     auto result_ptr = &(*returns)[0].second;
@@ -290,39 +405,87 @@ Status TaskExecutor::ExecuteTask(
   return ray::Status::OK();
 }
 
+/// Execute a remote function registered in this process. The function is found by the
+/// name hash from the task spec, or by name when the hash is unset or ambiguous.
+static msgpack::sbuffer ExecuteLocalFunction(const CppFunctionDescriptor &descriptor,
+                                             const ArgsBufferList &args_buffer,
+                                             msgpack::sbuffer *actor_ptr) {
+  auto &function_manager = FunctionManager::Instance();
+  if (actor_ptr) {
+    auto func_ptr = function_manager.GetMemberFunctionByHash(descriptor.FunctionHash(),
+                                                            descriptor.FunctionName());
+    if (func_ptr != nullptr) {
+      return (*func_ptr)(actor_ptr, args_buffer);
+    }
+  } else {
+    auto func_ptr = function_manager.GetFunctionByHash(descriptor.FunctionHash(),
+                                                      descriptor.FunctionName());
+    if (func_ptr != nullptr) {
+      return (*func_ptr)(args_buffer);
+    }
+  }
+  return TaskExecutionHandler(descriptor.FunctionName(), args_buffer, actor_ptr);
+}
+
 void TaskExecutor::Invoke(
     const TaskSpecification &task_spec,
+    const std::vector<std::shared_ptr<RayObject>> &arg_values,
     std::shared_ptr<msgpack::sbuffer> actor,
     AbstractRayRuntime *runtime,
     std::unordered_map<ActorID, std::unique_ptr<ActorContext>> &actor_contexts,
     absl::Mutex &actor_contexts_mutex) {
+  // By-value arguments are viewed in place in the task spec and resolved arguments in
+  // the object store. Other by-reference arguments are passed as their id, which needs a
+  // buffer that lives until the call returns.
   ArgsBufferList args_buffer;
+  args_buffer.reserve(task_spec.NumArgs());
+  std::vector<std::string> arg_ids;
+  arg_ids.reserve(task_spec.NumArgs());
   for (size_t i = 0; i < task_spec.NumArgs(); i++) {
-    if (task_spec.ArgByRef(i)) {
-      const auto &id = task_spec.ArgId(i).Binary();
-      msgpack::sbuffer sbuf;
-      sbuf.write(id.data(), id.size());
-      args_buffer.push_back(std::move(sbuf));
+    if (i < arg_values.size() && arg_values[i] != nullptr) {
+      const auto &data = arg_values[i]->GetData();
+      if (Serializer::HasError(reinterpret_cast<const char *>(data->Data()),
+                               data->Size())) {
+        // A task this one depends on failed, fail with the same error.
+        auto error = std::make_shared<msgpack::sbuffer>(data->Size());
+        error->write(reinterpret_cast<const char *>(data->Data()), data->Size());
+        runtime->Put(std::move(error), task_spec.ReturnId(0));
+        return;
+      }
+      args_buffer.emplace_back(reinterpret_cast<const char *>(data->Data()),
+                               data->Size());
+    } else if (task_spec.ArgByRef(i)) {
+      arg_ids.push_back(task_spec.ArgId(i).Binary());
+      args_buffer.emplace_back(arg_ids.back().data(), arg_ids.back().size());
     } else {
-      msgpack::sbuffer sbuf;
-      sbuf.write((const char *)task_spec.ArgData(i), task_spec.ArgDataSize(i));
-      args_buffer.push_back(std::move(sbuf));
+      args_buffer.emplace_back((const char *)task_spec.ArgData(i),
+                               task_spec.ArgDataSize(i));
     }
   }
 
   auto function_descriptor = task_spec.FunctionDescriptor();
   auto typed_descriptor = function_descriptor->As<ray::CppFunctionDescriptor>();
 
+  // The items of a streaming generator go straight into the store, where the caller's
+  // stream looks for them.
+  std::optional<GeneratorItemReporter> generator_reporter;
+  if (task_spec.IsStreamingGenerator()) {
+    generator_reporter.emplace(
+        [runtime, generator_id = task_spec.ReturnId(0), item_index = int64_t{0}](
+            std::shared_ptr<msgpack::sbuffer> item) mutable {
+          runtime->Put(std::move(item),
+                       LocalModeObjectStore::GeneratorItemId(generator_id, item_index++));
+        });
+  }
+
   std::shared_ptr<msgpack::sbuffer> data;
   try {
     if (actor) {
-      auto result = TaskExecutionHandler(
-          typed_descriptor->FunctionName(), args_buffer, actor.get());
+      auto result = ExecuteLocalFunction(*typed_descriptor, args_buffer, actor.get());
       data = std::make_shared<msgpack::sbuffer>(std::move(result));
       runtime->Put(std::move(data), task_spec.ReturnId(0));
     } else {
-      auto result =
-          TaskExecutionHandler(typed_descriptor->FunctionName(), args_buffer, nullptr);
+      auto result = ExecuteLocalFunction(*typed_descriptor, args_buffer, nullptr);
       data = std::make_shared<msgpack::sbuffer>(std::move(result));
       if (task_spec.IsActorCreationTask()) {
         std::unique_ptr<ActorContext> actorContext(new ActorContext());
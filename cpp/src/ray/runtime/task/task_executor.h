@@ -18,6 +18,7 @@
 #include <ray/api/serializer.h>
 
 #include <boost/dll.hpp>
+#include <functional>
 #include <memory>
 
 #include "absl/synchronization/mutex.h"
@@ -63,12 +64,42 @@ class ActorContext {
   ActorContext() { actor_mutex = std::shared_ptr<absl::Mutex>(new absl::Mutex); }
 };
 
+/// Sends the items of the streaming generator task running on the current thread to its
+/// caller. It is installed on the thread for as long as it lives.
+class GeneratorItemReporter {
+ public:
+  using ReportFunc = std::function<void(std::shared_ptr<msgpack::sbuffer> item)>;
+
+  explicit GeneratorItemReporter(ReportFunc report);
+
+  ~GeneratorItemReporter();
+
+  GeneratorItemReporter(const GeneratorItemReporter &) = delete;
+  GeneratorItemReporter &operator=(const GeneratorItemReporter &) = delete;
+
+  /// The reporter of the current thread, or nullptr if it isn't running a streaming
+  /// generator task.
+  static GeneratorItemReporter *Current();
+
+  void Report(std::shared_ptr<msgpack::sbuffer> item) { report_(std::move(item)); }
+
+ private:
+  ReportFunc report_;
+  GeneratorItemReporter *previous_;
+};
+
 class TaskExecutor {
  public:
   TaskExecutor() = default;
 
+  /// Execute a task in local mode.
+  ///
+  /// \param[in] task_spec The task to execute.
+  /// \param[in] arg_values The resolved values of by-reference args the callee takes by
+  /// value, indexed like the task args. Other entries are null.
   static void Invoke(
       const TaskSpecification &task_spec,
+      const std::vector<std::shared_ptr<RayObject>> &arg_values,
       std::shared_ptr<msgpack::sbuffer> actor,
       AbstractRayRuntime *runtime,
       std::unordered_map<ActorID, std::unique_ptr<ActorContext>> &actor_contexts,
@@ -0,0 +1,124 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "work_stealing_thread_pool.h"
+
+#include "ray/util/util.h"
+
+namespace ray {
+namespace internal {
+
+namespace {
+/// The pool and the deque index of the current thread, if it is a pool worker.
+thread_local const WorkStealingThreadPool *current_pool = nullptr;
+thread_local size_t current_index = 0;
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t num_threads) {
+  if (num_threads == 0) {
+    num_threads = 1;
+  }
+  for (size_t i = 0; i < num_threads; i++) {
+    queues_.emplace_back(std::make_unique<TaskQueue>());
+  }
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; i++) {
+    threads_.emplace_back([this, i] {
+      SetThreadName("local_worker." + std::to_string(i));
+      WorkerLoop(i);
+    });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    absl::MutexLock lock(&sleep_mutex_);
+    stopped_ = true;
+    sleep_cv_.SignalAll();
+  }
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkStealingThreadPool::Post(std::function<void()> task) {
+  if (current_pool == this) {
+    auto &queue = *queues_[current_index];
+    absl::MutexLock lock(&queue.mutex);
+    queue.tasks.push_front(std::move(task));
+  } else {
+    auto &queue = *queues_[next_queue_.fetch_add(1) % queues_.size()];
+    absl::MutexLock lock(&queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  // A worker going to sleep registers itself before checking `num_pending_`, and we
+  // bump `num_pending_` before checking for sleepers, so one of us sees the other.
+  num_pending_.fetch_add(1);
+  if (num_sleeping_.load() > 0) {
+    absl::MutexLock lock(&sleep_mutex_);
+    sleep_cv_.Signal();
+  }
+}
+
+bool WorkStealingThreadPool::TryTake(size_t index, std::function<void()> *task) {
+  {
+    auto &queue = *queues_[index];
+    absl::MutexLock lock(&queue.mutex);
+    if (!queue.tasks.empty()) {
+      *task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      return true;
+    }
+  }
+  for (size_t i = 1; i < queues_.size(); i++) {
+    auto &queue = *queues_[(index + i) % queues_.size()];
+    absl::MutexLock lock(&queue.mutex);
+    if (!queue.tasks.empty()) {
+      *task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::WorkerLoop(size_t index) {
+  current_pool = this;
+  current_index = index;
+  std::function<void()> task;
+  while (true) {
+    if (TryTake(index, &task)) {
+      num_pending_.fetch_sub(1);
+      task();
+      task = nullptr;
+      continue;
+    }
+    absl::MutexLock lock(&sleep_mutex_);
+    if (stopped_) {
+      break;
+    }
+    num_sleeping_.fetch_add(1);
+    if (num_pending_.load() == 0) {
+      sleep_cv_.Wait(&sleep_mutex_);
+    }
+    num_sleeping_.fetch_sub(1);
+    if (stopped_) {
+      break;
+    }
+  }
+  current_pool = nullptr;
+}
+
+}  // namespace internal
+}  // namespace ray
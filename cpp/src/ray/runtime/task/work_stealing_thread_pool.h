@@ -0,0 +1,71 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+
+namespace ray {
+namespace internal {
+
+/// A fixed-size thread pool with one task deque per worker thread. Tasks posted from a
+/// worker go to the front of its own deque and the worker pops from the front, so a task
+/// submitted by a running task runs next on the same core. Tasks posted from other
+/// threads are spread round-robin, and idle workers steal from the back of other
+/// workers' deques.
+class WorkStealingThreadPool {
+ public:
+  explicit WorkStealingThreadPool(size_t num_threads);
+
+  /// Let the workers drain the queued tasks, then stop and join them.
+  ~WorkStealingThreadPool();
+
+  WorkStealingThreadPool(const WorkStealingThreadPool &) = delete;
+  WorkStealingThreadPool &operator=(const WorkStealingThreadPool &) = delete;
+
+  void Post(std::function<void()> task);
+
+  size_t NumThreads() const { return threads_.size(); }
+
+ private:
+  struct TaskQueue {
+    absl::Mutex mutex;
+    std::deque<std::function<void()>> tasks ABSL_GUARDED_BY(mutex);
+  };
+
+  void WorkerLoop(size_t index);
+
+  /// Take a task from the worker's own deque, or steal one from another worker.
+  bool TryTake(size_t index, std::function<void()> *task);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<size_t> next_queue_{0};
+  /// Number of tasks posted but not yet taken by a worker.
+  std::atomic<size_t> num_pending_{0};
+  std::atomic<size_t> num_sleeping_{0};
+  absl::Mutex sleep_mutex_;
+  absl::CondVar sleep_cv_;
+  bool stopped_ ABSL_GUARDED_BY(sleep_mutex_) = false;
+};
+
+}  // namespace internal
+}  // namespace ray
@@ -15,9 +15,14 @@
 #include <gtest/gtest.h>
 #include <ray/api.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <future>
+#include <optional>
 #include <thread>
 
 #include "../config_internal.h"
@@ -61,6 +66,59 @@ bool GetValue(ray::ObjectRef<bool> arg) {
 
 RAY_REMOTE(BlockGet, GetValue);
 
+ray::Generator<int> Count(int n) {
+  return ray::Generator<int>([i = 0, n]() mutable -> std::optional<int> {
+    if (i == n) {
+      return std::nullopt;
+    }
+    return i++;
+  });
+}
+
+ray::Generator<int> CountThenFail(int n) {
+  return ray::Generator<int>([i = 0, n]() mutable -> std::optional<int> {
+    if (i == n) {
+      throw std::runtime_error("generator failed");
+    }
+    return i++;
+  });
+}
+
+/// Produce `n` items, each after `work_us` of work.
+ray::Generator<int> SlowCount(int n, int work_us) {
+  return ray::Generator<int>([i = 0, n, work_us]() mutable -> std::optional<int> {
+    if (i == n) {
+      return std::nullopt;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(work_us));
+    return i++;
+  });
+}
+
+/// Like SlowCount, but return all the items at once.
+std::vector<int> SlowCountAll(int n, int work_us) {
+  std::vector<int> items;
+  for (int i = 0; i < n; i++) {
+    std::this_thread::sleep_for(std::chrono::microseconds(work_us));
+    items.push_back(i);
+  }
+  return items;
+}
+
+RAY_REMOTE(Count, CountThenFail, SlowCount, SlowCountAll);
+
+int SumWithSpans(int n) {
+  ray::Span span("sum", "n=" + std::to_string(n));
+  int sum = 0;
+  for (int i = 0; i < n; i++) {
+    ray::Span inner("add");
+    sum += i;
+  }
+  return sum;
+}
+
+RAY_REMOTE(SumWithSpans);
+
 class Counter {
  public:
   int count;
@@ -214,6 +272,33 @@ TEST(RayApiTest, ObjectRefArgsTest) {
   EXPECT_EQ(*r5.Get(), true);
 }
 
+TEST(RayApiTest, LocalModeFreeObjectTest) {
+  ray::RayConfig config;
+  config.local_mode = true;
+  ray::Init(config);
+  auto runtime = ray::internal::GetRayRuntime();
+  std::string id;
+  {
+    auto obj = ray::Put(1);
+    id = obj.ID();
+    auto copy = obj;
+    EXPECT_TRUE(runtime->Wait({id}, 1, 0)[0]);
+  }
+  // Freed with its last reference.
+  EXPECT_FALSE(runtime->Wait({id}, 1, 0)[0]);
+
+  // An object passed by reference is kept until the task has run.
+  ray::ObjectRef<std::string> r;
+  {
+    auto obj = ray::Put(std::string("aaa"));
+    r = ray::Task(GetVal).Remote(obj);
+  }
+  EXPECT_EQ(*r.Get(), "aaa");
+  id = r.ID();
+  r = ray::ObjectRef<std::string>();
+  EXPECT_FALSE(runtime->Wait({id}, 1, 0)[0]);
+}
+
 TEST(RayApiTest, CallWithValueTest) {
   auto r0 = ray::Task(Return1).Remote();
   auto r1 = ray::Task(Plus1).Remote(3);
@@ -251,6 +336,231 @@ TEST(RayApiTest, CallWithObjectTest) {
   EXPECT_EQ(return4, 9);
 }
 
+TEST(RayApiTest, LocalModeThroughputBenchmark) {
+  auto now_us = [] {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  };
+
+  // Independent tasks, all in flight at once.
+  const int num_tasks = 20000;
+  auto start = now_us();
+  std::vector<ray::ObjectRef<int>> refs;
+  refs.reserve(num_tasks);
+  for (int i = 0; i < num_tasks; i++) {
+    refs.push_back(ray::Task(Plus1).Remote(i));
+  }
+  auto results = ray::Get(refs);
+  auto elapsed_us = now_us() - start;
+  for (int i = 0; i < num_tasks; i++) {
+    EXPECT_EQ(*results[i], i + 1);
+  }
+  RAY_LOG(INFO) << "Local mode ran " << num_tasks << " independent tasks at "
+                << num_tasks * 1e6 / std::max<int64_t>(elapsed_us, 1) << " tasks/s";
+
+  // A chain of dependent tasks, submitted without waiting for each other.
+  const int chain_length = 5000;
+  start = now_us();
+  auto ref = ray::Task(Return1).Remote();
+  for (int i = 1; i < chain_length; i++) {
+    ref = ray::Task(Plus1).Remote(ref);
+  }
+  EXPECT_EQ(*ref.Get(), chain_length);
+  elapsed_us = now_us() - start;
+  RAY_LOG(INFO) << "Local mode ran a chain of " << chain_length << " dependent tasks at "
+                << chain_length * 1e6 / std::max<int64_t>(elapsed_us, 1) << " tasks/s";
+}
+
+TEST(RayApiTest, PutBatchGetBatchTest) {
+  std::vector<std::string> objs{"a", "bb", "ccc"};
+  auto refs = ray::PutBatch(objs);
+  ASSERT_EQ(refs.size(), objs.size());
+  auto results = ray::GetBatch(refs);
+  ASSERT_EQ(results.size(), objs.size());
+  for (size_t i = 0; i < objs.size(); i++) {
+    EXPECT_EQ(*results[i], objs[i]);
+    EXPECT_EQ(*ray::Get(refs[i]), objs[i]);
+  }
+  EXPECT_TRUE(ray::PutBatch(std::vector<int>{}).empty());
+
+  // Batch results can be passed to tasks like any other object.
+  auto task_ref = ray::Task(Plus1).Remote(ray::PutBatch(std::vector<int>{41})[0]);
+  EXPECT_EQ(*ray::GetBatch(std::vector<ray::ObjectRef<int>>{task_ref})[0], 42);
+}
+
+TEST(RayApiTest, PutBatchGetBatchBenchmark) {
+  auto now_us = [] {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  };
+  const int num_objects = 100000;
+  std::vector<std::string> objs;
+  objs.reserve(num_objects);
+  for (int i = 0; i < num_objects; i++) {
+    objs.push_back(std::to_string(i));
+  }
+
+  auto start = now_us();
+  std::vector<ray::ObjectRef<std::string>> refs;
+  refs.reserve(num_objects);
+  for (const auto &obj : objs) {
+    refs.push_back(ray::Put(obj));
+  }
+  auto results = ray::Get(refs);
+  auto single_us = now_us() - start;
+  EXPECT_EQ(*results.back(), objs.back());
+
+  start = now_us();
+  auto batch_refs = ray::PutBatch(objs);
+  auto batch_results = ray::GetBatch(batch_refs);
+  auto batch_us = now_us() - start;
+  EXPECT_EQ(*batch_results.back(), objs.back());
+
+  RAY_LOG(INFO) << "Put+Get of " << num_objects << " small objects: one by one "
+                << num_objects * 1e6 / std::max<int64_t>(single_us, 1)
+                << " objects/s, batched "
+                << num_objects * 1e6 / std::max<int64_t>(batch_us, 1) << " objects/s";
+}
+
+TEST(RayApiTest, GetAsyncTest) {
+  auto r0 = ray::Task(Return1).Remote();
+  auto r1 = ray::Task(Plus1).Remote(r0);
+  auto future = r1.GetAsync();
+  EXPECT_TRUE(future.WaitFor(-1));
+  EXPECT_TRUE(future.IsReady());
+  EXPECT_EQ(*future.Get(), 2);
+
+  std::promise<int> promise;
+  ray::Task(Plus).Remote(r1, 3).GetAsync(
+      [&promise](std::shared_ptr<int> value, std::exception_ptr error) {
+        EXPECT_FALSE(error);
+        promise.set_value(*value);
+      });
+  EXPECT_EQ(promise.get_future().get(), 5);
+
+  // Getting an object that is already in the store completes right away.
+  auto obj = ray::Put(std::string("aaa"));
+  EXPECT_EQ(*obj.GetAsync().Get(), "aaa");
+
+  // An exception thrown by the callback is stored in the future it returns.
+  auto done = obj.GetAsync([](std::shared_ptr<std::string> value,
+                              std::exception_ptr error) {
+    throw std::runtime_error("callback failed");
+  });
+  EXPECT_THROW(done.Get(), std::runtime_error);
+}
+
+TEST(RayApiTest, GetAsyncDriverCpuBenchmark) {
+  auto thread_cpu_us = [] {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+  };
+  const int num_tasks = 10000;
+
+  // Blocking gets, one at a time.
+  std::vector<ray::ObjectRef<int>> refs;
+  refs.reserve(num_tasks);
+  auto start = thread_cpu_us();
+  for (int i = 0; i < num_tasks; i++) {
+    refs.push_back(ray::Task(Plus1).Remote(i));
+  }
+  for (int i = 0; i < num_tasks; i++) {
+    EXPECT_EQ(*refs[i].Get(), i + 1);
+  }
+  auto blocking_us = thread_cpu_us() - start;
+
+  // Async gets, the driver thread sleeps until the last one completes.
+  refs.clear();
+  std::atomic<int> num_done{0};
+  std::promise<void> all_done;
+  start = thread_cpu_us();
+  for (int i = 0; i < num_tasks; i++) {
+    refs.push_back(ray::Task(Plus1).Remote(i));
+  }
+  for (int i = 0; i < num_tasks; i++) {
+    refs[i].GetAsync([&](std::shared_ptr<int> value, std::exception_ptr error) {
+      EXPECT_FALSE(error);
+      if (num_done.fetch_add(1) + 1 == num_tasks) {
+        all_done.set_value();
+      }
+    });
+  }
+  all_done.get_future().wait();
+  auto async_us = thread_cpu_us() - start;
+  RAY_LOG(INFO) << "Driver CPU per completed task: blocking get "
+                << blocking_us * 1.0 / num_tasks << "us, async get "
+                << async_us * 1.0 / num_tasks << "us";
+}
+
+TEST(RayApiTest, StreamingGeneratorTest) {
+  std::vector<int> items;
+  for (auto &ref : ray::Task(Count).Remote(5)) {
+    items.push_back(*ref.Get());
+  }
+  EXPECT_EQ(items, (std::vector<int>{0, 1, 2, 3, 4}));
+
+  auto empty = ray::Task(Count).Remote(0);
+  EXPECT_FALSE(empty.Next().has_value());
+  EXPECT_FALSE(empty.Next().has_value());
+
+  // Items produced before the failure can be read, then the error is thrown.
+  auto failing = ray::Task(CountThenFail).Remote(2);
+  EXPECT_EQ(*failing.Next()->Get(), 0);
+  EXPECT_EQ(*failing.Next()->Get(), 1);
+  EXPECT_THROW(failing.Next(), ray::internal::RayTaskException);
+
+  // Items can be passed to other tasks while the generator is still running.
+  auto stream = ray::Task(Count).SetGeneratorBackpressure(2).Remote(3);
+  auto ref = stream.Next();
+  ASSERT_TRUE(ref.has_value());
+  EXPECT_EQ(*ray::Task(Plus1).Remote(*ref).Get(), 1);
+}
+
+TEST(RayApiTest, StreamingGeneratorPipelineBenchmark) {
+  auto now_us = [] {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  };
+  const int num_items = 200;
+  const int work_us = 1000;
+  auto consume = [work_us](int item) {
+    std::this_thread::sleep_for(std::chrono::microseconds(work_us));
+    return item;
+  };
+
+  // The consumer waits for the whole result before it starts.
+  auto start = now_us();
+  auto all_items = *ray::Task(SlowCountAll).Remote(num_items, work_us).Get();
+  auto buffered_first_us = now_us() - start;
+  int64_t sum = 0;
+  for (auto item : all_items) {
+    sum += consume(item);
+  }
+  auto buffered_us = now_us() - start;
+
+  // The consumer works on each item while the producer makes the next one.
+  start = now_us();
+  int64_t streamed_first_us = -1;
+  int64_t streamed_sum = 0;
+  for (auto &ref : ray::Task(SlowCount).Remote(num_items, work_us)) {
+    if (streamed_first_us < 0) {
+      streamed_first_us = now_us() - start;
+    }
+    streamed_sum += consume(*ref.Get());
+  }
+  auto streamed_us = now_us() - start;
+  EXPECT_EQ(streamed_sum, sum);
+
+  RAY_LOG(INFO) << "Pipeline of " << num_items << " items: buffered return took "
+                << buffered_us << "us (first item after " << buffered_first_us
+                << "us), streaming generator took " << streamed_us
+                << "us (first item after " << streamed_first_us << "us)";
+}
+
 TEST(RayApiTest, ActorTest) {
   ray::RayConfig config;
   config.local_mode = true;
@@ -341,6 +651,17 @@ TEST(RayApiTest, CreateAndRemovePlacementGroup) {
   ray::RemovePlacementGroup(first_placement_group.GetID());
 }
 
+TEST(RayApiTest, SpanTest) {
+  // Local mode has no timeline, spans must still be safe to use.
+  EXPECT_EQ(*ray::Task(SumWithSpans).Remote(10).Get(), 45);
+  ray::Span span("driver");
+  span.End();
+}
+
+TEST(RayApiTest, ChannelLocalModeTest) {
+  EXPECT_THROW(ray::experimental::CreateChannel<int>(1024), ray::internal::RayException);
+}
+
 TEST(RayApiTest, DefaultActorLifetimeTest) {
   ray::RayConfig config;
   ray::internal::ConfigInternal::Instance().Init(config, 0, nullptr);
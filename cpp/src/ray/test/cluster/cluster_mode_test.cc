@@ -15,6 +15,10 @@
 #include <gtest/gtest.h>
 #include <ray/api.h>
 
+#include <future>
+#include <numeric>
+#include <stdexcept>
+
 #include "../../runtime/abstract_ray_runtime.h"
 #include "../../runtime/object/native_object_store.h"
 #include "../../util/process_helper.h"
@@ -302,6 +306,146 @@ TEST(RayClusterModeTest, PythonInvocationTest) {
   EXPECT_EQ(p.name, py_result.name);
 }
 
+TEST(RayClusterModeTest, FlatPutGetTest) {
+  std::vector<double> values(100000);
+  std::iota(values.begin(), values.end(), 0.0);
+  double sum = std::accumulate(values.begin(), values.end(), 0.0);
+
+  auto ref = ray::Put(values);
+  EXPECT_EQ(values, *ray::Get(ref));
+  EXPECT_EQ(sum, *ray::Task(Sum).Remote(ref).Get());
+  // The flat encoding is also used for values passed to and returned from C++ tasks.
+  EXPECT_EQ(sum, *ray::Task(Sum).Remote(values).Get());
+
+  // Python can't read the flat object, but can take the value.
+  EXPECT_THROW(ray::Task(ray::PyFunction<std::vector<double>>{
+                             "test_cross_language_invocation", "py_return_input"})
+                   .Remote(ref),
+               std::invalid_argument);
+  auto py_obj = ray::Task(ray::PyFunction<std::vector<double>>{
+                              "test_cross_language_invocation", "py_return_input"})
+                    .Remote(values);
+  EXPECT_EQ(values, *py_obj.Get());
+}
+
+TEST(RayClusterModeTest, GetAsyncTest) {
+  auto r0 = ray::Task(Return1).Remote();
+  auto r1 = ray::Task(Plus1).Remote(r0);
+  EXPECT_EQ(*r1.GetAsync().Get(), 2);
+
+  std::promise<int> promise;
+  auto done = r1.GetAsync().Then(
+      [&promise](std::shared_ptr<int> value, std::exception_ptr error) {
+        EXPECT_FALSE(error);
+        promise.set_value(*value);
+      });
+  EXPECT_EQ(promise.get_future().get(), 2);
+  EXPECT_NO_THROW(done.Get());
+
+  // A task error is handed to the callback, and rethrown by Get.
+  auto actor = ray::Actor(Counter::FactoryCreateException).Remote();
+  auto failed = actor.Task(&Counter::Plus1).Remote();
+  std::promise<bool> failed_promise;
+  failed.GetAsync([&failed_promise](std::shared_ptr<int> value,
+                                    std::exception_ptr error) {
+    failed_promise.set_value(value == nullptr && error != nullptr);
+  });
+  EXPECT_TRUE(failed_promise.get_future().get());
+  EXPECT_THROW(failed.GetAsync().Get(), ray::internal::RayActorException);
+
+  // An exception thrown by the callback is stored in the future it returns.
+  auto callback_failed = r1.GetAsync(
+      [](std::shared_ptr<int> value, std::exception_ptr error) {
+        throw std::runtime_error("callback failed");
+      });
+  EXPECT_THROW(callback_failed.Get(), std::runtime_error);
+}
+
+TEST(RayClusterModeTest, PutBatchGetBatchTest) {
+  // CoreWorker::PutBatch writes all of these to plasma and pins them with one request.
+  std::vector<std::string> objs;
+  for (int i = 0; i < 1000; i++) {
+    objs.push_back(std::to_string(i));
+  }
+  objs.push_back(std::string(10 * 1024 * 1024, 'a'));
+  auto refs = ray::PutBatch(objs);
+  ASSERT_EQ(refs.size(), objs.size());
+  auto results = ray::GetBatch(refs);
+  ASSERT_EQ(results.size(), objs.size());
+  for (size_t i = 0; i < objs.size(); i++) {
+    EXPECT_EQ(*results[i], objs[i]);
+  }
+  EXPECT_TRUE(ray::PutBatch(std::vector<int>{}).empty());
+
+  // Batch results can be passed to tasks like any other object.
+  auto ints = ray::PutBatch(std::vector<int>{1, 2});
+  EXPECT_EQ(*ray::Task(Plus).Remote(ints[0], ints[1]).Get(), 3);
+
+  // One failed object fails the whole GetBatch, and the others can still be got.
+  auto actor = ray::Actor(Counter::FactoryCreateException).Remote();
+  std::vector<ray::ObjectRef<int>> mixed{ints[0], actor.Task(&Counter::Plus1).Remote()};
+  EXPECT_THROW(ray::GetBatch(mixed), ray::internal::RayActorException);
+  EXPECT_EQ(*ray::GetBatch(std::vector<ray::ObjectRef<int>>{ints[0], ints[1]})[1], 2);
+}
+
+TEST(RayClusterModeTest, StreamingGeneratorTest) {
+  std::vector<int> items;
+  for (auto &ref : ray::Task(Count).Remote(3)) {
+    items.push_back(*ref.Get());
+  }
+  EXPECT_EQ(items, (std::vector<int>{0, 1, 2}));
+
+  // The items yielded before the generator throws can be read, then Next rethrows the
+  // error.
+  auto failing = ray::Task(CountThenFail).Remote(2);
+  EXPECT_EQ(*failing.Next()->Get(), 0);
+  EXPECT_EQ(*failing.Next()->Get(), 1);
+  try {
+    failing.Next();
+    FAIL() << "Next should rethrow the generator's error.";
+  } catch (ray::internal::RayTaskException &e) {
+    EXPECT_NE(std::string(e.what()).find("generator failed"), std::string::npos);
+  }
+
+  // Also when the generator is throttled by backpressure.
+  auto throttled = ray::Task(CountThenFail).SetGeneratorBackpressure(1).Remote(3);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(*throttled.Next()->Get(), i);
+  }
+  EXPECT_THROW(throttled.Next(), ray::internal::RayTaskException);
+}
+
+TEST(RayClusterModeTest, ChannelWriterExceptionTest) {
+  auto channel = ray::experimental::CreateChannel<int>(1024);
+  channel.Write(1);
+  EXPECT_EQ(*channel.Read(), 1);
+
+  // Go through the runtime to get a writer that throws after the buffer is acquired.
+  EXPECT_THROW(ray::internal::GetRayRuntime()->WriteChannel(
+                   channel.ID(),
+                   sizeof(int),
+                   channel.NumReaders(),
+                   -1,
+                   [](char *) { throw std::runtime_error("bad value"); }),
+               std::runtime_error);
+
+  // The partial value is never published, the channel is closed instead.
+  EXPECT_THROW(channel.Read(), ray::internal::RayChannelException);
+  EXPECT_THROW(channel.Write(2), ray::internal::RayChannelException);
+}
+
+TEST(RayClusterModeTest, FlatPutWriterThrowsTest) {
+  ray::internal::NativeObjectStore object_store;
+  auto ref_counts = object_store.GetAllReferenceCounts();
+  EXPECT_THROW(ray::internal::GetRayRuntime()->Put(
+                   1024, [](char *data) { throw std::runtime_error("writer failed"); }),
+               std::runtime_error);
+  // The aborted object leaves no reference behind and the store stays usable.
+  EXPECT_EQ(ref_counts, object_store.GetAllReferenceCounts());
+  std::vector<double> values(1024, 1.0);
+  EXPECT_EQ(values, *ray::Get(ray::Put(values)));
+}
+
 TEST(RayClusterModeTest, MaxConcurrentTest) {
   auto actor1 =
       ray::Actor(ActorConcurrentCall::FactoryCreate).SetMaxConcurrency(3).Remote();
@@ -14,6 +14,10 @@
 
 #include "plus.h"
 
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+
 int Return1() { return 1; };
 int Plus1(int x) { return x + 1; };
 int Plus(int x, int y) { return x + y; };
@@ -34,6 +38,28 @@ std::vector<std::string> GetList(std::vector<std::string> list) { return list; }
 
 std::tuple<int, std::string> GetTuple(std::tuple<int, std::string> tp) { return tp; }
 
+double Sum(std::vector<double> values) {
+  return std::accumulate(values.begin(), values.end(), 0.0);
+}
+
+ray::Generator<int> Count(int n) {
+  return ray::Generator<int>([i = 0, n]() mutable -> std::optional<int> {
+    if (i == n) {
+      return std::nullopt;
+    }
+    return i++;
+  });
+}
+
+ray::Generator<int> CountThenFail(int n) {
+  return ray::Generator<int>([i = 0, n]() mutable -> std::optional<int> {
+    if (i == n) {
+      throw std::runtime_error("generator failed");
+    }
+    return i++;
+  });
+}
+
 std::string GetNamespaceInTask() { return ray::GetNamespace(); }
 
 Student GetStudent(Student student) { return student; }
@@ -50,6 +76,9 @@ RAY_REMOTE(Return1,
            GetArray,
            GetList,
            GetTuple,
+           Sum,
+           Count,
+           CountThenFail,
            GetNamespaceInTask,
            GetStudent,
            GetStudents);
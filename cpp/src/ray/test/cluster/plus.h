@@ -28,6 +28,9 @@ std::map<int, std::string> GetMap(std::map<int, std::string> map);
 std::array<std::string, 2> GetArray(std::array<std::string, 2> array);
 std::vector<std::string> GetList(std::vector<std::string> list);
 std::tuple<int, std::string> GetTuple(std::tuple<int, std::string> tp);
+double Sum(std::vector<double> values);
+ray::Generator<int> Count(int n);
+ray::Generator<int> CountThenFail(int n);
 
 std::string GetNamespaceInTask();
 
@@ -0,0 +1,83 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Built as C++20, so that ObjectFuture can be `co_await`ed.
+
+#include <gtest/gtest.h>
+#include <ray/api.h>
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+static_assert(__cpp_impl_coroutine, "This test must be built as C++20.");
+
+int Plus1(int x) { return x + 1; }
+
+int Fail() { throw std::runtime_error("task failed"); }
+
+RAY_REMOTE(Plus1, Fail);
+
+/// A coroutine that starts right away and hands its result to a std::future.
+template <typename T>
+struct AsyncResult {
+  struct promise_type {
+    std::promise<T> result;
+
+    AsyncResult get_return_object() { return AsyncResult{result.get_future()}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_value(T value) { result.set_value(std::move(value)); }
+    void unhandled_exception() { result.set_exception(std::current_exception()); }
+  };
+
+  std::future<T> future;
+};
+
+AsyncResult<int> AddAsync(ray::ObjectRef<int> a, ray::ObjectRef<int> b) {
+  auto x = co_await a.GetAsync();
+  auto y = co_await b.GetAsync();
+  co_return *x + *y;
+}
+
+AsyncResult<std::string> GetStringAsync(ray::ObjectRef<std::string> ref) {
+  co_return *co_await ref.GetAsync();
+}
+
+AsyncResult<int> GetIntAsync(ray::ObjectRef<int> ref) {
+  co_return *co_await ref.GetAsync();
+}
+
+TEST(RayCoroutineTest, AwaitGetAsyncTest) {
+  ray::RayConfig config;
+  config.local_mode = true;
+  ray::Init(config);
+
+  // Pending and ready objects.
+  auto r1 = ray::Task(Plus1).Remote(1);
+  auto r2 = ray::Task(Plus1).Remote(r1);
+  EXPECT_EQ(AddAsync(r1, r2).future.get(), 5);
+
+  auto obj = ray::Put(std::string("aaa"));
+  EXPECT_EQ(GetStringAsync(obj).future.get(), "aaa");
+
+  // The error that prevented getting the object is thrown from `co_await`.
+  auto failed = ray::Task(Fail).Remote();
+  EXPECT_ANY_THROW(GetIntAsync(failed).future.get());
+
+  ray::Shutdown();
+}
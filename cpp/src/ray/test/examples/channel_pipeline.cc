@@ -0,0 +1,113 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// This is an example of a pipeline of C++ actors connected by channels. The driver
+/// sends a vector through a chain of stages and measures the round-trip latency.
+#include <ray/api.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+
+ABSL_FLAG(int32_t, num_stages, 2, "The number of actors in the pipeline");
+ABSL_FLAG(int32_t, num_iterations, 10000, "The number of values sent through");
+ABSL_FLAG(int32_t, payload_size, 256, "The number of floats in each value");
+
+using Payload = std::vector<float>;
+
+/// A pipeline stage: adds one to every element of the values read from `in` and writes
+/// the results to `out`.
+class Stage {
+ public:
+  static Stage *FactoryCreate() { return new Stage(); }
+
+  int Run(ray::experimental::Channel<Payload> in,
+          ray::experimental::Channel<Payload> out,
+          int num_iterations) {
+    Payload next;
+    for (int i = 0; i < num_iterations; i++) {
+      {
+        // Read the input in place, and release it before writing the output so the
+        // upstream stage can move on.
+        auto view = in.ReadView();
+        auto input = view.AsArray<float>();
+        next.assign(input.begin(), input.end());
+      }
+      for (auto &x : next) {
+        x += 1;
+      }
+      out.Write(next);
+    }
+    return num_iterations;
+  }
+};
+
+RAY_REMOTE(RAY_FUNC(Stage::FactoryCreate), &Stage::Run);
+
+int main(int argc, char **argv) {
+  absl::ParseCommandLine(argc, argv);
+  const int num_stages = absl::GetFlag(FLAGS_num_stages);
+  const int num_iterations = absl::GetFlag(FLAGS_num_iterations);
+  const size_t payload_size = absl::GetFlag(FLAGS_payload_size);
+  // Start ray cluster and ray runtime.
+  ray::RayConfig config;
+  ray::Init(config, argc, argv);
+
+  const size_t buffer_size =
+      ray::internal::FLAT_HEADER_LEN + payload_size * sizeof(float);
+  std::vector<ray::experimental::Channel<Payload>> channels;
+  for (int i = 0; i <= num_stages; i++) {
+    channels.push_back(ray::experimental::CreateChannel<Payload>(buffer_size));
+  }
+  std::vector<ray::ActorHandle<Stage>> stages;
+  std::vector<ray::ObjectRef<int>> runs;
+  for (int i = 0; i < num_stages; i++) {
+    stages.push_back(ray::Actor(Stage::FactoryCreate).Remote());
+    runs.push_back(stages.back()
+                       .Task(&Stage::Run)
+                       .Remote(channels[i], channels[i + 1], num_iterations));
+  }
+
+  auto &input = channels.front();
+  auto &output = channels.back();
+  Payload value(payload_size, 0);
+  std::vector<double> latencies_us;
+  latencies_us.reserve(num_iterations);
+  for (int i = 0; i < num_iterations; i++) {
+    auto start = std::chrono::steady_clock::now();
+    input.Write(value);
+    auto result = output.Read();
+    latencies_us.push_back(std::chrono::duration<double, std::micro>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
+    if (result->front() != num_stages) {
+      std::cerr << "Unexpected result " << result->front() << std::endl;
+      return 1;
+    }
+  }
+  for (auto &run : runs) {
+    run.Get();
+  }
+
+  std::sort(latencies_us.begin(), latencies_us.end());
+  std::cout << "Channel pipeline of " << num_stages << " stages, " << payload_size
+            << " floats: p50 " << latencies_us[latencies_us.size() / 2] << "us, p99 "
+            << latencies_us[latencies_us.size() * 99 / 100] << "us" << std::endl;
+  // Stop ray cluster and ray runtime.
+  ray::Shutdown();
+  return 0;
+}
@@ -17,10 +17,39 @@
 #include <ray/api.h>
 #include <ray/api/metric.h>
 
+#include <chrono>
+#include <iostream>
+
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
 
 ABSL_FLAG(int32_t, metric_time, 10, "The total time in seconds for recording metrics");
+ABSL_FLAG(int32_t,
+          benchmark_records,
+          1000000,
+          "The number of records to time for each way of recording");
+
+/// Print the average cost of recording through the tag map and through bound metrics.
+void benchmark_metric(int num_records) {
+  ray::Counter counter("ray.test.bench_counter", "bench counter", "unit", {"tag1"});
+  ray::Sum sum("ray.test.bench_sum", "bench sum", "unit", {"tag1"});
+  std::unordered_map<std::string, std::string> tags = {{"tag1", "bench"}};
+  auto time_ns = [num_records](auto &&record) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_records; i++) {
+      record();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / num_records;
+  };
+  auto bound_counter = counter.Bind(tags);
+  auto bound_sum = sum.Bind(tags);
+  std::cout << "Counter::Inc: " << time_ns([&] { counter.Inc(1, tags); }) << "ns\n"
+            << "bound counter: " << time_ns([&] { bound_counter.Record(1); }) << "ns\n"
+            << "Sum::Record: " << time_ns([&] { sum.Record(1, tags); }) << "ns\n"
+            << "bound sum: " << time_ns([&] { bound_sum.Record(1); }) << "ns"
+            << std::endl;
+}
 
 void test_metric(const std::string &exec_type, int total_time) {
   ray::Gauge gauge("ray.test.gauge", "test gauge", "unit", {"tag1", "tag2"});
@@ -62,6 +91,7 @@ int main(int argc, char **argv) {
   // Start ray cluster and ray runtime.
   ray::RayConfig config;
   ray::Init(config, argc, argv);
+  benchmark_metric(absl::GetFlag(FLAGS_benchmark_records));
   auto actor = ray::Actor(MetricActor::FactoryCreate).Remote();
   auto object_ref = actor.Task(&MetricActor::record_metric).Remote(total_time);
   test_metric("driver", total_time);
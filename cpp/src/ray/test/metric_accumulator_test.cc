@@ -0,0 +1,95 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../runtime/metric/metric_accumulator.h"
+
+using ray::internal::MetricAccumulator;
+
+TEST(MetricAccumulatorTest, FlushReturnsWhatWasAddedSinceLastFlush) {
+  MetricAccumulator accumulator;
+  EXPECT_EQ(accumulator.Flush(), 0);
+  accumulator.Add(1);
+  accumulator.Add(2);
+  EXPECT_EQ(accumulator.Flush(), 3);
+  EXPECT_EQ(accumulator.Flush(), 0);
+  accumulator.Add(4);
+  EXPECT_EQ(accumulator.Flush(), 4);
+}
+
+TEST(MetricAccumulatorTest, AddUpAcrossThreads) {
+  MetricAccumulator accumulator;
+  constexpr int kThreads = 8;
+  constexpr int kAddsPerThread = 10000;
+  std::atomic<bool> done{false};
+  double flushed = 0;
+  // Flush while the values are being added, nothing is lost or flushed twice.
+  std::thread flusher([&] {
+    while (!done.load()) {
+      flushed += accumulator.Flush();
+    }
+  });
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; i++) {
+    threads.emplace_back([&accumulator] {
+      for (int j = 0; j < kAddsPerThread; j++) {
+        accumulator.Add(1);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  done = true;
+  flusher.join();
+  // The values of threads that exited are still flushed.
+  flushed += accumulator.Flush();
+  EXPECT_EQ(flushed, kThreads * kAddsPerThread);
+}
+
+TEST(MetricAccumulatorTest, DropCellsOfDestroyedAccumulators) {
+  // Use a new thread, so that the cells of the other tests aren't counted.
+  std::thread([] {
+    MetricAccumulator kept;
+    kept.Add(1);
+    for (int i = 0; i < 1000; i++) {
+      MetricAccumulator accumulator;
+      accumulator.Add(1);
+      EXPECT_EQ(accumulator.Flush(), 1);
+    }
+    EXPECT_LE(MetricAccumulator::NumThreadCells(), 16);
+    EXPECT_EQ(kept.Flush(), 1);
+  }).join();
+}
+
+TEST(MetricAccumulatorTest, ReleaseCellsOfExitedThreads) {
+  MetricAccumulator accumulator;
+  constexpr int kThreads = 8;
+  for (int i = 0; i < kThreads; i++) {
+    std::thread([&accumulator] { accumulator.Add(1); }).join();
+  }
+  accumulator.Add(1);
+  EXPECT_EQ(accumulator.NumCells(), kThreads + 1);
+  // The values of the exited threads are flushed once, then only this thread's cell is
+  // left.
+  EXPECT_EQ(accumulator.Flush(), kThreads + 1);
+  EXPECT_EQ(accumulator.NumCells(), 1);
+  accumulator.Add(1);
+  EXPECT_EQ(accumulator.Flush(), 1);
+}
@@ -0,0 +1,90 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <ray/api.h>
+
+#include <chrono>
+#include <numeric>
+
+#include "ray/util/logging.h"
+
+namespace {
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+TEST(ObjectViewTest, ViewBorrowsStoreBuffer) {
+  ray::RayConfig config;
+  config.local_mode = true;
+  ray::Init(config);
+
+  std::string payload(1 << 20, 'x');
+  auto obj = ray::Put(payload);
+  auto view1 = obj.GetView();
+  auto view2 = ray::GetView(obj);
+  EXPECT_EQ(view1.Bytes(), payload);
+  EXPECT_EQ(view1.Get(), payload);
+  // Both views point at the same bytes in the object store rather than at copies.
+  EXPECT_EQ(view1.Bytes().data(), view2.Bytes().data());
+  EXPECT_EQ(view1.AsArray<char>().size(), payload.size());
+
+  std::vector<int> numbers{1, 2, 3};
+  auto numbers_view = ray::Put(numbers).GetView();
+  EXPECT_EQ(numbers_view.Get(), numbers);
+  EXPECT_THROW(numbers_view.Bytes(), ray::internal::RayException);
+
+  std::vector<ray::ObjectRef<int>> refs{ray::Put(1), ray::Put(2)};
+  auto views = ray::GetView(refs);
+  ASSERT_EQ(views.size(), 2);
+  EXPECT_EQ(views[0].Get(), 1);
+  EXPECT_EQ(views[1].Get(), 2);
+}
+
+TEST(ObjectViewTest, GetVectorOfDoublesThroughput) {
+  ray::RayConfig config;
+  config.local_mode = true;
+  ray::Init(config);
+
+  const size_t num_elements = 1 << 22;
+  const int iterations = 5;
+  std::vector<double> values(num_elements);
+  std::iota(values.begin(), values.end(), 0.0);
+  auto obj = ray::Put(values);
+  const double gigabytes =
+      static_cast<double>(num_elements * sizeof(double) * iterations) / (1 << 30);
+
+  auto start = NowUs();
+  for (int i = 0; i < iterations; i++) {
+    auto result = obj.Get();
+    ASSERT_EQ(result->size(), num_elements);
+  }
+  auto copy_us = NowUs() - start;
+
+  start = NowUs();
+  for (int i = 0; i < iterations; i++) {
+    auto result = obj.GetView().Get();
+    ASSERT_EQ(result.size(), num_elements);
+  }
+  auto view_us = NowUs() - start;
+
+  RAY_LOG(INFO) << "Get of " << num_elements << " doubles: copy "
+                << gigabytes / (copy_us / 1e6) << " GB/s, view "
+                << gigabytes / (view_us / 1e6) << " GB/s";
+}
@@ -15,6 +15,44 @@
 #include <gtest/gtest.h>
 #include <ray/api.h>
 
+#include <chrono>
+#include <numeric>
+
+#include "ray/util/logging.h"
+
+struct FlatPoint {
+  int32_t id;
+  double x;
+  double y;
+  bool operator==(const FlatPoint &rhs) const {
+    return id == rhs.id && x == rhs.x && y == rhs.y;
+  }
+};
+
+RAY_FLAT_SERIALIZABLE(FlatPoint)
+
+/// The same payload as a std::vector<double>, but packed through msgpack.
+struct MsgpackDoubles {
+  std::vector<double> values;
+  MSGPACK_DEFINE(values);
+};
+
+std::vector<double> EchoFlat(std::vector<double> values) { return values; }
+
+MsgpackDoubles EchoMsgpack(MsgpackDoubles values) { return values; }
+
+RAY_REMOTE(EchoFlat, EchoMsgpack);
+
+namespace {
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
 bool IsAnyEqual(const std::any &lhs, const std::any &rhs) {
   if (lhs.type() != rhs.type()) {
     return false;
@@ -123,4 +161,104 @@ TEST(SerializationTest, BoundaryValueTest) {
   auto out_arg3 = ray::internal::Serializer::Deserialize<std::vector<std::byte>>(
       buffer1.data(), buffer1.size());
   EXPECT_EQ(std::vector<std::byte>(), out_arg3);
-}
\ No newline at end of file
+}
+TEST(SerializationTest, FlatRoundTripTest) {
+  using ray::internal::Serializer;
+  static_assert(ray::internal::is_flat_v<std::vector<double>>);
+  static_assert(ray::internal::is_flat_v<std::vector<FlatPoint>>);
+  static_assert(!ray::internal::is_flat_v<std::vector<char>>);
+  static_assert(!ray::internal::is_flat_v<int>);
+
+  std::vector<double> doubles{1.5, -2.25, 3.0};
+  auto buffer1 = Serializer::Serialize(doubles);
+  EXPECT_TRUE(ray::internal::IsFlatPayload(buffer1.data(), buffer1.size()));
+  EXPECT_FALSE(Serializer::HasError(buffer1.data(), buffer1.size()));
+  EXPECT_FALSE(Serializer::IsXLang(buffer1.data(), buffer1.size()));
+  EXPECT_EQ(Serializer::Deserialize<std::vector<double>>(buffer1.data(), buffer1.size()),
+            doubles);
+  EXPECT_EQ(*Serializer::Deserialize<std::shared_ptr<std::vector<double>>>(
+                buffer1.data(), buffer1.size()),
+            doubles);
+
+  // Flat types still read msgpack payloads, e.g. from other languages.
+  auto buffer2 = Serializer::SerializeMsgpack(doubles);
+  EXPECT_EQ(Serializer::Deserialize<std::vector<double>>(buffer2.data(), buffer2.size()),
+            doubles);
+
+  // And other languages get a msgpack array back.
+  auto buffer3 = Serializer::FlatToMsgpack(buffer1.data(), buffer1.size());
+  EXPECT_EQ(std::string(buffer3.data(), buffer3.size()),
+            std::string(buffer2.data(), buffer2.size()));
+
+  FlatPoint point{7, 1.0, 2.0};
+  auto buffer4 = Serializer::Serialize(point);
+  EXPECT_EQ(Serializer::Deserialize<FlatPoint>(buffer4.data(), buffer4.size()), point);
+  std::vector<FlatPoint> points{point, {8, 3.0, 4.0}};
+  auto buffer5 = Serializer::Serialize(points);
+  auto [ok, out_points] =
+      Serializer::DeserializeWhenNil<std::vector<FlatPoint>>(buffer5.data(),
+                                                             buffer5.size());
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(out_points, points);
+
+  ray::RayConfig config;
+  config.local_mode = true;
+  ray::Init(config);
+  auto obj = ray::Put(doubles);
+  EXPECT_EQ(*obj.Get(), doubles);
+  auto view = obj.GetView();
+  EXPECT_EQ(view.Get(), doubles);
+  auto array = view.AsArray<double>();
+  EXPECT_EQ(std::vector<double>(array.begin(), array.end()), doubles);
+  EXPECT_EQ(*ray::Task(EchoFlat).Remote(doubles).Get(), doubles);
+}
+
+TEST(SerializationTest, FlatVsMsgpackBenchmark) {
+  using ray::internal::Serializer;
+  const size_t num_elements = 1 << 20;
+  const int iterations = 20;
+  MsgpackDoubles msgpack_values;
+  msgpack_values.values.resize(num_elements);
+  std::iota(msgpack_values.values.begin(), msgpack_values.values.end(), 0.0);
+  const std::vector<double> &values = msgpack_values.values;
+
+  auto start = NowUs();
+  for (int i = 0; i < iterations; i++) {
+    auto buffer = Serializer::Serialize(msgpack_values);
+    auto out = Serializer::Deserialize<MsgpackDoubles>(buffer.data(), buffer.size());
+    ASSERT_EQ(out.values.size(), num_elements);
+  }
+  auto msgpack_us = NowUs() - start;
+
+  start = NowUs();
+  for (int i = 0; i < iterations; i++) {
+    auto buffer = Serializer::Serialize(values);
+    auto out = Serializer::Deserialize<std::vector<double>>(buffer.data(), buffer.size());
+    ASSERT_EQ(out.size(), num_elements);
+  }
+  auto flat_us = NowUs() - start;
+  RAY_LOG(INFO) << "Serialize + deserialize " << num_elements
+                << " doubles: msgpack " << msgpack_us / iterations << "us, flat "
+                << flat_us / iterations << "us";
+
+  // Pass the same data as a task argument and return value.
+  ray::RayConfig config;
+  config.local_mode = true;
+  ray::Init(config);
+  start = NowUs();
+  for (int i = 0; i < iterations; i++) {
+    auto out = ray::Task(EchoMsgpack).Remote(msgpack_values).Get();
+    ASSERT_EQ(out->values.size(), num_elements);
+  }
+  msgpack_us = NowUs() - start;
+
+  start = NowUs();
+  for (int i = 0; i < iterations; i++) {
+    auto out = ray::Task(EchoFlat).Remote(values).Get();
+    ASSERT_EQ(out->size(), num_elements);
+  }
+  flat_us = NowUs() - start;
+  RAY_LOG(INFO) << "Task round trip of " << num_elements << " doubles: msgpack "
+                << msgpack_us / iterations << "us, flat " << flat_us / iterations
+                << "us";
+}
@@ -52,10 +52,13 @@ void FunctionHelper::LoadDll(const std::filesystem::path &lib_path) {
   RAY_CHECK(libraries_.emplace(lib_path.string(), lib).second);
 
   try {
-    auto entry_func = boost::dll::import_alias<msgpack::sbuffer(
-        const std::string &, const ArgsBufferList &, msgpack::sbuffer *)>(
-        *lib, "TaskExecutionHandler");
-    auto function_names = LoadAllRemoteFunctions(lib_path.string(), *lib, entry_func);
+    if (!lib->has("TaskExecutionHandler")) {
+      RAY_LOG(INFO) << "The library " << lib_path
+                    << " isn't integrated with Ray, skip it.";
+      lib->unload();
+      return;
+    }
+    auto function_names = LoadAllRemoteFunctions(lib_path.string(), *lib);
     if (function_names.empty()) {
       RAY_LOG(WARNING)
           << "No remote functions in library " << lib_path
@@ -83,9 +86,8 @@ void FunctionHelper::LoadDll(const std::filesystem::path &lib_path) {
   return;
 }
 
-std::string FunctionHelper::LoadAllRemoteFunctions(const std::string lib_path,
-                                                   const boost::dll::shared_library &lib,
-                                                   const EntryFuntion &entry_function) {
+std::string FunctionHelper::LoadAllRemoteFunctions(
+    const std::string lib_path, const boost::dll::shared_library &lib) {
   static const std::string internal_function_name = "GetRemoteFunctions";
   if (!lib.has(internal_function_name)) {
     RAY_LOG(WARNING) << "Internal function '" << internal_function_name
@@ -107,11 +109,17 @@ std::string FunctionHelper::LoadAllRemoteFunctions(const std::string lib_path,
   auto function_maps = get_remote_func();
   for (const auto &pair : function_maps.first) {
     names_str.append(pair.first).append(", ");
-    remote_funcs_.emplace(pair.first, entry_function);
+    if (remote_funcs_.count(pair.first) == 0) {
+      remote_funcs_.emplace(pair.first,
+                            AddExecutableFunction({pair.first, &pair.second, nullptr}));
+    }
   }
   for (const auto &pair : function_maps.second) {
     names_str.append(pair.first).append(", ");
-    remote_member_funcs_.emplace(pair.first, entry_function);
+    if (remote_member_funcs_.count(pair.first) == 0) {
+      remote_member_funcs_.emplace(
+          pair.first, AddExecutableFunction({pair.first, nullptr, &pair.second}));
+    }
   }
   if (!names_str.empty()) {
     names_str.pop_back();
@@ -160,26 +168,57 @@ void FunctionHelper::LoadFunctionsFromPaths(const std::vector<std::string> &path
   }
 }
 
-const EntryFuntion &FunctionHelper::GetExecutableFunctions(
-    const std::string &function_name) {
-  auto it = remote_funcs_.find(function_name);
-  if (it == remote_funcs_.end()) {
+size_t FunctionHelper::AddExecutableFunction(ExecutableFunction function) {
+  size_t id = functions_.size();
+  auto hash = HashFunctionName(function.name);
+  auto pair = ids_by_hash_.emplace(hash, id);
+  if (!pair.second) {
+    RAY_LOG(WARNING) << "Remote function " << function.name << " has the same hash as "
+                     << functions_[pair.first->second].name
+                     << ", it will be dispatched by name.";
+  }
+  functions_.push_back(std::move(function));
+  return id;
+}
+
+const ExecutableFunction *FunctionHelper::FindExecutableFunction(
+    uint64_t function_hash, const std::string &function_name, bool is_member) const {
+  if (function_hash != 0) {
+    auto it = ids_by_hash_.find(function_hash);
+    if (it != ids_by_hash_.end()) {
+      const auto &function = functions_[it->second];
+      if (function.name == function_name &&
+          (function.member_function != nullptr) == is_member) {
+        return &function;
+      }
+    }
+  }
+  const auto &ids_by_name = is_member ? remote_member_funcs_ : remote_funcs_;
+  auto it = ids_by_name.find(function_name);
+  if (it == ids_by_name.end()) {
+    return nullptr;
+  }
+  return &functions_[it->second];
+}
+
+const RemoteFunction &FunctionHelper::GetExecutableFunction(
+    uint64_t function_hash, const std::string &function_name) {
+  auto function = FindExecutableFunction(function_hash, function_name, false);
+  if (function == nullptr) {
     throw RayFunctionNotFound("Executable function not found, the function name " +
                               function_name);
-  } else {
-    return it->second;
   }
+  return *function->function;
 }
 
-const EntryFuntion &FunctionHelper::GetExecutableMemberFunctions(
-    const std::string &function_name) {
-  auto it = remote_member_funcs_.find(function_name);
-  if (it == remote_member_funcs_.end()) {
+const RemoteMemberFunction &FunctionHelper::GetExecutableMemberFunction(
+    uint64_t function_hash, const std::string &function_name) {
+  auto function = FindExecutableFunction(function_hash, function_name, true);
+  if (function == nullptr) {
     throw RayFunctionNotFound("Executable member function not found, the function name " +
                               function_name);
-  } else {
-    return it->second;
   }
+  return *function->member_function;
 }
 
 }  // namespace internal
@@ -23,14 +23,20 @@
 #include <msgpack.hpp>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 using namespace ::ray::internal;
 
 namespace ray {
 namespace internal {
 
-using EntryFuntion = std::function<msgpack::sbuffer(
-    const std::string &, const ArgsBufferList &, msgpack::sbuffer *)>;
+/// An entry of the worker's dispatch table. The invokers live in the function maps of
+/// the loaded library, which is never unloaded once it registered functions.
+struct ExecutableFunction {
+  std::string name;
+  const RemoteFunction *function = nullptr;
+  const RemoteMemberFunction *member_function = nullptr;
+};
 
 class FunctionHelper {
  public:
@@ -44,8 +50,12 @@ class FunctionHelper {
 
   void LoadDll(const std::filesystem::path &lib_path);
   void LoadFunctionsFromPaths(const std::vector<std::string> &paths);
-  const EntryFuntion &GetExecutableFunctions(const std::string &function_name);
-  const EntryFuntion &GetExecutableMemberFunctions(const std::string &function_name);
+  /// Look up a remote function by the name hash from the task spec, falling back to the
+  /// name when the hash is not set (cross-language callers) or collides.
+  const RemoteFunction &GetExecutableFunction(uint64_t function_hash,
+                                              const std::string &function_name);
+  const RemoteMemberFunction &GetExecutableMemberFunction(
+      uint64_t function_hash, const std::string &function_name);
 
  private:
   FunctionHelper() = default;
@@ -53,13 +63,20 @@ class FunctionHelper {
   FunctionHelper(FunctionHelper const &) = delete;
   FunctionHelper(FunctionHelper &&) = delete;
   std::string LoadAllRemoteFunctions(const std::string lib_path,
-                                     const boost::dll::shared_library &lib,
-                                     const EntryFuntion &entry_function);
+                                     const boost::dll::shared_library &lib);
+  size_t AddExecutableFunction(ExecutableFunction function);
+  const ExecutableFunction *FindExecutableFunction(uint64_t function_hash,
+                                                   const std::string &function_name,
+                                                   bool is_member) const;
   std::unordered_map<std::string, std::shared_ptr<boost::dll::shared_library>> libraries_;
-  // Map from remote function name to executable entry function.
-  std::unordered_map<std::string, EntryFuntion> remote_funcs_;
-  // Map from remote member function name to executable entry function.
-  std::unordered_map<std::string, EntryFuntion> remote_member_funcs_;
+  // Dispatch table of all loaded remote functions, indexed by dense function id.
+  std::vector<ExecutableFunction> functions_;
+  // Map from function name hash to function id.
+  std::unordered_map<uint64_t, size_t> ids_by_hash_;
+  // Map from remote function name to function id.
+  std::unordered_map<std::string, size_t> remote_funcs_;
+  // Map from remote member function name to function id.
+  std::unordered_map<std::string, size_t> remote_member_funcs_;
 };
 }  // namespace internal
 }  // namespace ray
\ No newline at end of file
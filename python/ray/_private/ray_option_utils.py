@@ -180,12 +180,6 @@ _task_only_options = {
         "'streaming' instead.",
         default_value=None,
     ),
-    "object_store_memory": Option(  # override "_common_options"
-        (int, type(None)),
-        lambda x: None
-        if (x is None)
-        else "Setting 'object_store_memory' is not implemented for tasks",
-    ),
     "retry_exceptions": Option(
         (bool, list, tuple),
         lambda x: None
@@ -350,8 +344,9 @@ def validate_actor_options(options: Dict[str, Any], in_options: bool):
     if "object_store_memory" in options:
         warnings.warn(
             "Setting 'object_store_memory'"
-            " for actors is deprecated since it doesn't actually"
-            " reserve the required object store memory."
+            " for actors is deprecated since the memory is reserved"
+            " for the whole lifetime of the actor rather than for the"
+            " outputs of its tasks."
             f" Use object spilling that's enabled by default (https://docs.ray.io/en/{get_ray_doc_version()}/ray-core/objects/object-spilling.html) "  # noqa: E501
             "instead to bypass the object store memory size limitation.",
             DeprecationWarning,
@@ -178,7 +178,8 @@ class RemoteFunction:
                 See :ref:`accelerator types <accelerator_types>`.
             memory: The heap memory request in bytes for this task/actor,
                 rounded down to the nearest integer.
-            object_store_memory: The object store memory request for actors only.
+            object_store_memory: The object store memory in bytes to reserve
+                for this task's outputs while it runs.
             max_calls: This specifies the
                 maximum number of times that a given worker can execute
                 the given remote function before it must exit
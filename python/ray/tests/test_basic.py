@@ -14,6 +14,7 @@ from ray._private.test_utils import (
     SignalActor,
     client_test_enabled,
     run_string_as_driver,
+    wait_for_condition,
 )
 from ray.util.scheduling_strategies import PlacementGroupSchedulingStrategy
 
@@ -731,6 +732,34 @@ def test_ray_options(shutdown_only):
     assert memory_available_without_options < memory_available_with_options
 
 
+def test_task_object_store_memory(shutdown_only):
+    ray.init(num_cpus=2, object_store_memory=100 * 2**20)
+
+    @ray.remote(object_store_memory=60 * 2**20)
+    def reserve(signal):
+        ray.get(signal.wait.remote())
+        return b"x" * 2**20
+
+    @ray.remote
+    def f():
+        return 1
+
+    signal = SignalActor.remote()
+    reserving = reserve.remote(signal)
+    # The memory is reserved for as long as the task runs.
+    wait_for_condition(
+        lambda: ray.available_resources().get("object_store_memory", 0) < 40 * 2**20
+    )
+    # So a task that wants more than what's left waits, even though CPUs are free.
+    waiting = f.options(object_store_memory=50 * 2**20).remote()
+    ready, _ = ray.wait([waiting], timeout=2)
+    assert not ready
+
+    ray.get(signal.send.remote())
+    assert len(ray.get(reserving)) == 2**20
+    assert ray.get(waiting) == 1
+
+
 @pytest.mark.skipif(client_test_enabled(), reason="internal api")
 @pytest.mark.parametrize(
     "ray_start_cluster_head",
@@ -221,7 +221,8 @@ class MockTaskInfoAccessor : public TaskInfoAccessor {
  public:
   MOCK_METHOD(Status,
               AsyncAddTaskEventData,
-              (std::unique_ptr<rpc::TaskEventData> data_ptr, StatusCallback callback),
+              (std::unique_ptr<rpc::TaskEventData> data_ptr,
+               MultiItemCallback<int64_t> callback),
               (override));
 };
 
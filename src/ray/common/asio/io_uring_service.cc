@@ -0,0 +1,498 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/asio/io_uring_service.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "ray/common/ray_config.h"
+#include "ray/util/logging.h"
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace ray {
+
+boost::asio::execution_context::id IoUringService::id;
+
+#ifdef __linux__
+
+namespace {
+
+/// The user data of cancellation requests. Operation ids start at 1.
+constexpr uint64_t kCancelUserData = 0;
+
+int SysIoUringSetup(unsigned entries, struct io_uring_params *params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int SysIoUringEnter(int ring_fd,
+                    unsigned to_submit,
+                    unsigned min_complete = 0,
+                    unsigned flags = 0) {
+  return static_cast<int>(syscall(
+      __NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int SysIoUringRegister(int ring_fd, unsigned opcode, void *arg, unsigned nr_args) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+unsigned *RingField(void *ring, uint32_t offset) {
+  return reinterpret_cast<unsigned *>(static_cast<char *>(ring) + offset);
+}
+
+}  // namespace
+
+struct IoUringService::Operation {
+  int fd;
+  bool is_write;
+  /// The buffers, advanced in place as bytes are transferred.
+  std::vector<iovec> iovecs;
+  /// Index of the first iovec that is not yet fully transferred.
+  size_t iovec_index = 0;
+  size_t bytes_transferred = 0;
+  /// Whether Cancel was called for the descriptor. The descriptor may be closed
+  /// and reused afterwards, so the operation must not be resubmitted.
+  bool cancelled = false;
+  Handler handler;
+  /// The message header submitted with sendmsg/recvmsg. It must stay valid until
+  /// the kernel has consumed the submission.
+  struct msghdr msg;
+};
+
+IoUringService::IoUringService(boost::asio::execution_context &context)
+    : boost::asio::execution_context::service(context),
+      io_context_(static_cast<boost::asio::io_context &>(context)) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int ring_fd = SysIoUringSetup(RayConfig::instance().io_uring_queue_depth(), &params);
+  if (ring_fd < 0) {
+    RAY_LOG(WARNING) << "Failed to set up io_uring, falling back to epoll: "
+                     << strerror(errno);
+    return;
+  }
+  ring_fd_ = ring_fd;
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr,
+                  sq_ring_size_,
+                  PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE,
+                  ring_fd_,
+                  IORING_OFF_SQ_RING);
+  if (sq_ring_ != MAP_FAILED) {
+    cq_ring_ = single_mmap ? sq_ring_
+                           : mmap(nullptr,
+                                  cq_ring_size_,
+                                  PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE,
+                                  ring_fd_,
+                                  IORING_OFF_CQ_RING);
+  }
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  if (sq_ring_ != MAP_FAILED && cq_ring_ != MAP_FAILED) {
+    sqes_ = mmap(nullptr,
+                 sqes_size_,
+                 PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE,
+                 ring_fd_,
+                 IORING_OFF_SQES);
+  }
+  if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+    RAY_LOG(WARNING) << "Failed to map io_uring rings, falling back to epoll: "
+                     << strerror(errno);
+    ReleaseRing();
+    return;
+  }
+
+  sq_head_ = RingField(sq_ring_, params.sq_off.head);
+  sq_tail_ = RingField(sq_ring_, params.sq_off.tail);
+  sq_mask_ = RingField(sq_ring_, params.sq_off.ring_mask);
+  sq_array_ = RingField(sq_ring_, params.sq_off.array);
+  sq_entries_ = params.sq_entries;
+  cq_head_ = RingField(cq_ring_, params.cq_off.head);
+  cq_tail_ = RingField(cq_ring_, params.cq_off.tail);
+  cq_mask_ = RingField(cq_ring_, params.cq_off.ring_mask);
+  cqes_ = static_cast<char *>(cq_ring_) + params.cq_off.cqes;
+
+  event_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (event_fd_ < 0 ||
+      SysIoUringRegister(ring_fd_, IORING_REGISTER_EVENTFD, &event_fd_, 1) < 0) {
+    RAY_LOG(WARNING) << "Failed to register io_uring eventfd, falling back to epoll: "
+                     << strerror(errno);
+    ReleaseRing();
+    return;
+  }
+  event_descriptor_ =
+      std::make_unique<boost::asio::posix::stream_descriptor>(io_context_, event_fd_);
+  RAY_LOG(INFO) << "Using io_uring for Unix socket reads and writes with "
+                << sq_entries_ << " submission entries.";
+}
+
+IoUringService::~IoUringService() { ReleaseRing(); }
+
+void IoUringService::shutdown() {
+  absl::MutexLock lock(&mutex_);
+  if (IsAvailable()) {
+    // The kernel may still be reading the message headers and buffers of
+    // submitted operations, so cancel them and wait for their completions before
+    // freeing them.
+    FlushLocked();
+    for (auto &[user_data, operation] : operations_) {
+      operation->cancelled = true;
+      QueueCancel(user_data);
+    }
+    FlushLocked();
+    while (!operations_.empty()) {
+      ReapCompletionsLocked(/*finished=*/nullptr);
+      if (!operations_.empty() &&
+          SysIoUringEnter(ring_fd_, 0, /*min_complete=*/1, IORING_ENTER_GETEVENTS) < 0 &&
+          errno != EINTR) {
+        RAY_LOG(FATAL) << "io_uring_enter failed: " << strerror(errno);
+      }
+    }
+  }
+  // Handlers of outstanding operations are destroyed without being invoked, like
+  // the handlers of any other asio service.
+  operations_.clear();
+  if (event_descriptor_ != nullptr) {
+    boost::system::error_code ec;
+    event_descriptor_->cancel(ec);
+  }
+}
+
+void IoUringService::ReleaseRing() {
+  if (event_descriptor_ != nullptr) {
+    // The descriptor owns and closes the eventfd.
+    event_descriptor_.reset();
+    event_fd_ = -1;
+  } else if (event_fd_ >= 0) {
+    close(event_fd_);
+    event_fd_ = -1;
+  }
+  if (sqes_ != nullptr && sqes_ != MAP_FAILED) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr && sq_ring_ != MAP_FAILED) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  sqes_ = cq_ring_ = sq_ring_ = nullptr;
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+}
+
+void IoUringService::AsyncReadAll(int fd,
+                                  const std::vector<boost::asio::mutable_buffer> &buffers,
+                                  Handler handler) {
+  auto operation = std::make_unique<Operation>();
+  operation->fd = fd;
+  operation->is_write = false;
+  operation->iovecs.reserve(buffers.size());
+  for (const auto &buffer : buffers) {
+    if (buffer.size() > 0) {
+      operation->iovecs.push_back({buffer.data(), buffer.size()});
+    }
+  }
+  operation->handler = std::move(handler);
+  StartOperation(std::move(operation));
+}
+
+void IoUringService::AsyncWriteAll(int fd,
+                                   const std::vector<boost::asio::const_buffer> &buffers,
+                                   Handler handler) {
+  auto operation = std::make_unique<Operation>();
+  operation->fd = fd;
+  operation->is_write = true;
+  operation->iovecs.reserve(buffers.size());
+  for (const auto &buffer : buffers) {
+    if (buffer.size() > 0) {
+      // sendmsg never writes to the buffers.
+      operation->iovecs.push_back({const_cast<void *>(buffer.data()), buffer.size()});
+    }
+  }
+  operation->handler = std::move(handler);
+  StartOperation(std::move(operation));
+}
+
+void IoUringService::StartOperation(std::unique_ptr<Operation> operation) {
+  RAY_CHECK(IsAvailable());
+  if (operation->iovecs.empty()) {
+    // Nothing to transfer, complete right away like boost::asio::async_read.
+    boost::asio::post(io_context_, [handler = std::move(operation->handler)]() {
+      handler(boost::system::error_code(), 0);
+    });
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  uint64_t user_data = next_operation_id_++;
+  auto *operation_ptr = operation.get();
+  operations_.emplace(user_data, std::move(operation));
+  QueueSubmission(user_data, operation_ptr);
+  ArmCompletionWait();
+}
+
+void IoUringService::Cancel(int fd) {
+  if (!IsAvailable()) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  for (const auto &[user_data, operation] : operations_) {
+    if (operation->fd == fd) {
+      operation->cancelled = true;
+      QueueCancel(user_data);
+    }
+  }
+  // Submit right away, since the caller is about to close the descriptor.
+  FlushLocked();
+}
+
+void *IoUringService::GetSubmissionEntry() {
+  unsigned tail = *sq_tail_;
+  if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+    // The ring is full. Without SQPOLL the kernel consumes all the entries
+    // during io_uring_enter, so submitting frees the whole ring.
+    FlushLocked();
+  }
+  unsigned index = tail & *sq_mask_;
+  auto *sqe = static_cast<struct io_uring_sqe *>(sqes_) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  num_unsubmitted_++;
+  if (!flush_scheduled_) {
+    flush_scheduled_ = true;
+    boost::asio::post(io_context_, [this]() { Flush(); });
+  }
+  return sqe;
+}
+
+void IoUringService::QueueSubmission(uint64_t user_data, Operation *operation) {
+  memset(&operation->msg, 0, sizeof(operation->msg));
+  operation->msg.msg_iov = operation->iovecs.data() + operation->iovec_index;
+  operation->msg.msg_iovlen = operation->iovecs.size() - operation->iovec_index;
+
+  auto *sqe = static_cast<struct io_uring_sqe *>(GetSubmissionEntry());
+  sqe->opcode = operation->is_write ? IORING_OP_SENDMSG : IORING_OP_RECVMSG;
+  sqe->fd = operation->fd;
+  sqe->addr = reinterpret_cast<uint64_t>(&operation->msg);
+  sqe->len = 1;
+  // Avoid SIGPIPE when the peer has closed the socket, like asio does.
+  sqe->msg_flags = operation->is_write ? MSG_NOSIGNAL : 0;
+  sqe->user_data = user_data;
+}
+
+void IoUringService::QueueCancel(uint64_t user_data) {
+  auto *sqe = static_cast<struct io_uring_sqe *>(GetSubmissionEntry());
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = user_data;
+  sqe->user_data = kCancelUserData;
+}
+
+void IoUringService::Flush() {
+  absl::MutexLock lock(&mutex_);
+  flush_scheduled_ = false;
+  FlushLocked();
+}
+
+void IoUringService::FlushLocked() {
+  while (num_unsubmitted_ > 0) {
+    int submitted = SysIoUringEnter(ring_fd_, num_unsubmitted_);
+    if (submitted < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        continue;
+      }
+      RAY_LOG(FATAL) << "io_uring_enter failed: " << strerror(errno);
+    }
+    num_unsubmitted_ -= std::min<unsigned>(submitted, num_unsubmitted_);
+  }
+}
+
+void IoUringService::ArmCompletionWait() {
+  if (completion_wait_armed_ || event_descriptor_ == nullptr) {
+    return;
+  }
+  completion_wait_armed_ = true;
+  event_descriptor_->async_wait(boost::asio::posix::stream_descriptor::wait_read,
+                                [this](const boost::system::error_code &ec) {
+                                  if (ec == boost::asio::error::operation_aborted) {
+                                    return;
+                                  }
+                                  ProcessCompletions();
+                                });
+}
+
+void IoUringService::ProcessCompletions() {
+  uint64_t num_events;
+  // Reset the eventfd counter. Completions are read from the ring below.
+  (void)!read(event_fd_, &num_events, sizeof(num_events));
+
+  FinishedOperations finished;
+  {
+    absl::MutexLock lock(&mutex_);
+    completion_wait_armed_ = false;
+    ReapCompletionsLocked(&finished);
+    if (!operations_.empty()) {
+      ArmCompletionWait();
+    }
+  }
+
+  for (auto &[operation, error] : finished) {
+    operation->handler(error, operation->bytes_transferred);
+  }
+}
+
+void IoUringService::ReapCompletionsLocked(FinishedOperations *finished) {
+  auto *cqes = static_cast<struct io_uring_cqe *>(cqes_);
+  unsigned head = *cq_head_;
+  unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  for (; head != tail; head++) {
+    const auto &cqe = cqes[head & *cq_mask_];
+    if (cqe.user_data == kCancelUserData) {
+      continue;
+    }
+    auto it = operations_.find(cqe.user_data);
+    if (it == operations_.end()) {
+      continue;
+    }
+    boost::system::error_code error;
+    bool done = HandleResult(*it->second, cqe.res, &error);
+    if (!done && it->second->cancelled) {
+      // The descriptor may already be closed or reused, so don't submit the
+      // remainder.
+      error = boost::asio::error::operation_aborted;
+      done = true;
+    }
+    if (!done) {
+      // Short transfer, submit the remainder with the next batch.
+      QueueSubmission(it->first, it->second.get());
+    } else {
+      if (finished != nullptr) {
+        finished->emplace_back(std::move(it->second), error);
+      }
+      operations_.erase(it);
+    }
+  }
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+}
+
+bool IoUringService::HandleResult(Operation &operation,
+                                  int result,
+                                  boost::system::error_code *error) {
+  if (result == -EINTR || result == -EAGAIN) {
+    return false;
+  }
+  if (result == -ECANCELED) {
+    *error = boost::asio::error::operation_aborted;
+    return true;
+  }
+  if (result < 0) {
+    *error = boost::system::error_code(-result, boost::system::system_category());
+    return true;
+  }
+  if (result == 0 && !operation.is_write) {
+    *error = boost::asio::error::eof;
+    return true;
+  }
+
+  size_t remaining = static_cast<size_t>(result);
+  operation.bytes_transferred += remaining;
+  while (remaining > 0 && operation.iovec_index < operation.iovecs.size()) {
+    auto &iov = operation.iovecs[operation.iovec_index];
+    size_t consumed = std::min(remaining, iov.iov_len);
+    iov.iov_base = static_cast<char *>(iov.iov_base) + consumed;
+    iov.iov_len -= consumed;
+    remaining -= consumed;
+    if (iov.iov_len == 0) {
+      operation.iovec_index++;
+    }
+  }
+  return operation.iovec_index == operation.iovecs.size();
+}
+
+#else  // __linux__
+
+struct IoUringService::Operation {};
+
+IoUringService::IoUringService(boost::asio::execution_context &context)
+    : boost::asio::execution_context::service(context),
+      io_context_(static_cast<boost::asio::io_context &>(context)) {}
+
+IoUringService::~IoUringService() {}
+
+void IoUringService::shutdown() {}
+
+void IoUringService::ReleaseRing() {}
+
+void IoUringService::AsyncReadAll(int fd,
+                                  const std::vector<boost::asio::mutable_buffer> &buffers,
+                                  Handler handler) {
+  RAY_LOG(FATAL) << "io_uring is only supported on Linux.";
+}
+
+void IoUringService::AsyncWriteAll(int fd,
+                                   const std::vector<boost::asio::const_buffer> &buffers,
+                                   Handler handler) {
+  RAY_LOG(FATAL) << "io_uring is only supported on Linux.";
+}
+
+void IoUringService::Cancel(int fd) {}
+
+void IoUringService::StartOperation(std::unique_ptr<Operation> operation) {}
+
+void IoUringService::ArmCompletionWait() {}
+
+void IoUringService::QueueSubmission(uint64_t user_data, Operation *operation) {}
+
+void IoUringService::QueueCancel(uint64_t user_data) {}
+
+void *IoUringService::GetSubmissionEntry() { return nullptr; }
+
+void IoUringService::Flush() {}
+
+void IoUringService::FlushLocked() {}
+
+void IoUringService::ProcessCompletions() {}
+
+void IoUringService::ReapCompletionsLocked(FinishedOperations *finished) {}
+
+bool IoUringService::HandleResult(Operation &operation,
+                                  int result,
+                                  boost::system::error_code *error) {
+  return true;
+}
+
+#endif  // __linux__
+
+}  // namespace ray
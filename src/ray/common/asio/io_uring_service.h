@@ -0,0 +1,183 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace ray {
+
+/// An io_context service that drives reads and writes on Unix sockets through a
+/// Linux io_uring instead of the epoll reactor.
+///
+/// Operations are queued on the submission ring and submitted in one
+/// io_uring_enter call per event loop turn, so a handler that issues several
+/// reads or writes only pays for one syscall. Completions are signaled through an
+/// eventfd that is waited on by the io_context, and handlers run on the thread(s)
+/// running the io_context, like regular asio completion handlers.
+///
+/// Obtain the instance for an io_context with
+/// boost::asio::use_service<IoUringService>(io_context). If the kernel does not
+/// support io_uring, IsAvailable() returns false and callers should fall back to
+/// boost::asio::async_read / async_write. io_uring is only supported on Linux.
+class IoUringService : public boost::asio::execution_context::service {
+ public:
+  using key_type = IoUringService;
+  using Handler = std::function<void(const boost::system::error_code &, size_t)>;
+
+  static boost::asio::execution_context::id id;
+
+  explicit IoUringService(boost::asio::execution_context &context);
+
+  ~IoUringService() override;
+
+  /// Whether the io_uring instance was set up successfully.
+  bool IsAvailable() const { return ring_fd_ >= 0; }
+
+  /// Read until all the buffers are filled, like boost::asio::async_read.
+  ///
+  /// \param fd The socket to read from.
+  /// \param buffers The buffers to read into. They must stay valid until the
+  /// handler is called.
+  /// \param handler Called with the error, if any, and the bytes read.
+  void AsyncReadAll(int fd,
+                    const std::vector<boost::asio::mutable_buffer> &buffers,
+                    Handler handler);
+
+  /// Write all the buffers, like boost::asio::async_write.
+  ///
+  /// \param fd The socket to write to.
+  /// \param buffers The buffers to write. They must stay valid until the handler
+  /// is called.
+  /// \param handler Called with the error, if any, and the bytes written.
+  void AsyncWriteAll(int fd,
+                     const std::vector<boost::asio::const_buffer> &buffers,
+                     Handler handler);
+
+  /// Cancel all the outstanding operations on a file descriptor. Their handlers
+  /// are called with boost::asio::error::operation_aborted, including operations
+  /// that complete with a short transfer before the cancellation takes effect.
+  /// This should be called before closing the descriptor, since in-flight
+  /// operations hold a reference to the file and would otherwise never complete.
+  ///
+  /// \param fd The file descriptor whose operations to cancel.
+  void Cancel(int fd);
+
+ private:
+  /// An in-flight read or write. Defined in the source file, since it holds the
+  /// platform-specific message header passed to the kernel.
+  struct Operation;
+
+  using FinishedOperations =
+      std::vector<std::pair<std::unique_ptr<Operation>, boost::system::error_code>>;
+
+  /// Cancel all outstanding operations and wait for the kernel to complete them,
+  /// so that their message headers and buffers can be freed.
+  void shutdown() override;
+
+  /// Queue a new operation and submit it with the next batch.
+  void StartOperation(std::unique_ptr<Operation> operation);
+
+  /// Unmap the rings and close the descriptors.
+  void ReleaseRing();
+
+  /// Start waiting on the completion eventfd if not already waiting. The wait is
+  /// only armed while operations are outstanding, so that an idle service does
+  /// not keep io_context::run() from returning.
+  void ArmCompletionWait() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Queue a submission for an operation, scheduling a flush of the submission
+  /// ring if one is not already pending.
+  void QueueSubmission(uint64_t user_data, Operation *operation)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Queue a cancellation of the operation identified by `user_data`.
+  void QueueCancel(uint64_t user_data) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Get a free submission queue entry, submitting queued entries to the kernel
+  /// first if the ring is full.
+  void *GetSubmissionEntry() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Submit all queued entries to the kernel with a single syscall.
+  void Flush();
+  void FlushLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Reap the completion ring and run the handlers of finished operations.
+  void ProcessCompletions();
+
+  /// Consume the completion ring. Short transfers are resubmitted unless the
+  /// operation was cancelled, in which case it finishes with operation_aborted.
+  ///
+  /// \param finished Finished operations and their errors are moved here, or
+  /// dropped without running their handlers if this is nullptr.
+  void ReapCompletionsLocked(FinishedOperations *finished)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Apply a completion result to an operation. Returns true if the operation is
+  /// done and its handler should run with `error`.
+  static bool HandleResult(Operation &operation,
+                           int result,
+                           boost::system::error_code *error);
+
+  boost::asio::io_context &io_context_;
+
+  int ring_fd_ = -1;
+  int event_fd_ = -1;
+#ifdef __linux__
+  std::unique_ptr<boost::asio::posix::stream_descriptor> event_descriptor_;
+#endif
+
+  /// Mappings of the submission and completion rings.
+  void *sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  void *cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0;
+  void *sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  unsigned *sq_head_ = nullptr;
+  unsigned *sq_tail_ = nullptr;
+  unsigned *sq_mask_ = nullptr;
+  unsigned *sq_array_ = nullptr;
+  unsigned sq_entries_ = 0;
+  unsigned *cq_head_ = nullptr;
+  unsigned *cq_tail_ = nullptr;
+  unsigned *cq_mask_ = nullptr;
+  void *cqes_ = nullptr;
+
+  absl::Mutex mutex_;
+
+  /// Number of entries queued on the submission ring but not yet submitted.
+  unsigned num_unsubmitted_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  /// Whether a flush of the submission ring has been posted to the io_context.
+  bool flush_scheduled_ ABSL_GUARDED_BY(mutex_) = false;
+
+  /// Whether an async wait on the completion eventfd is outstanding.
+  bool completion_wait_armed_ ABSL_GUARDED_BY(mutex_) = false;
+
+  uint64_t next_operation_id_ ABSL_GUARDED_BY(mutex_) = 1;
+
+  absl::flat_hash_map<uint64_t, std::unique_ptr<Operation>> operations_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace ray
@@ -125,15 +125,45 @@ ServerConnection::ServerConnection(local_stream_socket &&socket)
       async_write_in_flight_(false),
       async_write_broken_pipe_(false) {
   SetCloseOnFork(socket_);
+  if (RayConfig::instance().unix_socket_use_io_uring()) {
+    auto &io_uring =
+        boost::asio::use_service<IoUringService>(socket_.get_executor().context());
+    if (io_uring.IsAvailable()) {
+      io_uring_ = &io_uring;
+    }
+  }
 }
 
 ServerConnection::~ServerConnection() {
+  if (io_uring_ != nullptr && socket_.is_open()) {
+    io_uring_->Cancel(socket_.native_handle());
+  }
   // If there are any pending messages, invoke their callbacks with an IOError status.
   for (const auto &write_buffer : async_write_queue_) {
     write_buffer->handler(Status::IOError("Connection closed."));
   }
 }
 
+void ServerConnection::AsyncReadAll(
+    const std::vector<boost::asio::mutable_buffer> &buffers,
+    IoUringService::Handler handler) {
+  if (io_uring_ != nullptr) {
+    io_uring_->AsyncReadAll(socket_.native_handle(), buffers, std::move(handler));
+  } else {
+    boost::asio::async_read(socket_, buffers, std::move(handler));
+  }
+}
+
+void ServerConnection::AsyncWriteAll(
+    const std::vector<boost::asio::const_buffer> &buffers,
+    IoUringService::Handler handler) {
+  if (io_uring_ != nullptr) {
+    io_uring_->AsyncWriteAll(socket_.native_handle(), buffers, std::move(handler));
+  } else {
+    boost::asio::async_write(socket_, buffers, std::move(handler));
+  }
+}
+
 Status ServerConnection::WriteBuffer(
     const std::vector<boost::asio::const_buffer> &buffer) {
   boost::system::error_code error;
@@ -167,8 +197,7 @@ void ServerConnection::WriteBufferAsync(
         static_cast<instrumented_io_context &>(socket_.get_executor().context());
     const auto stats_handle =
         io_context.stats().RecordStart("ClientConnection.async_write.WriteBufferAsync");
-    boost::asio::async_write(
-        socket_,
+    AsyncWriteAll(
         buffer,
         [handler, stats_handle = std::move(stats_handle)](
             const boost::system::error_code &ec, size_t bytes_transferred) {
@@ -177,8 +206,7 @@ void ServerConnection::WriteBufferAsync(
               std::move(stats_handle));
         });
   } else {
-    boost::asio::async_write(
-        socket_,
+    AsyncWriteAll(
         buffer,
         [handler](const boost::system::error_code &ec, size_t bytes_transferred) {
           handler(boost_to_ray_status(ec));
@@ -217,8 +245,7 @@ void ServerConnection::ReadBufferAsync(
         static_cast<instrumented_io_context &>(socket_.get_executor().context());
     const auto stats_handle =
         io_context.stats().RecordStart("ServerConnection.async_read.ReadBufferAsync");
-    boost::asio::async_read(
-        socket_,
+    AsyncReadAll(
         buffer,
         [handler, stats_handle = std::move(stats_handle)](
             const boost::system::error_code &ec, size_t bytes_transferred) {
@@ -227,8 +254,7 @@ void ServerConnection::ReadBufferAsync(
               std::move(stats_handle));
         });
   } else {
-    boost::asio::async_read(
-        socket_,
+    AsyncReadAll(
         buffer,
         [handler](const boost::system::error_code &ec, size_t bytes_transferred) {
           handler(boost_to_ray_status(ec));
@@ -354,8 +380,7 @@ void ServerConnection::DoAsyncWrites() {
         static_cast<instrumented_io_context &>(socket_.get_executor().context());
     const auto stats_handle =
         io_context.stats().RecordStart("ClientConnection.async_write.DoAsyncWrites");
-    boost::asio::async_write(
-        socket_,
+    AsyncWriteAll(
         message_buffers,
         [this,
          this_ptr,
@@ -383,8 +408,7 @@ void ServerConnection::DoAsyncWrites() {
               std::move(stats_handle));
         });
   } else {
-    boost::asio::async_write(
-        ServerConnection::socket_,
+    AsyncWriteAll(
         message_buffers,
         [this, this_ptr, num_messages, call_handlers](
             const boost::system::error_code &error, size_t bytes_transferred) {
@@ -455,8 +479,7 @@ void ClientConnection::ProcessMessages() {
         ServerConnection::socket_.get_executor().context());
     const auto stats_handle = io_context.stats().RecordStart(
         "ClientConnection.async_read.ProcessMessageHeader");
-    boost::asio::async_read(
-        ServerConnection::socket_,
+    AsyncReadAll(
         header,
         [this, this_ptr, stats_handle = std::move(stats_handle)](
             const boost::system::error_code &ec, size_t bytes_transferred) {
@@ -465,11 +488,10 @@ void ClientConnection::ProcessMessages() {
               std::move(stats_handle));
         });
   } else {
-    boost::asio::async_read(ServerConnection::socket_,
-                            header,
-                            boost::bind(&ClientConnection::ProcessMessageHeader,
-                                        shared_ClientConnection_from_this(),
-                                        boost::asio::placeholders::error));
+    AsyncReadAll(header,
+                 boost::bind(&ClientConnection::ProcessMessageHeader,
+                             shared_ClientConnection_from_this(),
+                             boost::asio::placeholders::error));
   }
 }
 
@@ -496,20 +518,18 @@ void ClientConnection::ProcessMessageHeader(const boost::system::error_code &err
         ServerConnection::socket_.get_executor().context());
     const auto stats_handle =
         io_context.stats().RecordStart("ClientConnection.async_read.ProcessMessage");
-    boost::asio::async_read(
-        ServerConnection::socket_,
-        boost::asio::buffer(read_message_),
+    AsyncReadAll(
+        {boost::asio::buffer(read_message_)},
         [this, this_ptr, stats_handle = std::move(stats_handle)](
             const boost::system::error_code &ec, size_t bytes_transferred) {
           EventTracker::RecordExecution([this, this_ptr, ec]() { ProcessMessage(ec); },
                                         std::move(stats_handle));
         });
   } else {
-    boost::asio::async_read(ServerConnection::socket_,
-                            boost::asio::buffer(read_message_),
-                            boost::bind(&ClientConnection::ProcessMessage,
-                                        shared_ClientConnection_from_this(),
-                                        boost::asio::placeholders::error));
+    AsyncReadAll({boost::asio::buffer(read_message_)},
+                 boost::bind(&ClientConnection::ProcessMessage,
+                             shared_ClientConnection_from_this(),
+                             boost::asio::placeholders::error));
   }
 }
 
@@ -22,6 +22,7 @@
 #include <memory>
 
 #include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/asio/io_uring_service.h"
 #include "ray/common/common_protocol.h"
 #include "ray/common/id.h"
 #include "ray/common/status.h"
@@ -115,6 +116,9 @@ class ServerConnection : public std::enable_shared_from_this<ServerConnection> {
 
   /// Shuts down socket for this connection.
   void Close() {
+    if (io_uring_ != nullptr) {
+      io_uring_->Cancel(socket_.native_handle());
+    }
     boost::system::error_code ec;
     socket_.close(ec);
   }
@@ -171,6 +175,24 @@ class ServerConnection : public std::enable_shared_from_this<ServerConnection> {
   /// Count of bytes read total.
   int64_t bytes_read_ = 0;
 
+  /// The io_uring service of the socket's io_context, if async reads and writes
+  /// should go through io_uring instead of the epoll reactor.
+  IoUringService *io_uring_ = nullptr;
+
+  /// Asynchronously read until all the buffers are filled.
+  ///
+  /// \param buffers The buffers to read into.
+  /// \param handler A callback to run on read completion.
+  void AsyncReadAll(const std::vector<boost::asio::mutable_buffer> &buffers,
+                    IoUringService::Handler handler);
+
+  /// Asynchronously write all the buffers.
+  ///
+  /// \param buffers The buffers to write.
+  /// \param handler A callback to run on write completion.
+  void AsyncWriteAll(const std::vector<boost::asio::const_buffer> &buffers,
+                     IoUringService::Handler handler);
+
  private:
   /// Asynchronously flushes the write queue. While async writes are running, the flag
   /// async_write_in_flight_ will be set. This should only be called when no async writes
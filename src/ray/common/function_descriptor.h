@@ -267,6 +267,8 @@ class CppFunctionDescriptor : public FunctionDescriptorInterface {
 
   const std::string &Caller() const { return typed_message_->caller(); }
 
+  uint64_t FunctionHash() const { return typed_message_->function_hash(); }
+
  private:
   const rpc::CppFunctionDescriptor *typed_message_;
 };
@@ -334,7 +336,8 @@ class FunctionDescriptorBuilder {
   /// \return a ray::CppFunctionDescriptor
   static FunctionDescriptor BuildCpp(const std::string &function_name,
                                      const std::string &caller = "",
-                                     const std::string &class_name = "");
+                                     const std::string &class_name = "",
+                                     uint64_t function_hash = 0);
 
   /// Build a ray::FunctionDescriptor according to input message.
   ///
@@ -17,12 +17,14 @@
 #include <inttypes.h>
 #include <limits.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <msgpack.hpp>
 #include <mutex>
 #include <random>
 #include <string>
+#include <type_traits>
 
 #include "ray/common/constants.h"
 #include "ray/util/logging.h"
@@ -82,12 +84,9 @@ class BaseID {
       std::memcpy(const_cast<uint8_t *>(this->Data()), binary.data(), Size());
     }
   }
-  // All IDs are immutable for hash evaluations. MutableData is only allow to use
-  // in construction time, so this function is protected.
+  // MutableData is only allow to use in construction time, so this function is
+  // protected.
   uint8_t *MutableData();
-  // For lazy evaluation, be careful to have one Id contained in another.
-  // This hash code will be duplicated.
-  mutable size_t hash_ = 0;
 };
 
 class UniqueID : public BaseID<UniqueID> {
@@ -375,16 +374,16 @@ class PlacementGroupID : public BaseID<PlacementGroupID> {
 
 typedef std::pair<PlacementGroupID, int64_t> BundleID;
 
-static_assert(sizeof(JobID) == JobID::kLength + sizeof(size_t),
-              "JobID size is not as expected");
-static_assert(sizeof(ActorID) == ActorID::kLength + sizeof(size_t),
-              "ActorID size is not as expected");
-static_assert(sizeof(TaskID) == TaskID::kLength + sizeof(size_t),
-              "TaskID size is not as expected");
-static_assert(sizeof(ObjectID) == ObjectID::kLength + sizeof(size_t),
-              "ObjectID size is not as expected");
-static_assert(sizeof(PlacementGroupID) == PlacementGroupID::kLength + sizeof(size_t),
+// BaseID has no members, so the ID bytes start at the beginning of each ID.
+static_assert(sizeof(UniqueID) == kUniqueIDSize, "UniqueID size is not as expected");
+static_assert(sizeof(JobID) == JobID::kLength, "JobID size is not as expected");
+static_assert(sizeof(ActorID) == ActorID::kLength, "ActorID size is not as expected");
+static_assert(sizeof(TaskID) == TaskID::kLength, "TaskID size is not as expected");
+static_assert(sizeof(ObjectID) == ObjectID::kLength, "ObjectID size is not as expected");
+static_assert(sizeof(PlacementGroupID) == PlacementGroupID::kLength,
               "PlacementGroupID size is not as expected");
+static_assert(std::is_trivially_copyable_v<ObjectID>,
+              "ObjectID should be trivially copyable");
 
 std::ostream &operator<<(std::ostream &os, const UniqueID &id);
 std::ostream &operator<<(std::ostream &os, const JobID &id);
@@ -426,8 +425,6 @@ std::ostream &operator<<(std::ostream &os, const PlacementGroupID &id);
 
 template <typename T>
 BaseID<T>::BaseID() {
-  // Using const_cast to directly change data is dangerous. The cached
-  // hash may not be changed. This is used in construction time.
   std::fill_n(this->MutableData(), T::Size(), 0xff);
 }
 
@@ -503,12 +500,25 @@ bool BaseID<T>::IsNil() const {
 
 template <typename T>
 size_t BaseID<T>::Hash() const {
-  // Note(ashione): hash code lazy calculation(it's invoked every time if hash code is
-  // default value 0)
-  if (!hash_) {
-    hash_ = MurmurHash64A(Data(), T::Size(), 0);
+  // IDs are short and of a fixed size, so mixing them 8 bytes at a time in the way
+  // of MurmurHash64A is cheap enough to not cache the hash.
+  constexpr uint64_t kMul = 0xc6a4a7935bd1e995ULL;
+  constexpr int kShift = 47;
+  const uint8_t *data = Data();
+  uint64_t hash = T::Size() * kMul;
+  for (size_t i = 0; i < T::Size(); i += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, std::min(sizeof(uint64_t), T::Size() - i));
+    word *= kMul;
+    word ^= word >> kShift;
+    word *= kMul;
+    hash ^= word;
+    hash *= kMul;
   }
-  return hash_;
+  hash ^= hash >> kShift;
+  hash *= kMul;
+  hash ^= hash >> kShift;
+  return hash;
 }
 
 template <typename T>
@@ -523,12 +533,12 @@ bool BaseID<T>::operator!=(const BaseID &rhs) const {
 
 template <typename T>
 uint8_t *BaseID<T>::MutableData() {
-  return reinterpret_cast<uint8_t *>(this) + sizeof(hash_);
+  return reinterpret_cast<uint8_t *>(this);
 }
 
 template <typename T>
 const uint8_t *BaseID<T>::Data() const {
-  return reinterpret_cast<const uint8_t *>(this) + sizeof(hash_);
+  return reinterpret_cast<const uint8_t *>(this);
 }
 
 template <typename T>
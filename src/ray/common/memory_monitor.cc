@@ -14,11 +14,20 @@
 
 #include "ray/common/memory_monitor.h"
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include <array>
 #include <boost/algorithm/string.hpp>
 #include <filesystem>
 #include <fstream>  // std::ifstream
 #include <tuple>
 
+#include "absl/container/flat_hash_set.h"
 #include "ray/common/ray_config.h"
 #include "ray/util/logging.h"
 #include "ray/util/process.h"
@@ -30,11 +39,13 @@ MemoryMonitor::MemoryMonitor(instrumented_io_context &io_service,
                              float usage_threshold,
                              int64_t min_memory_free_bytes,
                              uint64_t monitor_interval_ms,
-                             MemoryUsageRefreshCallback monitor_callback)
+                             MemoryUsageRefreshCallback monitor_callback,
+                             bool use_pressure_notifications)
     : usage_threshold_(usage_threshold),
       min_memory_free_bytes_(min_memory_free_bytes),
       monitor_callback_(monitor_callback),
-      runner_(io_service) {
+      runner_(io_service),
+      io_service_(io_service) {
   RAY_CHECK(monitor_callback_ != nullptr);
   RAY_CHECK_GE(usage_threshold_, 0);
   RAY_CHECK_LE(usage_threshold_, 1);
@@ -48,21 +59,22 @@ MemoryMonitor::MemoryMonitor(instrumented_io_context &io_service,
                   << computed_threshold_bytes_ << " bytes ("
                   << FormatFloat(computed_threshold_fraction_, 2)
                   << " system memory), total system memory bytes: " << total_memory_bytes;
-    runner_.RunFnPeriodically(
-        [this] {
-          auto [used_memory_bytes, total_memory_bytes] = GetMemoryBytes();
-          MemorySnapshot system_memory;
-          system_memory.used_bytes = used_memory_bytes;
-          system_memory.total_bytes = total_memory_bytes;
-
-          bool is_usage_above_threshold =
-              IsUsageAboveThreshold(system_memory, computed_threshold_bytes_);
-
-          monitor_callback_(
-              is_usage_above_threshold, system_memory, computed_threshold_fraction_);
-        },
-        monitor_interval_ms,
-        "MemoryMonitor.CheckIsMemoryUsageAboveThreshold");
+    if (use_pressure_notifications && InitPressureNotifications()) {
+      RAY_LOG(INFO) << "MemoryMonitor refreshing on memory pressure notifications.";
+      pressure_thread_ = std::make_unique<std::thread>([this, monitor_interval_ms] {
+        SetThreadName("mem.monitor");
+        RunPressureNotificationLoop(monitor_interval_ms);
+      });
+    } else {
+      if (use_pressure_notifications) {
+        RAY_LOG(WARNING) << "Memory pressure notifications are not available on this "
+                         << "node, falling back to polling every " << monitor_interval_ms
+                         << "ms.";
+      }
+      runner_.RunFnPeriodically([this] { RefreshMemoryUsage(); },
+                                monitor_interval_ms,
+                                "MemoryMonitor.CheckIsMemoryUsageAboveThreshold");
+    }
 #else
     RAY_LOG(WARNING) << "Not running MemoryMonitor. It is currently supported "
                      << "only on Linux.";
@@ -73,6 +85,166 @@ MemoryMonitor::MemoryMonitor(instrumented_io_context &io_service,
   }
 }
 
+MemoryMonitor::~MemoryMonitor() {
+#ifdef __linux__
+  if (pressure_thread_ != nullptr) {
+    uint64_t one = 1;
+    RAY_CHECK_EQ(write(wakeup_fd_, &one, sizeof(one)), static_cast<ssize_t>(sizeof(one)));
+    pressure_thread_->join();
+  }
+  ClosePressureNotifications();
+  absl::MutexLock lock(&statm_mutex_);
+  for (const auto &[pid, fd] : statm_fds_) {
+    close(fd);
+  }
+#endif
+}
+
+void MemoryMonitor::RefreshMemoryUsage() {
+  auto [used_memory_bytes, total_memory_bytes] = GetMemoryBytes();
+  MemorySnapshot system_memory;
+  system_memory.used_bytes = used_memory_bytes;
+  system_memory.total_bytes = total_memory_bytes;
+
+  bool is_usage_above_threshold =
+      IsUsageAboveThreshold(system_memory, computed_threshold_bytes_);
+  is_usage_above_threshold_ = is_usage_above_threshold;
+
+  monitor_callback_(is_usage_above_threshold, system_memory, computed_threshold_fraction_);
+}
+
+bool MemoryMonitor::InitPressureNotifications() {
+#ifdef __linux__
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  wakeup_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (epoll_fd_ < 0 || wakeup_fd_ < 0) {
+    RAY_LOG(WARNING) << "Failed to create epoll instance for the memory monitor: "
+                     << strerror(errno);
+    ClosePressureNotifications();
+    return false;
+  }
+  struct epoll_event wakeup_event = {};
+  wakeup_event.events = EPOLLIN;
+  wakeup_event.data.fd = wakeup_fd_;
+  RAY_CHECK_EQ(epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &wakeup_event), 0);
+
+  auto register_fd = [this](int fd, const char *path) {
+    struct epoll_event event = {};
+    event.events = EPOLLPRI;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+      RAY_LOG(WARNING) << "Failed to register " << path
+                       << " with epoll: " << strerror(errno);
+      close(fd);
+      return;
+    }
+    pressure_fds_.push_back(fd);
+  };
+
+  // The PSI trigger fires when tasks are stalled on memory for more than the
+  // configured time within the window. Prefer the cgroup's pressure file so the
+  // trigger is scoped to the container, like the cgroup usage numbers above.
+  const char *psi_path = std::filesystem::exists(kCgroupsV2MemoryPressurePath)
+                             ? kCgroupsV2MemoryPressurePath
+                             : kPsiMemoryPath;
+  int psi_fd = open(psi_path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (psi_fd >= 0) {
+    std::string trigger =
+        "some " +
+        std::to_string(RayConfig::instance().memory_monitor_psi_stall_threshold_us()) +
+        " " + std::to_string(RayConfig::instance().memory_monitor_psi_window_us());
+    if (write(psi_fd, trigger.c_str(), trigger.size() + 1) < 0) {
+      RAY_LOG(WARNING) << "Failed to set PSI trigger \"" << trigger << "\" on "
+                       << psi_path << ": " << strerror(errno);
+      close(psi_fd);
+    } else {
+      register_fd(psi_fd, psi_path);
+    }
+  }
+
+  // memory.events is modified whenever the cgroup hits memory.high or memory.max, or
+  // an OOM kill happens in it.
+  int events_fd = open(kCgroupsV2MemoryEventsPath, O_RDONLY | O_CLOEXEC);
+  if (events_fd >= 0) {
+    register_fd(events_fd, kCgroupsV2MemoryEventsPath);
+  }
+
+  if (pressure_fds_.empty()) {
+    ClosePressureNotifications();
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void MemoryMonitor::RunPressureNotificationLoop(uint64_t monitor_interval_ms) {
+#ifdef __linux__
+  const uint64_t idle_refresh_ms =
+      std::max(monitor_interval_ms,
+               RayConfig::instance().memory_monitor_pressure_idle_refresh_ms());
+  std::array<struct epoll_event, 4> events;
+  // Schedule an initial refresh so that callers see a snapshot even if the node
+  // never comes under pressure.
+  bool should_refresh = true;
+  while (true) {
+    if (should_refresh && !is_refresh_pending_.exchange(true)) {
+      io_service_.post(
+          [this] {
+            is_refresh_pending_ = false;
+            RefreshMemoryUsage();
+          },
+          "MemoryMonitor.OnMemoryPressure");
+    }
+    const uint64_t timeout_ms =
+        is_usage_above_threshold_ ? monitor_interval_ms : idle_refresh_ms;
+    int num_events =
+        epoll_wait(epoll_fd_, events.data(), events.size(), static_cast<int>(timeout_ms));
+    if (num_events < 0) {
+      if (errno == EINTR) {
+        should_refresh = false;
+        continue;
+      }
+      RAY_LOG(ERROR) << "Memory monitor failed to wait for pressure notifications: "
+                     << strerror(errno);
+      return;
+    }
+    // A timeout also refreshes the usage, to catch a slow build up that never stalls.
+    should_refresh = true;
+    for (int i = 0; i < num_events; i++) {
+      int fd = events[i].data.fd;
+      if (fd == wakeup_fd_) {
+        return;
+      }
+      // cgroup files stay readable until they are read again after a change, so
+      // consume the new content to re-arm the notification. PSI triggers re-arm
+      // themselves.
+      char buffer[512];
+      while (pread(fd, buffer, sizeof(buffer), 0) < 0 && errno == EINTR) {
+      }
+    }
+  }
+#endif
+}
+
+void MemoryMonitor::ClosePressureNotifications() {
+#ifdef __linux__
+  for (int fd : pressure_fds_) {
+    close(fd);
+  }
+  pressure_fds_.clear();
+  if (wakeup_fd_ >= 0) {
+    close(wakeup_fd_);
+    wakeup_fd_ = -1;
+  }
+  if (epoll_fd_ >= 0) {
+    close(epoll_fd_);
+    epoll_fd_ = -1;
+  }
+#endif
+}
+
 bool MemoryMonitor::IsUsageAboveThreshold(MemorySnapshot system_memory,
                                           int64_t threshold_bytes) {
   int64_t used_memory_bytes = system_memory.used_bytes;
@@ -455,6 +627,71 @@ const absl::flat_hash_map<pid_t, int64_t> MemoryMonitor::GetProcessMemoryUsage(
   return pid_to_memory_usage;
 }
 
+const absl::flat_hash_map<pid_t, int64_t> MemoryMonitor::GetProcessMemoryUsageFromStatm(
+    const std::vector<pid_t> &pids, const std::string proc_dir) {
+  absl::flat_hash_map<pid_t, int64_t> pid_to_memory_usage;
+#ifdef __linux__
+  static const int64_t page_size_bytes = sysconf(_SC_PAGESIZE);
+  absl::flat_hash_set<pid_t> requested_pids(pids.begin(), pids.end());
+
+  absl::MutexLock lock(&statm_mutex_);
+  for (auto it = statm_fds_.begin(); it != statm_fds_.end();) {
+    if (!requested_pids.contains(it->first)) {
+      close(it->second);
+      statm_fds_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+
+  for (pid_t pid : pids) {
+    auto fd_it = statm_fds_.find(pid);
+    if (fd_it == statm_fds_.end()) {
+      std::string path = proc_dir + "/" + std::to_string(pid) + "/" + kStatmPath;
+      int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) {
+        RAY_LOG_EVERY_MS(INFO, kLogIntervalMs) << " file not found: " << path;
+        continue;
+      }
+      fd_it = statm_fds_.emplace(pid, fd).first;
+    }
+
+    // The fd refers to the process that was alive when it was opened, so reads fail
+    // once it exits even if the pid is reused.
+    char buffer[256];
+    ssize_t num_bytes = pread(fd_it->second, buffer, sizeof(buffer) - 1, 0);
+    if (num_bytes <= 0) {
+      close(fd_it->second);
+      statm_fds_.erase(fd_it);
+      continue;
+    }
+    int64_t memory_used_bytes = GetProcessMemoryBytesFromStatm(
+        std::string(buffer, static_cast<size_t>(num_bytes)), page_size_bytes);
+    if (memory_used_bytes != kNull) {
+      pid_to_memory_usage.insert({pid, memory_used_bytes});
+    }
+  }
+#endif
+  return pid_to_memory_usage;
+}
+
+int64_t MemoryMonitor::GetProcessMemoryBytesFromStatm(const std::string &statm_content,
+                                                      int64_t page_size_bytes) {
+  /// The fields are size, resident, shared, text, lib, data and dt, in pages.
+  std::istringstream iss(statm_content);
+  int64_t size_pages = kNull;
+  int64_t resident_pages = kNull;
+  int64_t shared_pages = kNull;
+  if (!(iss >> size_pages >> resident_pages >> shared_pages)) {
+    RAY_LOG_EVERY_MS(WARNING, kLogIntervalMs)
+        << "Failed to parse statm content: " << statm_content;
+    return kNull;
+  }
+  /// Approximates the private memory that smaps_rollup reports, without walking the
+  /// process' mappings.
+  return std::max<int64_t>(resident_pages - shared_pages, 0) * page_size_bytes;
+}
+
 const std::string MemoryMonitor::TruncateString(const std::string value,
                                                 uint32_t max_length) {
   if (value.length() > max_length) {
@@ -16,8 +16,13 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <atomic>
+#include <thread>
+
+#include "absl/synchronization/mutex.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/asio/periodical_runner.h"
+#include "ray/common/id.h"
 #include "ray/util/process.h"
 
 namespace ray {
@@ -33,6 +38,10 @@ struct MemorySnapshot {
   /// The per-process memory used;
   absl::flat_hash_map<pid_t, int64_t> process_used_bytes;
 
+  /// The primary object store bytes pinned on this node, keyed by the owning worker.
+  /// Only populated by the raylet when the usage is above the threshold.
+  absl::flat_hash_map<WorkerID, int64_t> owner_object_store_bytes;
+
   friend std::ostream &operator<<(std::ostream &os,
                                   const MemorySnapshot &memory_snapshot);
 };
@@ -47,7 +56,10 @@ using MemoryUsageRefreshCallback = std::function<void(
     bool is_usage_above_threshold, MemorySnapshot system_memory, float usage_threshold)>;
 
 /// Monitors the memory usage of the node.
-/// It checks the memory usage p
+/// By default it checks the memory usage periodically. When pressure notifications are
+/// enabled, it instead waits on Linux PSI memory pressure triggers and cgroup v2
+/// `memory.events` through epoll, and only refreshes the usage at the monitoring
+/// interval while the node is under pressure.
 /// This class is thread safe.
 class MemoryMonitor {
  public:
@@ -61,11 +73,17 @@ class MemoryMonitor {
   /// monitor and callbacks won't fire.
   /// \param monitor_callback function to execute on a dedicated thread owned by this
   /// monitor when the usage is refreshed.
+  /// \param use_pressure_notifications whether to refresh the usage on memory pressure
+  /// notifications instead of polling. Falls back to polling if neither PSI nor cgroup
+  /// v2 notifications are available.
   MemoryMonitor(instrumented_io_context &io_service,
                 float usage_threshold,
                 int64_t min_memory_free_bytes,
                 uint64_t monitor_interval_ms,
-                MemoryUsageRefreshCallback monitor_callback);
+                MemoryUsageRefreshCallback monitor_callback,
+                bool use_pressure_notifications = false);
+
+  ~MemoryMonitor();
 
  public:
   /// \param top_n the number of top memory-using processes
@@ -85,6 +103,18 @@ class MemoryMonitor {
   static const absl::flat_hash_map<pid_t, int64_t> GetProcessMemoryUsage(
       const std::string proc_dir = kProcDirectory);
 
+  /// Reads the memory usage of the given processes from /proc/<pid>/statm. The file
+  /// descriptors are kept open across calls so that sampling the same processes again
+  /// only costs one pread each. Descriptors of processes not in `pids` are closed.
+  ///
+  /// \param pids the processes to sample.
+  /// \param proc_dir the directory to scan for the processes
+  ///
+  /// \return the pid to memory usage map for the processes that could be read
+  const absl::flat_hash_map<pid_t, int64_t> GetProcessMemoryUsageFromStatm(
+      const std::vector<pid_t> &pids, const std::string proc_dir = kProcDirectory)
+      ABSL_LOCKS_EXCLUDED(statm_mutex_);
+
  private:
   static constexpr char kCgroupsV1MemoryMaxPath[] =
       "/sys/fs/cgroup/memory/memory.limit_in_bytes";
@@ -100,10 +130,40 @@ class MemoryMonitor {
   static constexpr char kCgroupsV2MemoryStatActiveFileKey[] = "active_file";
   static constexpr char kProcDirectory[] = "/proc";
   static constexpr char kCommandlinePath[] = "cmdline";
+  static constexpr char kStatmPath[] = "statm";
+  static constexpr char kPsiMemoryPath[] = "/proc/pressure/memory";
+  static constexpr char kCgroupsV2MemoryPressurePath[] = "/sys/fs/cgroup/memory.pressure";
+  static constexpr char kCgroupsV2MemoryEventsPath[] = "/sys/fs/cgroup/memory.events";
   /// The logging frequency. Decoupled from how often the monitor runs.
   static constexpr uint32_t kLogIntervalMs = 5000;
   static constexpr int64_t kNull = -1;
 
+  /// Refreshes the memory usage and runs the monitor callback.
+  void RefreshMemoryUsage();
+
+  /// Registers the PSI trigger and the cgroup v2 memory.events file with a new epoll
+  /// instance.
+  ///
+  /// \return true if at least one pressure source was registered.
+  bool InitPressureNotifications();
+
+  /// Waits for pressure notifications and schedules a refresh on the event loop for each
+  /// one. While the usage is above the threshold, it also refreshes every
+  /// monitor_interval_ms so that the killing policy can make progress. Runs until
+  /// `wakeup_fd_` is signaled.
+  void RunPressureNotificationLoop(uint64_t monitor_interval_ms);
+
+  /// Closes the pressure notification file descriptors.
+  void ClosePressureNotifications();
+
+  /// \param statm_content content of a /proc/<pid>/statm file.
+  /// \param page_size_bytes the page size.
+  ///
+  /// \return the resident memory that is not shared with other processes in bytes,
+  /// or kNull if the content is malformed.
+  static int64_t GetProcessMemoryBytesFromStatm(const std::string &statm_content,
+                                                int64_t page_size_bytes);
+
   /// \param system_memory snapshot of system memory information.
   /// \param threshold_bytes usage threshold in bytes.
   /// \return true if the memory usage of this node is above the threshold.
@@ -215,6 +275,8 @@ class MemoryMonitor {
   FRIEND_TEST(MemoryMonitorTest, TestLongStringTruncated);
   FRIEND_TEST(MemoryMonitorTest, TestTopNLessThanNReturnsMemoryUsedDesc);
   FRIEND_TEST(MemoryMonitorTest, TestTopNMoreThanNReturnsAllDesc);
+  FRIEND_TEST(MemoryMonitorTest, TestStatmContentReturnsResidentMinusShared);
+  FRIEND_TEST(MemoryMonitorTest, TestStatmMalformedContentReturnskNull);
 
   /// Memory usage fraction between [0, 1]
   const float usage_threshold_;
@@ -234,6 +296,33 @@ class MemoryMonitor {
   /// on a dedicated thread managed by this class.
   const MemoryUsageRefreshCallback monitor_callback_;
   PeriodicalRunner runner_;
+
+  /// The event loop to run the refreshes triggered by pressure notifications on.
+  instrumented_io_context &io_service_;
+
+  /// Whether the last refresh found the usage above the threshold.
+  std::atomic<bool> is_usage_above_threshold_ = false;
+
+  /// Whether a refresh triggered by a pressure notification is queued on the event loop.
+  /// Used to coalesce bursts of notifications into a single refresh.
+  std::atomic<bool> is_refresh_pending_ = false;
+
+  /// The epoll instance that the pressure sources are registered with.
+  int epoll_fd_ = -1;
+
+  /// The eventfd used to stop the pressure notification thread.
+  int wakeup_fd_ = -1;
+
+  /// The PSI trigger and cgroup memory.events file descriptors.
+  std::vector<int> pressure_fds_;
+
+  /// The thread that waits for pressure notifications.
+  std::unique_ptr<std::thread> pressure_thread_;
+
+  absl::Mutex statm_mutex_;
+
+  /// Open /proc/<pid>/statm file descriptors, keyed by pid.
+  absl::flat_hash_map<pid_t, int> statm_fds_ ABSL_GUARDED_BY(statm_mutex_);
 };
 
 }  // namespace ray
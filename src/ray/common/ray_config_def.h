@@ -68,6 +68,22 @@ RAY_CONFIG(float, memory_usage_threshold, 0.95)
 /// Monitor is disabled when this value is 0.
 RAY_CONFIG(uint64_t, memory_monitor_refresh_ms, 250)
 
+/// If true, the memory monitor waits on Linux PSI memory pressure triggers and cgroup v2
+/// memory.events notifications instead of polling every memory_monitor_refresh_ms, and
+/// only polls at that interval while the usage is above the threshold. Falls back to
+/// polling when neither is available.
+RAY_CONFIG(bool, memory_monitor_use_pressure_notifications, false)
+
+/// The PSI trigger fires when tasks stall on memory for more than
+/// memory_monitor_psi_stall_threshold_us within memory_monitor_psi_window_us.
+/// Unprivileged processes require the window to be a multiple of 2 seconds.
+RAY_CONFIG(uint64_t, memory_monitor_psi_stall_threshold_us, 100000)
+RAY_CONFIG(uint64_t, memory_monitor_psi_window_us, 2000000)
+
+/// With pressure notifications enabled, the interval at which the memory usage is
+/// still refreshed when no notification arrives, to catch a slow build up.
+RAY_CONFIG(uint64_t, memory_monitor_pressure_idle_refresh_ms, 5000)
+
 /// The minimum amount of free space. If the memory is above the
 /// memory_usage_threshold and free space is below min_memory_free_bytes then it
 /// will start killing processes to free up the space. Disabled if it is -1.
@@ -94,6 +110,8 @@ RAY_CONFIG(uint64_t, task_oom_retries, -1)
 /// group_by_owner
 /// retriable_lifo
 /// retriable_fifo
+/// cost_based: minimizes lost task runtime per byte of RSS and owned object store
+/// memory freed.
 RAY_CONFIG(std::string, worker_killing_policy, "group_by_owner")
 
 /// If the raylet fails to get agent info, we will retry after this interval.
@@ -150,6 +168,18 @@ RAY_CONFIG(int64_t, reconstruct_objects_period_milliseconds, 100)
 /// inlined args.
 RAY_CONFIG(int64_t, max_lineage_bytes, 1024 * 1024 * 1024)
 
+/// Task specs of at least this many bytes that are only pinned as lineage are
+/// compressed with LZ4, and count against max_lineage_bytes at their compressed
+/// size. They are decompressed if the task is resubmitted. -1 disables
+/// compression.
+RAY_CONFIG(int64_t, lineage_compression_min_spec_size, -1)
+
+/// Whether to release the lineage of an owned object once it has been spilled
+/// to external storage that doesn't live on any node (e.g., S3). Such objects
+/// are restored from the spilled copy instead of being reconstructed, so long
+/// chains of tasks don't have to be pinned for them.
+RAY_CONFIG(bool, truncate_lineage_on_durable_spill, false)
+
 /// Whether to re-populate plasma memory. This avoids memory allocation failures
 /// at runtime (SIGBUS errors creating new objects), however it will use more memory
 /// upfront and can slow down Ray startup.
@@ -267,6 +297,14 @@ RAY_CONFIG(bool, inline_object_status_in_refs, true)
 RAY_CONFIG(int64_t, raylet_client_num_connect_attempts, 10)
 RAY_CONFIG(int64_t, raylet_client_connect_timeout_milliseconds, 1000)
 
+/// Whether async reads and writes on raylet and plasma store Unix socket
+/// connections go through io_uring instead of the epoll reactor. Falls back to
+/// epoll if io_uring is not supported by the kernel. Linux only.
+RAY_CONFIG(bool, unix_socket_use_io_uring, false)
+
+/// The number of submission queue entries of each io_uring instance.
+RAY_CONFIG(uint32_t, io_uring_queue_depth, 256)
+
 /// The duration that the raylet will wait before reinitiating a
 /// fetch request for a missing task dependency. This time may adapt based on
 /// the number of missing task dependencies.
@@ -300,6 +338,14 @@ RAY_CONFIG(uint32_t, max_num_generator_returns, 100 * 1000 * 1000)
 /// NOTE(swang): Linux only.
 RAY_CONFIG(int, worker_oom_score_adjustment, 1000)
 
+/// If set, the raylet places each worker in its own cgroup v2 child of this directory,
+/// and sets the child's memory.high to the task's `memory` resource request so that
+/// the kernel throttles a worker that uses more than it requested. The directory must
+/// be writable by the raylet, have the memory controller available, and contain no
+/// processes itself. Disabled if empty.
+/// NOTE: Linux only.
+RAY_CONFIG(std::string, worker_cgroup_root, "")
+
 /// Sets workers' nice value on posix systems, so that the OS prioritizes CPU for other
 /// processes over worker. This makes CPU available to GCS, Raylet and user processes
 /// even when workers are busy.
@@ -393,6 +439,39 @@ RAY_CONFIG(std::string, gcs_storage, "memory")
 /// Duration to sleep after failing to put an object in plasma because it is full.
 RAY_CONFIG(uint32_t, object_store_full_delay_ms, 10)
 
+/// How long object creation requests that are smaller than a request blocked on
+/// memory at the head of the plasma create queue may be served ahead of it. After
+/// this, requests are served in order again so the blocked request isn't starved.
+/// 0 disables this.
+RAY_CONFIG(int64_t, plasma_create_request_max_bypass_ms, 10000)
+
+/// Sealed plasma objects at least this many bytes are hashed once no client is
+/// using them, and objects whose contents are identical share a single
+/// allocation. -1 disables content deduplication.
+RAY_CONFIG(int64_t, plasma_dedup_min_object_size, -1)
+
+/// Objects larger than this many bytes are never deduplicated. Hashing runs on the
+/// store's thread and blocks all other requests while it runs.
+RAY_CONFIG(int64_t, plasma_dedup_max_object_size, 16 * 1024 * 1024)
+
+/// When the object store is full, sealed objects at least this many bytes that
+/// would otherwise be evicted are compressed with LZ4 and kept in the store. They
+/// are decompressed when clients get them. -1 disables compression.
+RAY_CONFIG(int64_t, plasma_compression_min_object_size, -1)
+
+/// Objects larger than this many bytes are never compressed. Compression and
+/// decompression run on the store's thread and block all other requests while
+/// they run.
+RAY_CONFIG(int64_t, plasma_compression_max_object_size, 16 * 1024 * 1024)
+
+/// Number of threads that read plasma store client connections. They serve gets,
+/// contains and releases of sealed objects that other clients also use without
+/// the store lock, and pass all other requests to the store's thread. 0 reads
+/// and serves all clients on the store's thread.
+RAY_CONFIG(uint32_t,
+           plasma_store_num_client_io_threads,
+           std::min(4U, std::thread::hardware_concurrency() / 8U))
+
 /// The threshold to trigger a global gc
 RAY_CONFIG(double, high_plasma_storage_usage, 0.7)
 
@@ -508,6 +587,11 @@ RAY_CONFIG(uint64_t,
 /// the message size, and also the processing work on GCS.
 RAY_CONFIG(uint64_t, task_events_send_batch_size, 10 * 1000)
 
+/// Whether workers report status changes of task attempts already reported to GCS
+/// as compact (attempt index, state, timestamp) transitions instead of full task
+/// events.
+RAY_CONFIG(bool, task_events_compact_state_transitions, true)
+
 /// Max number of task events to be written in a single flush iteration. This
 /// caps the number of file writes per iteration.
 RAY_CONFIG(uint64_t, export_task_events_write_batch_size, 10 * 1000)
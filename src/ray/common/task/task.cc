@@ -37,9 +37,19 @@ const std::vector<rpc::ObjectReference> &RayTask::GetDependencies() const {
   return dependencies_;
 }
 
+const std::vector<ObjectID> &RayTask::GetDependencyIds() const {
+  return dependency_ids_;
+}
+
 const std::string &RayTask::GetPreferredNodeID() const { return preferred_node_id_; }
 
-void RayTask::ComputeDependencies() { dependencies_ = task_spec_.GetDependencies(); }
+void RayTask::ComputeDependencies() {
+  dependencies_ = task_spec_.GetDependencies();
+  dependency_ids_.reserve(dependencies_.size());
+  for (const auto &dependency : dependencies_) {
+    dependency_ids_.push_back(ObjectID::FromBinary(dependency.object_id()));
+  }
+}
 
 std::string RayTask::DebugString() const {
   std::ostringstream stream;
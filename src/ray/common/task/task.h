@@ -56,6 +56,12 @@ class RayTask {
   /// \return The object dependencies.
   const std::vector<rpc::ObjectReference> &GetDependencies() const;
 
+  /// Get the IDs of the task's object dependencies, in the same order as
+  /// GetDependencies().
+  ///
+  /// \return The object dependency IDs.
+  const std::vector<ObjectID> &GetDependencyIds() const;
+
   /// Get the task's preferred node id for scheduling. If the returned value
   /// is empty, then it means the task has no preferred node.
   ///
@@ -74,6 +80,8 @@ class RayTask {
   /// A cached copy of the task's object dependencies, including arguments from
   /// the TaskSpecification.
   std::vector<rpc::ObjectReference> dependencies_;
+  /// The IDs of dependencies_.
+  std::vector<ObjectID> dependency_ids_;
 
   std::string preferred_node_id_;
 };
@@ -27,20 +27,31 @@ namespace ray {
 absl::Mutex TaskSpecification::mutex_;
 absl::flat_hash_map<SchedulingClassDescriptor, SchedulingClass>
     TaskSpecification::sched_cls_to_id_;
-absl::flat_hash_map<SchedulingClass, SchedulingClassDescriptor>
+absl::node_hash_map<SchedulingClass, SchedulingClassDescriptor>
     TaskSpecification::sched_id_to_cls_;
 int TaskSpecification::next_sched_id_;
 
 SchedulingClassDescriptor &TaskSpecification::GetSchedulingClassDescriptor(
     SchedulingClass id) {
+  thread_local absl::flat_hash_map<SchedulingClass, SchedulingClassDescriptor *> cache;
+  auto cached = cache.find(id);
+  if (cached != cache.end()) {
+    return *cached->second;
+  }
   absl::MutexLock lock(&mutex_);
   auto it = sched_id_to_cls_.find(id);
   RAY_CHECK(it != sched_id_to_cls_.end()) << "invalid id: " << id;
+  cache.emplace(id, &it->second);
   return it->second;
 }
 
 SchedulingClass TaskSpecification::GetSchedulingClass(
     const SchedulingClassDescriptor &sched_cls) {
+  thread_local absl::flat_hash_map<SchedulingClassDescriptor, SchedulingClass> cache;
+  auto cached = cache.find(sched_cls);
+  if (cached != cache.end()) {
+    return cached->second;
+  }
   SchedulingClass sched_cls_id;
   absl::MutexLock lock(&mutex_);
   auto it = sched_cls_to_id_.find(sched_cls);
@@ -57,6 +68,7 @@ SchedulingClass TaskSpecification::GetSchedulingClass(
   } else {
     sched_cls_id = it->second;
   }
+  cache.emplace(sched_cls, sched_cls_id);
   return sched_cls_id;
 }
 
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/node_hash_map.h"
 #include "absl/synchronization/mutex.h"
 #include "ray/common/function_descriptor.h"
 #include "ray/common/grpc_util.h"
@@ -476,10 +477,12 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
   // A one-word summary of the task func as a call site (e.g., __main__.foo).
   std::string CallSiteString() const;
 
-  // Lookup the resource shape that corresponds to the static key.
+  // Lookup the resource shape that corresponds to the static key. Lookups are cached
+  // per thread, so the global mutex is only taken the first time a thread sees a key.
   static SchedulingClassDescriptor &GetSchedulingClassDescriptor(SchedulingClass id);
 
-  // Compute a static key that represents the given resource shape.
+  // Compute a static key that represents the given resource shape. Like
+  // GetSchedulingClassDescriptor, this is cached per thread.
   static SchedulingClass GetSchedulingClass(const SchedulingClassDescriptor &sched_cls);
 
   // Placement Group bundle that this task or actor creation is associated with.
@@ -521,10 +524,12 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
   /// Below static fields could be mutated in `ComputeResources` concurrently due to
   /// multi-threading, we need a mutex to protect it.
   static absl::Mutex mutex_;
-  /// Keep global static id mappings for SchedulingClass for performance.
+  /// Keep global static id mappings for SchedulingClass for performance. Entries are
+  /// never removed, and descriptors are stored in a node_hash_map so that references
+  /// to them stay valid, which makes it safe to cache them per thread.
   static absl::flat_hash_map<SchedulingClassDescriptor, SchedulingClass> sched_cls_to_id_
       ABSL_GUARDED_BY(mutex_);
-  static absl::flat_hash_map<SchedulingClass, SchedulingClassDescriptor> sched_id_to_cls_
+  static absl::node_hash_map<SchedulingClass, SchedulingClassDescriptor> sched_id_to_cls_
       ABSL_GUARDED_BY(mutex_);
   static int next_sched_id_ ABSL_GUARDED_BY(mutex_);
 };
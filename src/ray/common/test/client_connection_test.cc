@@ -22,11 +22,16 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/asio/io_uring_service.h"
+#include "ray/common/ray_config.h"
+#include "ray/util/util.h"
 
 namespace ray {
 namespace raylet {
 
-class ClientConnectionTest : public ::testing::Test {
+/// Runs every test with epoll and io_uring as the backend of the async socket
+/// operations.
+class ClientConnectionTest : public ::testing::TestWithParam<bool> {
  public:
   ClientConnectionTest()
       : io_service_(), in_(io_service_), out_(io_service_), error_message_type_(1) {
@@ -45,6 +50,20 @@ class ClientConnectionTest : public ::testing::Test {
 #endif
   }
 
+  void SetUp() override {
+    RayConfig::instance().initialize(GetParam()
+                                         ? R"({"unix_socket_use_io_uring": true})"
+                                         : R"({"unix_socket_use_io_uring": false})");
+    if (GetParam() &&
+        !boost::asio::use_service<IoUringService>(io_service_).IsAvailable()) {
+      GTEST_SKIP() << "io_uring is not supported on this platform.";
+    }
+  }
+
+  void TearDown() override {
+    RayConfig::instance().initialize(R"({"unix_socket_use_io_uring": false})");
+  }
+
   ray::Status WriteBadMessage(std::shared_ptr<ray::ClientConnection> conn,
                               int64_t type,
                               int64_t length,
@@ -65,7 +84,7 @@ class ClientConnectionTest : public ::testing::Test {
   int64_t error_message_type_;
 };
 
-TEST_F(ClientConnectionTest, SimpleSyncWrite) {
+TEST_P(ClientConnectionTest, SimpleSyncWrite) {
   const uint8_t arr[5] = {1, 2, 3, 4, 5};
   int num_messages = 0;
 
@@ -93,7 +112,7 @@ TEST_F(ClientConnectionTest, SimpleSyncWrite) {
   ASSERT_EQ(num_messages, 2);
 }
 
-TEST_F(ClientConnectionTest, SimpleAsyncWrite) {
+TEST_P(ClientConnectionTest, SimpleAsyncWrite) {
   const uint8_t msg1[5] = {1, 2, 3, 4, 5};
   const uint8_t msg2[5] = {4, 4, 4, 4, 4};
   const uint8_t msg3[5] = {8, 8, 8, 8, 8};
@@ -146,7 +165,7 @@ TEST_F(ClientConnectionTest, SimpleAsyncWrite) {
   ASSERT_EQ(num_messages, 3);
 }
 
-TEST_F(ClientConnectionTest, SimpleSyncReadWriteMessage) {
+TEST_P(ClientConnectionTest, SimpleSyncReadWriteMessage) {
   auto writer = ServerConnection::Create(std::move(in_));
   auto reader = ServerConnection::Create(std::move(out_));
 
@@ -158,7 +177,7 @@ TEST_F(ClientConnectionTest, SimpleSyncReadWriteMessage) {
   RAY_CHECK(write_buffer == read_buffer);
 }
 
-TEST_F(ClientConnectionTest, SimpleAsyncReadWriteBuffers) {
+TEST_P(ClientConnectionTest, SimpleAsyncReadWriteBuffers) {
   auto writer = ServerConnection::Create(std::move(in_));
   auto reader = ServerConnection::Create(std::move(out_));
 
@@ -176,7 +195,7 @@ TEST_F(ClientConnectionTest, SimpleAsyncReadWriteBuffers) {
   io_service_.run();
 }
 
-TEST_F(ClientConnectionTest, SimpleAsyncError) {
+TEST_P(ClientConnectionTest, SimpleAsyncError) {
   const uint8_t msg1[5] = {1, 2, 3, 4, 5};
 
   ClientHandler client_handler = [](ClientConnection &client) {};
@@ -197,7 +216,29 @@ TEST_F(ClientConnectionTest, SimpleAsyncError) {
   io_service_.run();
 }
 
-TEST_F(ClientConnectionTest, CallbackWithSharedRefDoesNotLeakConnection) {
+TEST_P(ClientConnectionTest, CloseCancelsPendingRead) {
+  ClientHandler client_handler = [](ClientConnection &client) {};
+
+  MessageHandler noop_handler = [](std::shared_ptr<ClientConnection> client,
+                                   int64_t message_type,
+                                   const std::vector<uint8_t> &message) {};
+
+  auto reader = ClientConnection::Create(
+      client_handler, noop_handler, std::move(out_), "reader", {}, error_message_type_);
+
+  uint8_t buffer[5];
+  bool read_done = false;
+  reader->ReadBufferAsync({boost::asio::buffer(buffer)},
+                          [&read_done](const ray::Status &status) {
+                            ASSERT_FALSE(status.ok());
+                            read_done = true;
+                          });
+  io_service_.post([reader]() { reader->Close(); }, "ClientConnectionTest.Close");
+  io_service_.run();
+  ASSERT_TRUE(read_done);
+}
+
+TEST_P(ClientConnectionTest, CallbackWithSharedRefDoesNotLeakConnection) {
   const uint8_t msg1[5] = {1, 2, 3, 4, 5};
 
   ClientHandler client_handler = [](ClientConnection &client) {};
@@ -218,7 +259,7 @@ TEST_F(ClientConnectionTest, CallbackWithSharedRefDoesNotLeakConnection) {
   io_service_.run();
 }
 
-TEST_F(ClientConnectionTest, ProcessBadMessage) {
+TEST_P(ClientConnectionTest, ProcessBadMessage) {
   const uint8_t arr[5] = {1, 2, 3, 4, 5};
   int num_messages = 0;
 
@@ -253,6 +294,77 @@ TEST_F(ClientConnectionTest, ProcessBadMessage) {
   ASSERT_EQ(num_messages, 0);
 }
 
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && !defined(_WIN32)
+/// Benchmark the rate of small async messages between two connections, with the
+/// epoll reactor and with io_uring.
+TEST_P(ClientConnectionTest, AsyncMessageRateByBackend) {
+  if (!GetParam()) {
+    GTEST_SKIP() << "The benchmark measures both backends in the io_uring instance.";
+  }
+  const int num_messages = 100000;
+  const uint8_t msg[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  ClientHandler client_handler = [](ClientConnection &client) {};
+  MessageHandler noop_handler = [](std::shared_ptr<ClientConnection> client,
+                                   int64_t message_type,
+                                   const std::vector<uint8_t> &message) {};
+
+  auto measure_message_rate = [&](bool use_io_uring) {
+    RayConfig::instance().initialize(
+        use_io_uring ? R"({"unix_socket_use_io_uring": true})"
+                     : R"({"unix_socket_use_io_uring": false})");
+    instrumented_io_context io_service;
+    boost::asio::local::stream_protocol::socket input(io_service), output(io_service);
+    boost::asio::local::connect_pair(input, output);
+    local_stream_socket in(io_service), out(io_service);
+    in = std::move(input);
+    out = std::move(output);
+
+    int num_received = 0;
+    MessageHandler message_handler = [&](std::shared_ptr<ClientConnection> client,
+                                         int64_t message_type,
+                                         const std::vector<uint8_t> &message) {
+      ASSERT_TRUE(!std::memcmp(msg, message.data(), sizeof(msg)));
+      if (++num_received < num_messages) {
+        client->ProcessMessages();
+      }
+    };
+    auto writer = ClientConnection::Create(
+        client_handler, noop_handler, std::move(in), "writer", {}, error_message_type_);
+    auto reader = ClientConnection::Create(client_handler,
+                                           message_handler,
+                                           std::move(out),
+                                           "reader",
+                                           {},
+                                           error_message_type_);
+
+    int64_t start_time = current_time_ms();
+    for (int i = 0; i < num_messages; i++) {
+      writer->WriteMessageAsync(0, sizeof(msg), msg, [](const ray::Status &status) {
+        RAY_CHECK_OK(status);
+      });
+    }
+    reader->ProcessMessages();
+    io_service.run();
+    int64_t elapsed_ms = std::max<int64_t>(current_time_ms() - start_time, 1);
+    EXPECT_EQ(num_received, num_messages);
+    return num_messages * 1000.0 / elapsed_ms;
+  };
+
+  double epoll_rate = measure_message_rate(false);
+  double io_uring_rate = measure_message_rate(true);
+  RayConfig::instance().initialize(R"({"unix_socket_use_io_uring": false})");
+  RAY_LOG(INFO) << "Async messages per second: epoll " << epoll_rate << ", io_uring "
+                << io_uring_rate;
+}
+#endif
+
+INSTANTIATE_TEST_SUITE_P(Backends,
+                         ClientConnectionTest,
+                         ::testing::Bool(),
+                         [](const ::testing::TestParamInfo<bool> &info) {
+                           return info.param ? "IoUring" : "Epoll";
+                         });
+
 }  // namespace raylet
 
 }  // namespace ray
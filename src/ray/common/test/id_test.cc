@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/time/clock.h"
 #include "gtest/gtest.h"
 #include "ray/common/common_protocol.h"
 #include "ray/common/task/task_spec.h"
@@ -137,6 +140,49 @@ TEST(HashTest, TestNilHash) {
   ASSERT_NE(id1.Hash(), id2.Hash());
 }
 
+TEST(HashTest, TestHashObjectIDsOfSameTask) {
+  // Object IDs of the same task only differ in their index bytes.
+  const auto task_id = TaskID::FromRandom(JobID::FromInt(1));
+  absl::flat_hash_set<size_t> hashes;
+  for (int64_t index = 1; index <= 1000; ++index) {
+    hashes.insert(ObjectID::FromIndex(task_id, index).Hash());
+  }
+  ASSERT_EQ(hashes.size(), 1000);
+}
+
+TEST(HashTest, TestMapThroughput) {
+  const size_t num_tasks = 100 * 1000;
+  const size_t num_returns = 10;
+  std::vector<ObjectID> object_ids;
+  object_ids.reserve(num_tasks * num_returns);
+  for (size_t i = 0; i < num_tasks; ++i) {
+    const auto task_id = TaskID::FromRandom(JobID::FromInt(1));
+    for (size_t index = 1; index <= num_returns; ++index) {
+      object_ids.push_back(ObjectID::FromIndex(task_id, index));
+    }
+  }
+
+  absl::flat_hash_map<ObjectID, size_t> map;
+  auto start = absl::Now();
+  for (size_t i = 0; i < object_ids.size(); ++i) {
+    map.emplace(object_ids[i], i);
+  }
+  auto insert_elapsed = absl::ToDoubleSeconds(absl::Now() - start);
+
+  start = absl::Now();
+  size_t num_found = 0;
+  for (const auto &object_id : object_ids) {
+    num_found += map.count(object_id);
+  }
+  auto lookup_elapsed = absl::ToDoubleSeconds(absl::Now() - start);
+
+  RAY_LOG(INFO) << object_ids.size() << " object IDs: "
+                << object_ids.size() / insert_elapsed << " inserts/s, "
+                << object_ids.size() / lookup_elapsed << " lookups/s.";
+  ASSERT_EQ(map.size(), object_ids.size());
+  ASSERT_EQ(num_found, object_ids.size());
+}
+
 TEST(PlacementGroupIDTest, TestPlacementGroup) {
   {
     // test from binary
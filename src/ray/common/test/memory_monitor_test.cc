@@ -15,6 +15,7 @@
 #include "ray/common/memory_monitor.h"
 
 #include <sys/sysinfo.h>
+#include <unistd.h>
 
 #include <boost/filesystem.hpp>
 #include <boost/thread/latch.hpp>
@@ -62,12 +63,14 @@ class MemoryMonitorTest : public ::testing::Test {
   MemoryMonitor &MakeMemoryMonitor(float usage_threshold,
                                    int64_t min_memory_free_bytes,
                                    uint64_t monitor_interval_ms,
-                                   MemoryUsageRefreshCallback monitor_callback) {
+                                   MemoryUsageRefreshCallback monitor_callback,
+                                   bool use_pressure_notifications = false) {
     instance = std::make_unique<MemoryMonitor>(io_context_,
                                                usage_threshold,
                                                min_memory_free_bytes,
                                                monitor_interval_ms,
-                                               std::move(monitor_callback));
+                                               std::move(monitor_callback),
+                                               use_pressure_notifications);
     return *instance;
   }
   std::unique_ptr<MemoryMonitor> instance;
@@ -478,6 +481,78 @@ TEST_F(MemoryMonitorTest, TestGetProcessMemoryUsageFiltersBadPids) {
   ASSERT_TRUE(usage.contains(1));
 }
 
+TEST_F(MemoryMonitorTest, TestStatmContentReturnsResidentMinusShared) {
+  ASSERT_EQ(MemoryMonitor::GetProcessMemoryBytesFromStatm("1000 300 100 10 0 200 0\n",
+                                                          4096),
+            200 * 4096);
+  ASSERT_EQ(MemoryMonitor::GetProcessMemoryBytesFromStatm("1000 100 300 10 0 200 0\n",
+                                                          4096),
+            0);
+}
+
+TEST_F(MemoryMonitorTest, TestStatmMalformedContentReturnskNull) {
+  ASSERT_EQ(MemoryMonitor::GetProcessMemoryBytesFromStatm("", 4096),
+            MemoryMonitor::kNull);
+  ASSERT_EQ(MemoryMonitor::GetProcessMemoryBytesFromStatm("1000 abc", 4096),
+            MemoryMonitor::kNull);
+}
+
+TEST_F(MemoryMonitorTest, TestGetProcessMemoryUsageFromStatmRereadsOpenFile) {
+  auto &monitor = MakeMemoryMonitor(
+      0 /*usage_threshold*/,
+      -1 /*min_memory_free_bytes*/,
+      0 /*refresh_interval_ms*/,
+      [](bool is_usage_above_threshold,
+         MemorySnapshot system_memory,
+         float usage_threshold) { FAIL() << "Expected monitor to not run"; });
+  std::string proc_dir = UniqueID::FromRandom().Hex();
+  boost::filesystem::create_directories(proc_dir + "/123");
+  std::string statm_filename = proc_dir + "/123/statm";
+  int64_t page_size = sysconf(_SC_PAGESIZE);
+
+  std::ofstream statm_file;
+  statm_file.open(statm_filename);
+  statm_file << "1000 300 100 10 0 200 0" << std::endl;
+  statm_file.close();
+
+  auto usage = monitor.GetProcessMemoryUsageFromStatm({123, 456}, proc_dir);
+  ASSERT_EQ(usage.size(), 1);
+  ASSERT_EQ(usage[123], 200 * page_size);
+
+  // Rewriting the file in place is visible through the cached descriptor.
+  statm_file.open(statm_filename);
+  statm_file << "1000 500 100 10 0 400 0" << std::endl;
+  statm_file.close();
+
+  usage = monitor.GetProcessMemoryUsageFromStatm({123}, proc_dir);
+  boost::filesystem::remove_all(proc_dir);
+
+  ASSERT_EQ(usage.size(), 1);
+  ASSERT_EQ(usage[123], 400 * page_size);
+}
+
+TEST_F(MemoryMonitorTest, TestPressureNotificationsCallbackExecuted) {
+  // Falls back to polling when PSI and cgroup v2 are not available, so the callback
+  // runs either way.
+  std::shared_ptr<boost::latch> has_checked_once = std::make_shared<boost::latch>(1);
+
+  MakeMemoryMonitor(
+      0.4 /*usage_threshold*/,
+      -1 /*min_memory_free_bytes*/,
+      1 /*refresh_interval_ms*/,
+      [has_checked_once](bool is_usage_above_threshold,
+                         MemorySnapshot system_memory,
+                         float usage_threshold) {
+        ASSERT_FLOAT_EQ(0.4f, usage_threshold);
+        ASSERT_GT(system_memory.total_bytes, 0);
+        ASSERT_GT(system_memory.used_bytes, 0);
+        has_checked_once->count_down();
+      },
+      true /*use_pressure_notifications*/);
+
+  has_checked_once->wait();
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -328,7 +328,8 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
       /*object_info_publisher=*/object_info_publisher_.get(),
       /*object_info_subscriber=*/object_info_subscriber_.get(),
       check_node_alive_fn,
-      RayConfig::instance().lineage_pinning_enabled());
+      RayConfig::instance().lineage_pinning_enabled(),
+      RayConfig::instance().truncate_lineage_on_durable_spill());
 
   if (RayConfig::instance().max_pending_lease_requests_per_scheduling_category() > 0) {
     lease_request_rate_limiter_ = std::make_shared<StaticLeaseRequestRateLimiter>(
@@ -1306,6 +1307,77 @@ Status CoreWorker::Put(const RayObject &object,
   return PutInLocalPlasmaStore(object, object_id, pin_object);
 }
 
+Status CoreWorker::PutBatch(const std::vector<std::shared_ptr<RayObject>> &objects,
+                            std::vector<ObjectID> *object_ids) {
+  object_ids->clear();
+  object_ids->reserve(objects.size());
+  // The objects that were newly created in plasma and still need to be pinned.
+  std::vector<ObjectID> pin_ids;
+  Status put_status;
+  for (const auto &object : objects) {
+    const auto object_id = ObjectID::FromIndex(worker_context_.GetCurrentInternalTaskId(),
+                                               worker_context_.GetNextPutIndex());
+    reference_counter_->AddOwnedObject(object_id,
+                                       /*contained_ids=*/{},
+                                       rpc_address_,
+                                       CurrentCallSite(),
+                                       object->GetSize(),
+                                       /*is_reconstructable=*/false,
+                                       /*add_local_ref=*/true,
+                                       NodeID::FromBinary(rpc_address_.raylet_id()));
+    object_ids->push_back(object_id);
+    if (options_.is_local_mode) {
+      RAY_CHECK(memory_store_->Put(*object, object_id));
+      continue;
+    }
+    bool object_exists;
+    put_status = plasma_store_provider_->Put(
+        *object, object_id, /*owner_address=*/rpc_address_, &object_exists);
+    if (!put_status.ok()) {
+      break;
+    }
+    if (!object_exists) {
+      pin_ids.push_back(object_id);
+    }
+  }
+
+  if (!put_status.ok()) {
+    for (const auto &object_id : pin_ids) {
+      RAY_UNUSED(plasma_store_provider_->Release(object_id));
+    }
+    for (const auto &object_id : *object_ids) {
+      RemoveLocalReference(object_id);
+    }
+    object_ids->clear();
+    return put_status;
+  }
+
+  if (!pin_ids.empty()) {
+    RAY_LOG(DEBUG) << "Pinning " << pin_ids.size() << " put objects";
+    local_raylet_client_->PinObjectIDs(
+        rpc_address_,
+        pin_ids,
+        /*generator_id=*/ObjectID::Nil(),
+        [this, pin_ids](const Status &status, const rpc::PinObjectIDsReply &reply) {
+          // Only release the objects once the raylet has responded to avoid the race
+          // condition that they could be evicted before the raylet pins them.
+          for (const auto &object_id : pin_ids) {
+            if (!plasma_store_provider_->Release(object_id).ok()) {
+              RAY_LOG(ERROR).WithField(object_id)
+                  << "Failed to release object, might cause a leak in plasma.";
+            }
+          }
+        });
+  }
+  if (!options_.is_local_mode) {
+    for (const auto &object_id : *object_ids) {
+      RAY_CHECK(
+          memory_store_->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA), object_id));
+    }
+  }
+  return Status::OK();
+}
+
 Status CoreWorker::CreateOwnedAndIncrementLocalRef(
     bool is_experimental_mutable_object,
     const std::shared_ptr<Buffer> &metadata,
@@ -1457,6 +1529,20 @@ Status CoreWorker::SealOwned(const ObjectID &object_id,
   return status;
 }
 
+Status CoreWorker::AbortOwned(const ObjectID &object_id) {
+  Status status = Status::OK();
+  // In local mode the object may live in a local buffer that plasma never saw.
+  if (!options_.is_local_mode) {
+    status = plasma_store_provider_->Abort(object_id);
+    if (!status.ok()) {
+      RAY_LOG(WARNING).WithField(object_id)
+          << "Failed to abort unsealed object, might cause a leak in plasma: " << status;
+    }
+  }
+  RemoveLocalReference(object_id);
+  return status;
+}
+
 Status CoreWorker::SealExisting(const ObjectID &object_id,
                                 bool pin_object,
                                 const ObjectID &generator_id,
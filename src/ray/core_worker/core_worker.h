@@ -577,6 +577,17 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
              const ObjectID &object_id,
              bool pin_object = false);
 
+  /// Put a batch of objects into object store. This is equivalent to calling
+  /// `Put()` for each object, except that all of the new plasma objects are pinned
+  /// at the raylet with a single request. If any put fails, none of the objects stay
+  /// in scope.
+  ///
+  /// \param[in] objects The ray objects. They may not contain other object IDs.
+  /// \param[out] object_ids Generated IDs of the objects, in the same order.
+  /// \return Status.
+  Status PutBatch(const std::vector<std::shared_ptr<RayObject>> &objects,
+                  std::vector<ObjectID> *object_ids);
+
   /// Create and return a buffer in the object store that can be directly written
   /// into. After writing to the buffer, the caller must call `SealOwned()` to
   /// finalize the object. The `CreateOwnedAndIncrementLocalRef()` and
@@ -649,6 +660,15 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
                    bool pin_object,
                    const std::unique_ptr<rpc::Address> &owner_address = nullptr);
 
+  /// Discard an object created with `CreateOwnedAndIncrementLocalRef()` that
+  /// will never be sealed, e.g. because filling its buffer failed. The unsealed
+  /// plasma object is aborted and the initial local reference is removed. The
+  /// caller must have dropped its reference to the buffer beforehand.
+  ///
+  /// \param[in] object_id Object ID corresponding to the object.
+  /// \return Status.
+  Status AbortOwned(const ObjectID &object_id);
+
   /// Finalize placing an object into the object store. This should be called after
   /// a corresponding `CreateExisting()` call and then writing into the returned buffer.
   ///
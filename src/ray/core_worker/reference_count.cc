@@ -1426,6 +1426,19 @@ bool ReferenceCounter::HandleObjectSpilled(const ObjectID &object_id,
       it->second.spilled_node_id = spilled_node_id;
     }
     PushToLocationSubscribers(it);
+    if (truncate_lineage_on_durable_spill_ && spilled_node_id.IsNil() &&
+        !it->second.spilled_url.empty() && it->second.is_reconstructable) {
+      // The spilled copy doesn't depend on any node, so the object no longer
+      // needs lineage to be recovered. Releasing it here also releases the
+      // lineage of the object's arguments that are no longer needed.
+      RAY_LOG(DEBUG).WithField(object_id) << "Truncating lineage of spilled object";
+      auto index_it = reconstructable_owned_objects_index_.find(object_id);
+      if (index_it != reconstructable_owned_objects_index_.end()) {
+        reconstructable_owned_objects_.erase(index_it->second);
+        reconstructable_owned_objects_index_.erase(index_it);
+      }
+      ReleaseLineageReferences(it);
+    }
   } else {
     RAY_LOG(DEBUG).WithField(spilled_node_id).WithField(object_id)
         << "Object spilled to dead node ";
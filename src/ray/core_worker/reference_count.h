@@ -75,9 +75,11 @@ class ReferenceCounter : public ReferenceCounterInterface,
                    pubsub::PublisherInterface *object_info_publisher,
                    pubsub::SubscriberInterface *object_info_subscriber,
                    const std::function<bool(const NodeID &node_id)> &check_node_alive,
-                   bool lineage_pinning_enabled = false)
+                   bool lineage_pinning_enabled = false,
+                   bool truncate_lineage_on_durable_spill = false)
       : rpc_address_(rpc_address),
         lineage_pinning_enabled_(lineage_pinning_enabled),
+        truncate_lineage_on_durable_spill_(truncate_lineage_on_durable_spill),
         object_info_publisher_(object_info_publisher),
         object_info_subscriber_(object_info_subscriber),
         check_node_alive_(check_node_alive) {}
@@ -524,7 +526,9 @@ class ReferenceCounter : public ReferenceCounterInterface,
   /// Handle an object has been spilled to external storage.
   ///
   /// This notifies the primary raylet that the object is safe to release and
-  /// records the spill URL, spill node ID, and updated object size.
+  /// records the spill URL, spill node ID, and updated object size. If the
+  /// object was spilled to storage that doesn't live on any node and lineage
+  /// truncation is enabled, this also releases the object's lineage.
   /// \param[in] object_id The object that has been spilled.
   /// \param[in] spilled_url The URL to which the object has been spilled.
   /// \param[in] spilled_node_id The ID of the node on which the object was spilled.
@@ -1028,6 +1032,11 @@ class ReferenceCounter : public ReferenceCounterInterface,
   /// tasks that depend on that object that may be retried in the future.
   const bool lineage_pinning_enabled_;
 
+  /// Whether to release the lineage of owned objects once they are spilled to
+  /// external storage that doesn't live on any node. These objects are
+  /// restored from the spilled copy rather than reconstructed.
+  const bool truncate_lineage_on_durable_spill_;
+
   /// Protects access to the reference counting state.
   mutable absl::Mutex mutex_;
 
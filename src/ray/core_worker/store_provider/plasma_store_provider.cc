@@ -164,6 +164,10 @@ Status CoreWorkerPlasmaStoreProvider::Release(const ObjectID &object_id) {
   return store_client_->Release(object_id);
 }
 
+Status CoreWorkerPlasmaStoreProvider::Abort(const ObjectID &object_id) {
+  return store_client_->Abort(object_id);
+}
+
 Status CoreWorkerPlasmaStoreProvider::FetchAndGetFromPlasmaStore(
     absl::flat_hash_set<ObjectID> &remaining,
     const std::vector<ObjectID> &batch_ids,
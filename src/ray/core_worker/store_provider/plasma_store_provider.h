@@ -146,6 +146,12 @@ class CoreWorkerPlasmaStoreProvider {
   /// argument to Get to retrieve the object data.
   Status Release(const ObjectID &object_id);
 
+  /// Abort an object created by Create() that will never be sealed. The caller must
+  /// have released its buffer, and after this the object is gone from the store.
+  ///
+  /// \param[in] object_id The ID of the unsealed object.
+  Status Abort(const ObjectID &object_id);
+
   Status Get(const absl::flat_hash_set<ObjectID> &object_ids,
              int64_t timeout_ms,
              const WorkerContext &ctx,
@@ -109,6 +109,16 @@ void TaskStatusEvent::ToRpcTaskEvents(rpc::TaskEvents *rpc_task_events) {
   }
 }
 
+bool TaskStatusEvent::ToRpcTaskStateTransition(rpc::TaskStateTransition *transition) {
+  if (task_spec_ || task_status_ == rpc::TaskStatus::NIL ||
+      (state_update_.has_value() && !state_update_->Empty())) {
+    return false;
+  }
+  transition->set_state(task_status_);
+  transition->set_timestamp_ns(timestamp_);
+  return true;
+}
+
 void TaskStatusEvent::ToRpcTaskExportEvents(
     std::shared_ptr<rpc::ExportTaskEventData> rpc_task_export_event_data) {
   // Base fields
@@ -249,6 +259,8 @@ Status TaskEventBufferImpl::Start(bool auto_flush) {
       RayConfig::instance().task_events_max_num_status_events_buffer_on_worker());
   status_events_for_export_.set_capacity(
       RayConfig::instance().task_events_max_num_export_status_events_buffer_on_worker());
+  pending_events_drain_threshold_ =
+      RayConfig::instance().task_events_max_num_status_events_buffer_on_worker();
 
   io_thread_ = std::thread([this]() {
 #ifndef _WIN32
@@ -403,10 +415,21 @@ void TaskEventBufferImpl::GetTaskProfileEventsToSend(
 std::unique_ptr<rpc::TaskEventData> TaskEventBufferImpl::CreateDataToSend(
     std::vector<std::shared_ptr<TaskEvent>> &&status_events_to_send,
     std::vector<std::shared_ptr<TaskEvent>> &&profile_events_to_send,
-    absl::flat_hash_set<TaskAttempt> &&dropped_task_attempts_to_send) {
+    absl::flat_hash_set<TaskAttempt> &&dropped_task_attempts_to_send,
+    absl::flat_hash_map<int64_t, std::vector<std::shared_ptr<TaskEvent>>>
+        *compacted_events) {
+  auto data = std::make_unique<rpc::TaskEventData>();
+  const bool compact = RayConfig::instance().task_events_compact_state_transitions();
+  absl::MutexLock lock(&attempt_index_mutex_);
+
   // Aggregate the task events by TaskAttempt.
   absl::flat_hash_map<TaskAttempt, rpc::TaskEvents> agg_task_events;
-  auto to_rpc_event_fn = [this, &agg_task_events, &dropped_task_attempts_to_send](
+  auto to_rpc_event_fn = [this,
+                          compact,
+                          compacted_events,
+                          &data,
+                          &agg_task_events,
+                          &dropped_task_attempts_to_send](
                              std::shared_ptr<TaskEvent> &event) {
     if (dropped_task_attempts_to_send.count(event->GetTaskAttempt())) {
       // We are marking this as data loss due to some missing task status updates.
@@ -416,6 +439,25 @@ std::unique_ptr<rpc::TaskEventData> TaskEventBufferImpl::CreateDataToSend(
       return;
     }
 
+    if (compact && !agg_task_events.count(event->GetTaskAttempt())) {
+      // GCS already has the task info of attempts with an index, so a plain status
+      // change only needs the index, the state and the timestamp.
+      auto index_itr = attempt_indices_.find(event->GetTaskAttempt());
+      rpc::TaskStateTransition transition;
+      if (index_itr != attempt_indices_.end() &&
+          event->ToRpcTaskStateTransition(&transition)) {
+        transition.set_attempt_index(index_itr->second);
+        // Kept in case GCS doesn't know the index.
+        (*compacted_events)[index_itr->second].push_back(event);
+        if (transition.state() == rpc::TaskStatus::FINISHED ||
+            transition.state() == rpc::TaskStatus::FAILED) {
+          attempt_indices_.erase(index_itr);
+        }
+        *data->add_state_transitions() = std::move(transition);
+        return;
+      }
+    }
+
     if (!agg_task_events.count(event->GetTaskAttempt())) {
       auto inserted =
           agg_task_events.insert({event->GetTaskAttempt(), rpc::TaskEvents()});
@@ -433,14 +475,32 @@ std::unique_ptr<rpc::TaskEventData> TaskEventBufferImpl::CreateDataToSend(
       profile_events_to_send.begin(), profile_events_to_send.end(), to_rpc_event_fn);
 
   // Convert to rpc::TaskEventsData
-  auto data = std::make_unique<rpc::TaskEventData>();
-  for (auto &[_task_attempt, task_event] : agg_task_events) {
+  for (auto &[task_attempt, task_event] : agg_task_events) {
+    if (compact && task_event.has_state_updates()) {
+      auto index_itr = attempt_indices_.find(task_attempt);
+      if (gcs::IsTaskTerminated(task_event)) {
+        // Still pass the index so that GCS can forget it.
+        if (index_itr != attempt_indices_.end()) {
+          task_event.set_attempt_index(index_itr->second);
+          attempt_indices_.erase(index_itr);
+        }
+      } else {
+        if (index_itr == attempt_indices_.end()) {
+          index_itr = attempt_indices_.emplace(task_attempt, next_attempt_index_++).first;
+        }
+        task_event.set_attempt_index(index_itr->second);
+      }
+    }
     auto events_by_task = data->add_events_by_task();
     *events_by_task = std::move(task_event);
   }
+  if (compact) {
+    data->set_sender_id(sender_id_.Binary());
+  }
 
   // Add the data loss info.
   for (auto &task_attempt : dropped_task_attempts_to_send) {
+    attempt_indices_.erase(task_attempt);
     rpc::TaskAttempt rpc_task_attempt;
     rpc_task_attempt.set_task_id(task_attempt.first.Binary());
     rpc_task_attempt.set_attempt_number(task_attempt.second);
@@ -498,6 +558,8 @@ void TaskEventBufferImpl::FlushEvents(bool forced) {
     return;
   }
 
+  DrainPendingEvents();
+
   // Skip if GCS hasn't finished processing the previous message.
   if (grpc_in_progress_ && !forced) {
     RAY_LOG_EVERY_N_OR_DEBUG(WARNING, 100)
@@ -526,10 +588,13 @@ void TaskEventBufferImpl::FlushEvents(bool forced) {
   GetTaskProfileEventsToSend(&profile_events_to_send);
 
   // Aggregate and prepare the data to send.
+  absl::flat_hash_map<int64_t, std::vector<std::shared_ptr<TaskEvent>>>
+      compacted_events;
   std::unique_ptr<rpc::TaskEventData> data =
       CreateDataToSend(std::move(status_events_to_send),
                        std::move(profile_events_to_send),
-                       std::move(dropped_task_attempts_to_send));
+                       std::move(dropped_task_attempts_to_send),
+                       &compacted_events);
   if (export_event_write_enabled_) {
     WriteExportData(std::move(status_events_to_write_for_export),
                     std::move(profile_events_to_send));
@@ -552,7 +617,10 @@ void TaskEventBufferImpl::FlushEvents(bool forced) {
   auto on_complete = [this,
                       num_task_attempts_to_send,
                       num_dropped_task_attempts_to_send,
-                      num_bytes_to_send](const Status &status) {
+                      num_bytes_to_send,
+                      compacted_events = std::move(compacted_events)](
+                         const Status &status,
+                         std::vector<int64_t> &&unknown_attempt_indices) mutable {
     if (!status.ok()) {
       RAY_LOG(WARNING) << "Failed to push task events of  " << num_task_attempts_to_send
                        << " tasks attempts, and report "
@@ -561,11 +629,18 @@ void TaskEventBufferImpl::FlushEvents(bool forced) {
                        << "[status=" << status.ToString() << "]";
 
       stats_counter_.Increment(TaskEventBufferCounter::kTotalNumFailedToReport);
+      // GCS might not have received the attempt indices, so report the attempts in
+      // full again.
+      absl::MutexLock lock(&attempt_index_mutex_);
+      attempt_indices_.clear();
     } else {
       stats_counter_.Increment(kTotalNumTaskAttemptsReported, num_task_attempts_to_send);
       stats_counter_.Increment(kTotalNumLostTaskAttemptsReported,
                                num_dropped_task_attempts_to_send);
       stats_counter_.Increment(kTotalTaskEventsBytesReported, num_bytes_to_send);
+      if (!unknown_attempt_indices.empty()) {
+        ResendUnknownAttempts(unknown_attempt_indices, compacted_events);
+      }
     }
     grpc_in_progress_ = false;
   };
@@ -574,6 +649,35 @@ void TaskEventBufferImpl::FlushEvents(bool forced) {
   RAY_CHECK(status.ok());
 }
 
+void TaskEventBufferImpl::ResendUnknownAttempts(
+    const std::vector<int64_t> &unknown_attempt_indices,
+    absl::flat_hash_map<int64_t, std::vector<std::shared_ptr<TaskEvent>>>
+        &compacted_events) {
+  RAY_LOG_EVERY_N_OR_DEBUG(WARNING, 100)
+      << "GCS doesn't know " << unknown_attempt_indices.size()
+      << " task attempts reported with state transitions, likely because it "
+         "restarted. Reporting them in full again.";
+  {
+    // Forget the indices so that the attempts get new ones with their full info.
+    absl::flat_hash_set<int64_t> unknown(unknown_attempt_indices.begin(),
+                                         unknown_attempt_indices.end());
+    absl::MutexLock lock(&attempt_index_mutex_);
+    absl::erase_if(attempt_indices_, [&unknown](const auto &entry) {
+      return unknown.contains(entry.second);
+    });
+  }
+  absl::MutexLock lock(&mutex_);
+  for (auto attempt_index : unknown_attempt_indices) {
+    auto itr = compacted_events.find(attempt_index);
+    if (itr == compacted_events.end()) {
+      continue;
+    }
+    for (auto &event : itr->second) {
+      BufferTaskStatusEvent(std::move(event));
+    }
+  }
+}
+
 void TaskEventBufferImpl::ResetCountersForFlush() {
   // Profile events dropped.
   auto num_profile_events_dropped_since_last_flush = stats_counter_.Get(
@@ -595,18 +699,42 @@ void TaskEventBufferImpl::ResetCountersForFlush() {
 }
 
 void TaskEventBufferImpl::AddTaskEvent(std::unique_ptr<TaskEvent> task_event) {
-  if (task_event->IsProfileEvent()) {
-    AddTaskProfileEvent(std::move(task_event));
-  } else {
-    AddTaskStatusEvent(std::move(task_event));
+  if (!enabled_) {
+    return;
+  }
+  if (pending_events_.Push(std::move(task_event)) < pending_events_drain_threshold_) {
+    return;
+  }
+  // Drain here if the flush can't keep up, unless another thread is already
+  // draining or flushing.
+  if (mutex_.TryLock()) {
+    DrainPendingEventsLocked();
+    mutex_.Unlock();
   }
 }
 
-void TaskEventBufferImpl::AddTaskStatusEvent(std::unique_ptr<TaskEvent> status_event) {
+void TaskEventBufferImpl::DrainPendingEvents() {
   absl::MutexLock lock(&mutex_);
-  if (!enabled_) {
+  DrainPendingEventsLocked();
+}
+
+void TaskEventBufferImpl::DrainPendingEventsLocked() {
+  auto events = pending_events_.PopAll();
+  if (events.empty()) {
     return;
   }
+
+  absl::MutexLock profile_lock(&profile_mutex_);
+  for (auto &event : events) {
+    if (event->IsProfileEvent()) {
+      AddTaskProfileEvent(std::move(event));
+    } else {
+      AddTaskStatusEvent(std::move(event));
+    }
+  }
+}
+
+void TaskEventBufferImpl::AddTaskStatusEvent(std::unique_ptr<TaskEvent> status_event) {
   std::shared_ptr<TaskEvent> status_event_shared_ptr = std::move(status_event);
 
   if (export_event_write_enabled_) {
@@ -618,6 +746,11 @@ void TaskEventBufferImpl::AddTaskStatusEvent(std::unique_ptr<TaskEvent> status_e
     }
     status_events_for_export_.push_back(status_event_shared_ptr);
   }
+  BufferTaskStatusEvent(std::move(status_event_shared_ptr));
+}
+
+void TaskEventBufferImpl::BufferTaskStatusEvent(
+    std::shared_ptr<TaskEvent> status_event_shared_ptr) {
   if (dropped_task_attempts_unreported_.count(
           status_event_shared_ptr->GetTaskAttempt())) {
     // This task attempt has been dropped before, so we drop this event.
@@ -646,14 +779,10 @@ void TaskEventBufferImpl::AddTaskStatusEvent(std::unique_ptr<TaskEvent> status_e
   } else {
     stats_counter_.Increment(TaskEventBufferCounter::kNumTaskStatusEventsStored);
   }
-  status_events_.push_back(status_event_shared_ptr);
+  status_events_.push_back(std::move(status_event_shared_ptr));
 }
 
 void TaskEventBufferImpl::AddTaskProfileEvent(std::unique_ptr<TaskEvent> profile_event) {
-  absl::MutexLock lock(&profile_mutex_);
-  if (!enabled_) {
-    return;
-  }
   std::shared_ptr<TaskEvent> profile_event_shared_ptr = std::move(profile_event);
   auto profile_events_itr =
       profile_events_.find(profile_event_shared_ptr->GetTaskAttempt());
@@ -17,8 +17,11 @@
 #include <boost/circular_buffer.hpp>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "ray/common/asio/instrumented_io_context.h"
@@ -27,6 +30,7 @@
 #include "ray/common/task/task_spec.h"
 #include "ray/gcs/gcs_client/gcs_client.h"
 #include "ray/util/counter_map.h"
+#include "ray/util/mpsc_queue.h"
 #include "src/ray/protobuf/export_api/export_task_event.pb.h"
 #include "src/ray/protobuf/gcs.pb.h"
 
@@ -64,6 +68,16 @@ class TaskEvent {
   virtual void ToRpcTaskExportEvents(
       std::shared_ptr<rpc::ExportTaskEventData> rpc_task_export_event_data) = 0;
 
+  /// Convert itself to a rpc::TaskStateTransition if the event carries nothing but
+  /// a status change.
+  ///
+  /// \param[out] transition The rpc task state transition to be filled. The attempt
+  /// index is left to the caller.
+  /// \return True if the event was converted.
+  virtual bool ToRpcTaskStateTransition(rpc::TaskStateTransition *transition) {
+    return false;
+  }
+
   /// If it is a profile event.
   virtual bool IsProfileEvent() const = 0;
 
@@ -103,6 +117,14 @@ class TaskStatusEvent : public TaskEvent {
 
     TaskStateUpdate(bool is_debugger_paused) : is_debugger_paused_(is_debugger_paused) {}
 
+    /// Whether there is no update besides the status change.
+    bool Empty() const {
+      return !node_id_.has_value() && !worker_id_.has_value() &&
+             !error_info_.has_value() && !task_log_info_.has_value() &&
+             actor_repr_name_.empty() && !pid_.has_value() &&
+             !is_debugger_paused_.has_value();
+    }
+
    private:
     friend class TaskStatusEvent;
 
@@ -136,6 +158,8 @@ class TaskStatusEvent : public TaskEvent {
   void ToRpcTaskExportEvents(
       std::shared_ptr<rpc::ExportTaskEventData> rpc_task_export_event_data) override;
 
+  bool ToRpcTaskStateTransition(rpc::TaskStateTransition *transition) override;
+
   bool IsProfileEvent() const override { return false; }
 
  private:
@@ -292,6 +316,11 @@ class TaskEventBuffer {
 /// The buffer has its own io_context and io_thread, that's isolated from other
 /// components.
 ///
+/// Events are added to a lock-free queue, and moved into the status and profile
+/// event buffers when flushing, or by the adding thread once many events are
+/// pending. Limits on the buffers and accounting of dropped events are applied
+/// at that point, in the order events were added.
+///
 /// This class is thread-safe.
 class TaskEventBufferImpl : public TaskEventBuffer {
  public:
@@ -302,8 +331,7 @@ class TaskEventBufferImpl : public TaskEventBuffer {
 
   ~TaskEventBufferImpl() override;
 
-  void AddTaskEvent(std::unique_ptr<TaskEvent> task_event)
-      ABSL_LOCKS_EXCLUDED(mutex_) override;
+  void AddTaskEvent(std::unique_ptr<TaskEvent> task_event) override;
 
   void FlushEvents(bool forced) ABSL_LOCKS_EXCLUDED(mutex_) override;
 
@@ -316,17 +344,40 @@ class TaskEventBufferImpl : public TaskEventBuffer {
   const std::string DebugString() override;
 
  private:
+  /// Move the events added since the last call into the status and profile event
+  /// buffers.
+  void DrainPendingEvents() ABSL_LOCKS_EXCLUDED(mutex_, profile_mutex_);
+
+  void DrainPendingEventsLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_)
+      ABSL_LOCKS_EXCLUDED(profile_mutex_);
+
   /// Add a task status event to be reported.
   ///
   /// \param status_event Task status event.
   void AddTaskStatusEvent(std::unique_ptr<TaskEvent> status_event)
-      ABSL_LOCKS_EXCLUDED(mutex_);
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Add a task status event to the buffer of events to be sent to GCS.
+  ///
+  /// \param status_event Task status event.
+  void BufferTaskStatusEvent(std::shared_ptr<TaskEvent> status_event)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Report the attempts of state transitions that GCS didn't know in full again.
+  ///
+  /// \param unknown_attempt_indices Attempt indices GCS doesn't know.
+  /// \param compacted_events The status events sent as state transitions, by
+  ///        attempt index.
+  void ResendUnknownAttempts(
+      const std::vector<int64_t> &unknown_attempt_indices,
+      absl::flat_hash_map<int64_t, std::vector<std::shared_ptr<TaskEvent>>>
+          &compacted_events) ABSL_LOCKS_EXCLUDED(mutex_, attempt_index_mutex_);
 
   /// Add a task profile event to be reported.
   ///
   /// \param profile_event Task profile event.
   void AddTaskProfileEvent(std::unique_ptr<TaskEvent> profile_event)
-      ABSL_LOCKS_EXCLUDED(profile_mutex_);
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(profile_mutex_);
 
   /// Get data related to task status events to be send to GCS.
   ///
@@ -352,15 +403,22 @@ class TaskEventBufferImpl : public TaskEventBuffer {
 
   /// Get the task events to GCS.
   ///
+  /// Status changes of task attempts that were already reported with an attempt
+  /// index are sent as compact state transitions, if enabled.
+  ///
   /// \param status_events_to_send Task status events to be sent.
   /// \param profile_events_to_send Task profile events to be sent.
   /// \param dropped_task_attempts_to_send Task attempts that were dropped due to
   ///        status events being dropped.
+  /// \param[out] compacted_events The status events sent as state transitions, by
+  ///             attempt index.
   /// \return A unique_ptr to rpc::TaskEvents to be sent to GCS.
   std::unique_ptr<rpc::TaskEventData> CreateDataToSend(
       std::vector<std::shared_ptr<TaskEvent>> &&status_events_to_send,
       std::vector<std::shared_ptr<TaskEvent>> &&profile_events_to_send,
-      absl::flat_hash_set<TaskAttempt> &&dropped_task_attempts_to_send);
+      absl::flat_hash_set<TaskAttempt> &&dropped_task_attempts_to_send,
+      absl::flat_hash_map<int64_t, std::vector<std::shared_ptr<TaskEvent>>>
+          *compacted_events) ABSL_LOCKS_EXCLUDED(attempt_index_mutex_);
 
   /// Write task events for the Export API.
   ///
@@ -378,28 +436,33 @@ class TaskEventBufferImpl : public TaskEventBuffer {
 
   /// Test only functions.
   size_t GetNumTaskEventsStored() {
+    DrainPendingEvents();
     return stats_counter_.Get(TaskEventBufferCounter::kNumTaskStatusEventsStored) +
            stats_counter_.Get(TaskEventBufferCounter::kNumTaskProfileEventsStored);
   }
 
   /// Test only functions.
   size_t GetTotalNumStatusTaskEventsDropped() {
+    DrainPendingEvents();
     return stats_counter_.Get(TaskEventBufferCounter::kTotalNumTaskStatusEventDropped);
   }
 
   /// Test only functions.
   size_t GetNumStatusTaskEventsDroppedSinceLastFlush() {
+    DrainPendingEvents();
     return stats_counter_.Get(
         TaskEventBufferCounter::kNumTaskStatusEventDroppedSinceLastFlush);
   }
 
   /// Test only functions.
   size_t GetTotalNumProfileTaskEventsDropped() {
+    DrainPendingEvents();
     return stats_counter_.Get(TaskEventBufferCounter::kTotalNumTaskProfileEventDropped);
   }
 
   /// Test only functions.
   size_t GetNumProfileTaskEventsDroppedSinceLastFlush() {
+    DrainPendingEvents();
     return stats_counter_.Get(
         TaskEventBufferCounter::kNumTaskProfileEventDroppedSinceLastFlush);
   }
@@ -420,6 +483,8 @@ class TaskEventBufferImpl : public TaskEventBuffer {
 
   absl::Mutex profile_mutex_;
 
+  absl::Mutex attempt_index_mutex_;
+
   /// IO service event loop owned by TaskEventBuffer.
   instrumented_io_context io_service_;
 
@@ -438,6 +503,13 @@ class TaskEventBufferImpl : public TaskEventBuffer {
   /// True if the TaskEventBuffer is enabled.
   std::atomic<bool> enabled_ = false;
 
+  /// Events added but not yet moved into the buffers below.
+  MpscQueue<std::unique_ptr<TaskEvent>> pending_events_;
+
+  /// An adding thread drains pending_events_ once it has this many events pending,
+  /// so that they don't pile up between flushes.
+  size_t pending_events_drain_threshold_ = 0;
+
   /// Circular buffered task status events.
   boost::circular_buffer<std::shared_ptr<TaskEvent>> status_events_
       ABSL_GUARDED_BY(mutex_);
@@ -456,6 +528,18 @@ class TaskEventBufferImpl : public TaskEventBuffer {
   absl::flat_hash_map<TaskAttempt, std::vector<std::shared_ptr<TaskEvent>>>
       profile_events_ ABSL_GUARDED_BY(profile_mutex_);
 
+  /// Unique id of this buffer, which scopes the attempt indices on GCS.
+  const UniqueID sender_id_ = UniqueID::FromRandom();
+
+  /// Indices of the non-terminated task attempts reported to GCS with
+  /// TaskEvents.attempt_index. Cleared when a report fails, since GCS might not
+  /// have received them, and pruned of the indices GCS replies it doesn't know.
+  absl::flat_hash_map<TaskAttempt, int64_t> attempt_indices_
+      ABSL_GUARDED_BY(attempt_index_mutex_);
+
+  /// The next attempt index to assign. Indices are never reused by a sender.
+  int64_t next_attempt_index_ ABSL_GUARDED_BY(attempt_index_mutex_) = 0;
+
   /// Stats counter map.
   CounterMapThreadSafe<TaskEventBufferCounter> stats_counter_;
 
@@ -470,6 +554,10 @@ class TaskEventBufferImpl : public TaskEventBuffer {
   FRIEND_TEST(TaskEventBufferTestManualStart, TestGcsClientFail);
   FRIEND_TEST(TaskEventBufferTestBatchSend, TestBatchedSend);
   FRIEND_TEST(TaskEventBufferTest, TestAddEvent);
+  FRIEND_TEST(TaskEventBufferTest, TestConcurrentAddEvents);
+  FRIEND_TEST(TaskEventBufferTest, TestCompactStateTransitions);
+  FRIEND_TEST(TaskEventBufferTest, TestResendUnknownAttempts);
+  FRIEND_TEST(TaskEventBufferTest, TestCompactStateTransitionsBytesPerTask);
   FRIEND_TEST(TaskEventBufferTest, TestFlushEvents);
   FRIEND_TEST(TaskEventBufferTest, TestFailedFlush);
   FRIEND_TEST(TaskEventBufferTest, TestBackPressure);
@@ -14,6 +14,7 @@
 
 #include "ray/core_worker/task_manager.h"
 
+#include "lz4.h"
 #include "ray/common/buffer.h"
 #include "ray/common/common_protocol.h"
 #include "ray/common/constants.h"
@@ -204,6 +205,60 @@ ObjectID ObjectRefStream::GetObjectRefAtIndex(int64_t generator_index) const {
   return ObjectID::FromIndex(generator_task_id_, 2 + generator_index);
 }
 
+int64_t TaskManager::TaskEntry::CompressSpec(int64_t min_spec_size) {
+  RAY_CHECK(!IsPending());
+  if (IsSpecCompressed()) {
+    return compressed_spec_.size();
+  }
+  const int64_t spec_size = spec.GetMessage().ByteSizeLong();
+  // Streaming generator specs are still read after the task finishes, when
+  // their outputs are consumed, so we keep them as is.
+  if (min_spec_size < 0 || spec_size < min_spec_size || spec.IsStreamingGenerator()) {
+    return spec_size;
+  }
+
+  const std::string serialized = spec.GetMessage().SerializeAsString();
+  std::string compressed(LZ4_compressBound(spec_size), '\0');
+  const int compressed_size = LZ4_compress_default(
+      serialized.data(), compressed.data(), spec_size, compressed.size());
+  if (compressed_size <= 0 || compressed_size >= spec_size) {
+    return spec_size;
+  }
+  compressed.resize(compressed_size);
+  compressed.shrink_to_fit();
+  compressed_spec_ = std::move(compressed);
+  uncompressed_spec_size_ = spec_size;
+  compressed_attempt_number_ = spec.AttemptNumber();
+  spec = TaskSpecification();
+  return compressed_size;
+}
+
+void TaskManager::TaskEntry::DecompressSpec() {
+  if (!IsSpecCompressed()) {
+    return;
+  }
+  spec = GetSpec();
+  compressed_spec_.clear();
+  compressed_spec_.shrink_to_fit();
+  uncompressed_spec_size_ = 0;
+}
+
+TaskSpecification TaskManager::TaskEntry::GetSpec() const {
+  if (!IsSpecCompressed()) {
+    return spec;
+  }
+  std::string serialized(uncompressed_spec_size_, '\0');
+  const int decompressed_size = LZ4_decompress_safe(compressed_spec_.data(),
+                                                    serialized.data(),
+                                                    compressed_spec_.size(),
+                                                    uncompressed_spec_size_);
+  RAY_CHECK(decompressed_size == uncompressed_spec_size_)
+      << "Failed to decompress task spec.";
+  rpc::TaskSpec message;
+  RAY_CHECK(message.ParseFromString(serialized)) << "Failed to parse task spec.";
+  return TaskSpecification(std::move(message));
+}
+
 std::vector<rpc::ObjectReference> TaskManager::AddPendingTask(
     const rpc::Address &caller_address,
     const TaskSpecification &spec,
@@ -316,6 +371,7 @@ bool TaskManager::ResubmitTask(const TaskID &task_id, std::vector<ObjectID> *tas
 
     if (!it->second.IsPending()) {
       resubmit = true;
+      it->second.DecompressSpec();
       MarkTaskRetryOnResubmit(it->second);
       num_pending_tasks_++;
 
@@ -893,7 +949,8 @@ void TaskManager::CompletePendingTask(const TaskID &task_id,
     if (task_retryable) {
       // Pin the task spec if it may be retried again.
       release_lineage = false;
-      it->second.lineage_footprint_bytes = it->second.spec.GetMessage().ByteSizeLong();
+      it->second.lineage_footprint_bytes = it->second.CompressSpec(
+          RayConfig::instance().lineage_compression_min_spec_size());
       total_lineage_footprint_bytes_ += it->second.lineage_footprint_bytes;
       if (total_lineage_footprint_bytes_ > max_lineage_bytes_) {
         RAY_LOG(INFO) << "Total lineage size is " << total_lineage_footprint_bytes_ / 1e6
@@ -1225,23 +1282,24 @@ int64_t TaskManager::RemoveLineageReference(const ObjectID &object_id,
                  << " plasma returns in scope";
 
   if (it->second.reconstructable_return_ids.empty() && !it->second.IsPending()) {
+    const auto spec = it->second.GetSpec();
     // If the task can no longer be retried, decrement the lineage ref count
     // for each of the task's args.
-    for (size_t i = 0; i < it->second.spec.NumArgs(); i++) {
-      if (it->second.spec.ArgByRef(i)) {
-        released_objects->push_back(it->second.spec.ArgId(i));
+    for (size_t i = 0; i < spec.NumArgs(); i++) {
+      if (spec.ArgByRef(i)) {
+        released_objects->push_back(spec.ArgId(i));
       } else {
-        const auto &inlined_refs = it->second.spec.ArgInlinedRefs(i);
+        const auto &inlined_refs = spec.ArgInlinedRefs(i);
         for (const auto &inlined_ref : inlined_refs) {
           released_objects->push_back(ObjectID::FromBinary(inlined_ref.object_id()));
         }
       }
     }
 
-    if (it->second.spec.IsActorTask()) {
+    if (spec.IsActorTask()) {
       // We need to decrement the actor lineage ref count here
       // since it's incremented during TaskManager::AddPendingTask.
-      const auto actor_creation_return_id = it->second.spec.ActorCreationDummyObjectId();
+      const auto actor_creation_return_id = spec.ActorCreationDummyObjectId();
       released_objects->push_back(actor_creation_return_id);
     }
 
@@ -1356,7 +1414,7 @@ absl::optional<TaskSpecification> TaskManager::GetTaskSpec(const TaskID &task_id
   if (it == submissible_tasks_.end()) {
     return absl::optional<TaskSpecification>();
   }
-  return it->second.spec;
+  return it->second.GetSpec();
 }
 
 std::vector<TaskID> TaskManager::GetPendingChildrenTasks(
@@ -1382,7 +1440,7 @@ void TaskManager::AddTaskStatusInfo(rpc::CoreWorkerStats *stats) const {
       continue;
     }
     ref->set_task_status(it->second.GetStatus());
-    ref->set_attempt_number(it->second.spec.AttemptNumber());
+    ref->set_attempt_number(it->second.AttemptNumber());
   }
 }
 
@@ -1408,6 +1466,7 @@ void TaskManager::MarkTaskWaitingForExecution(const TaskID &task_id,
   }
   RAY_CHECK(it->second.GetStatus() == rpc::TaskStatus::PENDING_NODE_ASSIGNMENT)
       << ", task ID = " << it->first << ", status = " << it->second.GetStatus();
+  RAY_CHECK(!it->second.IsSpecCompressed());
   it->second.SetNodeId(node_id);
   it->second.SetStatus(rpc::TaskStatus::SUBMITTED_TO_WORKER);
   RAY_UNUSED(task_event_buffer_.RecordTaskStatusEventIfNeeded(
@@ -1423,6 +1482,8 @@ void TaskManager::MarkTaskWaitingForExecution(const TaskID &task_id,
 void TaskManager::MarkTaskRetryOnResubmit(TaskEntry &task_entry) {
   RAY_CHECK(!task_entry.IsPending())
       << "Only finished tasks can be resubmitted: " << task_entry.spec.TaskId();
+  // The caller must decompress the lineage spec first.
+  RAY_CHECK(!task_entry.IsSpecCompressed());
 
   task_entry.MarkRetry();
 
@@ -1443,6 +1504,7 @@ void TaskManager::MarkTaskRetryOnResubmit(TaskEntry &task_entry) {
 void TaskManager::MarkTaskRetryOnFailed(TaskEntry &task_entry,
                                         const rpc::RayErrorInfo &error_info) {
   RAY_CHECK(task_entry.IsPending());
+  RAY_CHECK(!task_entry.IsSpecCompressed());
 
   // Record the old attempt status as FAILED.
   SetTaskStatus(task_entry, rpc::TaskStatus::FAILED, error_info);
@@ -1463,6 +1525,9 @@ void TaskManager::SetTaskStatus(
     TaskEntry &task_entry,
     rpc::TaskStatus status,
     const absl::optional<const rpc::RayErrorInfo> &error_info) {
+  // Only called while the task is pending or just finished, before the spec is
+  // compressed.
+  RAY_CHECK(!task_entry.IsSpecCompressed());
   task_entry.SetStatus(status);
   RAY_UNUSED(task_event_buffer_.RecordTaskStatusEventIfNeeded(
       task_entry.spec.TaskId(),
@@ -1518,7 +1583,8 @@ void TaskManager::FillTaskInfo(rpc::GetCoreWorkerStatsReply *reply,
 
     const auto &task_entry = task_it.second;
     auto entry = reply->add_owned_task_info_entries();
-    const auto &task_spec = task_entry.spec;
+    // Finished tasks pinned as lineage might have a compressed spec.
+    const auto task_spec = task_entry.GetSpec();
     const auto &task_state = task_entry.GetStatus();
     const auto &node_id = task_entry.GetNodeId();
     rpc::TaskType type;
@@ -1563,10 +1629,11 @@ ObjectID TaskManager::TaskGeneratorId(const TaskID &task_id) const {
   if (it == submissible_tasks_.end()) {
     return ObjectID::Nil();
   }
-  if (!it->second.spec.ReturnsDynamic()) {
+  const auto spec = it->second.GetSpec();
+  if (!spec.ReturnsDynamic()) {
     return ObjectID::Nil();
   }
-  return it->second.spec.ReturnId(0);
+  return spec.ReturnId(0);
 }
 
 }  // namespace core
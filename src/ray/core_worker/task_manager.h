@@ -661,6 +661,30 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
       return GetStatus() == rpc::TaskStatus::SUBMITTED_TO_WORKER;
     }
 
+    /// Compress the task spec with LZ4 if it is at least min_spec_size bytes
+    /// and compression saves space. This should only be called once the task
+    /// is no longer pending and the spec is only pinned as lineage.
+    ///
+    /// \param[in] min_spec_size The minimum serialized size of a spec to
+    /// compress. -1 disables compression.
+    /// \return The number of bytes that the spec takes up afterwards.
+    int64_t CompressSpec(int64_t min_spec_size);
+
+    /// Restore the task spec if it was compressed. This must be called before
+    /// the task becomes pending again.
+    void DecompressSpec();
+
+    /// Return the task spec. If the spec is compressed, this returns a
+    /// decompressed copy and the entry stays compressed.
+    TaskSpecification GetSpec() const;
+
+    bool IsSpecCompressed() const { return !compressed_spec_.empty(); }
+
+    /// Return the attempt number of the task spec, without decompressing it.
+    uint64_t AttemptNumber() const {
+      return IsSpecCompressed() ? compressed_attempt_number_ : spec.AttemptNumber();
+    }
+
     /// The task spec. This is pinned as long as the following are true:
     /// - The task is still pending execution. This means that the task may
     /// fail and so it may be retried in the future.
@@ -672,7 +696,9 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
     /// the worker fails. We could avoid this by either not caching the full
     /// TaskSpec for tasks that cannot be retried (e.g., actor tasks), or by
     /// storing a shared_ptr to a PushTaskRequest protobuf for all tasks.
-    const TaskSpecification spec;
+    /// While the spec is only pinned as lineage, it may be compressed, in
+    /// which case this is empty and GetSpec() must be used to read it.
+    TaskSpecification spec;
     // Number of times this task may be resubmitted. If this reaches 0, then
     // the task entry may be erased.
     int32_t num_retries_left;
@@ -708,6 +734,12 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
     NodeID node_id_;
     // Whether this is a task retry due to task failure.
     bool is_retry_ = false;
+    // The LZ4-compressed serialized task spec, if the spec is compressed.
+    std::string compressed_spec_;
+    // The serialized size of the task spec before it was compressed.
+    int64_t uncompressed_spec_size_ = 0;
+    // The attempt number of the task spec when it was compressed.
+    uint64_t compressed_attempt_number_ = 0;
   };
 
   /// Update nested ref count info and store the in-memory value for a task's
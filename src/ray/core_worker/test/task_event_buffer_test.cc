@@ -18,9 +18,11 @@
 
 #include <filesystem>
 #include <fstream>
+#include <thread>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
 #include "absl/types/optional.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -93,7 +95,9 @@ class TaskEventBufferTest : public ::testing::Test {
     // Sort and compare
     std::vector<std::string> actual_events;
     std::vector<std::string> expect_events;
-    for (const auto &e : actual_data.events_by_task()) {
+    for (auto e : actual_data.events_by_task()) {
+      // Attempt indices are assigned by the buffer.
+      e.clear_attempt_index();
       actual_events.push_back(e.DebugString());
     }
     for (const auto &e : expect_data.events_by_task()) {
@@ -226,6 +230,42 @@ TEST_F(TaskEventBufferTest, TestAddEvent) {
   ASSERT_EQ(task_event_buffer_->GetNumTaskEventsStored(), 2);
 }
 
+TEST_F(TaskEventBufferTest, TestConcurrentAddEvents) {
+  const size_t num_threads = 16;
+  const size_t num_events_per_thread = 10000;
+  const size_t num_limit_status_events = 100;  // sync with setup
+
+  std::vector<std::vector<std::unique_ptr<TaskEvent>>> events(num_threads);
+  for (auto &thread_events : events) {
+    for (size_t i = 0; i < num_events_per_thread; ++i) {
+      thread_events.push_back(GenStatusTaskEvent(RandomTaskId(), 0));
+    }
+  }
+
+  auto start = absl::Now();
+  std::vector<std::thread> threads;
+  for (auto &thread_events : events) {
+    threads.emplace_back([this, &thread_events]() {
+      for (auto &event : thread_events) {
+        task_event_buffer_->AddTaskEvent(std::move(event));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto elapsed = absl::ToDoubleSeconds(absl::Now() - start);
+  const size_t num_events = num_threads * num_events_per_thread;
+  RAY_LOG(INFO) << "Added " << num_events << " task events from " << num_threads
+                << " threads in " << elapsed << "s (" << num_events / elapsed
+                << " events/s).";
+
+  // Every event is either stored, or dropped once the buffer is full.
+  ASSERT_EQ(task_event_buffer_->GetNumTaskEventsStored(), num_limit_status_events);
+  ASSERT_EQ(task_event_buffer_->GetNumStatusTaskEventsDroppedSinceLastFlush(),
+            num_events - num_limit_status_events);
+}
+
 TEST_F(TaskEventBufferTest, TestFlushEvents) {
   size_t num_events = 20;
   auto task_ids = GenTaskIDs(num_events);
@@ -256,7 +296,7 @@ TEST_F(TaskEventBufferTest, TestFlushEvents) {
 
   EXPECT_CALL(*task_gcs_accessor, AsyncAddTaskEventData(_, _))
       .WillOnce([&](std::unique_ptr<rpc::TaskEventData> actual_data,
-                    ray::gcs::StatusCallback callback) {
+                    ray::gcs::MultiItemCallback<int64_t> callback) {
         CompareTaskEventData(*actual_data, expected_data);
         return Status::OK();
       });
@@ -267,6 +307,172 @@ TEST_F(TaskEventBufferTest, TestFlushEvents) {
   ASSERT_EQ(task_event_buffer_->GetNumTaskEventsStored(), 0);
 }
 
+TEST_F(TaskEventBufferTest, TestCompactStateTransitions) {
+  auto task_id_1 = RandomTaskId();
+  auto task_id_2 = RandomTaskId();
+  auto task_gcs_accessor =
+      static_cast<ray::gcs::MockGcsClient *>(task_event_buffer_->GetGcsClient())
+          ->mock_task_accessor;
+
+  std::vector<rpc::TaskEventData> sent_data;
+  Status flush_status = Status::OK();
+  EXPECT_CALL(*task_gcs_accessor, AsyncAddTaskEventData)
+      .Times(4)
+      .WillRepeatedly([&](std::unique_ptr<rpc::TaskEventData> actual_data,
+                          ray::gcs::MultiItemCallback<int64_t> callback) {
+        sent_data.push_back(*actual_data);
+        callback(flush_status, {});
+        return Status::OK();
+      });
+
+  // The first report of an attempt is in full, with an attempt index.
+  task_event_buffer_->AddTaskEvent(GenStatusTaskEvent(task_id_1, 0));
+  task_event_buffer_->FlushEvents(false);
+  ASSERT_EQ(sent_data[0].events_by_task_size(), 1);
+  ASSERT_TRUE(sent_data[0].events_by_task(0).has_attempt_index());
+  auto attempt_index_1 = sent_data[0].events_by_task(0).attempt_index();
+
+  // Later plain status changes only refer to the attempt index.
+  task_event_buffer_->AddTaskEvent(std::make_unique<TaskStatusEvent>(
+      task_id_1, JobID::FromInt(0), 0, rpc::TaskStatus::FINISHED, 2));
+  task_event_buffer_->AddTaskEvent(GenStatusTaskEvent(task_id_2, 0));
+  task_event_buffer_->FlushEvents(false);
+  ASSERT_EQ(sent_data[1].sender_id(), sent_data[0].sender_id());
+  ASSERT_EQ(sent_data[1].state_transitions_size(), 1);
+  const auto &transition = sent_data[1].state_transitions(0);
+  ASSERT_EQ(transition.attempt_index(), attempt_index_1);
+  ASSERT_EQ(transition.state(), rpc::TaskStatus::FINISHED);
+  ASSERT_EQ(transition.timestamp_ns(), 2);
+  ASSERT_EQ(sent_data[1].events_by_task_size(), 1);
+  ASSERT_NE(sent_data[1].events_by_task(0).attempt_index(), attempt_index_1);
+  {
+    // Terminated attempts are forgotten.
+    absl::MutexLock lock(&task_event_buffer_->attempt_index_mutex_);
+    ASSERT_EQ(task_event_buffer_->attempt_indices_.size(), 1);
+  }
+
+  // After a failed report, attempts are reported in full again.
+  flush_status = Status::RpcError("grpc error", grpc::StatusCode::UNKNOWN);
+  task_event_buffer_->FlushEvents(false);
+  flush_status = Status::OK();
+  task_event_buffer_->AddTaskEvent(std::make_unique<TaskStatusEvent>(
+      task_id_2, JobID::FromInt(0), 0, rpc::TaskStatus::FINISHED, 3));
+  task_event_buffer_->FlushEvents(false);
+  ASSERT_EQ(sent_data[3].state_transitions_size(), 0);
+  ASSERT_EQ(sent_data[3].events_by_task_size(), 1);
+  ASSERT_FALSE(sent_data[3].events_by_task(0).has_attempt_index());
+}
+
+TEST_F(TaskEventBufferTest, TestResendUnknownAttempts) {
+  auto task_id = RandomTaskId();
+  auto task_gcs_accessor =
+      static_cast<ray::gcs::MockGcsClient *>(task_event_buffer_->GetGcsClient())
+          ->mock_task_accessor;
+
+  std::vector<rpc::TaskEventData> sent_data;
+  std::vector<int64_t> unknown_attempt_indices;
+  EXPECT_CALL(*task_gcs_accessor, AsyncAddTaskEventData)
+      .Times(3)
+      .WillRepeatedly([&](std::unique_ptr<rpc::TaskEventData> actual_data,
+                          ray::gcs::MultiItemCallback<int64_t> callback) {
+        sent_data.push_back(*actual_data);
+        callback(Status::OK(), std::move(unknown_attempt_indices));
+        unknown_attempt_indices.clear();
+        return Status::OK();
+      });
+
+  task_event_buffer_->AddTaskEvent(GenStatusTaskEvent(task_id, 0));
+  task_event_buffer_->FlushEvents(false);
+  ASSERT_TRUE(sent_data[0].events_by_task(0).has_attempt_index());
+  auto attempt_index = sent_data[0].events_by_task(0).attempt_index();
+
+  // GCS doesn't know the attempt index, e.g. because it restarted.
+  unknown_attempt_indices = {attempt_index};
+  task_event_buffer_->AddTaskEvent(std::make_unique<TaskStatusEvent>(
+      task_id, JobID::FromInt(0), 0, rpc::TaskStatus::RUNNING, 2));
+  task_event_buffer_->FlushEvents(false);
+  ASSERT_EQ(sent_data[1].state_transitions_size(), 1);
+  {
+    absl::MutexLock lock(&task_event_buffer_->attempt_index_mutex_);
+    ASSERT_TRUE(task_event_buffer_->attempt_indices_.empty());
+  }
+
+  // The lost state transition is reported again with the full attempt.
+  task_event_buffer_->FlushEvents(false);
+  ASSERT_EQ(sent_data[2].state_transitions_size(), 0);
+  ASSERT_EQ(sent_data[2].events_by_task_size(), 1);
+  const auto &events_by_task = sent_data[2].events_by_task(0);
+  ASSERT_EQ(events_by_task.task_id(), task_id.Binary());
+  ASSERT_TRUE(events_by_task.has_attempt_index());
+  ASSERT_NE(events_by_task.attempt_index(), attempt_index);
+  ASSERT_EQ(events_by_task.state_updates().state_ts_ns().at(rpc::TaskStatus::RUNNING),
+            2);
+}
+
+TEST_F(TaskEventBufferTest, TestCompactStateTransitionsBytesPerTask) {
+  const size_t num_tasks = 100;  // sync with setup
+  const std::vector<rpc::TaskStatus> transitions = {
+      rpc::TaskStatus::PENDING_NODE_ASSIGNMENT,
+      rpc::TaskStatus::SUBMITTED_TO_WORKER,
+      rpc::TaskStatus::RUNNING,
+      rpc::TaskStatus::FINISHED};
+  auto task_gcs_accessor =
+      static_cast<ray::gcs::MockGcsClient *>(task_event_buffer_->GetGcsClient())
+          ->mock_task_accessor;
+  size_t num_bytes_sent = 0;
+  EXPECT_CALL(*task_gcs_accessor, AsyncAddTaskEventData)
+      .WillRepeatedly([&](std::unique_ptr<rpc::TaskEventData> actual_data,
+                          ray::gcs::MultiItemCallback<int64_t> callback) {
+        num_bytes_sent += actual_data->ByteSizeLong();
+        callback(Status::OK(), {});
+        return Status::OK();
+      });
+
+  // Each task goes through its states one flush after another, as a long running
+  // task would.
+  auto bytes_per_task = [&](bool compact) {
+    RayConfig::instance().initialize(
+        compact ? R"({"task_events_compact_state_transitions": true})"
+                : R"({"task_events_compact_state_transitions": false})");
+    num_bytes_sent = 0;
+    auto task_ids = GenTaskIDs(num_tasks);
+    for (const auto &task_id : task_ids) {
+      rpc::TaskSpec message;
+      message.set_task_id(task_id.Binary());
+      message.set_job_id(JobID::FromInt(0).Binary());
+      message.set_type(rpc::TaskType::NORMAL_TASK);
+      message.set_name("a_remote_function");
+      auto python_descriptor =
+          message.mutable_function_descriptor()->mutable_python_function_descriptor();
+      python_descriptor->set_module_name("a_module");
+      python_descriptor->set_function_name("a_remote_function");
+      task_event_buffer_->AddTaskEvent(std::make_unique<TaskStatusEvent>(
+          task_id,
+          JobID::FromInt(0),
+          0,
+          rpc::TaskStatus::PENDING_ARGS_AVAIL,
+          1,
+          std::make_shared<const TaskSpecification>(std::move(message))));
+    }
+    task_event_buffer_->FlushEvents(false);
+    for (auto status : transitions) {
+      for (const auto &task_id : task_ids) {
+        task_event_buffer_->AddTaskEvent(std::make_unique<TaskStatusEvent>(
+            task_id, JobID::FromInt(0), 0, status, absl::GetCurrentTimeNanos()));
+      }
+      task_event_buffer_->FlushEvents(false);
+    }
+    return num_bytes_sent / num_tasks;
+  };
+
+  auto full_bytes_per_task = bytes_per_task(false);
+  auto compact_bytes_per_task = bytes_per_task(true);
+  RAY_LOG(INFO) << "Task events sent per task with " << transitions.size() + 1
+                << " state changes: " << full_bytes_per_task << " bytes in full, "
+                << compact_bytes_per_task << " bytes with compact state transitions.";
+  ASSERT_LT(compact_bytes_per_task, full_bytes_per_task);
+}
+
 TEST_F(TaskEventBufferTest, TestFailedFlush) {
   size_t num_status_events = 20;
   size_t num_profile_events = 20;
@@ -288,13 +494,13 @@ TEST_F(TaskEventBufferTest, TestFailedFlush) {
   EXPECT_CALL(*task_gcs_accessor, AsyncAddTaskEventData)
       .Times(2)
       .WillOnce([&](std::unique_ptr<rpc::TaskEventData> actual_data,
-                    ray::gcs::StatusCallback callback) {
-        callback(Status::RpcError("grpc error", grpc::StatusCode::UNKNOWN));
+                    ray::gcs::MultiItemCallback<int64_t> callback) {
+        callback(Status::RpcError("grpc error", grpc::StatusCode::UNKNOWN), {});
         return Status::OK();
       })
       .WillOnce([&](std::unique_ptr<rpc::TaskEventData> actual_data,
-                    ray::gcs::StatusCallback callback) {
-        callback(Status::OK());
+                    ray::gcs::MultiItemCallback<int64_t> callback) {
+        callback(Status::OK(), {});
         return Status::OK();
       });
 
@@ -387,9 +593,9 @@ TEST_F(TaskEventBufferTestBatchSend, TestBatchedSend) {
   EXPECT_CALL(*task_gcs_accessor, AsyncAddTaskEventData)
       .Times(num_events / batch_size)
       .WillRepeatedly([&batch_size](std::unique_ptr<rpc::TaskEventData> actual_data,
-                                    ray::gcs::StatusCallback callback) {
+                                    ray::gcs::MultiItemCallback<int64_t> callback) {
         EXPECT_EQ(actual_data->events_by_task_size(), batch_size);
-        callback(Status::OK());
+        callback(Status::OK(), {});
         return Status::OK();
       });
 
@@ -451,7 +657,7 @@ TEST_F(TaskEventBufferTestLimitBuffer, TestBufferSizeLimitStatusEvents) {
 
   EXPECT_CALL(*task_gcs_accessor, AsyncAddTaskEventData(_, _))
       .WillOnce([&](std::unique_ptr<rpc::TaskEventData> actual_data,
-                    ray::gcs::StatusCallback callback) {
+                    ray::gcs::MultiItemCallback<int64_t> callback) {
         // Sort and compare
         CompareTaskEventData(*actual_data, expected_data);
         return Status::OK();
@@ -499,7 +705,7 @@ TEST_F(TaskEventBufferTestLimitProfileEvents, TestBufferSizeLimitProfileEvents)
 
   EXPECT_CALL(*task_gcs_accessor, AsyncAddTaskEventData(_, _))
       .WillOnce([&](std::unique_ptr<rpc::TaskEventData> actual_data,
-                    ray::gcs::StatusCallback callback) {
+                    ray::gcs::MultiItemCallback<int64_t> callback) {
         EXPECT_EQ(actual_data->num_profile_events_dropped(), num_profile_dropped);
         EXPECT_EQ(actual_data->events_by_task_size(), num_limit_profile_events);
         return Status::OK();
@@ -110,7 +110,8 @@ class MockTaskEventBuffer : public worker::TaskEventBuffer {
 class TaskManagerTest : public ::testing::Test {
  public:
   explicit TaskManagerTest(bool lineage_pinning_enabled = false,
-                           int64_t max_lineage_bytes = 1024 * 1024 * 1024)
+                           int64_t max_lineage_bytes = 1024 * 1024 * 1024,
+                           bool truncate_lineage_on_durable_spill = false)
       : lineage_pinning_enabled_(lineage_pinning_enabled),
         addr_(GetRandomWorkerAddr()),
         publisher_(std::make_shared<pubsub::MockPublisher>()),
@@ -121,7 +122,8 @@ class TaskManagerTest : public ::testing::Test {
             publisher_.get(),
             subscriber_.get(),
             [this](const NodeID &node_id) { return all_nodes_alive_; },
-            lineage_pinning_enabled))),
+            lineage_pinning_enabled,
+            truncate_lineage_on_durable_spill))),
         io_context_("TaskManagerTest"),
         store_(std::shared_ptr<CoreWorkerMemoryStore>(
             new CoreWorkerMemoryStore(io_context_.GetIoService(), reference_counter_))),
@@ -197,6 +199,45 @@ class TaskManagerLineageTest : public TaskManagerTest {
   TaskManagerLineageTest() : TaskManagerTest(true, /*max_lineage_bytes=*/10000) {}
 };
 
+class TaskManagerLineageCompactionTest : public TaskManagerTest {
+ public:
+  TaskManagerLineageCompactionTest()
+      : TaskManagerTest(true,
+                        /*max_lineage_bytes=*/1024 * 1024 * 1024,
+                        /*truncate_lineage_on_durable_spill=*/true) {}
+
+  // Create a task spec with a function descriptor and runtime env of roughly
+  // the size that real specs carry.
+  TaskSpecification CreatePipelineTask(const std::vector<ObjectID> &dependencies) {
+    auto spec = CreateTaskHelper(1, dependencies);
+    auto descriptor = spec.GetMutableMessage()
+                          .mutable_function_descriptor()
+                          ->mutable_python_function_descriptor();
+    descriptor->set_module_name("pipeline.stages.transform");
+    descriptor->set_function_name("transform_batch");
+    descriptor->set_function_hash(std::string(40, 'f'));
+    std::string runtime_env = R"({"pip": [)";
+    for (int i = 0; i < 20; i++) {
+      runtime_env += R"("package-)" + std::to_string(i) + R"(==1.0.0", )";
+    }
+    runtime_env += R"("numpy"], "env_vars": {"PIPELINE_NAME": "streaming-etl"}})";
+    spec.GetMutableMessage().mutable_runtime_env_info()->set_serialized_runtime_env(
+        runtime_env);
+    return spec;
+  }
+
+  void CompletePipelineTask(const TaskSpecification &spec) {
+    manager_.MarkDependenciesResolved(spec.TaskId());
+    manager_.MarkTaskWaitingForExecution(
+        spec.TaskId(), NodeID::FromRandom(), WorkerID::FromRandom());
+    rpc::PushTaskReply reply;
+    auto return_object = reply.add_return_objects();
+    return_object->set_object_id(spec.ReturnId(0).Binary());
+    return_object->set_in_plasma(true);
+    manager_.CompletePendingTask(spec.TaskId(), reply, rpc::Address(), false);
+  }
+};
+
 TEST_F(TaskManagerTest, TestTaskSuccess) {
   rpc::Address caller_address;
   ObjectID dep1 = ObjectID::FromRandom();
@@ -1272,6 +1313,155 @@ TEST_F(TaskManagerLineageTest, TestResubmittedDynamicReturnsTaskFails) {
   ASSERT_EQ(stored_in_plasma.size(), 3);
 }
 
+TEST_F(TaskManagerLineageCompactionTest, TestCompressedLineageResubmit) {
+  RayConfig::instance().initialize(R"({"lineage_compression_min_spec_size": 0})");
+  rpc::Address caller_address;
+  ObjectID dep1 = ObjectID::FromRandom();
+  ObjectID dep2 = ObjectID::FromRandom();
+  auto spec = CreatePipelineTask({dep1, dep2});
+  const auto serialized_spec = spec.GetMessage().SerializeAsString();
+  const int64_t spec_size = serialized_spec.size();
+  auto return_id = spec.ReturnId(0);
+  manager_.AddPendingTask(caller_address, spec, "", /*max_retries=*/3);
+  CompletePipelineTask(spec);
+
+  // The task is pinned as lineage and its spec is compressed.
+  ASSERT_TRUE(manager_.IsTaskSubmissible(spec.TaskId()));
+  ASSERT_GT(manager_.TotalLineageFootprintBytes(), 0);
+  ASSERT_LT(manager_.TotalLineageFootprintBytes(), spec_size);
+  ASSERT_EQ(manager_.GetTaskSpec(spec.TaskId())->GetMessage().SerializeAsString(),
+            serialized_spec);
+
+  // Stats still report the compressed task.
+  rpc::GetCoreWorkerStatsReply reply;
+  manager_.FillTaskInfo(&reply, -1);
+  ASSERT_EQ(reply.owned_task_info_entries_size(), 1);
+  ASSERT_EQ(reply.owned_task_info_entries(0).task_id(), spec.TaskId().Binary());
+  ASSERT_EQ(reply.owned_task_info_entries(0).name(), spec.GetName());
+  rpc::CoreWorkerStats stats;
+  stats.add_object_refs()->set_object_id(return_id.Binary());
+  manager_.AddTaskStatusInfo(&stats);
+  ASSERT_EQ(stats.object_refs(0).task_status(), rpc::TaskStatus::FINISHED);
+  ASSERT_EQ(stats.object_refs(0).attempt_number(), spec.AttemptNumber());
+
+  // The spec is restored when the task is resubmitted.
+  std::vector<ObjectID> resubmitted_task_deps;
+  ASSERT_TRUE(manager_.ResubmitTask(spec.TaskId(), &resubmitted_task_deps));
+  ASSERT_EQ(resubmitted_task_deps, std::vector<ObjectID>({dep1, dep2}));
+  ASSERT_EQ(num_retries_, 1);
+  ASSERT_EQ(manager_.TotalLineageFootprintBytes(), 0);
+  ASSERT_EQ(manager_.GetTaskSpec(spec.TaskId())->GetMessage().SerializeAsString(),
+            serialized_spec);
+
+  // The resubmitted task finishes and is compressed again.
+  CompletePipelineTask(spec);
+  ASSERT_LT(manager_.TotalLineageFootprintBytes(), spec_size);
+
+  // The compressed spec still releases its arguments' lineage.
+  reference_counter_->RemoveLocalReference(return_id, nullptr);
+  ASSERT_FALSE(manager_.IsTaskSubmissible(spec.TaskId()));
+  ASSERT_FALSE(reference_counter_->HasReference(dep1));
+  ASSERT_FALSE(reference_counter_->HasReference(dep2));
+  ASSERT_EQ(reference_counter_->NumObjectIDsInScope(), 0);
+  RayConfig::instance().initialize(R"({"lineage_compression_min_spec_size": -1})");
+}
+
+TEST_F(TaskManagerLineageCompactionTest, TestLineageTruncatedOnDurableSpill) {
+  rpc::Address caller_address;
+  auto spec1 = CreatePipelineTask({});
+  auto return_id1 = spec1.ReturnId(0);
+  manager_.AddPendingTask(caller_address, spec1, "", /*max_retries=*/3);
+  CompletePipelineTask(spec1);
+  auto spec2 = CreatePipelineTask({return_id1});
+  auto return_id2 = spec2.ReturnId(0);
+  manager_.AddPendingTask(caller_address, spec2, "", /*max_retries=*/3);
+  CompletePipelineTask(spec2);
+  reference_counter_->RemoveLocalReference(return_id1, nullptr);
+  // The second task's lineage pins the first task.
+  ASSERT_TRUE(manager_.IsTaskSubmissible(spec1.TaskId()));
+  ASSERT_TRUE(manager_.IsTaskSubmissible(spec2.TaskId()));
+
+  // Spilling to a node's local disk doesn't truncate the lineage, since the
+  // copy is lost with the node.
+  ASSERT_TRUE(reference_counter_->HandleObjectSpilled(
+      return_id2, "/tmp/spill/object", NodeID::FromRandom()));
+  ASSERT_TRUE(manager_.IsTaskSubmissible(spec2.TaskId()));
+
+  // Spilling to external storage releases the lineage of the whole chain.
+  ASSERT_TRUE(reference_counter_->HandleObjectSpilled(
+      return_id2, "s3://bucket/object", NodeID::Nil()));
+  ASSERT_FALSE(manager_.IsTaskSubmissible(spec1.TaskId()));
+  ASSERT_FALSE(manager_.IsTaskSubmissible(spec2.TaskId()));
+  ASSERT_FALSE(reference_counter_->HasReference(return_id1));
+  bool lineage_evicted = false;
+  ASSERT_FALSE(reference_counter_->IsObjectReconstructable(return_id2, &lineage_evicted));
+  ASSERT_EQ(manager_.TotalLineageFootprintBytes(), 0);
+
+  reference_counter_->RemoveLocalReference(return_id2, nullptr);
+  ASSERT_EQ(reference_counter_->NumObjectIDsInScope(), 0);
+}
+
+// Measure the lineage that a long-running streaming pipeline pins. The
+// pipeline runs one task per minute for 24 hours, and each task consumes the
+// previous task's output.
+TEST_F(TaskManagerLineageCompactionTest, TestLongRunningPipelineLineageFootprint) {
+  const int num_tasks = 24 * 60;
+  rpc::Address caller_address;
+  auto run_pipeline = [&](bool spill, int64_t *lineage_bytes, size_t *num_tasks_pinned) {
+    ObjectID prev_id;
+    for (int i = 0; i < num_tasks; i++) {
+      std::vector<ObjectID> dependencies;
+      if (!prev_id.IsNil()) {
+        dependencies.push_back(prev_id);
+      }
+      auto spec = CreatePipelineTask(dependencies);
+      manager_.AddPendingTask(caller_address, spec, "", /*max_retries=*/3);
+      CompletePipelineTask(spec);
+      if (spill) {
+        ASSERT_TRUE(reference_counter_->HandleObjectSpilled(
+            spec.ReturnId(0), "s3://bucket/" + spec.ReturnId(0).Hex(), NodeID::Nil()));
+      }
+      if (!prev_id.IsNil()) {
+        reference_counter_->RemoveLocalReference(prev_id, nullptr);
+      }
+      prev_id = spec.ReturnId(0);
+    }
+    *lineage_bytes = manager_.TotalLineageFootprintBytes();
+    *num_tasks_pinned = manager_.NumSubmissibleTasks();
+    reference_counter_->RemoveLocalReference(prev_id, nullptr);
+    ASSERT_EQ(manager_.NumSubmissibleTasks(), 0);
+    ASSERT_EQ(reference_counter_->NumObjectIDsInScope(), 0);
+  };
+
+  int64_t pinned_bytes;
+  size_t pinned_tasks;
+  auto start = absl::Now();
+  run_pipeline(/*spill=*/false, &pinned_bytes, &pinned_tasks);
+  RAY_LOG(INFO) << "Full lineage: " << pinned_tasks << " tasks, " << pinned_bytes
+                << " bytes, " << absl::ToDoubleMilliseconds(absl::Now() - start) << "ms";
+  ASSERT_EQ(pinned_tasks, num_tasks);
+
+  RayConfig::instance().initialize(R"({"lineage_compression_min_spec_size": 0})");
+  int64_t compressed_bytes;
+  start = absl::Now();
+  run_pipeline(/*spill=*/false, &compressed_bytes, &pinned_tasks);
+  RAY_LOG(INFO) << "Compressed lineage: " << pinned_tasks << " tasks, "
+                << compressed_bytes << " bytes, "
+                << absl::ToDoubleMilliseconds(absl::Now() - start) << "ms";
+  RayConfig::instance().initialize(R"({"lineage_compression_min_spec_size": -1})");
+  ASSERT_EQ(pinned_tasks, num_tasks);
+  ASSERT_LT(compressed_bytes, pinned_bytes);
+
+  int64_t truncated_bytes;
+  start = absl::Now();
+  run_pipeline(/*spill=*/true, &truncated_bytes, &pinned_tasks);
+  RAY_LOG(INFO) << "Lineage truncated on spill: " << pinned_tasks << " tasks, "
+                << truncated_bytes << " bytes, "
+                << absl::ToDoubleMilliseconds(absl::Now() - start) << "ms";
+  ASSERT_EQ(pinned_tasks, 0);
+  ASSERT_EQ(truncated_bytes, 0);
+}
+
 TEST_F(TaskManagerTest, TestObjectRefStreamCreateDelete) {
   /**
    * Test create and deletion of stream works.
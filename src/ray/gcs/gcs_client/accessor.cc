@@ -874,14 +874,14 @@ Status NodeResourceInfoAccessor::GetAllResourceUsage(
 }
 
 Status TaskInfoAccessor::AsyncAddTaskEventData(
-    std::unique_ptr<rpc::TaskEventData> data_ptr, StatusCallback callback) {
+    std::unique_ptr<rpc::TaskEventData> data_ptr, MultiItemCallback<int64_t> callback) {
   rpc::AddTaskEventDataRequest request;
   // Prevent copy here
   request.mutable_data()->Swap(data_ptr.get());
   client_impl_->GetGcsRpcClient().AddTaskEventData(
       request, [callback](const Status &status, rpc::AddTaskEventDataReply &&reply) {
         if (callback) {
-          callback(status);
+          callback(status, VectorFromProtobuf(reply.unknown_attempt_indices()));
         }
         RAY_LOG(DEBUG) << "Accessor added task events grpc OK";
       });
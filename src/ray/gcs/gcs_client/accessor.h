@@ -588,10 +588,11 @@ class TaskInfoAccessor {
   /// Add task event data to GCS asynchronously.
   ///
   /// \param data_ptr The task states event data that will be added to GCS.
-  /// \param callback Callback that will be called when add is complete.
+  /// \param callback Callback that will be called when add is complete, with the
+  /// attempt indices of the state transitions that GCS doesn't know.
   /// \return Status
   virtual Status AsyncAddTaskEventData(std::unique_ptr<rpc::TaskEventData> data_ptr,
-                                       StatusCallback callback);
+                                       MultiItemCallback<int64_t> callback);
 
   /// Get all info/events of all tasks stored in GCS asynchronously.
   ///
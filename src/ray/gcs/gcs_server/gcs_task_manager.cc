@@ -17,6 +17,7 @@
 #include "absl/strings/match.h"
 #include "ray/common/ray_config.h"
 #include "ray/common/status.h"
+#include "ray/util/util.h"
 
 namespace ray {
 namespace gcs {
@@ -510,15 +511,84 @@ void GcsTaskManager::HandleAddTaskEventData(rpc::AddTaskEventDataRequest request
   auto data = std::move(request.data());
   task_event_storage_->RecordDataLossFromWorker(data);
 
+  SenderAttemptIndices *sender = nullptr;
+  if (!data.sender_id().empty()) {
+    sender = &attempt_indices_[UniqueID::FromBinary(data.sender_id())];
+    sender->last_report_ms = current_time_ms();
+  }
+
+  std::vector<int64_t> terminated_attempt_indices;
   for (auto events_by_task : *data.mutable_events_by_task()) {
     stats_counter_.Increment(kTotalNumTaskEventsReported);
+    if (sender != nullptr && events_by_task.has_attempt_index()) {
+      if (IsTaskTerminated(events_by_task)) {
+        terminated_attempt_indices.push_back(events_by_task.attempt_index());
+      } else {
+        sender->attempts[events_by_task.attempt_index()] = {
+            GetTaskAttempt(events_by_task), JobID::FromBinary(events_by_task.job_id())};
+      }
+      events_by_task.clear_attempt_index();
+    }
     task_event_storage_->AddOrReplaceTaskEvent(std::move(events_by_task));
   }
 
+  if (sender != nullptr) {
+    // Transitions might refer to the attempt indices reported above, including the
+    // ones of attempts terminated in this report.
+    AddStateTransitions(*sender, data, reply);
+    for (auto attempt_index : terminated_attempt_indices) {
+      sender->attempts.erase(attempt_index);
+    }
+  }
+
   // Processed all the task events
   GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
 }
 
+void GcsTaskManager::AddStateTransitions(SenderAttemptIndices &sender,
+                                         const rpc::TaskEventData &data,
+                                         rpc::AddTaskEventDataReply *reply) {
+  absl::flat_hash_set<int64_t> unknown_attempt_indices;
+  for (const auto &transition : data.state_transitions()) {
+    auto itr = sender.attempts.find(transition.attempt_index());
+    if (itr == sender.attempts.end()) {
+      // The report with the attempt index didn't reach GCS, GCS restarted or the
+      // sender was garbage collected. Ask the sender to report the attempt in full.
+      stats_counter_.Increment(kTotalNumStateTransitionsUnknownAttempt);
+      if (unknown_attempt_indices.insert(transition.attempt_index()).second) {
+        reply->add_unknown_attempt_indices(transition.attempt_index());
+      }
+      continue;
+    }
+    const auto &[task_attempt, job_id] = itr->second;
+    rpc::TaskEvents events_by_task;
+    events_by_task.set_task_id(task_attempt.first.Binary());
+    events_by_task.set_attempt_number(task_attempt.second);
+    events_by_task.set_job_id(job_id.Binary());
+    (*events_by_task.mutable_state_updates()
+          ->mutable_state_ts_ns())[transition.state()] = transition.timestamp_ns();
+    if (IsTaskTerminated(events_by_task)) {
+      sender.attempts.erase(itr);
+    }
+
+    stats_counter_.Increment(kTotalNumTaskEventsReported);
+    task_event_storage_->AddOrReplaceTaskEvent(std::move(events_by_task));
+  }
+}
+
+void GcsTaskManager::GcAttemptIndices() {
+  const int64_t threshold_ms =
+      RayConfig::instance().task_events_dropped_task_attempts_gc_threshold_s() * 1000;
+  const int64_t now_ms = current_time_ms();
+  for (auto itr = attempt_indices_.begin(); itr != attempt_indices_.end();) {
+    if (now_ms - itr->second.last_report_ms > threshold_ms) {
+      attempt_indices_.erase(itr++);
+    } else {
+      ++itr;
+    }
+  }
+}
+
 std::string GcsTaskManager::DebugString() {
   std::ostringstream ss;
   auto counters = stats_counter_.GetAll();
@@ -531,7 +601,10 @@ std::string GcsTaskManager::DebugString() {
      << "\n-Total num of actor creation tasks: " << counters[kTotalNumActorCreationTask]
      << "\n-Total num of actor tasks: " << counters[kTotalNumActorTask]
      << "\n-Total num of normal tasks: " << counters[kTotalNumNormalTask]
-     << "\n-Total num of driver tasks: " << counters[kTotalNumDriverTask];
+     << "\n-Total num of driver tasks: " << counters[kTotalNumDriverTask]
+     << "\n-Total num state transitions of unknown task attempts: "
+     << counters[kTotalNumStateTransitionsUnknownAttempt]
+     << "\n-Num senders with attempt indices: " << attempt_indices_.size();
 
   return ss.str();
 }
@@ -37,6 +37,7 @@ enum GcsTaskManagerCounter {
   kTotalNumActorTask,
   kTotalNumNormalTask,
   kTotalNumDriverTask,
+  kTotalNumStateTransitionsUnknownAttempt,
 };
 
 const absl::flat_hash_map<rpc::TaskType, GcsTaskManagerCounter> kTaskTypeToCounterType = {
@@ -97,6 +98,9 @@ class GcsTaskManager : public rpc::TaskInfoHandler {
     periodical_runner_.RunFnPeriodically([this] { task_event_storage_->GcJobSummary(); },
                                          5 * 1000,
                                          "GcsTaskManager.GcJobSummary");
+    periodical_runner_.RunFnPeriodically([this] { GcAttemptIndices(); },
+                                         5 * 1000,
+                                         "GcsTaskManager.GcAttemptIndices");
   }
 
   /// Handles a AddTaskEventData request.
@@ -473,6 +477,30 @@ class GcsTaskManager : public rpc::TaskInfoHandler {
   };
 
  private:
+  /// Task attempts that a sender reported with TaskEvents.attempt_index, so that its
+  /// later TaskStateTransition can be expanded to full task events.
+  struct SenderAttemptIndices {
+    /// Task attempt and its job by attempt index.
+    absl::flat_hash_map<int64_t, std::pair<TaskAttempt, JobID>> attempts;
+    /// When the sender reported last.
+    int64_t last_report_ms = 0;
+  };
+
+  /// Expand the state transitions reported by a sender to task events and add them to
+  /// the storage.
+  ///
+  /// \param sender The attempt indices of the sender.
+  /// \param data The task event data with the state transitions.
+  /// \param reply The reply to the sender, which gets the attempt indices GCS doesn't
+  /// know so that the sender reports those attempts in full again.
+  void AddStateTransitions(SenderAttemptIndices &sender,
+                           const rpc::TaskEventData &data,
+                           rpc::AddTaskEventDataReply *reply);
+
+  /// Forget the attempt indices of senders that haven't reported for longer than
+  /// `RAY_task_events_dropped_task_attempts_gc_threshold_s`, e.g. dead workers.
+  void GcAttemptIndices();
+
   /// Record data loss from worker.
   ///
   /// TODO(rickyx): This will be updated to record task attempt loss properly.
@@ -513,6 +541,9 @@ class GcsTaskManager : public rpc::TaskInfoHandler {
   // the io_service_thread_. Access to it is *not* thread safe.
   std::unique_ptr<GcsTaskManagerStorage> task_event_storage_;
 
+  /// Attempt indices by sender. Only accessed from the io_service_thread_.
+  absl::flat_hash_map<UniqueID, SenderAttemptIndices> attempt_indices_;
+
   /// The runner to run function periodically.
   PeriodicalRunner periodical_runner_;
 
@@ -526,6 +557,7 @@ class GcsTaskManager : public rpc::TaskInfoHandler {
   FRIEND_TEST(GcsTaskManagerTest, TestMultipleJobsDataLoss);
   FRIEND_TEST(GcsTaskManagerDroppedTaskAttemptsLimit, TestDroppedTaskAttemptsLimit);
   FRIEND_TEST(GcsTaskManagerProfileEventsLimitTest, TestProfileEventsNoLeak);
+  FRIEND_TEST(GcsTaskManagerTest, TestCompactStateTransitions);
 };
 
 }  // namespace gcs
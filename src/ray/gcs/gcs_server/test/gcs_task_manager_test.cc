@@ -381,6 +381,53 @@ TEST_F(GcsTaskManagerTest, TestMergeTaskEventsSameTaskAttempt) {
   }
 }
 
+TEST_F(GcsTaskManagerTest, TestCompactStateTransitions) {
+  auto task_ids = GenTaskIDs(2);
+  auto sender_id = UniqueID::FromRandom();
+  {
+    rpc::TaskStateUpdate state_update;
+    state_update.mutable_state_ts_ns()->insert({rpc::TaskStatus::RUNNING, 1});
+    auto events = GenTaskEvents(task_ids, 0, 0, absl::nullopt, state_update);
+    for (size_t i = 0; i < events.size(); ++i) {
+      events[i].set_attempt_index(i);
+    }
+    auto events_data = Mocker::GenTaskEventsData(events);
+    events_data.set_sender_id(sender_id.Binary());
+    SyncAddTaskEventData(events_data);
+  }
+
+  {
+    rpc::TaskEventData events_data;
+    events_data.set_sender_id(sender_id.Binary());
+    for (int64_t attempt_index : {0, 1, 7}) {
+      auto transition = events_data.add_state_transitions();
+      transition->set_attempt_index(attempt_index);
+      transition->set_state(rpc::TaskStatus::FINISHED);
+      transition->set_timestamp_ns(2);
+    }
+    auto reply = SyncAddTaskEventData(events_data);
+    // The sender is asked to report the unknown attempt in full again.
+    ASSERT_EQ(reply.unknown_attempt_indices_size(), 1);
+    EXPECT_EQ(reply.unknown_attempt_indices(0), 7);
+  }
+
+  // Transitions are expanded to full task events of the indexed attempts.
+  auto task_events = task_manager->task_event_storage_->GetTaskEvents();
+  EXPECT_EQ(task_events.size(), 2);
+  for (const auto &task_event : task_events) {
+    EXPECT_FALSE(task_event.has_attempt_index());
+    EXPECT_TRUE(task_event.has_task_info());
+    EXPECT_EQ(task_event.state_updates().state_ts_ns().at(rpc::TaskStatus::RUNNING), 1);
+    EXPECT_EQ(task_event.state_updates().state_ts_ns().at(rpc::TaskStatus::FINISHED),
+              2);
+  }
+  EXPECT_EQ(task_manager->GetTotalNumTaskEventsReported(), 4);
+  EXPECT_EQ(task_manager->stats_counter_.Get(kTotalNumStateTransitionsUnknownAttempt),
+            1);
+  // Terminated attempts are forgotten.
+  EXPECT_TRUE(task_manager->attempt_indices_.at(sender_id).attempts.empty());
+}
+
 TEST_F(GcsTaskManagerTest, TestGetTaskEvents) {
   // Add events
   size_t num_profile_events = 10;
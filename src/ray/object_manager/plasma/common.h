@@ -19,6 +19,7 @@
 
 #include <stddef.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -96,7 +97,9 @@ struct Allocation {
         fallback_allocated(false) {}
 
   friend class PlasmaAllocator;
+  friend class ObjectStore;
   friend class DummyAllocator;
+  friend class MallocAllocator;
   friend struct ObjectLifecycleManagerTest;
   FRIEND_TEST(ObjectStoreTest, PassThroughTest);
   FRIEND_TEST(EvictionPolicyTest, Test);
@@ -123,6 +126,14 @@ class LocalObject {
 
   const plasma::flatbuf::ObjectSource &GetSource() const { return source; }
 
+  /// Whether the allocation holds the object's contents compressed. Compressed
+  /// objects must be decompressed before clients can read them.
+  bool IsCompressed() const { return compressed; }
+
+  /// Whether the object shares the allocation of another object with identical
+  /// contents instead of owning its own.
+  bool SharesAllocation() const { return !shared_allocation_owner.IsNil(); }
+
   ray::PlasmaObjectHeader *GetPlasmaObjectHeader() const {
     RAY_CHECK(object_info.is_mutable) << "Object is not mutable";
     auto header_ptr = static_cast<uint8_t *>(allocation.address);
@@ -168,9 +179,11 @@ class LocalObject {
   Allocation allocation;
   /// Ray object info;
   ray::ObjectInfo object_info;
-  /// Number of clients currently using this object.
+  /// Number of clients currently using this object. Atomic because clients that
+  /// get or release an object someone else is also using update it without
+  /// holding the store lock (see ObjectStore::TryAddReference).
   /// TODO: ref_count probably shouldn't belong to LocalObject.
-  mutable int32_t ref_count;
+  mutable std::atomic<int32_t> ref_count;
   /// Unix epoch of when this object was created.
   int64_t create_time;
   /// How long creation of this object took.
@@ -179,5 +192,10 @@ class LocalObject {
   ObjectState state;
   /// The source of the object. Used for debugging purposes.
   plasma::flatbuf::ObjectSource source;
+  /// If not nil, the allocation is owned by this other object with identical
+  /// contents and must not be freed when this object is deleted.
+  ObjectID shared_allocation_owner;
+  /// Whether the allocation holds the object's contents compressed.
+  bool compressed = false;
 };
 }  // namespace plasma
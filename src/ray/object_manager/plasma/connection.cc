@@ -63,18 +63,10 @@ std::shared_ptr<Client> Client::Create(PlasmaStoreMessageHandler message_handler
       [message_handler](std::shared_ptr<ray::ClientConnection> client,
                         int64_t message_type,
                         const std::vector<uint8_t> &message) {
-        Status s = message_handler(
+        message_handler(
             std::static_pointer_cast<Client>(client->shared_ClientConnection_from_this()),
             (MessageType)message_type,
             message);
-        if (!s.ok()) {
-          if (!s.IsDisconnected()) {
-            RAY_LOG(ERROR) << "Fail to process client message. " << s.ToString();
-          }
-          client->Close();
-        } else {
-          client->ProcessMessages();
-        }
       };
   std::shared_ptr<Client> self(new Client(ray_message_handler, std::move(socket)));
   // Let our manager process our new connection.
@@ -82,7 +74,19 @@ std::shared_ptr<Client> Client::Create(PlasmaStoreMessageHandler message_handler
   return self;
 }
 
+void Client::FinishMessage(const Status &status) {
+  if (!status.ok()) {
+    if (!status.IsDisconnected()) {
+      RAY_LOG(ERROR) << "Fail to process client message. " << status.ToString();
+    }
+    Close();
+  } else {
+    ProcessMessages();
+  }
+}
+
 Status Client::SendFd(MEMFD_TYPE fd) {
+  absl::MutexLock lock(&mutex_);
   // Only send the file descriptor if it hasn't been sent (see analogous
   // logic in GetStoreFd in client.cc).
   if (used_fds_.find(fd) == used_fds_.end()) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
 #include "ray/common/client_connection.h"
 #include "ray/common/id.h"
 #include "ray/common/status.h"
@@ -14,7 +15,10 @@ enum class MessageType : int64_t;
 
 class Client;
 
-using PlasmaStoreMessageHandler = std::function<ray::Status(
+/// Handles a message from a client. Once the message is processed, possibly on
+/// another thread, the handler must call Client::FinishMessage. The client reads
+/// its next message only after that, and the message stays valid until then.
+using PlasmaStoreMessageHandler = std::function<void(
     std::shared_ptr<Client>, flatbuf::MessageType, const std::vector<uint8_t> &)>;
 
 class ClientInterface {
@@ -23,6 +27,9 @@ class ClientInterface {
 
   virtual ray::Status SendFd(MEMFD_TYPE fd) = 0;
   virtual const std::unordered_set<ray::ObjectID> &GetObjectIDs() = 0;
+  virtual bool IsObjectUsed(const ray::ObjectID &object_id) {
+    return GetObjectIDs().count(object_id) > 0;
+  }
   virtual void MarkObjectAsUsed(const ray::ObjectID &object_id,
                                 std::optional<MEMFD_TYPE> fallback_allocated_fd) = 0;
   virtual bool MarkObjectAsUnused(const ray::ObjectID &object_id) = 0;
@@ -34,9 +41,23 @@ class Client : public ray::ClientConnection, public ClientInterface {
   static std::shared_ptr<Client> Create(PlasmaStoreMessageHandler message_handler,
                                         ray::local_stream_socket &&socket);
 
+  /// Finish processing the current message: close the connection if the
+  /// status is an error, otherwise read the next message.
+  void FinishMessage(const ray::Status &status);
+
   ray::Status SendFd(MEMFD_TYPE fd) override;
 
-  const std::unordered_set<ray::ObjectID> &GetObjectIDs() override { return object_ids; }
+  /// The object ids may also be changed by the thread that reads this client's
+  /// messages, so only iterate them while it's waiting, e.g. on disconnect.
+  const std::unordered_set<ray::ObjectID> &GetObjectIDs()
+      ABSL_NO_THREAD_SAFETY_ANALYSIS override {
+    return object_ids;
+  }
+
+  bool IsObjectUsed(const ray::ObjectID &object_id) override {
+    absl::MutexLock lock(&mutex_);
+    return object_ids.count(object_id) > 0;
+  }
 
   // Holds the object ID. If the object ID has a fallback-allocated fd, adds the ref count
   // to that fd. Note: used_fds_ is not updated. rather, it's updated in SendFd().
@@ -46,6 +67,7 @@ class Client : public ray::ClientConnection, public ClientInterface {
   virtual void MarkObjectAsUsed(
       const ray::ObjectID &object_id,
       std::optional<MEMFD_TYPE> fallback_allocated_fd) override {
+    absl::MutexLock lock(&mutex_);
     const auto [_, inserted] = object_ids.insert(object_id);
     if (inserted) {
       // new insertion
@@ -79,6 +101,7 @@ class Client : public ray::ClientConnection, public ClientInterface {
   // Returns: bool, client should unmap.
   // Idempotency: only decrements ref count if the object ID was held.
   virtual bool MarkObjectAsUnused(const ray::ObjectID &object_id) override {
+    absl::MutexLock lock(&mutex_);
     size_t erased = object_ids.erase(object_id);
     if (erased == 0) {
       return false;
@@ -108,19 +131,27 @@ class Client : public ray::ClientConnection, public ClientInterface {
 
  private:
   Client(ray::MessageHandler &message_handler, ray::local_stream_socket &&socket);
+
+  /// Protects the state below. The store thread updates it when it serves
+  /// queued requests, while the client's own messages may be handled on
+  /// another thread.
+  absl::Mutex mutex_;
+
   /// File descriptors that are used by this client.
   /// TODO(ekl) we should also clean up old fds that are removed.
-  absl::flat_hash_set<MEMFD_TYPE> used_fds_;
+  absl::flat_hash_set<MEMFD_TYPE> used_fds_ ABSL_GUARDED_BY(mutex_);
 
   /// Object ids that are used by this client.
-  std::unordered_set<ray::ObjectID> object_ids;
+  std::unordered_set<ray::ObjectID> object_ids ABSL_GUARDED_BY(mutex_);
 
   // Records each fd sent to the client and which object IDs are in this fd.
   // Only tracks fallback-allocated fds. This means the main memory is not tracked, and we
   // won't tell client to unmap the main memory. Incremented by `Get`, Decremented by
   // `Release`. If an FD is emptied out, the fd can be unmapped on the client side.
-  absl::flat_hash_map<MEMFD_TYPE, size_t> fallback_allocated_fds_ref_count_;
-  absl::flat_hash_map<ray::ObjectID, MEMFD_TYPE> object_ids_to_fallback_allocated_fds_;
+  absl::flat_hash_map<MEMFD_TYPE, size_t> fallback_allocated_fds_ref_count_
+      ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<ray::ObjectID, MEMFD_TYPE> object_ids_to_fallback_allocated_fds_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 std::ostream &operator<<(std::ostream &os, const std::shared_ptr<Client> &client);
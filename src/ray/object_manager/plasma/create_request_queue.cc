@@ -20,18 +20,34 @@
 
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/object_manager/plasma/common.h"
+#include "ray/stats/metric_defs.h"
 #include "ray/util/util.h"
 
 namespace plasma {
+namespace {
+
+const char *GetSizeClass(size_t object_size) {
+  if (object_size < 1024 * 1024) {
+    return "LessThan1MB";
+  } else if (object_size < 100 * 1024 * 1024) {
+    return "1MBTo100MB";
+  } else if (object_size < 1024 * 1024 * 1024) {
+    return "100MBTo1GB";
+  }
+  return "AtLeast1GB";
+}
+
+}  // namespace
 
 uint64_t CreateRequestQueue::AddRequest(const ObjectID &object_id,
                                         const std::shared_ptr<ClientInterface> &client,
                                         const CreateObjectCallback &create_callback,
-                                        size_t object_size) {
+                                        size_t object_size,
+                                        bool is_task_return) {
   auto req_id = next_req_id_++;
   fulfilled_requests_[req_id] = nullptr;
-  queue_.emplace_back(
-      new CreateRequest(object_id, req_id, client, create_callback, object_size));
+  queues_[is_task_return ? kTaskReturns : kOthers].emplace_back(new CreateRequest(
+      object_id, req_id, client, create_callback, object_size, get_time_()));
   num_bytes_pending_ += object_size;
   return req_id;
 }
@@ -84,8 +100,10 @@ Status CreateRequestQueue::ProcessRequest(bool fallback_allocator,
 Status CreateRequestQueue::ProcessRequests() {
   // Suppress OOM dump to once per grace period.
   bool logged_oom = false;
-  while (!queue_.empty()) {
-    auto request_it = queue_.begin();
+  while (NumPendingRequests() > 0) {
+    auto &queue =
+        queues_[kTaskReturns].empty() ? queues_[kOthers] : queues_[kTaskReturns];
+    auto request_it = queue.begin();
     auto status = ProcessRequest(/*fallback_allocator=*/false, *request_it);
 
     // if allocation failed due to OOM, and fs_monitor_ indicates the local disk is full,
@@ -94,13 +112,13 @@ Status CreateRequestQueue::ProcessRequests() {
       (*request_it)->error = PlasmaError::OutOfDisk;
       RAY_LOG(INFO) << "Out-of-disk: Failed to create object " << (*request_it)->object_id
                     << " of size " << (*request_it)->object_size / 1024 / 1024 << "MB\n";
-      FinishRequest(request_it);
+      FinishRequest(queue, request_it);
       return Status::OutOfDisk("System running out of disk.");
     }
 
     auto now = get_time_();
     if (status.ok()) {
-      FinishRequest(request_it);
+      FinishRequest(queue, request_it);
       // Reset the oom start time since the creation succeeds.
       oom_start_time_ns_ = -1;
     } else {
@@ -111,6 +129,7 @@ Status CreateRequestQueue::ProcessRequests() {
       if (oom_start_time_ns_ == -1) {
         oom_start_time_ns_ = now;
       }
+      ProcessRequestsBehindBlockedHead(**request_it, now);
       auto grace_period_ns = oom_grace_period_ns_;
       auto spill_pending = spill_objects_callback_();
       if (spill_pending) {
@@ -140,7 +159,7 @@ Status CreateRequestQueue::ProcessRequests() {
                         << (*request_it)->object_size / 1024 / 1024 << "MB\n"
                         << dump;
         }
-        FinishRequest(request_it);
+        FinishRequest(queue, request_it);
       }
     }
   }
@@ -148,29 +167,65 @@ Status CreateRequestQueue::ProcessRequests() {
   return Status::OK();
 }
 
-void CreateRequestQueue::FinishRequest(
-    std::list<std::unique_ptr<CreateRequest>>::iterator request_it) {
+void CreateRequestQueue::ProcessRequestsBehindBlockedHead(const CreateRequest &head,
+                                                          int64_t now) {
+  if (blocked_head_req_id_ != head.request_id) {
+    blocked_head_req_id_ = head.request_id;
+    blocked_head_start_time_ns_ = now;
+  }
+  if (now - blocked_head_start_time_ns_ >= max_bypass_ns_) {
+    // Stop letting other requests take memory that the head is waiting for.
+    return;
+  }
+
+  for (auto &queue : queues_) {
+    for (auto it = queue.begin(); it != queue.end();) {
+      auto &request = *it;
+      if (request->request_id == head.request_id ||
+          request->object_size >= head.object_size) {
+        it++;
+        continue;
+      }
+      if (!ProcessRequest(/*fallback_allocator=*/false, request).ok()) {
+        // Nothing smaller is likely to fit either.
+        return;
+      }
+      RAY_LOG(DEBUG) << "Created object " << request->object_id << " of size "
+                     << request->object_size << " ahead of blocked object "
+                     << head.object_id << " of size " << head.object_size;
+      auto finished_it = it++;
+      FinishRequest(queue, finished_it);
+    }
+  }
+}
+
+void CreateRequestQueue::FinishRequest(Queue &queue, Queue::iterator request_it) {
   // Fulfill the request.
   auto &request = *request_it;
+  ray::stats::STATS_object_store_create_request_wait_ms.Record(
+      (get_time_() - request->enqueue_time_ns) / 1e6,
+      GetSizeClass(request->object_size));
   auto it = fulfilled_requests_.find(request->request_id);
   RAY_CHECK(it != fulfilled_requests_.end());
   RAY_CHECK(it->second == nullptr);
   it->second = std::move(request);
   RAY_CHECK(num_bytes_pending_ >= it->second->object_size);
   num_bytes_pending_ -= it->second->object_size;
-  queue_.erase(request_it);
+  queue.erase(request_it);
 }
 
 void CreateRequestQueue::RemoveDisconnectedClientRequests(
     const std::shared_ptr<ClientInterface> &client) {
-  for (auto it = queue_.begin(); it != queue_.end();) {
-    if ((*it)->client == client) {
-      fulfilled_requests_.erase((*it)->request_id);
-      RAY_CHECK(num_bytes_pending_ >= (*it)->object_size);
-      num_bytes_pending_ -= (*it)->object_size;
-      it = queue_.erase(it);
-    } else {
-      it++;
+  for (auto &queue : queues_) {
+    for (auto it = queue.begin(); it != queue.end();) {
+      if ((*it)->client == client) {
+        fulfilled_requests_.erase((*it)->request_id);
+        RAY_CHECK(num_bytes_pending_ >= (*it)->object_size);
+        num_bytes_pending_ -= (*it)->object_size;
+        it = queue.erase(it);
+      } else {
+        it++;
+      }
     }
   }
 
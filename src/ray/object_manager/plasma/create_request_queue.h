@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <array>
+#include <list>
 #include <memory>
 #include <string>
 #include <vector>
@@ -39,9 +41,11 @@ class CreateRequestQueue {
                      ray::SpillObjectsCallback spill_objects_callback,
                      std::function<void()> trigger_global_gc,
                      std::function<int64_t()> get_time,
-                     std::function<std::string()> dump_debug_info_callback = nullptr)
+                     std::function<std::string()> dump_debug_info_callback = nullptr,
+                     int64_t max_bypass_ms = 0)
       : fs_monitor_(fs_monitor),
         oom_grace_period_ns_(oom_grace_period_s * 1e9),
+        max_bypass_ns_(max_bypass_ms * 1e6),
         spill_objects_callback_(spill_objects_callback),
         trigger_global_gc_(trigger_global_gc),
         get_time_(get_time),
@@ -51,18 +55,21 @@ class CreateRequestQueue {
   /// to later get the result of the request.
   ///
   /// The request may not get tried immediately if the head of the queue is not
-  /// serviceable.
+  /// serviceable. Task returns are queued ahead of all other requests, since a
+  /// task can't finish until its returns are stored.
   ///
   /// \param object_id The ID of the object to create.
   /// \param client The client that sent the request. This is used as a key to
   /// drop this request if the client disconnects.
   /// \param create_callback A callback to attempt to create the object.
   /// \param object_size Object size in bytes.
+  /// \param is_task_return Whether the object is a task return value.
   /// \return A request ID that can be used to get the result.
   uint64_t AddRequest(const ObjectID &object_id,
                       const std::shared_ptr<ClientInterface> &client,
                       const CreateObjectCallback &create_callback,
-                      const size_t object_size);
+                      const size_t object_size,
+                      bool is_task_return = false);
 
   /// Get the result of a request.
   ///
@@ -101,8 +108,10 @@ class CreateRequestQueue {
   /// Process requests in the queue.
   ///
   /// This will try to process as many requests in the queue as possible, in
-  /// FIFO order. If the first request is not serviceable, this will break and
-  /// the caller should try again later.
+  /// FIFO order, task returns first. If the first request is not serviceable,
+  /// requests behind it that are smaller are tried in order, for up to
+  /// max_bypass_ms since the first request got blocked; then this will break
+  /// and the caller should try again later.
   ///
   /// \return Bad status for the first request in the queue if it failed to be
   /// serviced, or OK if all requests were fulfilled.
@@ -113,7 +122,9 @@ class CreateRequestQueue {
   /// \param client The client that was disconnected.
   void RemoveDisconnectedClientRequests(const std::shared_ptr<ClientInterface> &client);
 
-  size_t NumPendingRequests() const { return queue_.size(); }
+  size_t NumPendingRequests() const {
+    return queues_[kTaskReturns].size() + queues_[kOthers].size();
+  }
 
   size_t NumPendingBytes() const { return num_bytes_pending_; }
 
@@ -123,12 +134,14 @@ class CreateRequestQueue {
                   uint64_t request_id,
                   const std::shared_ptr<ClientInterface> &client,
                   CreateObjectCallback create_callback,
-                  size_t object_size)
+                  size_t object_size,
+                  int64_t enqueue_time_ns)
         : object_id(object_id),
           request_id(request_id),
           client(client),
           create_callback(create_callback),
-          object_size(object_size) {}
+          object_size(object_size),
+          enqueue_time_ns(enqueue_time_ns) {}
 
     // The ObjectID to create.
     const ObjectID object_id;
@@ -146,19 +159,33 @@ class CreateRequestQueue {
 
     const size_t object_size;
 
+    // When the request was queued, used to record the queueing delay.
+    const int64_t enqueue_time_ns;
+
     // The results of the creation call. These should be sent back to the
     // client once ready.
     PlasmaError error = PlasmaError::OK;
     PlasmaObject result = {};
   };
 
+  using Queue = std::list<std::unique_ptr<CreateRequest>>;
+
+  /// Indices into queues_, in priority order.
+  enum QueueIndex { kTaskReturns = 0, kOthers = 1, kNumQueues = 2 };
+
   /// Process a single request. Sets the request's error result to the error
   /// returned by the request handler inside. Returns OK if the request can be
   /// finished.
   Status ProcessRequest(bool fallback_allocator, std::unique_ptr<CreateRequest> &request);
 
+  /// Try to create the requests queued behind the blocked request at the head
+  /// of the queue that are smaller than it, in priority order. Stops at the
+  /// first request that doesn't fit, or once the head has been blocked for
+  /// longer than max_bypass_ns_, so that it can't be starved.
+  void ProcessRequestsBehindBlockedHead(const CreateRequest &head, int64_t now);
+
   /// Finish a queued request and remove it from the queue.
-  void FinishRequest(std::list<std::unique_ptr<CreateRequest>>::iterator request_it);
+  void FinishRequest(Queue &queue, Queue::iterator request_it);
 
   /// Monitor the disk utilization.
   ray::FileSystemMonitor &fs_monitor_;
@@ -171,6 +198,10 @@ class CreateRequestQueue {
   /// -1 means grace period is infinite.
   const int64_t oom_grace_period_ns_;
 
+  /// How long smaller requests may bypass a blocked request at the head of the
+  /// queue. 0 disables bypassing.
+  const int64_t max_bypass_ns_;
+
   /// A callback to trigger object spilling. It tries to spill objects upto max
   /// throughput. It returns true if space is made by object spilling, and false if
   /// there's no more space to be made.
@@ -197,7 +228,10 @@ class CreateRequestQueue {
   /// in the object store. Then, the client does not need to poll on an
   /// OutOfMemory error and we can just respond to them once there is enough
   /// space made, or after a timeout.
-  std::list<std::unique_ptr<CreateRequest>> queue_;
+  ///
+  /// Task returns and all other requests are kept in separate FIFO queues; the
+  /// head of the queue is the head of the first non-empty one.
+  std::array<Queue, kNumQueues> queues_;
 
   /// A buffer of the results of fulfilled requests. The value will be null
   /// while the request is pending and will be set once the request has
@@ -210,6 +244,11 @@ class CreateRequestQueue {
   /// The time OOM timer first starts. It becomes -1 upon every creation success.
   int64_t oom_start_time_ns_ = -1;
 
+  /// The request that is blocked at the head of the queue, and since when. Used
+  /// to bound how long other requests may bypass it.
+  uint64_t blocked_head_req_id_ = 0;
+  int64_t blocked_head_start_time_ns_ = -1;
+
   size_t num_bytes_pending_ = 0;
 
   friend class CreateRequestQueueTest;
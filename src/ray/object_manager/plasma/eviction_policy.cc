@@ -150,7 +150,16 @@ void EvictionPolicy::RemoveObject(const ObjectID &object_id) {
 }
 
 int64_t EvictionPolicy::GetObjectSize(const ObjectID &object_id) const {
-  return object_store_.GetObject(object_id)->GetObjectSize();
+  auto entry = object_store_.GetObject(object_id);
+  // Objects that share another object's allocation take up no space of their own.
+  if (entry->SharesAllocation()) {
+    return 0;
+  }
+  // Compressed objects only take up the space of their compressed contents.
+  if (entry->IsCompressed()) {
+    return entry->GetAllocation().size;
+  }
+  return entry->GetObjectSize();
 }
 
 bool EvictionPolicy::IsObjectExists(const ObjectID &object_id) const {
@@ -177,7 +177,7 @@ class EvictionPolicy : public IEvictionPolicy {
   std::string DebugString() const override;
 
  private:
-  /// Returns the size of the object
+  /// Returns the space the object takes up in the store
   int64_t GetObjectSize(const ObjectID &object_id) const;
 
   /// Returns whether the object exist in cache or not
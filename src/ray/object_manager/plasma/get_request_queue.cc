@@ -61,7 +61,7 @@ void GetRequestQueue::AddRequest(const std::shared_ptr<ClientInterface> &client,
   for (const auto &object_id : unique_ids) {
     // Check if this object is already present
     // locally. If so, record that the object is being used and mark it as accounted for.
-    auto entry = object_lifecycle_mgr_.GetObject(object_id);
+    auto entry = object_lifecycle_mgr_.GetObjectForRead(object_id);
     if (entry && entry->Sealed()) {
       // Update the get request to take into account the present object.
       auto *plasma_object = &get_request->objects[object_id];
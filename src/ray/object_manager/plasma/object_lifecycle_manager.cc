@@ -17,8 +17,16 @@
 
 #include "ray/object_manager/plasma/object_lifecycle_manager.h"
 
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
+#include "lz4.h"
 #include "ray/common/ray_config.h"
+#include "ray/stats/metric_defs.h"
 
 namespace plasma {
 using namespace flatbuf;
@@ -29,7 +37,13 @@ ObjectLifecycleManager::ObjectLifecycleManager(
       eviction_policy_(std::make_unique<EvictionPolicy>(*object_store_, allocator)),
       delete_object_callback_(delete_object_callback),
       earger_deletion_objects_(),
-      stats_collector_(std::make_unique<ObjectStatsCollector>()) {}
+      stats_collector_(std::make_unique<ObjectStatsCollector>()),
+      dedup_min_object_size_(RayConfig::instance().plasma_dedup_min_object_size()),
+      dedup_max_object_size_(RayConfig::instance().plasma_dedup_max_object_size()),
+      compression_min_object_size_(
+          RayConfig::instance().plasma_compression_min_object_size()),
+      compression_max_object_size_(
+          RayConfig::instance().plasma_compression_max_object_size()) {}
 
 std::pair<const LocalObject *, flatbuf::PlasmaError> ObjectLifecycleManager::CreateObject(
     const ray::ObjectInfo &object_info,
@@ -54,6 +68,53 @@ const LocalObject *ObjectLifecycleManager::GetObject(const ObjectID &object_id)
   return object_store_->GetObject(object_id);
 }
 
+const LocalObject *ObjectLifecycleManager::GetObjectForRead(const ObjectID &object_id) {
+  auto entry = object_store_->GetObject(object_id);
+  if (entry == nullptr || !entry->compressed) {
+    return entry;
+  }
+  RAY_CHECK(entry->ref_count == 0) << object_id << " is compressed while in use.";
+
+  const int64_t object_size = entry->GetObjectSize();
+  const int64_t compressed_size = entry->allocation.size;
+  const bool was_fallback_allocated = entry->allocation.fallback_allocated;
+  auto decompress = [object_size, compressed_size](const void *src, void *dst) {
+    int decompressed_size = LZ4_decompress_safe(static_cast<const char *>(src),
+                                                static_cast<char *>(dst),
+                                                compressed_size,
+                                                object_size);
+    RAY_CHECK(decompressed_size == object_size) << "Failed to decompress object.";
+  };
+
+  // Take the object out of the eviction policy so that making space for its
+  // contents doesn't evict it.
+  eviction_policy_->RemoveObject(object_id);
+  const int64_t start_ns = absl::GetCurrentTimeNanos();
+  auto result = AllocateWithEviction(
+      object_size, /*allow_fallback_allocation=*/true, [&](bool fallback_allocate) {
+        return object_store_->ReallocateObject(object_id,
+                                               object_size,
+                                               fallback_allocate,
+                                               /*compressed=*/false,
+                                               decompress);
+      });
+  if (result == nullptr) {
+    // Evict the object rather than leave it in the store where nobody can read it.
+    // Compressed objects aren't primary copies, so it's pulled or restored again.
+    RAY_LOG(WARNING) << "Out of space to decompress object " << object_id
+                     << ", evicting it.";
+    DeleteObjectInternal(object_id);
+    return nullptr;
+  }
+  eviction_policy_->ObjectCreated(object_id);
+  ray::stats::STATS_object_store_compression_time_ms.Record(
+      (absl::GetCurrentTimeNanos() - start_ns) / 1e6, "Decompress");
+  stats_collector_->OnObjectReallocated(*result, was_fallback_allocated);
+  num_bytes_compressed_ -= object_size;
+  num_bytes_compressed_stored_ -= compressed_size;
+  return result;
+}
+
 const LocalObject *ObjectLifecycleManager::SealObject(const ObjectID &object_id) {
   // TODO(scv119): should we check delete object from earger_deletion_objects_?
   auto entry = object_store_->SealObject(object_id);
@@ -131,8 +192,8 @@ bool ObjectLifecycleManager::AddReference(const ObjectID &object_id) {
     eviction_policy_->BeginObjectAccess(object_id);
   }
   // Increase reference count.
-  entry->ref_count++;
-  stats_collector_->OnObjectRefIncreased(*entry);
+  const int32_t ref_count = ++entry->ref_count;
+  stats_collector_->OnObjectRefIncreased(*entry, ref_count);
   RAY_LOG(DEBUG) << "Object " << object_id << " reference has incremented"
                  << ", num bytes in use is now " << GetNumBytesInUse();
   return true;
@@ -147,10 +208,10 @@ bool ObjectLifecycleManager::RemoveReference(const ObjectID &object_id) {
     return false;
   }
 
-  entry->ref_count--;
-  stats_collector_->OnObjectRefDecreased(*entry);
+  const int32_t ref_count = --entry->ref_count;
+  stats_collector_->OnObjectRefDecreased(*entry, ref_count);
 
-  if (entry->ref_count > 0) {
+  if (ref_count > 0) {
     return true;
   }
 
@@ -163,10 +224,85 @@ bool ObjectLifecycleManager::RemoveReference(const ObjectID &object_id) {
   RAY_CHECK(entry->Sealed()) << object_id << " is not sealed while ref count becomes 0.";
   if (earger_deletion_objects_.count(object_id) > 0) {
     DeleteObjectInternal(object_id);
+  } else {
+    MaybeDeduplicateObject(object_id);
   }
   return true;
 }
 
+const LocalObject *ObjectLifecycleManager::TryAddSharedReference(
+    const ObjectID &object_id) {
+  return object_store_->TryAddReference(object_id, /*min_ref_count=*/2);
+}
+
+bool ObjectLifecycleManager::TryRemoveSharedReference(const ObjectID &object_id) {
+  return object_store_->TryRemoveReference(object_id, /*min_ref_count=*/3);
+}
+
+void ObjectLifecycleManager::MaybeDeduplicateObject(const ObjectID &object_id) {
+  if (dedup_min_object_size_ < 0) {
+    return;
+  }
+  auto entry = object_store_->GetObject(object_id);
+  // Mutable objects are written in place and can't share memory. Objects that
+  // were already hashed are either in the index or share another allocation.
+  if (entry->object_info.is_mutable ||
+      entry->GetObjectSize() < dedup_min_object_size_ ||
+      entry->GetObjectSize() > dedup_max_object_size_ ||
+      !entry->shared_allocation_owner.IsNil() || dedup_hashes_.contains(object_id)) {
+    return;
+  }
+
+  absl::string_view contents(static_cast<const char *>(entry->allocation.address),
+                             entry->GetObjectSize());
+  size_t hash = absl::Hash<absl::string_view>{}(contents);
+  auto it = dedup_index_.find(hash);
+  if (it == dedup_index_.end()) {
+    dedup_index_.emplace(hash, object_id);
+    dedup_hashes_.emplace(object_id, hash);
+    return;
+  }
+
+  const ObjectID owner_id = it->second;
+  auto owner = object_store_->GetObject(owner_id);
+  RAY_CHECK(owner != nullptr) << owner_id << " is in the dedup index but doesn't exist.";
+  // Rule out hash collisions. Only share allocations of the same kind so that
+  // primary and fallback memory usage stay accurate.
+  if (owner->GetObjectSize() != entry->GetObjectSize() ||
+      owner->allocation.fallback_allocated != entry->allocation.fallback_allocated ||
+      std::memcmp(owner->allocation.address,
+                  entry->allocation.address,
+                  entry->GetObjectSize()) != 0) {
+    // Remember that the object was hashed so that it isn't hashed again, but keep
+    // the index pointing at the current owner.
+    dedup_hashes_.emplace(object_id, hash);
+    return;
+  }
+
+  AddReference(owner_id);
+  RAY_CHECK(object_store_->ShareAllocation(object_id, owner_id));
+  // The object takes up no space of its own anymore, so re-add it to the LRU cache
+  // at its new size. Evicting it only frees the reference on the owner.
+  eviction_policy_->RemoveObject(object_id);
+  eviction_policy_->ObjectCreated(object_id);
+  num_bytes_deduplicated_ += entry->GetObjectSize();
+  RAY_LOG(DEBUG) << "Object " << object_id << " now shares the allocation of "
+                 << owner_id << ", num bytes deduplicated is now "
+                 << num_bytes_deduplicated_;
+}
+
+void ObjectLifecycleManager::RemoveFromDedupIndex(const ObjectID &object_id) {
+  auto it = dedup_hashes_.find(object_id);
+  if (it == dedup_hashes_.end()) {
+    return;
+  }
+  auto index_it = dedup_index_.find(it->second);
+  if (index_it != dedup_index_.end() && index_it->second == object_id) {
+    dedup_index_.erase(index_it);
+  }
+  dedup_hashes_.erase(it);
+}
+
 std::string ObjectLifecycleManager::EvictionPolicyDebugString() const {
   return eviction_policy_->DebugString();
 }
@@ -175,25 +311,43 @@ const LocalObject *ObjectLifecycleManager::CreateObjectInternal(
     const ray::ObjectInfo &object_info,
     plasma::flatbuf::ObjectSource source,
     bool allow_fallback_allocation) {
+  return AllocateWithEviction(
+      object_info.GetObjectSize(),
+      allow_fallback_allocation,
+      [this, &object_info, source](bool fallback_allocate) {
+        return object_store_->CreateObject(object_info, source, fallback_allocate);
+      });
+}
+
+const LocalObject *ObjectLifecycleManager::AllocateWithEviction(
+    int64_t size,
+    bool allow_fallback_allocation,
+    const std::function<const LocalObject *(bool fallback_allocate)> &allocate) {
   // Try to evict objects until there is enough space.
   // NOTE(ekl) if we can't achieve this after a number of retries, it's
   // because memory fragmentation in dlmalloc prevents us from allocating
   // even if our footprint tracker here still says we have free space.
   for (int num_tries = 0; num_tries <= 10; num_tries++) {
-    auto result =
-        object_store_->CreateObject(object_info, source, /*fallback_allocate*/ false);
+    auto result = allocate(/*fallback_allocate*/ false);
     if (result != nullptr) {
       return result;
     }
     // Tell the eviction policy how much space we need to create this object.
     std::vector<ObjectID> objects_to_evict;
-    int64_t space_needed =
-        eviction_policy_->RequireSpace(object_info.GetObjectSize(), objects_to_evict);
-    EvictObjects(objects_to_evict);
+    int64_t space_needed = eviction_policy_->RequireSpace(size, objects_to_evict);
+    space_needed += EvictObjects(objects_to_evict);
+    // Compressed objects free less than the eviction policy counted, so keep evicting
+    // until enough space is actually free.
+    while (space_needed > 0 && !objects_to_evict.empty()) {
+      objects_to_evict.clear();
+      space_needed -=
+          eviction_policy_->ChooseObjectsToEvict(space_needed, objects_to_evict);
+      space_needed += EvictObjects(objects_to_evict);
+    }
     // More space is still needed.
     if (space_needed > 0) {
-      RAY_LOG(DEBUG) << "attempt to allocate " << object_info.GetObjectSize()
-                     << " failed, need " << space_needed;
+      RAY_LOG(DEBUG) << "attempt to allocate " << size << " failed, need "
+                     << space_needed;
       break;
     }
   }
@@ -205,10 +359,9 @@ const LocalObject *ObjectLifecycleManager::CreateObjectInternal(
 
   RAY_LOG(INFO)
       << "Shared memory store full, falling back to allocating from filesystem: "
-      << object_info.GetObjectSize();
+      << size;
 
-  auto result =
-      object_store_->CreateObject(object_info, source, /*fallback_allocate*/ true);
+  auto result = allocate(/*fallback_allocate*/ true);
 
   if (result == nullptr) {
     RAY_LOG(ERROR) << "Plasma fallback allocator failed, likely out of disk space.";
@@ -216,7 +369,8 @@ const LocalObject *ObjectLifecycleManager::CreateObjectInternal(
   return result;
 }
 
-void ObjectLifecycleManager::EvictObjects(const std::vector<ObjectID> &object_ids) {
+int64_t ObjectLifecycleManager::EvictObjects(const std::vector<ObjectID> &object_ids) {
+  int64_t bytes_kept = 0;
   for (const auto &object_id : object_ids) {
     RAY_LOG(DEBUG) << "evicting object " << object_id.Hex();
     auto entry = object_store_->GetObject(object_id);
@@ -229,8 +383,68 @@ void ObjectLifecycleManager::EvictObjects(const std::vector<ObjectID> &object_id
     RAY_CHECK(entry->ref_count == 0)
         << "To evict an object, there must be no clients currently using it.";
 
+    if (CompressObject(object_id)) {
+      // Keep the object, and let the eviction policy evict it again later.
+      eviction_policy_->ObjectCreated(object_id);
+      bytes_kept += entry->GetAllocation().size;
+      num_bytes_eviction_avoided_ += entry->GetObjectSize();
+      ray::stats::STATS_object_store_eviction_avoided_bytes.Record(
+          entry->GetObjectSize());
+      continue;
+    }
     DeleteObjectInternal(object_id);
   }
+  return bytes_kept;
+}
+
+bool ObjectLifecycleManager::CompressObject(const ObjectID &object_id) {
+  if (compression_min_object_size_ < 0) {
+    return false;
+  }
+  auto entry = object_store_->GetObject(object_id);
+  const int64_t object_size = entry->GetObjectSize();
+  // Mutable objects are written in place, and objects sharing an allocation
+  // can't change it. Objects in fallback memory don't take up the store.
+  if (entry->compressed || entry->object_info.is_mutable ||
+      !entry->shared_allocation_owner.IsNil() || entry->allocation.fallback_allocated ||
+      object_size < compression_min_object_size_ ||
+      object_size > std::min<int64_t>(compression_max_object_size_, LZ4_MAX_INPUT_SIZE)) {
+    return false;
+  }
+
+  const int64_t start_ns = absl::GetCurrentTimeNanos();
+  std::string compressed(LZ4_compressBound(object_size), '\0');
+  const int compressed_size =
+      LZ4_compress_default(static_cast<const char *>(entry->allocation.address),
+                           compressed.data(),
+                           object_size,
+                           compressed.size());
+  ray::stats::STATS_object_store_compression_time_ms.Record(
+      (absl::GetCurrentTimeNanos() - start_ns) / 1e6, "Compress");
+  // Only keep objects that compress to at most 3/4 of their size, since the
+  // rest aren't worth the cost of decompressing.
+  if (compressed_size <= 0 || compressed_size > object_size / 4 * 3) {
+    return false;
+  }
+
+  auto result = object_store_->ReallocateObject(
+      object_id,
+      compressed_size,
+      /*fallback_allocate=*/false,
+      /*compressed=*/true,
+      [&compressed, compressed_size](const void * /*src*/, void *dst) {
+        std::memcpy(dst, compressed.data(), compressed_size);
+      });
+  if (result == nullptr) {
+    return false;
+  }
+  // The compressed allocation can't be shared with identical objects.
+  RemoveFromDedupIndex(object_id);
+  num_bytes_compressed_ += object_size;
+  num_bytes_compressed_stored_ += compressed_size;
+  RAY_LOG(DEBUG) << "Compressed object " << object_id << " from " << object_size
+                 << " to " << compressed_size << " bytes";
+  return true;
 }
 
 void ObjectLifecycleManager::DeleteObjectInternal(const ObjectID &object_id) {
@@ -238,16 +452,29 @@ void ObjectLifecycleManager::DeleteObjectInternal(const ObjectID &object_id) {
   RAY_CHECK(entry != nullptr);
 
   bool aborted = entry->state == ObjectState::PLASMA_CREATED;
+  const ObjectID allocation_owner = entry->shared_allocation_owner;
+  const int64_t object_size = entry->GetObjectSize();
+  if (entry->compressed) {
+    num_bytes_compressed_ -= object_size;
+    num_bytes_compressed_stored_ -= entry->allocation.size;
+  }
 
   stats_collector_->OnObjectDeleting(*entry);
   earger_deletion_objects_.erase(object_id);
   eviction_policy_->RemoveObject(object_id);
+  RemoveFromDedupIndex(object_id);
   object_store_->DeleteObject(object_id);
 
   if (!aborted) {
     // only send notification if it's not aborted.
     delete_object_callback_(object_id);
   }
+
+  if (!allocation_owner.IsNil()) {
+    // Release the reference that kept the shared allocation alive.
+    num_bytes_deduplicated_ -= object_size;
+    RemoveReference(allocation_owner);
+  }
 }
 
 int64_t ObjectLifecycleManager::GetNumBytesInUse() const {
@@ -255,8 +482,7 @@ int64_t ObjectLifecycleManager::GetNumBytesInUse() const {
 }
 
 bool ObjectLifecycleManager::IsObjectSealed(const ObjectID &object_id) const {
-  auto entry = GetObject(object_id);
-  return entry && entry->state == ObjectState::PLASMA_SEALED;
+  return object_store_->IsObjectSealed(object_id);
 }
 
 int64_t ObjectLifecycleManager::GetNumObjectsCreatedTotal() const {
@@ -275,10 +501,46 @@ int64_t ObjectLifecycleManager::GetNumObjectsUnsealed() const {
   return stats_collector_->GetNumObjectsUnsealed();
 }
 
-void ObjectLifecycleManager::RecordMetrics() const { stats_collector_->RecordMetrics(); }
+int64_t ObjectLifecycleManager::GetNumBytesDeduplicated() const {
+  return num_bytes_deduplicated_;
+}
+
+int64_t ObjectLifecycleManager::GetNumBytesCompressed() const {
+  return num_bytes_compressed_;
+}
+
+int64_t ObjectLifecycleManager::GetNumBytesCompressedStored() const {
+  return num_bytes_compressed_stored_;
+}
+
+int64_t ObjectLifecycleManager::GetNumBytesEvictionAvoided() const {
+  return num_bytes_eviction_avoided_;
+}
+
+void ObjectLifecycleManager::RecordMetrics() const {
+  stats_collector_->RecordMetrics();
+  if (dedup_min_object_size_ >= 0) {
+    ray::stats::STATS_object_store_deduplicated_bytes.Record(num_bytes_deduplicated_);
+  }
+  if (compression_min_object_size_ >= 0) {
+    ray::stats::STATS_object_store_compressed_bytes.Record(num_bytes_compressed_,
+                                                           "ORIGINAL");
+    ray::stats::STATS_object_store_compressed_bytes.Record(num_bytes_compressed_stored_,
+                                                           "STORED");
+  }
+}
 
 void ObjectLifecycleManager::GetDebugDump(std::stringstream &buffer) const {
-  return stats_collector_->GetDebugDump(buffer);
+  stats_collector_->GetDebugDump(buffer);
+  if (dedup_min_object_size_ >= 0) {
+    buffer << "- bytes deduplicated: " << num_bytes_deduplicated_ << "\n";
+  }
+  if (compression_min_object_size_ >= 0) {
+    buffer << "- bytes compressed: " << num_bytes_compressed_ << "\n";
+    buffer << "- bytes compressed (stored): " << num_bytes_compressed_stored_ << "\n";
+    buffer << "- bytes compressed instead of evicted: " << num_bytes_eviction_avoided_
+           << "\n";
+  }
 }
 
 // For test only.
@@ -291,6 +553,10 @@ ObjectLifecycleManager::ObjectLifecycleManager(
       eviction_policy_(std::move(eviction_policy)),
       delete_object_callback_(delete_object_callback),
       earger_deletion_objects_(),
-      stats_collector_(std::move(stats_collector)) {}
+      stats_collector_(std::move(stats_collector)),
+      dedup_min_object_size_(-1),
+      dedup_max_object_size_(-1),
+      compression_min_object_size_(-1),
+      compression_max_object_size_(-1) {}
 
 }  // namespace plasma
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <functional>
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "gtest/gtest.h"
 #include "ray/object_manager/plasma/common.h"
@@ -52,6 +55,17 @@ class IObjectLifecycleManager {
   ///   - otherwise, pointer to the object.
   virtual const LocalObject *GetObject(const ObjectID &object_id) const = 0;
 
+  /// Get an object whose contents clients are about to read. If the object is
+  /// held compressed, it is decompressed first.
+  /// \return
+  ///   - nullptr if such object doesn't exist, or there's no space to
+  ///     decompress it. In the latter case the object is evicted, so that it's
+  ///     pulled or restored again like any other evicted object.
+  ///   - otherwise, pointer to the object.
+  virtual const LocalObject *GetObjectForRead(const ObjectID &object_id) {
+    return GetObject(object_id);
+  }
+
   /// Seal created object by id.
   ///
   /// \param object_id Object ID of the object to be sealed.
@@ -110,6 +124,8 @@ class ObjectLifecycleManager : public IObjectLifecycleManager {
 
   const LocalObject *GetObject(const ObjectID &object_id) const override;
 
+  const LocalObject *GetObjectForRead(const ObjectID &object_id) override;
+
   const LocalObject *SealObject(const ObjectID &object_id) override;
 
   flatbuf::PlasmaError AbortObject(const ObjectID &object_id) override;
@@ -120,6 +136,22 @@ class ObjectLifecycleManager : public IObjectLifecycleManager {
 
   bool RemoveReference(const ObjectID &object_id) override;
 
+  /// Add a reference to a sealed object that at least two clients already use.
+  /// Going from two references up never changes whether the object is
+  /// evictable, spillable or in use, so unlike the other methods this only
+  /// locks the object's shard of the object table and is safe to call
+  /// concurrently with them.
+  ///
+  /// \return pointer to the object, or nullptr if no reference was added.
+  const LocalObject *TryAddSharedReference(const ObjectID &object_id);
+
+  /// Remove a reference to an object that at least three clients use, so that
+  /// it stays shared. Like TryAddSharedReference, this is safe to call
+  /// concurrently with the other methods.
+  ///
+  /// \return true if a reference was removed.
+  bool TryRemoveSharedReference(const ObjectID &object_id);
+
   /// Ask it to evict objects until we have at least size of capacity
   /// available.
   /// TEST ONLY
@@ -129,6 +161,8 @@ class ObjectLifecycleManager : public IObjectLifecycleManager {
 
   std::string EvictionPolicyDebugString() const;
 
+  /// Check whether the object is sealed. Like TryAddSharedReference, this is
+  /// safe to call concurrently with the other methods.
   bool IsObjectSealed(const ObjectID &object_id) const;
 
   int64_t GetNumBytesInUse() const;
@@ -141,6 +175,17 @@ class ObjectLifecycleManager : public IObjectLifecycleManager {
 
   int64_t GetNumObjectsUnsealed() const;
 
+  /// Bytes of objects that share the allocation of an identical object instead
+  /// of holding their own copy.
+  int64_t GetNumBytesDeduplicated() const;
+
+  /// Bytes of objects held compressed, and the memory they take up compressed.
+  int64_t GetNumBytesCompressed() const;
+  int64_t GetNumBytesCompressedStored() const;
+
+  /// Total bytes of objects that were compressed instead of evicted.
+  int64_t GetNumBytesEvictionAvoided() const;
+
   void RecordMetrics() const;
 
   void GetDebugDump(std::stringstream &buffer) const;
@@ -163,12 +208,50 @@ class ObjectLifecycleManager : public IObjectLifecycleManager {
                                           plasma::flatbuf::ObjectSource source,
                                           bool allow_fallback_allocation);
 
-  // Evict objects returned by the eviction policy.
+  // Call `allocate` until it succeeds, evicting objects to make space for `size`
+  // bytes in between. If that fails, call it once more with fallback allocation.
+  //
+  // \param size The number of bytes to allocate.
+  // \param allow_fallback_allocation Whether to fall back to the filesystem.
+  // \param allocate Allocates from the primary or the fallback allocator.
+  // \return The result of the last call to `allocate`.
+  const LocalObject *AllocateWithEviction(
+      int64_t size,
+      bool allow_fallback_allocation,
+      const std::function<const LocalObject *(bool fallback_allocate)> &allocate);
+
+  // Evict objects returned by the eviction policy. Objects that can be
+  // compressed are compressed and kept instead.
   //
   // \param object_ids Object IDs of the objects to be evicted.
-  void EvictObjects(const std::vector<ObjectID> &object_ids);
+  // Evict the given objects, compressing those that can be compressed instead of
+  // deleting them.
+  //
+  // \return The bytes that the objects still take up because they were compressed.
+  // The eviction policy counts them as freed.
+  int64_t EvictObjects(const std::vector<ObjectID> &object_ids);
 
   void DeleteObjectInternal(const ObjectID &object_id);
+
+  // Hash the contents of a sealed object that is no longer in use. If another
+  // object with identical contents exists, release this object's allocation
+  // and share the other object's instead. The other object is kept alive by a
+  // reference until this object is deleted.
+  //
+  // \param object_id Object ID of the object to deduplicate.
+  void MaybeDeduplicateObject(const ObjectID &object_id);
+
+  // Stop offering the allocation of an object for sharing. Called before the
+  // object is deleted.
+  void RemoveFromDedupIndex(const ObjectID &object_id);
+
+  // Compress the contents of a sealed object that is no longer in use, if
+  // compression is enabled and saves enough space.
+  //
+  // \param object_id Object ID of the object to compress.
+  // \return Whether the object is now held compressed.
+  bool CompressObject(const ObjectID &object_id);
+
   std::unique_ptr<IObjectStore> object_store_;
   std::unique_ptr<IEvictionPolicy> eviction_policy_;
   const ray::DeleteObjectCallback delete_object_callback_;
@@ -178,5 +261,31 @@ class ObjectLifecycleManager : public IObjectLifecycleManager {
   absl::flat_hash_set<ObjectID> earger_deletion_objects_;
 
   std::unique_ptr<ObjectStatsCollector> stats_collector_;
+
+  // Minimum size of objects to deduplicate, or -1 if deduplication is disabled.
+  const int64_t dedup_min_object_size_;
+  // Maximum size of objects to deduplicate.
+  const int64_t dedup_max_object_size_;
+
+  // Content hash to the object whose allocation is shared by objects with
+  // that content.
+  absl::flat_hash_map<size_t, ObjectID> dedup_index_;
+  // The content hash of every object that was hashed and owns its allocation,
+  // whether or not it is the one in the index for that hash.
+  absl::flat_hash_map<ObjectID, size_t> dedup_hashes_;
+
+  // Bytes of objects that share another object's allocation.
+  int64_t num_bytes_deduplicated_ = 0;
+
+  // Minimum size of objects to compress, or -1 if compression is disabled.
+  const int64_t compression_min_object_size_;
+  // Maximum size of objects to compress.
+  const int64_t compression_max_object_size_;
+
+  // Bytes of objects held compressed, and the memory they take up compressed.
+  int64_t num_bytes_compressed_ = 0;
+  int64_t num_bytes_compressed_stored_ = 0;
+  // Total bytes of objects compressed instead of evicted.
+  int64_t num_bytes_eviction_avoided_ = 0;
 };
 }  // namespace plasma
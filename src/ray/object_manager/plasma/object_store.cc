@@ -19,15 +19,25 @@
 
 namespace plasma {
 
-ObjectStore::ObjectStore(IAllocator &allocator)
-    : allocator_(allocator), object_table_() {}
+ObjectStore::ObjectStore(IAllocator &allocator, size_t num_shards)
+    : allocator_(allocator) {
+  RAY_CHECK(num_shards > 0);
+  shards_.reserve(num_shards);
+  for (size_t i = 0; i < num_shards; i++) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+ObjectStore::Shard &ObjectStore::GetShard(const ObjectID &object_id) const {
+  return *shards_[object_id.Hash() % shards_.size()];
+}
 
 const LocalObject *ObjectStore::CreateObject(const ray::ObjectInfo &object_info,
                                              plasma::flatbuf::ObjectSource source,
                                              bool fallback_allocate) {
   RAY_LOG(DEBUG) << "attempting to create object " << object_info.object_id << " size "
                  << object_info.data_size;
-  RAY_CHECK(object_table_.count(object_info.object_id) == 0)
+  RAY_CHECK(GetObject(object_info.object_id) == nullptr)
       << object_info.object_id << " already exists!";
   auto object_size = object_info.GetObjectSize();
   auto allocation = fallback_allocate ? allocator_.FallbackAllocate(object_size)
@@ -39,8 +49,7 @@ const LocalObject *ObjectStore::CreateObject(const ray::ObjectInfo &object_info,
     return nullptr;
   }
   auto ptr = std::make_unique<LocalObject>(std::move(allocation.value()));
-  auto entry =
-      object_table_.emplace(object_info.object_id, std::move(ptr)).first->second.get();
+  auto entry = ptr.get();
   entry->object_info = object_info;
   entry->state = ObjectState::PLASMA_CREATED;
   entry->create_time = std::time(nullptr);
@@ -54,42 +63,152 @@ const LocalObject *ObjectStore::CreateObject(const ray::ObjectInfo &object_info,
   }
 #endif
 
+  {
+    auto &shard = GetShard(object_info.object_id);
+    absl::MutexLock lock(&shard.mutex);
+    shard.object_table.emplace(object_info.object_id, std::move(ptr));
+  }
   RAY_LOG(DEBUG) << "create object " << object_info.object_id << " succeeded";
   return entry;
 }
 
 const LocalObject *ObjectStore::GetObject(const ObjectID &object_id) const {
-  auto it = object_table_.find(object_id);
-  if (it == object_table_.end()) {
+  auto &shard = GetShard(object_id);
+  absl::ReaderMutexLock lock(&shard.mutex);
+  auto it = shard.object_table.find(object_id);
+  if (it == shard.object_table.end()) {
     return nullptr;
   }
   return it->second.get();
 }
 
+bool ObjectStore::IsObjectSealed(const ObjectID &object_id) const {
+  auto &shard = GetShard(object_id);
+  absl::ReaderMutexLock lock(&shard.mutex);
+  auto it = shard.object_table.find(object_id);
+  return it != shard.object_table.end() && it->second->Sealed();
+}
+
+const LocalObject *ObjectStore::TryAddReference(const ObjectID &object_id,
+                                                int32_t min_ref_count) {
+  auto &shard = GetShard(object_id);
+  absl::ReaderMutexLock lock(&shard.mutex);
+  auto it = shard.object_table.find(object_id);
+  if (it == shard.object_table.end() || !it->second->Sealed()) {
+    return nullptr;
+  }
+  auto &ref_count = it->second->ref_count;
+  int32_t current = ref_count.load();
+  while (current >= min_ref_count) {
+    if (ref_count.compare_exchange_weak(current, current + 1)) {
+      return it->second.get();
+    }
+  }
+  return nullptr;
+}
+
+bool ObjectStore::TryRemoveReference(const ObjectID &object_id, int32_t min_ref_count) {
+  auto &shard = GetShard(object_id);
+  absl::ReaderMutexLock lock(&shard.mutex);
+  auto it = shard.object_table.find(object_id);
+  if (it == shard.object_table.end()) {
+    return false;
+  }
+  auto &ref_count = it->second->ref_count;
+  int32_t current = ref_count.load();
+  while (current >= min_ref_count) {
+    if (ref_count.compare_exchange_weak(current, current - 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 const LocalObject *ObjectStore::SealObject(const ObjectID &object_id) {
   auto entry = GetMutableObject(object_id);
   if (entry == nullptr || entry->state == ObjectState::PLASMA_SEALED) {
     return nullptr;
   }
+  absl::MutexLock lock(&GetShard(object_id).mutex);
   entry->state = ObjectState::PLASMA_SEALED;
   entry->construct_duration = std::time(nullptr) - entry->create_time;
   return entry;
 }
 
 bool ObjectStore::DeleteObject(const ObjectID &object_id) {
+  std::unique_ptr<LocalObject> entry;
+  {
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mutex);
+    auto it = shard.object_table.find(object_id);
+    if (it == shard.object_table.end()) {
+      return false;
+    }
+    entry = std::move(it->second);
+    shard.object_table.erase(it);
+  }
+
+  if (entry->shared_allocation_owner.IsNil()) {
+    allocator_.Free(std::move(entry->allocation));
+  }
+  return true;
+}
+
+bool ObjectStore::ShareAllocation(const ObjectID &object_id, const ObjectID &owner_id) {
+  auto owner = GetMutableObject(owner_id);
   auto entry = GetMutableObject(object_id);
-  if (!entry) {
+  if (owner == nullptr || entry == nullptr) {
     return false;
   }
-
+  RAY_CHECK(owner->shared_allocation_owner.IsNil())
+      << owner_id << " doesn't own its allocation";
+  RAY_CHECK(entry->Sealed() && entry->shared_allocation_owner.IsNil())
+      << object_id << " can't share an allocation";
+  Allocation shared(owner->allocation.address,
+                    owner->allocation.size,
+                    owner->allocation.fd,
+                    owner->allocation.offset,
+                    owner->allocation.device_num,
+                    owner->allocation.mmap_size,
+                    owner->allocation.fallback_allocated);
+  absl::MutexLock lock(&GetShard(object_id).mutex);
   allocator_.Free(std::move(entry->allocation));
-  object_table_.erase(object_id);
+  entry->allocation = std::move(shared);
+  entry->shared_allocation_owner = owner_id;
   return true;
 }
 
+const LocalObject *ObjectStore::ReallocateObject(
+    const ObjectID &object_id,
+    int64_t size,
+    bool fallback_allocate,
+    bool compressed,
+    const std::function<void(const void *, void *)> &copy) {
+  auto entry = GetMutableObject(object_id);
+  if (entry == nullptr) {
+    return nullptr;
+  }
+  RAY_CHECK(entry->Sealed() && entry->shared_allocation_owner.IsNil())
+      << object_id << " can't be reallocated";
+
+  auto allocation = fallback_allocate ? allocator_.FallbackAllocate(size)
+                                      : allocator_.Allocate(size);
+  if (!allocation.has_value()) {
+    return nullptr;
+  }
+  copy(entry->allocation.address, allocation->address);
+  absl::MutexLock lock(&GetShard(object_id).mutex);
+  allocator_.Free(std::move(entry->allocation));
+  entry->allocation = std::move(allocation.value());
+  entry->compressed = compressed;
+  return entry;
+}
+
 LocalObject *ObjectStore::GetMutableObject(const ObjectID &object_id) {
-  auto it = object_table_.find(object_id);
-  if (it == object_table_.end()) {
+  auto &shard = GetShard(object_id);
+  absl::ReaderMutexLock lock(&shard.mutex);
+  auto it = shard.object_table.find(object_id);
+  if (it == shard.object_table.end()) {
     return nullptr;
   }
   return it->second.get();
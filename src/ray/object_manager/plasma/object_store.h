@@ -17,7 +17,12 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include "ray/object_manager/plasma/allocator.h"
 #include "ray/object_manager/plasma/common.h"
 #include "ray/object_manager/plasma/plasma.h"
@@ -52,6 +57,42 @@ class IObjectStore {
   ///   - otherwise, pointer to the object.
   virtual const LocalObject *GetObject(const ObjectID &object_id) const = 0;
 
+  /// Check whether an object exists and has been sealed.
+  ///
+  /// \param object_id Object ID of the object to be checked.
+  /// \return true if the object exists and is sealed.
+  virtual bool IsObjectSealed(const ObjectID &object_id) const {
+    auto entry = GetObject(object_id);
+    return entry && entry->Sealed();
+  }
+
+  /// Increment the reference count of a sealed object, but only if it's
+  /// already at least min_ref_count. The check and the increment are atomic.
+  ///
+  /// \param object_id Object ID of the object to be referenced.
+  /// \param min_ref_count The smallest reference count that may be incremented.
+  /// \return
+  ///   - nullptr if such object doesn't exist, isn't sealed or has fewer
+  ///     references, or if this isn't supported.
+  ///   - otherwise, pointer to the object.
+  virtual const LocalObject *TryAddReference(const ObjectID &object_id,
+                                             int32_t min_ref_count) {
+    return nullptr;
+  }
+
+  /// Decrement the reference count of an object, but only if it's at least
+  /// min_ref_count. The check and the decrement are atomic.
+  ///
+  /// \param object_id Object ID of the object to be released.
+  /// \param min_ref_count The smallest reference count that may be decremented.
+  /// \return
+  ///   - false if such object doesn't exist or has fewer references, or if this
+  ///     isn't supported.
+  ///   - true if the reference count was decremented.
+  virtual bool TryRemoveReference(const ObjectID &object_id, int32_t min_ref_count) {
+    return false;
+  }
+
   /// Seal created object by id.
   ///
   /// \param object_id Object ID of the object to be sealed.
@@ -67,13 +108,55 @@ class IObjectStore {
   ///   - false if such object doesn't exist.
   ///   - true if deleted.
   virtual bool DeleteObject(const ObjectID &object_id) = 0;
+
+  /// Make a sealed object share the allocation of another sealed object with
+  /// identical contents, and free the object's own allocation. The shared
+  /// allocation is not freed when the object is deleted.
+  ///
+  /// \param object_id Object ID of the object whose allocation is released.
+  /// \param owner_id Object ID of the object that owns the shared allocation.
+  /// \return
+  ///   - false if sharing isn't supported or either object doesn't exist.
+  ///   - true if the allocation is now shared.
+  virtual bool ShareAllocation(const ObjectID &object_id, const ObjectID &owner_id) {
+    return false;
+  }
+
+  /// Move the contents of a sealed object to a new allocation, e.g. to store
+  /// them compressed. The old allocation is freed once the contents are moved.
+  ///
+  /// \param object_id Object ID of the object to be moved.
+  /// \param size Size in bytes of the new allocation.
+  /// \param fallback_allocate Whether to use fallback allocation.
+  /// \param compressed Whether the new allocation holds the contents compressed.
+  /// \param copy Fills the new allocation given the old and new addresses.
+  /// \return
+  ///   - nullptr if such object doesn't exist, or when out of space. The object
+  ///     is unchanged in that case.
+  ///   - otherwise, pointer to the moved object.
+  virtual const LocalObject *ReallocateObject(
+      const ObjectID &object_id,
+      int64_t size,
+      bool fallback_allocate,
+      bool compressed,
+      const std::function<void(const void *, void *)> &copy) {
+    return nullptr;
+  }
 };
 
 // ObjectStore implements IObjectStore. It uses IAllocator
 // to allocate memory for object creation.
+//
+// The object table is split into shards by ObjectID, each guarded by its own
+// reader-writer mutex. GetObject, IsObjectSealed, TryAddReference and
+// TryRemoveReference only lock the object's shard and may be called from any
+// thread. The methods that create, seal, move or delete objects, and so call
+// into the allocator, must still be serialized by the caller.
 class ObjectStore : public IObjectStore {
  public:
-  explicit ObjectStore(IAllocator &allocator);
+  static constexpr size_t kDefaultNumShards = 16;
+
+  explicit ObjectStore(IAllocator &allocator, size_t num_shards = kDefaultNumShards);
 
   const LocalObject *CreateObject(const ray::ObjectInfo &object_info,
                                   plasma::flatbuf::ObjectSource source,
@@ -81,19 +164,45 @@ class ObjectStore : public IObjectStore {
 
   const LocalObject *GetObject(const ObjectID &object_id) const override;
 
+  bool IsObjectSealed(const ObjectID &object_id) const override;
+
+  const LocalObject *TryAddReference(const ObjectID &object_id,
+                                     int32_t min_ref_count) override;
+
+  bool TryRemoveReference(const ObjectID &object_id, int32_t min_ref_count) override;
+
   const LocalObject *SealObject(const ObjectID &object_id) override;
 
   bool DeleteObject(const ObjectID &object_id) override;
 
+  bool ShareAllocation(const ObjectID &object_id, const ObjectID &owner_id) override;
+
+  const LocalObject *ReallocateObject(
+      const ObjectID &object_id,
+      int64_t size,
+      bool fallback_allocate,
+      bool compressed,
+      const std::function<void(const void *, void *)> &copy) override;
+
  private:
   friend struct ObjectStatsCollectorTest;
 
+  /// A partition of the object table.
+  struct Shard {
+    mutable absl::Mutex mutex;
+    /// Mapping from ObjectIDs to information about the object.
+    absl::flat_hash_map<ObjectID, std::unique_ptr<LocalObject>> object_table
+        ABSL_GUARDED_BY(mutex);
+  };
+
+  Shard &GetShard(const ObjectID &object_id) const;
+
   LocalObject *GetMutableObject(const ObjectID &object_id);
 
   /// Allocator that allocates memory.
   IAllocator &allocator_;
 
-  /// Mapping from ObjectIDs to information about the object.
-  absl::flat_hash_map<ObjectID, std::unique_ptr<LocalObject>> object_table_;
+  /// The shards of the object table. Never resized after construction.
+  std::vector<std::unique_ptr<Shard>> shards_;
 };
 }  // namespace plasma
@@ -132,13 +132,14 @@ void ObjectStatsCollector::OnObjectDeleting(const LocalObject &obj) {
   }
 }
 
-void ObjectStatsCollector::OnObjectRefIncreased(const LocalObject &obj) {
+void ObjectStatsCollector::OnObjectRefIncreased(const LocalObject &obj,
+                                                int32_t ref_count) {
   const auto kObjectSize = obj.GetObjectInfo().GetObjectSize();
   const auto kSource = obj.GetSource();
   const bool kSealed = obj.Sealed();
 
   // object ref count bump from 0 to 1
-  if (obj.GetRefCount() == 1) {
+  if (ref_count == 1) {
     num_objects_in_use_++;
     num_bytes_in_use_ += kObjectSize;
 
@@ -154,20 +155,21 @@ void ObjectStatsCollector::OnObjectRefIncreased(const LocalObject &obj) {
   }
 
   // object ref count bump from 1 to 2
-  if (obj.GetRefCount() == 2 &&
-      kSource == plasma::flatbuf::ObjectSource::CreatedByWorker && kSealed) {
+  if (ref_count == 2 && kSource == plasma::flatbuf::ObjectSource::CreatedByWorker &&
+      kSealed) {
     num_objects_spillable_--;
     num_bytes_spillable_ -= kObjectSize;
   }
 }
 
-void ObjectStatsCollector::OnObjectRefDecreased(const LocalObject &obj) {
+void ObjectStatsCollector::OnObjectRefDecreased(const LocalObject &obj,
+                                                int32_t ref_count) {
   const auto kObjectSize = obj.GetObjectInfo().GetObjectSize();
   const auto kSource = obj.GetSource();
   const bool kSealed = obj.Sealed();
 
   // object ref count decrease from 2 to 1
-  if (obj.GetRefCount() == 1) {
+  if (ref_count == 1) {
     if (kSource == plasma::flatbuf::ObjectSource::CreatedByWorker && kSealed) {
       num_objects_spillable_++;
       num_bytes_spillable_ += kObjectSize;
@@ -175,7 +177,7 @@ void ObjectStatsCollector::OnObjectRefDecreased(const LocalObject &obj) {
   }
 
   // object ref count decrease from 1 to 0
-  if (obj.GetRefCount() == 0) {
+  if (ref_count == 0) {
     num_objects_in_use_--;
     num_bytes_in_use_ -= kObjectSize;
 
@@ -191,6 +193,14 @@ void ObjectStatsCollector::OnObjectRefDecreased(const LocalObject &obj) {
   }
 }
 
+void ObjectStatsCollector::OnObjectReallocated(const LocalObject &obj,
+                                               bool was_fallback_allocated) {
+  RAY_CHECK(obj.Sealed());
+  bytes_by_loc_seal_.Swap({was_fallback_allocated, /* sealed */ true},
+                          {obj.GetAllocation().fallback_allocated, /* sealed */ true},
+                          obj.GetObjectInfo().GetObjectSize());
+}
+
 int64_t ObjectStatsCollector::GetNumBytesCreatedCurrent() const {
   return num_bytes_created_by_worker_ + num_bytes_restored_ + num_bytes_received_ +
          num_bytes_errored_;
@@ -45,11 +45,15 @@ class ObjectStatsCollector {
   // Marked virtual for test mocking
   virtual void OnObjectDeleting(const LocalObject &object);
 
-  // Called after an object's ref count is bumped by 1.
-  void OnObjectRefIncreased(const LocalObject &object);
+  // Called after an object's ref count is bumped by 1 to ref_count. The new count
+  // is passed in because clients may change it again concurrently.
+  void OnObjectRefIncreased(const LocalObject &object, int32_t ref_count);
 
-  // Called after an object's ref count is decreased by 1.
-  void OnObjectRefDecreased(const LocalObject &object);
+  // Called after an object's ref count is decreased by 1 to ref_count.
+  void OnObjectRefDecreased(const LocalObject &object, int32_t ref_count);
+
+  // Called after a sealed object is moved to a new allocation.
+  void OnObjectReallocated(const LocalObject &object, bool was_fallback_allocated);
 
   /// Record the internal metrics.
   void RecordMetrics() const;
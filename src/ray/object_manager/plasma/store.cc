@@ -21,7 +21,9 @@
 // (name passed in via the -s option of the executable) and uses a
 // single thread to serve the clients. Each client establishes a
 // connection and can create objects, wait for objects and seal
-// objects through that connection.
+// objects through that connection. Connections may be read on separate
+// client io threads, which serve gets, contains and releases of objects
+// other clients also use themselves and pass everything else to that thread.
 //
 // It keeps a hash table that maps object_ids (which are 20 byte long,
 // just enough to store and SHA1 hash) to memory mapped files.
@@ -100,7 +102,8 @@ PlasmaStore::PlasmaStore(instrumented_io_context &main_service,
           [this]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
             mutex_.AssertHeld();
             return GetDebugDump();
-          }),
+          },
+          RayConfig::instance().plasma_create_request_max_bypass_ms()),
       total_consumed_bytes_(0),
       get_request_queue_(
           io_context_,
@@ -115,6 +118,12 @@ PlasmaStore::PlasmaStore(instrumented_io_context &main_service,
           [this](const auto &request) { this->ReturnFromGet(request); }) {
   ray::SetCloseOnFork(acceptor_);
 
+  if (RayConfig::instance().plasma_store_num_client_io_threads() > 0) {
+    client_io_pool_ = std::make_unique<ray::IOServicePool>(
+        RayConfig::instance().plasma_store_num_client_io_threads());
+    client_io_pool_->Run();
+  }
+
   if (RayConfig::instance().event_stats_print_interval_ms() > 0 &&
       RayConfig::instance().event_stats()) {
     PrintAndRecordDebugDump();
@@ -126,7 +135,12 @@ PlasmaStore::PlasmaStore(instrumented_io_context &main_service,
 }
 
 // TODO(pcm): Get rid of this destructor by using RAII to clean up data.
-PlasmaStore::~PlasmaStore() {}
+PlasmaStore::~PlasmaStore() {
+  if (client_io_pool_) {
+    // Wait for the requests being served on the client io threads.
+    client_io_pool_->Stop();
+  }
+}
 
 void PlasmaStore::Start() {
   // Start listening for clients.
@@ -141,8 +155,7 @@ void PlasmaStore::AddToClientObjectIds(const ObjectID &object_id,
                                        std::optional<MEMFD_TYPE> fallback_allocated_fd,
                                        const std::shared_ptr<ClientInterface> &client) {
   // Check if this client is already using the object.
-  auto &object_ids = client->GetObjectIDs();
-  if (object_ids.find(object_id) != object_ids.end()) {
+  if (client->IsObjectUsed(object_id)) {
     return;
   }
   RAY_CHECK(object_lifecycle_mgr_.AddReference(object_id));
@@ -203,42 +216,47 @@ void PlasmaStore::ReturnFromGet(const std::shared_ptr<GetRequest> &get_request)
     return;
   }
 
+  ReplyToGet(std::dynamic_pointer_cast<Client>(get_request->client),
+             get_request->object_ids,
+             get_request->objects,
+             get_request->is_from_worker);
+}
+
+void PlasmaStore::ReplyToGet(const std::shared_ptr<Client> &client,
+                             std::vector<ObjectID> &object_ids,
+                             absl::flat_hash_map<ObjectID, PlasmaObject> &objects,
+                             bool is_from_worker) {
   // Figure out how many file descriptors we need to send.
   absl::flat_hash_set<MEMFD_TYPE> fds_to_send;
   std::vector<MEMFD_TYPE> store_fds;
   std::vector<int64_t> mmap_sizes;
-  for (const auto &object_id : get_request->object_ids) {
-    const PlasmaObject &object = get_request->objects[object_id];
+  for (const auto &object_id : object_ids) {
+    const PlasmaObject &object = objects[object_id];
     MEMFD_TYPE fd = object.store_fd;
     if (object.data_size != -1 && fds_to_send.count(fd) == 0 && fd.first != INVALID_FD) {
       fds_to_send.insert(fd);
       store_fds.push_back(fd);
       mmap_sizes.push_back(object.mmap_size);
-      if (get_request->is_from_worker) {
+      if (is_from_worker) {
         total_consumed_bytes_ += object.data_size + object.metadata_size;
       }
     }
   }
   // Send the get reply to the client.
-  Status s = SendGetReply(std::dynamic_pointer_cast<Client>(get_request->client),
-                          &get_request->object_ids[0],
-                          get_request->objects,
-                          get_request->object_ids.size(),
-                          store_fds,
-                          mmap_sizes);
+  Status s = SendGetReply(
+      client, &object_ids[0], objects, object_ids.size(), store_fds, mmap_sizes);
   // If we successfully sent the get reply message to the client, then also send
   // the file descriptors.
   if (s.ok()) {
     // Send all of the file descriptors for the present objects.
     for (MEMFD_TYPE store_fd : store_fds) {
-      Status send_fd_status = get_request->client->SendFd(store_fd);
+      Status send_fd_status = client->SendFd(store_fd);
       if (!send_fd_status.ok()) {
-        RAY_LOG(ERROR) << "Failed to send mmap results to client on fd "
-                       << get_request->client;
+        RAY_LOG(ERROR) << "Failed to send mmap results to client on fd " << client;
       }
     }
   } else {
-    RAY_LOG(ERROR) << "Failed to send Get reply to client on fd " << get_request->client;
+    RAY_LOG(ERROR) << "Failed to send Get reply to client on fd " << client;
   }
 }
 
@@ -254,9 +272,7 @@ void PlasmaStore::ProcessGetRequest(const std::shared_ptr<Client> &client,
 
 bool PlasmaStore::RemoveFromClientObjectIds(const ObjectID &object_id,
                                             const std::shared_ptr<Client> &client) {
-  auto &object_ids = client->GetObjectIDs();
-  auto it = object_ids.find(object_id);
-  if (it != object_ids.end()) {
+  if (client->IsObjectUsed(object_id)) {
     bool should_unmap = client->MarkObjectAsUnused(object_id);
     RAY_LOG(DEBUG) << "Object " << object_id
                    << " no longer in use by client, should_unmap = " << should_unmap;
@@ -295,9 +311,7 @@ void PlasmaStore::SealObjects(const std::vector<ObjectID> &object_ids) {
 
 int PlasmaStore::AbortObject(const ObjectID &object_id,
                              const std::shared_ptr<Client> &client) {
-  auto &object_ids = client->GetObjectIDs();
-  auto it = object_ids.find(object_id);
-  if (it == object_ids.end()) {
+  if (!client->IsObjectUsed(object_id)) {
     // If the client requesting the abort is not the creator, do not
     // perform the abort.
     return 0;
@@ -313,7 +327,7 @@ void PlasmaStore::ConnectClient(const boost::system::error_code &error) {
     // Accept a new local client and dispatch it to the node manager.
     auto new_connection = Client::Create(
         // NOLINTNEXTLINE : handler must be of boost::AcceptHandler type.
-        boost::bind(&PlasmaStore::ProcessMessage, this, ph::_1, ph::_2, ph::_3),
+        boost::bind(&PlasmaStore::HandleClientMessage, this, ph::_1, ph::_2, ph::_3),
         std::move(socket_));
   }
 
@@ -355,6 +369,106 @@ void PlasmaStore::DisconnectClient(const std::shared_ptr<Client> &client) {
   create_request_queue_.RemoveDisconnectedClientRequests(client);
 }
 
+void PlasmaStore::HandleClientMessage(const std::shared_ptr<Client> &client,
+                                      fb::MessageType type,
+                                      const std::vector<uint8_t> &message) {
+  if (!client_io_pool_) {
+    client->FinishMessage(ProcessMessage(client, type, message));
+    return;
+  }
+  bool processed = false;
+  Status status = ProcessSharedObjectMessage(client, type, message, &processed);
+  if (processed) {
+    client->FinishMessage(status);
+    return;
+  }
+  // The client doesn't send its next message until this one is finished, so the
+  // message stays valid and the client's requests are still processed in order.
+  io_context_.post(
+      [this, client, type, &message]() {
+        client->FinishMessage(ProcessMessage(client, type, message));
+      },
+      "PlasmaStore.ProcessMessage");
+}
+
+Status PlasmaStore::ProcessSharedObjectMessage(const std::shared_ptr<Client> &client,
+                                               fb::MessageType type,
+                                               const std::vector<uint8_t> &message,
+                                               bool *processed) {
+  uint8_t *input = (uint8_t *)message.data();
+  size_t input_size = message.size();
+  ObjectID object_id;
+  *processed = true;
+
+  switch (type) {
+  case fb::MessageType::PlasmaGetRequest: {
+    std::vector<ObjectID> object_ids_to_get;
+    int64_t timeout_ms;
+    bool is_from_worker;
+    RAY_RETURN_NOT_OK(ReadGetRequest(
+        input, input_size, object_ids_to_get, &timeout_ms, &is_from_worker));
+    absl::flat_hash_map<ObjectID, PlasmaObject> objects;
+    for (const auto &object_id : object_ids_to_get) {
+      if (objects.contains(object_id)) {
+        continue;
+      }
+      const LocalObject *entry = nullptr;
+      if (client->IsObjectUsed(object_id)) {
+        // The client's reference keeps the object from being deleted or moved. It
+        // may still be unsealed if the client created it.
+        entry = object_lifecycle_mgr_.GetObject(object_id);
+        if (entry != nullptr && !entry->Sealed()) {
+          entry = nullptr;
+        }
+      } else {
+        entry = object_lifecycle_mgr_.TryAddSharedReference(object_id);
+        if (entry != nullptr) {
+          std::optional<MEMFD_TYPE> fallback_allocated_fd = std::nullopt;
+          if (entry->GetAllocation().fallback_allocated) {
+            fallback_allocated_fd = entry->GetAllocation().fd;
+          }
+          client->MarkObjectAsUsed(object_id, fallback_allocated_fd);
+        }
+      }
+      if (entry == nullptr) {
+        *processed = false;
+        return Status::OK();
+      }
+      entry->ToPlasmaObject(&objects[object_id], /* check sealed */ true);
+    }
+    ReplyToGet(client, object_ids_to_get, objects, is_from_worker);
+  } break;
+  case fb::MessageType::PlasmaReleaseRequest: {
+    bool may_unmap;
+    RAY_RETURN_NOT_OK(ReadReleaseRequest(input, input_size, &object_id, &may_unmap));
+    bool should_unmap = false;
+    if (client->IsObjectUsed(object_id)) {
+      if (!object_lifecycle_mgr_.TryRemoveSharedReference(object_id)) {
+        *processed = false;
+        return Status::OK();
+      }
+      should_unmap = client->MarkObjectAsUnused(object_id);
+    }
+    RAY_CHECK(may_unmap || !should_unmap)
+        << "Plasma client thinks a mmap should not be unmapped but server thinks so. "
+           "Object ID: "
+        << object_id;
+    if (may_unmap) {
+      RAY_RETURN_NOT_OK(
+          SendReleaseReply(client, object_id, should_unmap, PlasmaError::OK));
+    }
+  } break;
+  case fb::MessageType::PlasmaContainsRequest: {
+    RAY_RETURN_NOT_OK(ReadContainsRequest(input, input_size, &object_id));
+    RAY_RETURN_NOT_OK(SendContainsReply(
+        client, object_id, object_lifecycle_mgr_.IsObjectSealed(object_id) ? 1 : 0));
+  } break;
+  default:
+    *processed = false;
+  }
+  return Status::OK();
+}
+
 Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
                                    fb::MessageType type,
                                    const std::vector<uint8_t> &message) {
@@ -391,8 +505,13 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
         static_cast<void>(client->SendFd(result.store_fd));
       }
     } else {
-      auto req_id =
-          create_request_queue_.AddRequest(object_id, client, handle_create, object_size);
+      // Put indices start above the largest possible return index, so anything
+      // at or below it that a worker creates is a task return.
+      const bool is_task_return =
+          request->source() == fb::ObjectSource::CreatedByWorker &&
+          object_id.ObjectIndex() <= RayConfig::instance().max_num_generator_returns();
+      auto req_id = create_request_queue_.AddRequest(
+          object_id, client, handle_create, object_size, is_task_return);
       RAY_LOG(DEBUG) << "Received create request for object " << object_id
                      << " assigned request ID " << req_id << ", " << object_size
                      << " bytes";
@@ -490,6 +609,10 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
 }
 
 void PlasmaStore::DoAccept() {
+  if (client_io_pool_) {
+    // Read the next client's messages on one of the client io threads.
+    socket_ = ray::local_stream_socket(*client_io_pool_->Get());
+  }
   acceptor_.async_accept(
       socket_,
       boost::bind(&PlasmaStore::ConnectClient, this, boost::asio::placeholders::error));
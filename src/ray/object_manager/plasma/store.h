@@ -27,6 +27,7 @@
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/asio/io_service_pool.h"
 #include "ray/common/file_system_monitor.h"
 #include "ray/common/ray_config.h"
 #include "ray/common/status.h"
@@ -206,10 +207,33 @@ class PlasmaStore {
   void DisconnectClient(const std::shared_ptr<Client> &client)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  /// Handle a message from a client on the thread that reads the client's
+  /// messages. With client io threads, requests that ProcessSharedObjectMessage
+  /// can't serve are posted to the store thread.
+  void HandleClientMessage(const std::shared_ptr<Client> &client,
+                           plasma::flatbuf::MessageType type,
+                           const std::vector<uint8_t> &message)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
   Status ProcessMessage(const std::shared_ptr<Client> &client,
                         plasma::flatbuf::MessageType type,
                         const std::vector<uint8_t> &message) ABSL_LOCKS_EXCLUDED(mutex_);
 
+  /// Serve a get, contains or release request without taking mutex_, if it
+  /// only involves sealed objects that other clients also use. Gets and releases
+  /// then only change reference counts that stay at two or more, so the eviction
+  /// policy, the stats and the request queues aren't affected.
+  ///
+  /// \param processed Set to false if the request must be processed with
+  /// ProcessMessage instead. References that a get took by then are recorded
+  /// as the client's, so ProcessMessage doesn't take them again.
+  /// \return The status of processing the request, if it was processed.
+  Status ProcessSharedObjectMessage(const std::shared_ptr<Client> &client,
+                                    plasma::flatbuf::MessageType type,
+                                    const std::vector<uint8_t> &message,
+                                    bool *processed)
+      ABSL_LOCKS_EXCLUDED(mutex_) ABSL_NO_THREAD_SAFETY_ANALYSIS;
+
   PlasmaError HandleCreateObjectRequest(const std::shared_ptr<Client> &client,
                                         const std::vector<uint8_t> &message,
                                         bool fallback_allocator,
@@ -227,6 +251,12 @@ class PlasmaStore {
 
   void ReturnFromGet(const std::shared_ptr<GetRequest> &get_request);
 
+  /// Send a get reply and the file descriptors of the objects in it.
+  void ReplyToGet(const std::shared_ptr<Client> &client,
+                  std::vector<ObjectID> &object_ids,
+                  absl::flat_hash_map<ObjectID, PlasmaObject> &objects,
+                  bool is_from_worker);
+
   // Returns: the client should unmap the mmap section for this object.
   bool RemoveFromClientObjectIds(const ObjectID &object_id,
                                  const std::shared_ptr<Client> &client)
@@ -246,6 +276,10 @@ class PlasmaStore {
 
   // A reference to the asio io context.
   instrumented_io_context &io_context_;
+  /// The io contexts that client connections are read on, or null if they're read
+  /// on io_context_. Declared before the sockets and request queues, which hold
+  /// clients, so that it's destroyed after them.
+  std::unique_ptr<ray::IOServicePool> client_io_pool_;
   /// The name of the socket this object store listens on.
   std::string socket_name_;
   /// An acceptor for new clients.
@@ -14,12 +14,15 @@
 
 #include "ray/object_manager/plasma/object_lifecycle_manager.h"
 
+#include <cstring>
 #include <limits>
+#include <string>
 
 #include "absl/random/random.h"
 #include "absl/strings/str_format.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "ray/common/ray_config.h"
 
 using namespace ray;
 using namespace testing;
@@ -343,6 +346,236 @@ TEST_F(ObjectLifecycleManagerTest, RemoveReferenceOneRefEagerlyDeletion) {
   std::vector<ObjectID> expect_notified_ids{id1_};
   EXPECT_EQ(expect_notified_ids, notify_deleted_ids_);
 }
+
+// Allocates from the heap so that object contents can be read and compared.
+class MallocAllocator : public IAllocator {
+ public:
+  explicit MallocAllocator(int64_t footprint_limit) : footprint_limit_(footprint_limit) {}
+
+  absl::optional<Allocation> Allocate(size_t bytes) override {
+    if (allocated_ + static_cast<int64_t>(bytes) > footprint_limit_) {
+      return absl::nullopt;
+    }
+    allocated_ += bytes;
+    auto allocation = Allocation();
+    allocation.address = new uint8_t[bytes];
+    allocation.size = bytes;
+    return std::move(allocation);
+  }
+
+  absl::optional<Allocation> FallbackAllocate(size_t bytes) override {
+    return absl::nullopt;
+  }
+
+  void Free(Allocation allocation) override {
+    allocated_ -= allocation.size;
+    delete[] static_cast<uint8_t *>(allocation.address);
+  }
+
+  int64_t GetFootprintLimit() const override { return footprint_limit_; }
+
+  int64_t Allocated() const override { return allocated_; }
+
+  int64_t FallbackAllocated() const override { return 0; }
+
+ private:
+  const int64_t footprint_limit_;
+  int64_t allocated_ = 0;
+};
+
+// Runs the object lifecycle manager on heap memory with the given config.
+struct HeapObjectLifecycleManagerTest : public Test {
+  HeapObjectLifecycleManagerTest(std::string config, int64_t footprint_limit)
+      : config_(std::move(config)), allocator_(footprint_limit) {}
+
+  void SetUp() override {
+    Test::SetUp();
+    RayConfig::instance().initialize(config_);
+    manager_ = std::make_unique<ObjectLifecycleManager>(
+        allocator_, [this](auto &id) { notify_deleted_ids_.push_back(id); });
+  }
+
+  void TearDown() override {
+    manager_.reset();
+    RayConfig::instance().initialize(
+        R"({"plasma_dedup_min_object_size": -1,
+            "plasma_dedup_max_object_size": 16777216,
+            "plasma_compression_min_object_size": -1,
+            "plasma_compression_max_object_size": 16777216})");
+    Test::TearDown();
+  }
+
+  // Create and seal an object holding the given contents, then release it.
+  ObjectID Put(const std::string &contents) {
+    ray::ObjectInfo info;
+    info.object_id = ObjectID::FromRandom();
+    info.data_size = contents.size();
+    info.metadata_size = 0;
+    auto result =
+        manager_->CreateObject(info, flatbuf::ObjectSource::CreatedByWorker, false);
+    RAY_CHECK(result.second == flatbuf::PlasmaError::OK);
+    auto address = result.first->GetAllocation().address;
+    std::memcpy(address, contents.data(), contents.size());
+    manager_->SealObject(info.object_id);
+    manager_->AddReference(info.object_id);
+    manager_->RemoveReference(info.object_id);
+    return info.object_id;
+  }
+
+  const void *Address(const ObjectID &object_id) {
+    return manager_->GetObject(object_id)->GetAllocation().address;
+  }
+
+  const std::string config_;
+  MallocAllocator allocator_;
+  std::unique_ptr<ObjectLifecycleManager> manager_;
+  std::vector<ObjectID> notify_deleted_ids_;
+};
+
+struct ObjectDedupTest : public HeapObjectLifecycleManagerTest {
+  ObjectDedupTest()
+      : HeapObjectLifecycleManagerTest(R"({"plasma_dedup_min_object_size": 0})",
+                                       std::numeric_limits<int64_t>::max()) {}
+};
+
+TEST_F(ObjectDedupTest, IdenticalObjectsShareAllocation) {
+  auto id1 = Put("hello world");
+  auto id2 = Put("hello world");
+  auto id3 = Put("hello there");
+
+  EXPECT_EQ(Address(id1), Address(id2));
+  EXPECT_NE(Address(id1), Address(id3));
+  EXPECT_EQ(2 * 11, allocator_.Allocated());
+  EXPECT_EQ(11, manager_->GetNumBytesDeduplicated());
+  // The duplicate keeps the object that owns the allocation alive.
+  EXPECT_EQ(1, manager_->GetObject(id1)->GetRefCount());
+  EXPECT_EQ(flatbuf::PlasmaError::ObjectInUse, manager_->DeleteObject(id1));
+
+  // Deleting the duplicate releases the owner, which was pending deletion.
+  EXPECT_EQ(flatbuf::PlasmaError::OK, manager_->DeleteObject(id2));
+  EXPECT_EQ(nullptr, manager_->GetObject(id1));
+  EXPECT_EQ(nullptr, manager_->GetObject(id2));
+  EXPECT_EQ(11, allocator_.Allocated());
+  EXPECT_EQ(0, manager_->GetNumBytesDeduplicated());
+  std::vector<ObjectID> expect_notified_ids{id2, id1};
+  EXPECT_EQ(expect_notified_ids, notify_deleted_ids_);
+
+  // Once the owner is gone, the next object with its contents owns its copy.
+  auto id4 = Put("hello world");
+  EXPECT_EQ(2 * 11, allocator_.Allocated());
+  EXPECT_EQ(0, manager_->GetNumBytesDeduplicated());
+  auto id5 = Put("hello world");
+  EXPECT_EQ(Address(id4), Address(id5));
+}
+
+struct ObjectDedupEvictionTest : public HeapObjectLifecycleManagerTest {
+  ObjectDedupEvictionTest()
+      : HeapObjectLifecycleManagerTest(R"({"plasma_dedup_min_object_size": 0})",
+                                       /*footprint_limit=*/1000) {}
+};
+
+TEST_F(ObjectDedupEvictionTest, DuplicatesTakeNoSpaceInLru) {
+  auto id1 = Put(std::string(100, 'a'));
+  auto id2 = Put(std::string(100, 'a'));
+  EXPECT_EQ(Address(id1), Address(id2));
+  EXPECT_EQ(100, allocator_.Allocated());
+  // The owner is in use by the duplicate, and evicting the duplicate frees nothing.
+  auto lru = manager_->EvictionPolicyDebugString();
+  EXPECT_NE(lru.find("num objects: 1"), std::string::npos) << lru;
+  EXPECT_NE(lru.find("used: 0%"), std::string::npos) << lru;
+}
+
+struct ObjectDedupMaxSizeTest : public HeapObjectLifecycleManagerTest {
+  ObjectDedupMaxSizeTest()
+      : HeapObjectLifecycleManagerTest(R"({"plasma_dedup_min_object_size": 0,
+                                           "plasma_dedup_max_object_size": 50})",
+                                       std::numeric_limits<int64_t>::max()) {}
+};
+
+TEST_F(ObjectDedupMaxSizeTest, SkipObjectsOverMaxSize) {
+  auto id1 = Put(std::string(100, 'a'));
+  auto id2 = Put(std::string(100, 'a'));
+  EXPECT_NE(Address(id1), Address(id2));
+  EXPECT_EQ(2 * 100, allocator_.Allocated());
+  EXPECT_EQ(0, manager_->GetNumBytesDeduplicated());
+
+  // Objects up to the max size are still deduplicated.
+  auto id3 = Put(std::string(50, 'b'));
+  auto id4 = Put(std::string(50, 'b'));
+  EXPECT_EQ(Address(id3), Address(id4));
+  EXPECT_EQ(50, manager_->GetNumBytesDeduplicated());
+}
+
+struct ObjectCompressionTest : public HeapObjectLifecycleManagerTest {
+  ObjectCompressionTest()
+      : HeapObjectLifecycleManagerTest(R"({"plasma_compression_min_object_size": 0})",
+                                       /*footprint_limit=*/1000) {}
+};
+
+TEST_F(ObjectCompressionTest, CompressInsteadOfEvict) {
+  const std::string contents1(600, 'a');
+  const std::string contents2(600, 'b');
+  auto id1 = Put(contents1);
+  // There's only space for the second object once the first one is compressed.
+  auto id2 = Put(contents2);
+  EXPECT_TRUE(manager_->GetObject(id1)->IsCompressed());
+  EXPECT_FALSE(manager_->GetObject(id2)->IsCompressed());
+  EXPECT_EQ(600, manager_->GetNumBytesCompressed());
+  EXPECT_LT(manager_->GetNumBytesCompressedStored(), 600);
+  EXPECT_EQ(600 + manager_->GetNumBytesCompressedStored(), allocator_.Allocated());
+  EXPECT_EQ(600, manager_->GetNumBytesEvictionAvoided());
+  EXPECT_TRUE(notify_deleted_ids_.empty());
+
+  // Reading the first object decompresses it, compressing the second one to
+  // make space.
+  auto entry = manager_->GetObjectForRead(id1);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_FALSE(entry->IsCompressed());
+  EXPECT_EQ(0, std::memcmp(Address(id1), contents1.data(), contents1.size()));
+  EXPECT_TRUE(manager_->GetObject(id2)->IsCompressed());
+  EXPECT_EQ(600, manager_->GetNumBytesCompressed());
+  EXPECT_EQ(2 * 600, manager_->GetNumBytesEvictionAvoided());
+  EXPECT_TRUE(notify_deleted_ids_.empty());
+
+  EXPECT_EQ(flatbuf::PlasmaError::OK, manager_->DeleteObject(id2));
+  EXPECT_EQ(0, manager_->GetNumBytesCompressed());
+  EXPECT_EQ(0, manager_->GetNumBytesCompressedStored());
+  EXPECT_EQ(600, allocator_.Allocated());
+}
+
+TEST_F(ObjectCompressionTest, EvictWhenNoSpaceToDecompress) {
+  auto id1 = Put(std::string(600, 'a'));
+  auto id2 = Put(std::string(600, 'b'));
+  ASSERT_TRUE(manager_->GetObject(id1)->IsCompressed());
+
+  // The second object is in use, so the first one can't be decompressed. It's
+  // evicted instead of being left in the store where nobody can read it.
+  manager_->AddReference(id2);
+  EXPECT_EQ(nullptr, manager_->GetObjectForRead(id1));
+  EXPECT_EQ(nullptr, manager_->GetObject(id1));
+  std::vector<ObjectID> expect_notified_ids{id1};
+  EXPECT_EQ(expect_notified_ids, notify_deleted_ids_);
+  EXPECT_EQ(0, manager_->GetNumBytesCompressed());
+  EXPECT_EQ(600, allocator_.Allocated());
+  manager_->RemoveReference(id2);
+}
+
+struct ObjectCompressionMaxSizeTest : public HeapObjectLifecycleManagerTest {
+  ObjectCompressionMaxSizeTest()
+      : HeapObjectLifecycleManagerTest(R"({"plasma_compression_min_object_size": 0,
+                                           "plasma_compression_max_object_size": 500})",
+                                       /*footprint_limit=*/1000) {}
+};
+
+TEST_F(ObjectCompressionMaxSizeTest, EvictObjectsOverMaxSize) {
+  auto id1 = Put(std::string(600, 'a'));
+  Put(std::string(600, 'b'));
+  EXPECT_EQ(nullptr, manager_->GetObject(id1));
+  std::vector<ObjectID> expect_notified_ids{id1};
+  EXPECT_EQ(expect_notified_ids, notify_deleted_ids_);
+  EXPECT_EQ(0, manager_->GetNumBytesCompressed());
+  EXPECT_EQ(0, manager_->GetNumBytesEvictionAvoided());
+}
 }  // namespace plasma
 
 int main(int argc, char **argv) {
@@ -14,7 +14,11 @@
 
 #include "ray/object_manager/plasma/object_store.h"
 
+#include <atomic>
+#include <chrono>
 #include <limits>
+#include <thread>
+#include <vector>
 
 #include "absl/random/random.h"
 #include "absl/strings/str_format.h"
@@ -75,6 +79,33 @@ const ObjectID kId2 = []() {
 }();
 }  // namespace
 
+class DummyAllocator : public IAllocator {
+ public:
+  absl::optional<Allocation> Allocate(size_t bytes) override {
+    allocated_ += bytes;
+    auto allocation = Allocation();
+    allocation.size = bytes;
+    return std::move(allocation);
+  }
+
+  absl::optional<Allocation> FallbackAllocate(size_t bytes) override {
+    return absl::nullopt;
+  }
+
+  void Free(Allocation allocation) override { allocated_ -= allocation.size; }
+
+  int64_t GetFootprintLimit() const override {
+    return std::numeric_limits<int64_t>::max();
+  }
+
+  int64_t Allocated() const override { return allocated_; }
+
+  int64_t FallbackAllocated() const override { return 0; }
+
+ private:
+  int64_t allocated_ = 0;
+};
+
 class MockAllocator : public IAllocator {
  public:
   MOCK_METHOD1(Allocate, absl::optional<Allocation>(size_t bytes));
@@ -175,6 +206,100 @@ TEST(ObjectStoreTest, PassThroughTest) {
     EXPECT_TRUE(store.DeleteObject(kId2));
   }
 }
+
+TEST(ObjectStoreTest, TryReferenceTest) {
+  DummyAllocator allocator;
+  ObjectStore store(allocator);
+  EXPECT_EQ(nullptr, store.TryAddReference(kId1, 0));
+  EXPECT_FALSE(store.TryRemoveReference(kId1, 1));
+
+  auto entry =
+      store.CreateObject(CreateObjectInfo(kId1, 10), {}, /*fallback_allocate*/ false);
+  // Unsealed objects can't be referenced.
+  EXPECT_EQ(nullptr, store.TryAddReference(kId1, 0));
+  EXPECT_FALSE(store.IsObjectSealed(kId1));
+  store.SealObject(kId1);
+  EXPECT_TRUE(store.IsObjectSealed(kId1));
+
+  EXPECT_EQ(nullptr, store.TryAddReference(kId1, 1));
+  EXPECT_EQ(entry, store.TryAddReference(kId1, 0));
+  EXPECT_EQ(entry, store.TryAddReference(kId1, 1));
+  EXPECT_EQ(entry->GetRefCount(), 2);
+
+  EXPECT_FALSE(store.TryRemoveReference(kId1, 3));
+  EXPECT_TRUE(store.TryRemoveReference(kId1, 2));
+  EXPECT_EQ(entry->GetRefCount(), 1);
+  EXPECT_TRUE(store.TryRemoveReference(kId1, 1));
+  EXPECT_FALSE(store.TryRemoveReference(kId1, 1));
+  EXPECT_EQ(entry->GetRefCount(), 0);
+  EXPECT_TRUE(store.DeleteObject(kId1));
+}
+
+// 64 clients get, check and release objects that other clients also use, which
+// plasma serves on the client io threads, while the store thread keeps creating,
+// sealing and deleting other objects. Reports the throughput with a single shard
+// and with the default number of shards.
+TEST(ObjectStoreTest, ConcurrentSharedGetReleaseTest) {
+  constexpr int kNumClients = 64;
+  constexpr int kNumSharedObjects = 1024;
+  constexpr int kOpsPerClient = 20000;
+
+  for (size_t num_shards : {size_t{1}, ObjectStore::kDefaultNumShards}) {
+    DummyAllocator allocator;
+    ObjectStore store(allocator, num_shards);
+    std::vector<ObjectID> shared_ids;
+    for (int i = 0; i < kNumSharedObjects; i++) {
+      auto id = ObjectID::FromRandom();
+      store.CreateObject(CreateObjectInfo(id, 16), {}, /*fallback_allocate*/ false);
+      store.SealObject(id);
+      // Used by the raylet and one other client.
+      store.TryAddReference(id, 0);
+      store.TryAddReference(id, 1);
+      shared_ids.push_back(id);
+    }
+
+    std::atomic<bool> done = false;
+    std::atomic<int> num_failures = 0;
+    std::thread store_thread([&store, &done]() {
+      while (!done) {
+        auto id = ObjectID::FromRandom();
+        store.CreateObject(CreateObjectInfo(id, 16), {}, /*fallback_allocate*/ false);
+        store.SealObject(id);
+        store.DeleteObject(id);
+      }
+    });
+
+    std::vector<std::thread> clients;
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < kNumClients; c++) {
+      clients.emplace_back([&store, &shared_ids, &num_failures, c]() {
+        for (int i = 0; i < kOpsPerClient; i++) {
+          const auto &id = shared_ids[(c * 7919 + i) % shared_ids.size()];
+          if (!store.IsObjectSealed(id) || store.TryAddReference(id, 2) == nullptr ||
+              !store.TryRemoveReference(id, 3)) {
+            num_failures++;
+          }
+        }
+      });
+    }
+    for (auto &client : clients) {
+      client.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    done = true;
+    store_thread.join();
+
+    RAY_LOG(INFO) << num_shards << " shard(s): "
+                  << kNumClients * kOpsPerClient / elapsed.count()
+                  << " contains+get+release ops/s with " << kNumClients << " clients";
+    EXPECT_EQ(num_failures, 0);
+    for (const auto &id : shared_ids) {
+      EXPECT_EQ(store.GetObject(id)->GetRefCount(), 2);
+      EXPECT_TRUE(store.DeleteObject(id));
+    }
+    EXPECT_EQ(allocator.Allocated(), 0);
+  }
+}
 }  // namespace plasma
 
 int main(int argc, char **argv) {
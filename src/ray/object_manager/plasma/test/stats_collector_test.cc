@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <limits>
+#include <vector>
 
 #include "absl/random/random.h"
 #include "ray/object_manager/plasma/object_lifecycle_manager.h"
@@ -91,9 +92,15 @@ struct ObjectStatsCollectorTest : public Test {
     int64_t num_objects_errored = 0;
     int64_t num_bytes_errored = 0;
 
-    for (const auto &obj_entry : object_store_->object_table_) {
-      const auto &obj = obj_entry.second;
+    std::vector<const LocalObject *> objects;
+    for (const auto &shard : object_store_->shards_) {
+      absl::MutexLock lock(&shard->mutex);
+      for (const auto &obj_entry : shard->object_table) {
+        objects.push_back(obj_entry.second.get());
+      }
+    }
 
+    for (const auto *obj : objects) {
       if (obj->ref_count > 0) {
         num_objects_in_use++;
         num_bytes_in_use += obj->object_info.GetObjectSize();
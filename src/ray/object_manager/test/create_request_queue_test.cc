@@ -14,6 +14,8 @@
 
 #include "ray/object_manager/plasma/create_request_queue.h"
 
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ray/common/status.h"
@@ -65,7 +67,7 @@ class CreateRequestQueueTest : public ::testing::Test {
             /*debug_dump_handler*/ nullptr) {}
 
   void AssertNoLeaks() {
-    ASSERT_TRUE(queue_.queue_.empty());
+    ASSERT_EQ(queue_.NumPendingRequests(), 0);
     ASSERT_TRUE(queue_.fulfilled_requests_.empty());
   }
 
@@ -147,6 +149,81 @@ TEST_F(CreateRequestQueueTest, TestOom) {
   AssertNoLeaks();
 }
 
+TEST_F(CreateRequestQueueTest, TestTaskReturnsFirst) {
+  std::vector<int> order;
+  auto make_request = [&](int i) {
+    return [&order, i](bool fallback, PlasmaObject *result) {
+      order.push_back(i);
+      result->data_size = 1234;
+      return PlasmaError::OK;
+    };
+  };
+
+  auto client = std::make_shared<MockClient>();
+  auto req_id1 = queue_.AddRequest(ObjectID::Nil(), client, make_request(1), 1234);
+  auto req_id2 = queue_.AddRequest(ObjectID::Nil(), client, make_request(2), 1234);
+  auto req_id3 = queue_.AddRequest(
+      ObjectID::Nil(), client, make_request(3), 1234, /*is_task_return=*/true);
+
+  ASSERT_TRUE(queue_.ProcessRequests().ok());
+  ASSERT_EQ(order, std::vector<int>({3, 1, 2}));
+  ASSERT_REQUEST_FINISHED(queue_, req_id1, PlasmaError::OK);
+  ASSERT_REQUEST_FINISHED(queue_, req_id2, PlasmaError::OK);
+  ASSERT_REQUEST_FINISHED(queue_, req_id3, PlasmaError::OK);
+  AssertNoLeaks();
+}
+
+TEST_F(CreateRequestQueueTest, TestSmallRequestsBypassBlockedHead) {
+  CreateRequestQueue queue(
+      monitor_,
+      /*oom_grace_period_s=*/100,
+      /*spill_object_callback=*/[&]() { return false; },
+      /*on_global_gc=*/[&]() { num_global_gc_++; },
+      /*get_time=*/[&]() { return current_time_ns_; },
+      /*debug_dump_handler*/ nullptr,
+      /*max_bypass_ms=*/1000);
+
+  bool has_space = false;
+  auto large_request = [&](bool fallback, PlasmaObject *result) {
+    if (!has_space) {
+      return PlasmaError::OutOfMemory;
+    }
+    result->data_size = 1234;
+    return PlasmaError::OK;
+  };
+  auto small_request = [&](bool fallback, PlasmaObject *result) {
+    result->data_size = 1234;
+    return PlasmaError::OK;
+  };
+
+  auto client = std::make_shared<MockClient>();
+  auto req_id1 = queue.AddRequest(ObjectID::Nil(), client, large_request, 1 << 30);
+  auto req_id2 = queue.AddRequest(ObjectID::Nil(), client, small_request, 1234);
+  auto req_id3 = queue.AddRequest(ObjectID::Nil(), client, large_request, 1 << 30);
+
+  // The small request is served ahead of the blocked one, but the equally large
+  // one behind it isn't.
+  ASSERT_TRUE(queue.ProcessRequests().IsObjectStoreFull());
+  ASSERT_REQUEST_UNFINISHED(queue, req_id1);
+  ASSERT_REQUEST_FINISHED(queue, req_id2, PlasmaError::OK);
+  ASSERT_REQUEST_UNFINISHED(queue, req_id3);
+
+  // Once the head has been blocked for too long, nothing bypasses it anymore.
+  current_time_ns_ += 2e9;
+  auto req_id4 = queue.AddRequest(ObjectID::Nil(), client, small_request, 1234);
+  ASSERT_TRUE(queue.ProcessRequests().IsObjectStoreFull());
+  ASSERT_REQUEST_UNFINISHED(queue, req_id1);
+  ASSERT_REQUEST_UNFINISHED(queue, req_id4);
+
+  has_space = true;
+  ASSERT_TRUE(queue.ProcessRequests().ok());
+  ASSERT_REQUEST_FINISHED(queue, req_id1, PlasmaError::OK);
+  ASSERT_REQUEST_FINISHED(queue, req_id3, PlasmaError::OK);
+  ASSERT_REQUEST_FINISHED(queue, req_id4, PlasmaError::OK);
+  ASSERT_EQ(queue.NumPendingRequests(), 0);
+  ASSERT_EQ(queue.NumPendingBytes(), 0);
+}
+
 TEST_F(CreateRequestQueueTest, TestFallbackAllocator) {
   int num_fallbacks = 0;
   auto oom_request = [&](bool fallback, PlasmaObject *result) {
@@ -58,6 +58,17 @@ DependencyManager::GetOrInsertRequiredObject(const ObjectID &object_id,
   return it;
 }
 
+void DependencyManager::RemoveDependentTask(const ObjectID &object_id,
+                                            ObjectDependencies &object,
+                                            size_t index) {
+  auto &dependent_tasks = object.dependent_tasks;
+  RAY_CHECK(index < dependent_tasks.size());
+  TaskDependencies *moved_task = dependent_tasks.back();
+  dependent_tasks[index] = moved_task;
+  moved_task->dependencies[object_id] = index;
+  dependent_tasks.pop_back();
+}
+
 void DependencyManager::StartOrUpdateWaitRequest(
     const WorkerID &worker_id,
     const std::vector<rpc::ObjectReference> &required_objects) {
@@ -174,29 +185,35 @@ bool DependencyManager::RequestTaskDependencies(
   RAY_LOG(DEBUG) << "Adding dependencies for task " << task_id
                  << ". Required objects length: " << required_objects.size();
 
-  const auto required_ids = ObjectRefsToIds(required_objects);
-  absl::flat_hash_set<ObjectID> deduped_ids(required_ids.begin(), required_ids.end());
   auto inserted = queued_task_requests_.emplace(
       task_id,
-      std::make_unique<TaskDependencies>(
-          std::move(deduped_ids), waiting_tasks_counter_, task_key));
+      std::make_unique<TaskDependencies>(task_id, waiting_tasks_counter_, task_key));
   RAY_CHECK(inserted.second) << "Task depedencies can be requested only once per task. "
                              << task_id;
   auto &task_entry = inserted.first->second;
 
+  // Register all arguments in a single pass: one insert into the task's
+  // dependencies and one append to each object's dependent tasks per unique
+  // argument, counting the missing arguments on the task as we go.
+  task_entry->dependencies.reserve(required_objects.size());
+  size_t num_missing_dependencies = 0;
   for (const auto &ref : required_objects) {
     const auto obj_id = ObjectRefToId(ref);
+    auto dependency = task_entry->dependencies.try_emplace(obj_id, 0);
+    if (!dependency.second) {
+      // Duplicate argument.
+      continue;
+    }
     RAY_LOG(DEBUG) << "Task " << task_id << " blocked on object " << obj_id;
 
     auto it = GetOrInsertRequiredObject(obj_id, ref);
-    it->second.dependent_tasks.insert(task_id);
-  }
-
-  for (const auto &obj_id : task_entry->dependencies) {
-    if (local_objects_.count(obj_id)) {
-      task_entry->DecrementMissingDependencies();
+    dependency.first->second = it->second.dependent_tasks.size();
+    it->second.dependent_tasks.push_back(task_entry.get());
+    if (!local_objects_.contains(obj_id)) {
+      num_missing_dependencies++;
     }
   }
+  task_entry->AddMissingDependencies(num_missing_dependencies);
 
   if (!required_objects.empty()) {
     task_entry->pull_request_id =
@@ -220,10 +237,10 @@ void DependencyManager::RemoveTaskDependencies(const TaskID &task_id) {
     object_manager_.CancelPull(task_entry->second->pull_request_id);
   }
 
-  for (const auto &obj_id : task_entry->second->dependencies) {
+  for (const auto &[obj_id, index] : task_entry->second->dependencies) {
     auto it = required_objects_.find(obj_id);
     RAY_CHECK(it != required_objects_.end());
-    it->second.dependent_tasks.erase(task_id);
+    RemoveDependentTask(obj_id, it->second, index);
     RemoveObjectIfNotNeeded(it);
   }
 
@@ -239,15 +256,12 @@ std::vector<TaskID> DependencyManager::HandleObjectMissing(
   std::vector<TaskID> waiting_task_ids;
   auto object_entry = required_objects_.find(object_id);
   if (object_entry != required_objects_.end()) {
-    for (auto &dependent_task_id : object_entry->second.dependent_tasks) {
-      auto it = queued_task_requests_.find(dependent_task_id);
-      RAY_CHECK(it != queued_task_requests_.end());
-      auto &task_entry = it->second;
+    for (auto *task_entry : object_entry->second.dependent_tasks) {
       // If the dependent task had all of its arguments ready, it was ready to
       // run but must be switched to waiting since one of its arguments is now
       // missing.
       if (task_entry->num_missing_dependencies == 0) {
-        waiting_task_ids.push_back(dependent_task_id);
+        waiting_task_ids.push_back(task_entry->task_id);
         // During normal execution we should be able to include the check
         // RAY_CHECK(pending_tasks_.count(dependent_task_id) == 1);
         // However, this invariant will not hold during unit test execution.
@@ -271,15 +285,12 @@ std::vector<TaskID> DependencyManager::HandleObjectLocal(const ray::ObjectID &ob
   auto object_entry = required_objects_.find(object_id);
   if (object_entry != required_objects_.end()) {
     // Loop through all tasks that depend on the newly available object.
-    for (const auto &dependent_task_id : object_entry->second.dependent_tasks) {
-      auto it = queued_task_requests_.find(dependent_task_id);
-      RAY_CHECK(it != queued_task_requests_.end());
-      auto &task_entry = it->second;
+    for (auto *task_entry : object_entry->second.dependent_tasks) {
       task_entry->DecrementMissingDependencies();
       // If the dependent task now has all of its arguments ready, it's ready
       // to run.
       if (task_entry->num_missing_dependencies == 0) {
-        ready_task_ids.push_back(dependent_task_id);
+        ready_task_ids.push_back(task_entry->task_id);
       }
     }
 
@@ -199,14 +199,18 @@ class DependencyManager : public TaskDependencyManagerInterface {
   void RecordMetrics();
 
  private:
+  struct TaskDependencies;
+
   /// Metadata for an object that is needed by at least one executing worker
   /// and/or one queued task.
   struct ObjectDependencies {
     ObjectDependencies(const rpc::ObjectReference &ref)
         : owner_address(ref.owner_address()) {}
-    /// The tasks that depend on this object, either because the object is a task argument
-    /// or because the task called `ray.get` on the object.
-    std::unordered_set<TaskID> dependent_tasks;
+    /// The queued tasks that depend on this object as a task argument. This is
+    /// kept as a contiguous list so that an object becoming local notifies its
+    /// dependents without a map lookup per task. Each task records its index in
+    /// this list, so that it can be removed in constant time.
+    std::vector<TaskDependencies *> dependent_tasks;
     /// The workers that depend on this object because they called `ray.get` on the
     /// object.
     std::unordered_set<WorkerID> dependent_get_requests;
@@ -227,25 +231,22 @@ class DependencyManager : public TaskDependencyManagerInterface {
 
   /// A struct to represent the object dependencies of a task.
   struct TaskDependencies {
-    TaskDependencies(const absl::flat_hash_set<ObjectID> &deps,
+    TaskDependencies(const TaskID &task_id,
                      CounterMap<std::pair<std::string, bool>> &counter_map,
                      const TaskMetricsKey &task_key)
-        : dependencies(std::move(deps)),
-          num_missing_dependencies(dependencies.size()),
+        : task_id(task_id),
           waiting_task_counter_map(counter_map),
-          task_key(task_key) {
-      if (num_missing_dependencies > 0) {
-        waiting_task_counter_map.Increment(task_key);
-      }
-    }
-    /// The objects that the task depends on. These are the arguments to the
-    /// task. These must all be simultaneously local before the task is ready
-    /// to execute. Objects are removed from this set once
-    /// UnsubscribeGetDependencies is called.
-    absl::flat_hash_set<ObjectID> dependencies;
+          task_key(task_key) {}
+    /// The ID of the queued task.
+    const TaskID task_id;
+    /// The objects that the task depends on, mapped to the index of this task
+    /// in the object's ObjectDependencies::dependent_tasks. These are the
+    /// arguments to the task. These must all be simultaneously local before the
+    /// task is ready to execute.
+    absl::flat_hash_map<ObjectID, size_t> dependencies;
     /// The number of object arguments that are not available locally. This
     /// must be zero before the task is ready to execute.
-    size_t num_missing_dependencies;
+    size_t num_missing_dependencies = 0;
     /// Used to identify the pull request for the dependencies to the object
     /// manager.
     uint64_t pull_request_id = 0;
@@ -254,6 +255,13 @@ class DependencyManager : public TaskDependencyManagerInterface {
     /// The task name / is_retry tuple used for metrics tracking.
     const TaskMetricsKey task_key;
 
+    void AddMissingDependencies(size_t num_missing) {
+      if (num_missing_dependencies == 0 && num_missing > 0) {
+        waiting_task_counter_map.Increment(task_key);
+      }
+      num_missing_dependencies += num_missing;
+    }
+
     void IncrementMissingDependencies() {
       if (num_missing_dependencies == 0) {
         waiting_task_counter_map.Increment(task_key);
@@ -284,6 +292,16 @@ class DependencyManager : public TaskDependencyManagerInterface {
   absl::flat_hash_map<ObjectID, ObjectDependencies>::iterator GetOrInsertRequiredObject(
       const ObjectID &object_id, const rpc::ObjectReference &ref);
 
+  /// Remove a queued task from an object's dependent tasks by swapping the last
+  /// dependent task into its slot.
+  ///
+  /// \param object_id The object that the task depends on.
+  /// \param object The dependency metadata of the object.
+  /// \param index The index of the task in the object's dependent tasks.
+  void RemoveDependentTask(const ObjectID &object_id,
+                           ObjectDependencies &object,
+                           size_t index);
+
   /// The object manager, used to fetch required objects from remote nodes.
   ObjectManagerInterface &object_manager_;
 
@@ -310,7 +328,7 @@ class DependencyManager : public TaskDependencyManagerInterface {
 
   /// The set of locally available objects. This is used to determine which
   /// tasks are ready to run and which `ray.wait` requests can be finished.
-  std::unordered_set<ray::ObjectID> local_objects_;
+  absl::flat_hash_set<ray::ObjectID> local_objects_;
 
   /// Counts the number of active task dependency fetches by task name. The counter
   /// total will be less than or equal to the size of queued_task_requests_.
@@ -646,6 +646,26 @@ int64_t LocalObjectManager::GetPrimaryBytes() const {
   return pinned_objects_size_ + num_bytes_pending_spill_;
 }
 
+absl::flat_hash_map<WorkerID, int64_t> LocalObjectManager::GetPrimaryBytesByOwner()
+    const {
+  absl::flat_hash_map<WorkerID, int64_t> bytes_by_owner;
+  auto add_owner_bytes = [&](const ObjectID &object_id, const RayObject &object) {
+    auto it = local_objects_.find(object_id);
+    if (it == local_objects_.end()) {
+      return;
+    }
+    bytes_by_owner[WorkerID::FromBinary(it->second.owner_address.worker_id())] +=
+        object.GetSize();
+  };
+  for (const auto &[object_id, object] : pinned_objects_) {
+    add_owner_bytes(object_id, *object);
+  }
+  for (const auto &[object_id, object] : objects_pending_spill_) {
+    add_owner_bytes(object_id, *object);
+  }
+  return bytes_by_owner;
+}
+
 bool LocalObjectManager::HasLocallySpilledObjects() const {
   if (!is_external_storage_type_fs_) {
     // External storage is not local.
@@ -165,6 +165,12 @@ class LocalObjectManager {
   /// bytes used by objects currently being spilled.
   int64_t GetPrimaryBytes() const;
 
+  /// Get the bytes used by primary object copies grouped by the worker that owns
+  /// them. Like GetPrimaryBytes, this includes objects currently being spilled.
+  ///
+  /// \return Map from owner worker id to the primary bytes it owns on this node.
+  absl::flat_hash_map<WorkerID, int64_t> GetPrimaryBytesByOwner() const;
+
   /// Returns true if we have objects spilled to the local
   /// filesystem.
   bool HasLocallySpilledObjects() const;
@@ -84,9 +84,8 @@ bool LocalTaskManager::WaitForTaskArgsRequests(std::shared_ptr<internal::Work> w
   const auto &task = work->task;
   const auto &task_id = task.GetTaskSpecification().TaskId();
   const auto &scheduling_key = task.GetTaskSpecification().GetSchedulingClass();
-  auto object_ids = task.GetTaskSpecification().GetDependencies();
   bool can_dispatch = true;
-  if (object_ids.size() > 0) {
+  if (!task.GetDependencies().empty()) {
     bool args_ready = task_dependency_manager_.RequestTaskDependencies(
         task_id,
         task.GetDependencies(),
@@ -249,7 +248,7 @@ void LocalTaskManager::DispatchScheduledTasksToWorkers() {
     for (auto work_it = dispatch_queue.begin(); work_it != dispatch_queue.end();) {
       auto &work = *work_it;
       const auto &task = work->task;
-      const auto spec = task.GetTaskSpecification();
+      const auto &spec = task.GetTaskSpecification();
       TaskID task_id = spec.TaskId();
       if (work->GetState() == internal::WorkStatus::WAITING_FOR_WORKER) {
         work_it++;
@@ -292,7 +291,7 @@ void LocalTaskManager::DispatchScheduledTasksToWorkers() {
       }
 
       bool args_missing = false;
-      bool success = PinTaskArgsIfMemoryAvailable(spec, &args_missing);
+      bool success = PinTaskArgsIfMemoryAvailable(task, &args_missing);
       // An argument was evicted since this task was added to the dispatch
       // queue. Move it back to the waiting queue. The caller is responsible
       // for notifying us when the task is unblocked again.
@@ -333,7 +332,7 @@ void LocalTaskManager::DispatchScheduledTasksToWorkers() {
       if (!spec.IsDetachedActor() && !is_owner_alive_(owner_worker_id, owner_node_id)) {
         RAY_LOG(WARNING) << "RayTask: " << task.GetTaskSpecification().TaskId()
                          << "'s caller is no longer running. Cancelling task.";
-        if (!spec.GetDependencies().empty()) {
+        if (!task.GetDependencies().empty()) {
           task_dependency_manager_.RemoveTaskDependencies(task_id);
         }
         ReleaseTaskArgs(task_id);
@@ -467,7 +466,7 @@ void LocalTaskManager::SpillWaitingTasks() {
         scheduling_node_id.Binary() != self_node_id_.Binary()) {
       NodeID node_id = NodeID::FromBinary(scheduling_node_id.Binary());
       Spillback(node_id, *it);
-      if (!task.GetTaskSpecification().GetDependencies().empty()) {
+      if (!task.GetDependencies().empty()) {
         task_dependency_manager_.RemoveTaskDependencies(
             task.GetTaskSpecification().TaskId());
       }
@@ -510,7 +509,7 @@ bool LocalTaskManager::TrySpillback(const std::shared_ptr<internal::Work> &work,
   NodeID node_id = NodeID::FromBinary(scheduling_node_id.Binary());
   Spillback(node_id, work);
   num_unschedulable_task_spilled_++;
-  if (!work->task.GetTaskSpecification().GetDependencies().empty()) {
+  if (!work->task.GetDependencies().empty()) {
     task_dependency_manager_.RemoveTaskDependencies(
         work->task.GetTaskSpecification().TaskId());
   }
@@ -746,10 +745,11 @@ void LocalTaskManager::TaskFinished(std::shared_ptr<WorkerInterface> worker,
 }
 
 // TODO(scv119): task args related logic probaly belongs task dependency manager.
-bool LocalTaskManager::PinTaskArgsIfMemoryAvailable(const TaskSpecification &spec,
+bool LocalTaskManager::PinTaskArgsIfMemoryAvailable(const RayTask &task,
                                                     bool *args_missing) {
+  const auto &spec = task.GetTaskSpecification();
   std::vector<std::unique_ptr<RayObject>> args;
-  const auto &deps = spec.GetDependencyIds();
+  const auto &deps = task.GetDependencyIds();
   if (!deps.empty()) {
     // This gets refs to the arguments stored in plasma. The refs should be
     // deleted once we no longer need to pin the arguments.
@@ -779,7 +779,7 @@ bool LocalTaskManager::PinTaskArgsIfMemoryAvailable(const TaskSpecification &spe
     task_arg_bytes += arg->GetSize();
   }
   RAY_LOG(DEBUG) << "RayTask " << spec.TaskId() << " has args of size " << task_arg_bytes;
-  PinTaskArgs(spec, std::move(args));
+  PinTaskArgs(task, std::move(args));
   RAY_LOG(DEBUG) << "Size of pinned task args is now " << pinned_task_arguments_bytes_;
   if (max_pinned_task_arguments_bytes_ == 0) {
     // Max threshold for pinned args is not set.
@@ -803,9 +803,10 @@ bool LocalTaskManager::PinTaskArgsIfMemoryAvailable(const TaskSpecification &spe
   return true;
 }
 
-void LocalTaskManager::PinTaskArgs(const TaskSpecification &spec,
+void LocalTaskManager::PinTaskArgs(const RayTask &task,
                                    std::vector<std::unique_ptr<RayObject>> args) {
-  const auto &deps = spec.GetDependencyIds();
+  const auto &spec = task.GetTaskSpecification();
+  const auto &deps = task.GetDependencyIds();
   // TODO(swang): This should really be an assertion, but we can sometimes
   // receive a duplicate task request if there is a failure and the original
   // version of the task has not yet been canceled.
@@ -880,7 +881,7 @@ bool LocalTaskManager::CancelTasks(
             // Release pinned task args.
             ReleaseTaskArgs(task_id);
           }
-          if (!work->task.GetTaskSpecification().GetDependencies().empty()) {
+          if (!work->task.GetDependencies().empty()) {
             task_dependency_manager_.RemoveTaskDependencies(
                 work->task.GetTaskSpecification().TaskId());
           }
@@ -897,7 +898,7 @@ bool LocalTaskManager::CancelTasks(
       waiting_task_queue_, [&](const std::shared_ptr<internal::Work> &work) {
         if (predicate(work)) {
           ReplyCancelled(work, failure_type, scheduling_failure_message);
-          if (!work->task.GetTaskSpecification().GetDependencies().empty()) {
+          if (!work->task.GetDependencies().empty()) {
             task_dependency_manager_.RemoveTaskDependencies(
                 work->task.GetTaskSpecification().TaskId());
           }
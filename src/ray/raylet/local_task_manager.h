@@ -271,11 +271,10 @@ class LocalTaskManager : public ILocalTaskManager {
   // returns false if there are missing args (due to eviction) or if there is
   // not enough memory available to dispatch the task, due to other executing
   // tasks' arguments.
-  bool PinTaskArgsIfMemoryAvailable(const TaskSpecification &spec, bool *args_missing);
+  bool PinTaskArgsIfMemoryAvailable(const RayTask &task, bool *args_missing);
 
   // Helper functions to pin and release an executing task's args.
-  void PinTaskArgs(const TaskSpecification &spec,
-                   std::vector<std::unique_ptr<RayObject>> args);
+  void PinTaskArgs(const RayTask &task, std::vector<std::unique_ptr<RayObject>> args);
   void ReleaseTaskArgs(const TaskID &task_id);
 
  private:
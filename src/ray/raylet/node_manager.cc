@@ -283,7 +283,8 @@ NodeManager::NodeManager(
           RayConfig::instance().memory_usage_threshold(),
           RayConfig::instance().min_memory_free_bytes(),
           RayConfig::instance().memory_monitor_refresh_ms(),
-          CreateMemoryUsageRefreshCallback())) {
+          CreateMemoryUsageRefreshCallback(),
+          RayConfig::instance().memory_monitor_use_pressure_notifications())) {
   RAY_LOG(INFO).WithField(kLogKeyNodeID, self_node_id_) << "Initializing NodeManager";
   cluster_resource_scheduler_ = std::make_shared<ClusterResourceScheduler>(
       io_service,
@@ -1828,8 +1829,18 @@ void NodeManager::HandleRequestWorkerLease(rpc::RequestWorkerLeaseRequest reques
   auto task_spec = task.GetTaskSpecification();
   worker_pool_.PrestartWorkers(task_spec, request.backlog_size());
 
+  // Leases that reserve object store memory for their outputs may push the store
+  // over the spilling threshold as soon as they're granted.
+  const bool reserves_object_store_memory =
+      task_spec.GetRequiredResources().Has(scheduling::ResourceID::ObjectStoreMemory());
+
   auto send_reply_callback_wrapper =
-      [this, is_actor_creation_task, actor_id, reply, send_reply_callback](
+      [this,
+       is_actor_creation_task,
+       actor_id,
+       reply,
+       send_reply_callback,
+       reserves_object_store_memory](
           Status status, std::function<void()> success, std::function<void()> failure) {
         if (reply->rejected() && is_actor_creation_task) {
           auto resources_data = reply->mutable_resources_data();
@@ -1855,7 +1866,11 @@ void NodeManager::HandleRequestWorkerLease(rpc::RequestWorkerLeaseRequest reques
                 absl::GetCurrentTimeNanos());
           }
         }
+        const bool granted = status.ok() && !reply->rejected() && !reply->canceled();
         send_reply_callback(status, success, failure);
+        if (granted && reserves_object_store_memory) {
+          SpillIfOverPrimaryObjectsThreshold();
+        }
       };
 
   cluster_task_manager_->QueueAndScheduleTask(task,
@@ -2255,8 +2270,13 @@ void NodeManager::FinishAssignedActorCreationTask(WorkerInterface &worker,
 
 void NodeManager::SpillIfOverPrimaryObjectsThreshold() {
   // Trigger object spilling if current usage is above the specified threshold.
+  // Memory that granted leases reserved for their outputs, and that the outputs
+  // don't take up yet, counts as used, so that space is made before those tasks try
+  // to store their outputs.
+  const int64_t reserved_bytes = cluster_resource_scheduler_->GetLocalResourceManager()
+                                     .GetReservedObjectStoreMemory();
   const float allocated_percentage =
-      static_cast<float>(local_object_manager_.GetPrimaryBytes()) /
+      static_cast<float>(local_object_manager_.GetPrimaryBytes() + reserved_bytes) /
       object_manager_.GetMemoryCapacity();
   if (allocated_percentage >= RayConfig::instance().object_spilling_threshold()) {
     RAY_LOG(INFO) << "Triggering object spilling because current usage "
@@ -2455,6 +2475,19 @@ bool NodeManager::GetObjectsFromPlasma(const std::vector<ObjectID> &object_ids,
   return true;
 }
 
+std::shared_ptr<TaskResourceInstances> NodeManager::GetLeaseAllocationForTask(
+    const TaskID &task_id) const {
+  const ActorID actor_id = task_id.ActorId();
+  for (const auto &[worker_id, worker] : leased_workers_) {
+    if (worker->GetAssignedTaskId() == task_id ||
+        (!actor_id.IsNil() && worker->GetActorId() == actor_id)) {
+      return worker->GetAllocatedInstances() ? worker->GetAllocatedInstances()
+                                             : worker->GetLifetimeAllocatedInstances();
+    }
+  }
+  return nullptr;
+}
+
 void NodeManager::HandlePinObjectIDs(rpc::PinObjectIDsRequest request,
                                      rpc::PinObjectIDsReply *reply,
                                      rpc::SendReplyCallback send_reply_callback) {
@@ -2491,8 +2524,34 @@ void NodeManager::HandlePinObjectIDs(rpc::PinObjectIDsRequest request,
     ObjectID generator_id = request.has_generator_id()
                                 ? ObjectID::FromBinary(request.generator_id())
                                 : ObjectID::Nil();
-    local_object_manager_.PinObjectsAndWaitForFree(
-        object_ids, std::move(results), request.owner_address(), generator_id);
+    auto &local_resource_manager = cluster_resource_scheduler_->GetLocalResourceManager();
+    if (local_resource_manager.GetReservedObjectStoreMemory() == 0) {
+      local_object_manager_.PinObjectsAndWaitForFree(
+          object_ids, std::move(results), request.owner_address(), generator_id);
+    } else {
+      // Pin the outputs of each task separately, so that they only fill the
+      // reservation of the lease that created them.
+      absl::flat_hash_map<TaskID,
+                          std::pair<std::vector<ObjectID>,
+                                    std::vector<std::unique_ptr<RayObject>>>>
+          objects_by_task;
+      for (size_t i = 0; i < object_ids.size(); i++) {
+        auto &task_objects = objects_by_task[object_ids[i].TaskId()];
+        task_objects.first.push_back(object_ids[i]);
+        task_objects.second.push_back(std::move(results[i]));
+      }
+      for (auto &[task_id, task_objects] : objects_by_task) {
+        const int64_t primary_bytes = local_object_manager_.GetPrimaryBytes();
+        local_object_manager_.PinObjectsAndWaitForFree(task_objects.first,
+                                                       std::move(task_objects.second),
+                                                       request.owner_address(),
+                                                       generator_id);
+        // Outputs that were reserved for now take up the memory themselves.
+        local_resource_manager.ConsumeObjectStoreMemoryReservation(
+            GetLeaseAllocationForTask(task_id),
+            local_object_manager_.GetPrimaryBytes() - primary_bytes);
+      }
+    }
   }
   RAY_CHECK_EQ(request.object_ids_size(), reply->successes_size());
   send_reply_callback(Status::OK(), nullptr, nullptr);
@@ -2786,6 +2845,7 @@ void NodeManager::RecordMetrics() {
   last_metrics_recorded_at_ms_ = current_time;
   object_directory_->RecordMetrics(duration_ms);
   dependency_manager_.RecordMetrics();
+  worker_pool_.RecordMetrics();
 }
 
 void NodeManager::ConsumeSyncMessage(
@@ -2879,8 +2939,23 @@ MemoryUsageRefreshCallback NodeManager::CreateMemoryUsageRefreshCallback() {
             << "Still waiting for worker eviction to free up memory. "
             << "worker pid: " << high_memory_eviction_target_->GetProcess().GetId();
       } else {
-        system_memory.process_used_bytes = MemoryMonitor::GetProcessMemoryUsage();
         auto workers = worker_pool_.GetAllRegisteredWorkers();
+        if (RayConfig::instance().memory_monitor_use_pressure_notifications()) {
+          // Only the workers are candidates for killing, so sample just their
+          // usage through the monitor's cached statm descriptors instead of
+          // scanning every process on the node.
+          std::vector<pid_t> worker_pids;
+          worker_pids.reserve(workers.size());
+          for (const auto &worker : workers) {
+            worker_pids.push_back(worker->GetProcess().GetId());
+          }
+          system_memory.process_used_bytes =
+              memory_monitor_->GetProcessMemoryUsageFromStatm(worker_pids);
+        } else {
+          system_memory.process_used_bytes = MemoryMonitor::GetProcessMemoryUsage();
+        }
+        system_memory.owner_object_store_bytes =
+            local_object_manager_.GetPrimaryBytesByOwner();
         if (workers.empty()) {
           RAY_LOG_EVERY_MS(WARNING, 5000)
               << "Memory usage above threshold but no workers are available for killing."
@@ -640,6 +640,14 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   /// \param task RayTask that is infeasible
   void PublishInfeasibleTaskError(const RayTask &task) const;
 
+  /// Get the resources allocated to the lease that runs a task, i.e. the leased
+  /// worker that was assigned the task or that hosts the task's actor.
+  ///
+  /// \param[in] task_id The task.
+  /// \return The lease's allocation, or nullptr if no leased worker runs the task.
+  std::shared_ptr<TaskResourceInstances> GetLeaseAllocationForTask(
+      const TaskID &task_id) const;
+
   /// Get pointers to objects stored in plasma. They will be
   /// released once the returned references go out of scope.
   ///
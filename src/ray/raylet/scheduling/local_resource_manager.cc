@@ -14,6 +14,7 @@
 
 #include "ray/raylet/scheduling/local_resource_manager.h"
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <csignal>
 
@@ -88,6 +89,12 @@ bool LocalResourceManager::AllocateTaskResourceInstances(
     for (const auto &resource_id : resource_request.ResourceIds()) {
       SetResourceNonIdle(resource_id);
     }
+    const auto reserved = static_cast<int64_t>(
+        task_allocation->Sum(ResourceID::ObjectStoreMemory()).Double());
+    if (reserved > 0) {
+      reserved_object_store_memory_ += reserved;
+      object_store_memory_reservations_[task_allocation.get()] = {reserved, 0};
+    }
     return true;
   } else {
     return false;
@@ -97,10 +104,26 @@ bool LocalResourceManager::AllocateTaskResourceInstances(
 void LocalResourceManager::FreeTaskResourceInstances(
     std::shared_ptr<TaskResourceInstances> task_allocation, bool record_idle_resource) {
   RAY_CHECK(task_allocation != nullptr);
+  auto reservation = object_store_memory_reservations_.find(task_allocation.get());
+  if (reservation != object_store_memory_reservations_.end()) {
+    reserved_object_store_memory_ -= reservation->second.first;
+    consumed_object_store_memory_reservation_ -= reservation->second.second;
+    object_store_memory_reservations_.erase(reservation);
+  }
+  RAY_CHECK_GE(reserved_object_store_memory_, 0);
+  RAY_CHECK_GE(consumed_object_store_memory_reservation_, 0);
   for (auto &resource_id : task_allocation->ResourceIds()) {
     if (!local_resources_.total.Has(resource_id)) {
       continue;
     }
+    if (resource_id == ResourceID::ObjectStoreMemory() &&
+        get_used_object_store_memory_ != nullptr) {
+      // The available object store memory is derived from the usage and the
+      // reservations. Adding the reservation back could exceed the total once its
+      // outputs are freed.
+      UpdateAvailableObjectStoreMemResource();
+      continue;
+    }
     local_resources_.available.Free(resource_id, task_allocation->Get(resource_id));
     const auto &available = local_resources_.available.Get(resource_id);
     const auto &total = local_resources_.total.Get(resource_id);
@@ -115,6 +138,18 @@ void LocalResourceManager::FreeTaskResourceInstances(
     }
   }
 }
+void LocalResourceManager::ConsumeObjectStoreMemoryReservation(
+    const std::shared_ptr<TaskResourceInstances> &task_allocation, int64_t bytes) {
+  auto reservation = object_store_memory_reservations_.find(task_allocation.get());
+  if (bytes <= 0 || reservation == object_store_memory_reservations_.end()) {
+    return;
+  }
+  auto &[reserved, consumed] = reservation->second;
+  const int64_t to_consume = std::min(bytes, reserved - consumed);
+  consumed += to_consume;
+  consumed_object_store_memory_reservation_ += to_consume;
+}
+
 void LocalResourceManager::SetBusyFootprint(WorkFootprint item) {
   auto prev = last_idle_times_.find(item);
   if (prev != last_idle_times_.end() && !prev->second.has_value()) {
@@ -267,7 +302,7 @@ void LocalResourceManager::UpdateAvailableObjectStoreMemResource() {
 
   auto &total_instances = local_resources_.total.Get(ResourceID::ObjectStoreMemory());
   RAY_CHECK_EQ(total_instances.size(), 1u);
-  const double used = get_used_object_store_memory_();
+  const double used = get_used_object_store_memory_() + GetReservedObjectStoreMemory();
   const double total = total_instances[0].Double();
   auto new_available =
       std::vector<FixedPoint>{FixedPoint(total >= used ? total - used : 0.0)};
@@ -457,6 +492,12 @@ void LocalResourceManager::RecordMetrics() const {
     ray::stats::STATS_resources.Record(resource_usage.used,
                                        {{"State", "USED"}, {"Name", resource}});
   }
+  ray::stats::STATS_object_store_memory_reservation.Record(GetReservedObjectStoreMemory(),
+                                                           "RESERVED");
+  if (get_used_object_store_memory_ != nullptr) {
+    ray::stats::STATS_object_store_memory_reservation.Record(
+        get_used_object_store_memory_(), "USED");
+  }
 }
 
 void LocalResourceManager::SetLocalNodeDraining(
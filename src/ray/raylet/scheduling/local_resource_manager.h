@@ -17,7 +17,9 @@
 #include <gtest/gtest_prod.h>
 
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -129,6 +131,22 @@ class LocalResourceManager : public syncer::ReporterInterface {
 
   double GetLocalAvailableCpus() const;
 
+  /// Get the object store memory that granted leases have reserved for their
+  /// outputs, i.e. the object_store_memory they requested, minus what their outputs
+  /// already take up.
+  int64_t GetReservedObjectStoreMemory() const {
+    return reserved_object_store_memory_ - consumed_object_store_memory_reservation_;
+  }
+
+  /// Record that primary copies of `bytes` created by a lease were pinned, which
+  /// fills the lease's reservation so that its outputs aren't counted both as used
+  /// and as reserved. Only up to the lease's own reservation is filled.
+  ///
+  /// \param task_allocation The resources allocated to the lease.
+  /// \param bytes The size of the pinned primary copies.
+  void ConsumeObjectStoreMemoryReservation(
+      const std::shared_ptr<TaskResourceInstances> &task_allocation, int64_t bytes);
+
   /// Return human-readable string for this scheduler state.
   std::string DebugString() const;
 
@@ -229,6 +247,17 @@ class LocalResourceManager : public syncer::ReporterInterface {
   absl::flat_hash_map<WorkArtifact, absl::optional<absl::Time>> last_idle_times_;
   /// Function to get used object store memory.
   std::function<int64_t(void)> get_used_object_store_memory_;
+  /// Object store memory reserved by granted leases. What isn't consumed yet is
+  /// counted as used when computing the available object_store_memory resource until
+  /// the lease is returned, so that reservations can't be oversubscribed. An actor
+  /// creation lease holds its reservation for the lifetime of the actor.
+  int64_t reserved_object_store_memory_ = 0;
+  /// The part of `reserved_object_store_memory_` filled by pinned primary copies.
+  int64_t consumed_object_store_memory_reservation_ = 0;
+  /// The reservation of each granted lease that reserves object store memory, by its
+  /// allocation, as (reserved, consumed) bytes.
+  absl::flat_hash_map<const TaskResourceInstances *, std::pair<int64_t, int64_t>>
+      object_store_memory_reservations_;
   /// Function to get whether the pull manager is at capacity.
   std::function<bool(void)> get_pull_manager_at_capacity_;
   /// Function to shutdown the raylet gracefully.
@@ -258,6 +287,7 @@ class LocalResourceManager : public syncer::ReporterInterface {
   FRIEND_TEST(LocalResourceManagerTest, BasicGetResourceUsageMapTest);
   FRIEND_TEST(LocalResourceManagerTest, IdleResourceTimeTest);
   FRIEND_TEST(LocalResourceManagerTest, ObjectStoreMemoryDrainingTest);
+  FRIEND_TEST(LocalResourceManagerTest, ObjectStoreMemoryReservationTest);
 };
 
 }  // end namespace ray
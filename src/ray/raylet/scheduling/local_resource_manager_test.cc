@@ -193,6 +193,79 @@ TEST_F(LocalResourceManagerTest, ObjectStoreMemoryDrainingTest) {
   EXPECT_DEATH(manager->UpdateAvailableObjectStoreMemResource(), ".*");
 }
 
+TEST_F(LocalResourceManagerTest, ObjectStoreMemoryReservationTest) {
+  // Object store memory requested by a lease is reserved until the lease is returned,
+  // on top of what's already in use.
+  int64_t used_object_store = 30;
+  manager = std::make_unique<LocalResourceManager>(
+      local_node_id,
+      CreateNodeResources({{ResourceID::CPU(), 2.0},
+                           {ResourceID::ObjectStoreMemory(), 100.0}}),
+      /* get_used_object_store_memory */
+      [&used_object_store]() { return used_object_store; },
+      nullptr,
+      nullptr,
+      nullptr);
+  auto available_object_store = [this]() {
+    return manager->GetLocalResources()
+        .available.Sum(ResourceID::ObjectStoreMemory())
+        .Double();
+  };
+  manager->UpdateAvailableObjectStoreMemResource();
+
+  auto allocation = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(manager->AllocateLocalTaskResources(
+      {{"CPU", 1.0}, {"object_store_memory", 50.0}}, allocation));
+  ASSERT_EQ(manager->GetReservedObjectStoreMemory(), 50);
+  manager->UpdateAvailableObjectStoreMemResource();
+  ASSERT_EQ(available_object_store(), 20.0);
+
+  // The remaining memory can't be reserved twice.
+  auto allocation2 = std::make_shared<TaskResourceInstances>();
+  ASSERT_FALSE(manager->AllocateLocalTaskResources(
+      {{"CPU", 1.0}, {"object_store_memory", 50.0}}, allocation2));
+  ASSERT_EQ(manager->GetReservedObjectStoreMemory(), 50);
+
+  // Outputs that are pinned fill the reservation instead of being counted twice.
+  used_object_store += 20;
+  manager->ConsumeObjectStoreMemoryReservation(allocation, 20);
+  ASSERT_EQ(manager->GetReservedObjectStoreMemory(), 30);
+  manager->UpdateAvailableObjectStoreMemResource();
+  ASSERT_EQ(available_object_store(), 20.0);
+  // Beyond the reservation, they're only counted as used.
+  used_object_store += 40;
+  manager->ConsumeObjectStoreMemoryReservation(allocation, 40);
+  ASSERT_EQ(manager->GetReservedObjectStoreMemory(), 0);
+  manager->UpdateAvailableObjectStoreMemResource();
+  ASSERT_EQ(available_object_store(), 10.0);
+
+  // Returning the lease after its outputs are freed doesn't make more memory available
+  // than the total.
+  used_object_store = 30;
+  manager->UpdateAvailableObjectStoreMemResource();
+  manager->ReleaseWorkerResources(allocation);
+  ASSERT_EQ(manager->GetReservedObjectStoreMemory(), 0);
+  ASSERT_EQ(available_object_store(), 70.0);
+
+  // A lease's outputs only fill its own reservation.
+  ASSERT_TRUE(manager->AllocateLocalTaskResources(
+      {{"CPU", 1.0}, {"object_store_memory", 20.0}}, allocation));
+  ASSERT_TRUE(manager->AllocateLocalTaskResources(
+      {{"CPU", 1.0}, {"object_store_memory", 20.0}}, allocation2));
+  ASSERT_EQ(manager->GetReservedObjectStoreMemory(), 40);
+  manager->ConsumeObjectStoreMemoryReservation(allocation, 30);
+  ASSERT_EQ(manager->GetReservedObjectStoreMemory(), 20);
+  // Objects that no lease with a reservation created don't fill any.
+  manager->ConsumeObjectStoreMemoryReservation(nullptr, 10);
+  ASSERT_EQ(manager->GetReservedObjectStoreMemory(), 20);
+  manager->ReleaseWorkerResources(allocation);
+  ASSERT_EQ(manager->GetReservedObjectStoreMemory(), 20);
+  manager->ConsumeObjectStoreMemoryReservation(allocation2, 5);
+  ASSERT_EQ(manager->GetReservedObjectStoreMemory(), 15);
+  manager->ReleaseWorkerResources(allocation2);
+  ASSERT_EQ(manager->GetReservedObjectStoreMemory(), 0);
+}
+
 TEST_F(LocalResourceManagerTest, IdleResourceTimeTest) {
   auto node_ip_resource = "node:127.0.0.1";
   auto pg_wildcard_resource = "CPU_group_4482dec0faaf5ead891ff1659a9501000000";
@@ -45,6 +45,10 @@ class MockWorker : public WorkerInterface {
 
   absl::Time GetAssignedTaskTime() const override { return task_assign_time_; };
 
+  void SetAssignedTaskTime(absl::Time task_assign_time) {
+    task_assign_time_ = task_assign_time;
+  }
+
   std::optional<bool> GetIsGpu() const override { return is_gpu_; }
 
   std::optional<bool> GetIsActorWorker() const override { return is_actor_worker_; }
@@ -79,9 +83,11 @@ class MockWorker : public WorkerInterface {
   void MarkUnblocked() override { blocked_ = false; }
   bool IsBlocked() const override { return blocked_; }
 
-  Process GetProcess() const override { return Process::CreateNewDummy(); }
+  Process GetProcess() const override {
+    return proc_.IsNull() ? Process::CreateNewDummy() : proc_;
+  }
   StartupToken GetStartupToken() const override { return 0; }
-  void SetProcess(Process proc) override { RAY_CHECK(false) << "Method unused"; }
+  void SetProcess(Process proc) override { proc_ = std::move(proc); }
 
   Language GetLanguage() const override {
     RAY_CHECK(false) << "Method unused";
@@ -183,6 +189,7 @@ class MockWorker : public WorkerInterface {
   bool blocked_ = false;
   RayTask task_;
   absl::Time task_assign_time_;
+  Process proc_;
   int runtime_env_hash_;
   TaskID task_id_;
   JobID job_id_;
@@ -36,17 +36,17 @@ void WaitManager::Wait(const std::vector<ObjectID> &object_ids,
       wait_id, WaitRequest(timeout_ms, callback, object_ids, num_required_objects));
 
   auto &wait_request = wait_requests_.at(wait_id);
-  for (const auto &object_id : object_ids) {
+  object_to_wait_requests_.reserve(object_to_wait_requests_.size() +
+                                   wait_request.object_ids.size());
+  for (size_t i = 0; i < wait_request.object_ids.size(); i++) {
+    const auto &object_id = wait_request.object_ids[i];
     if (is_object_local_(object_id)) {
-      wait_request.ready.emplace(object_id);
+      wait_request.MarkReady(i);
     }
+    object_to_wait_requests_[object_id].emplace(wait_id, i);
   }
 
-  for (const auto &object_id : wait_request.object_ids) {
-    object_to_wait_requests_[object_id].emplace(wait_id);
-  }
-
-  if (wait_request.ready.size() >= wait_request.num_required_objects ||
+  if (wait_request.num_ready >= wait_request.num_required_objects ||
       wait_request.timeout_ms == 0) {
     // Requirements already satisfied.
     WaitComplete(wait_id);
@@ -71,22 +71,28 @@ void WaitManager::WaitComplete(uint64_t wait_id) {
   auto &wait_request = map_find_or_die(wait_requests_, wait_id);
 
   for (const auto &object_id : wait_request.object_ids) {
-    auto &requests = object_to_wait_requests_.at(object_id);
-    requests.erase(wait_id);
+    auto it = object_to_wait_requests_.find(object_id);
+    RAY_CHECK(it != object_to_wait_requests_.end());
+    auto &requests = it->second;
+    const size_t num_erased = requests.erase(wait_id);
+    RAY_CHECK_EQ(num_erased, 1u);
     if (requests.empty()) {
-      object_to_wait_requests_.erase(object_id);
+      object_to_wait_requests_.erase(it);
     }
   }
 
   // Order objects according to input order.
   std::vector<ObjectID> ready;
   std::vector<ObjectID> remaining;
-  for (const auto &object_id : wait_request.object_ids) {
-    if (ready.size() < wait_request.num_required_objects &&
-        wait_request.ready.count(object_id) > 0) {
-      ready.push_back(object_id);
+  const uint64_t num_ready =
+      std::min(wait_request.num_ready, wait_request.num_required_objects);
+  ready.reserve(num_ready);
+  remaining.reserve(wait_request.object_ids.size() - num_ready);
+  for (size_t i = 0; i < wait_request.object_ids.size(); i++) {
+    if (ready.size() < wait_request.num_required_objects && wait_request.ready[i]) {
+      ready.push_back(wait_request.object_ids[i]);
     } else {
-      remaining.push_back(object_id);
+      remaining.push_back(wait_request.object_ids[i]);
     }
   }
   wait_request.callback(ready, remaining);
@@ -96,15 +102,16 @@ void WaitManager::WaitComplete(uint64_t wait_id) {
 }
 
 void WaitManager::HandleObjectLocal(const ray::ObjectID &object_id) {
-  if (object_to_wait_requests_.find(object_id) == object_to_wait_requests_.end()) {
+  auto it = object_to_wait_requests_.find(object_id);
+  if (it == object_to_wait_requests_.end()) {
     return;
   }
 
   std::vector<uint64_t> complete_waits;
-  for (const auto &wait_id : object_to_wait_requests_.at(object_id)) {
+  for (const auto &[wait_id, index] : it->second) {
     auto &wait_request = map_find_or_die(wait_requests_, wait_id);
-    wait_request.ready.emplace(object_id);
-    if (wait_request.ready.size() >= wait_request.num_required_objects) {
+    wait_request.MarkReady(index);
+    if (wait_request.num_ready >= wait_request.num_required_objects) {
       complete_waits.emplace_back(wait_id);
     }
   }
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "absl/container/flat_hash_map.h"
 #include "ray/common/id.h"
 
 namespace ray {
@@ -64,7 +65,8 @@ class WaitManager {
         : timeout_ms(timeout_ms),
           callback(callback),
           object_ids(object_ids),
-          num_required_objects(num_required_objects) {}
+          num_required_objects(num_required_objects),
+          ready(object_ids.size(), false) {}
     /// The period of time to wait before invoking the callback.
     const int64_t timeout_ms;
     /// The callback invoked when Wait is complete.
@@ -73,8 +75,18 @@ class WaitManager {
     const std::vector<ObjectID> object_ids;
     /// The number of required objects.
     const uint64_t num_required_objects;
-    /// The objects that have been locally available.
-    std::unordered_set<ObjectID> ready;
+    /// Bitmap over object_ids of the objects that have been locally available.
+    std::vector<bool> ready;
+    /// The number of set bits in `ready`.
+    uint64_t num_ready = 0;
+
+    /// Mark the object at the given index of object_ids as locally available.
+    void MarkReady(size_t index) {
+      if (!ready[index]) {
+        ready[index] = true;
+        num_ready++;
+      }
+    }
   };
 
   /// Completion handler for Wait.
@@ -93,8 +105,11 @@ class WaitManager {
   /// A set of active wait requests.
   std::unordered_map<uint64_t, WaitRequest> wait_requests_;
 
-  /// Map from object to wait requests that are waiting for this object.
-  std::unordered_map<ObjectID, std::unordered_set<uint64_t>> object_to_wait_requests_;
+  /// Map from object to the wait requests that are waiting for this object, keyed by
+  /// wait ID, to the index of the object in each request's object_ids. Keying by wait
+  /// ID lets a completed wait remove itself in constant time per object.
+  absl::flat_hash_map<ObjectID, absl::flat_hash_map<uint64_t, size_t>>
+      object_to_wait_requests_;
 
   uint64_t next_wait_id_;
 
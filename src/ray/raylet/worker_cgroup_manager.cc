@@ -0,0 +1,194 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_cgroup_manager.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "ray/stats/metric_defs.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+std::unique_ptr<WorkerCgroupManager> WorkerCgroupManager::Create(
+    const std::string &root) {
+#ifdef __linux__
+  std::ifstream controllers_file(root + "/cgroup.controllers");
+  if (!controllers_file.is_open()) {
+    RAY_LOG(WARNING) << "Not placing workers in cgroups, " << root
+                     << " is not a cgroup v2 directory.";
+    return nullptr;
+  }
+  bool has_memory_controller = false;
+  std::string controller;
+  while (controllers_file >> controller) {
+    has_memory_controller |= controller == "memory";
+  }
+  if (!has_memory_controller) {
+    RAY_LOG(WARNING) << "Not placing workers in cgroups, the memory controller is not "
+                     << "available in " << root << ".";
+    return nullptr;
+  }
+  // This fails if the root cgroup itself contains processes.
+  if (!WriteCgroupFile(root + "/cgroup.subtree_control", "+memory")) {
+    RAY_LOG(WARNING) << "Not placing workers in cgroups, failed to enable the memory "
+                     << "controller for the children of " << root << ".";
+    return nullptr;
+  }
+  RAY_LOG(INFO) << "Placing workers in per-worker cgroups under " << root;
+  return std::unique_ptr<WorkerCgroupManager>(new WorkerCgroupManager(root));
+#else
+  RAY_LOG(WARNING) << "Per-worker cgroups are only supported on Linux.";
+  return nullptr;
+#endif
+}
+
+WorkerCgroupManager::WorkerCgroupManager(const std::string &root) : root_(root) {}
+
+WorkerCgroupManager::~WorkerCgroupManager() {
+  for (const auto &[pid, worker_cgroup] : workers_) {
+    pending_removal_.push_back(worker_cgroup.path);
+  }
+  workers_.clear();
+  TryRemovePendingCgroups();
+}
+
+std::string WorkerCgroupManager::CreateWorkerCgroup(int64_t startup_token) {
+  TryRemovePendingCgroups();
+  const std::string path = GetWorkerCgroupPath(startup_token);
+  std::error_code ec;
+  std::filesystem::create_directory(path, ec);
+  if (ec) {
+    RAY_LOG(WARNING) << "Failed to create cgroup " << path << " for worker with token "
+                     << startup_token << ", error: " << ec.message();
+    return "";
+  }
+  return path + "/cgroup.procs";
+}
+
+bool WorkerCgroupManager::AddWorker(pid_t pid, int64_t startup_token) {
+  const std::string path = GetWorkerCgroupPath(startup_token);
+  // Moving a process into the cgroup it's already in is a no-op.
+  if (!WriteCgroupFile(path + "/cgroup.procs", std::to_string(pid))) {
+    RAY_LOG(WARNING) << "Failed to move worker with PID " << pid << " into cgroup "
+                     << path;
+    pending_removal_.push_back(path);
+    TryRemovePendingCgroups();
+    return false;
+  }
+  workers_[pid] = {path, 0};
+  return true;
+}
+
+void WorkerCgroupManager::SetMemoryHigh(pid_t pid, int64_t memory_high_bytes) {
+  auto it = workers_.find(pid);
+  if (it == workers_.end()) {
+    return;
+  }
+  const std::string value =
+      memory_high_bytes > 0 ? std::to_string(memory_high_bytes) : "max";
+  if (!WriteCgroupFile(it->second.path + "/memory.high", value)) {
+    RAY_LOG(INFO) << "Failed to set memory.high to " << value << " for worker with PID "
+                  << pid;
+  }
+}
+
+void WorkerCgroupManager::RemoveWorker(pid_t pid) {
+  auto it = workers_.find(pid);
+  if (it != workers_.end()) {
+    pending_removal_.push_back(it->second.path);
+    workers_.erase(it);
+  }
+  TryRemovePendingCgroups();
+}
+
+absl::flat_hash_map<pid_t, WorkerCgroupMemoryStats>
+WorkerCgroupManager::GetWorkerMemoryStats() const {
+  absl::flat_hash_map<pid_t, WorkerCgroupMemoryStats> stats;
+  for (const auto &[pid, worker_cgroup] : workers_) {
+    const std::string &path = worker_cgroup.path;
+    std::ifstream current_file(path + "/memory.current");
+    int64_t current_bytes = -1;
+    if (!(current_file >> current_bytes)) {
+      continue;
+    }
+    stats[pid] = {current_bytes, ReadMemoryHighEvents(path + "/memory.events")};
+  }
+  return stats;
+}
+
+void WorkerCgroupManager::RecordMetrics() {
+  TryRemovePendingCgroups();
+  for (const auto &[pid, memory_stats] : GetWorkerMemoryStats()) {
+    ray::stats::STATS_memory_manager_worker_cgroup_memory_bytes.Record(
+        memory_stats.current_bytes);
+    auto &last_high_events = workers_[pid].last_high_events;
+    if (memory_stats.high_events > last_high_events) {
+      ray::stats::STATS_memory_manager_worker_cgroup_throttled_total.Record(
+          memory_stats.high_events - last_high_events);
+      last_high_events = memory_stats.high_events;
+    }
+  }
+}
+
+std::string WorkerCgroupManager::GetWorkerCgroupPath(int64_t startup_token) const {
+  return root_ + "/worker_" + std::to_string(startup_token);
+}
+
+void WorkerCgroupManager::TryRemovePendingCgroups() {
+  std::vector<std::string> still_pending;
+  for (const auto &path : pending_removal_) {
+    // rmdir succeeds on a cgroup once all of its processes have exited, even though
+    // the interface files are still listed.
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    if (ec && std::filesystem::exists(path)) {
+      still_pending.push_back(path);
+    }
+  }
+  pending_removal_ = std::move(still_pending);
+}
+
+bool WorkerCgroupManager::WriteCgroupFile(const std::string &path,
+                                          const std::string &value) {
+  std::ofstream file(path, std::ofstream::out);
+  if (!file.is_open()) {
+    return false;
+  }
+  file << value;
+  file.flush();
+  return !file.fail();
+}
+
+int64_t WorkerCgroupManager::ReadMemoryHighEvents(const std::string &memory_events_path) {
+  std::ifstream events_file(memory_events_path);
+  std::string line;
+  while (std::getline(events_file, line)) {
+    std::istringstream iss(line);
+    std::string key;
+    int64_t value;
+    if (iss >> key >> value && key == "high") {
+      return value;
+    }
+  }
+  return -1;
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,136 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gtest/gtest_prod.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// Memory accounting of a worker's cgroup.
+struct WorkerCgroupMemoryStats {
+  /// The memory charged to the cgroup, from memory.current.
+  int64_t current_bytes;
+
+  /// The number of times the cgroup was throttled for exceeding memory.high, from the
+  /// `high` entry of memory.events.
+  int64_t high_events;
+};
+
+/// Places each worker process in its own cgroup v2 child of a delegated root so that
+/// the kernel throttles a worker that goes over the memory its task requested before
+/// the whole node runs low on memory.
+///
+/// The root must be a cgroup v2 directory writable by the raylet, with the memory
+/// controller available and no processes of its own, e.g. a delegated systemd scope.
+/// This class is not thread safe.
+class WorkerCgroupManager {
+ public:
+  /// Creates a manager for the given root.
+  ///
+  /// \param root the path of the cgroup the worker cgroups are created under.
+  /// \return the manager, or nullptr if the memory controller cannot be enabled for
+  /// the children of `root`.
+  static std::unique_ptr<WorkerCgroupManager> Create(const std::string &root);
+
+  ~WorkerCgroupManager();
+
+  /// Creates a cgroup for a worker process that is about to be started, so that the
+  /// process can join it before it execs.
+  ///
+  /// \param startup_token the startup token of the worker process.
+  /// \return the path of the cgroup.procs file of the cgroup, or an empty string if the
+  /// cgroup could not be created.
+  std::string CreateWorkerCgroup(int64_t startup_token);
+
+  /// Starts managing the cgroup created for the worker process. The process normally
+  /// joined the cgroup itself before it exec'd. This moves it in otherwise.
+  ///
+  /// \param pid the worker process id.
+  /// \param startup_token the startup token the cgroup was created for.
+  /// \return true if the worker is in its cgroup.
+  bool AddWorker(pid_t pid, int64_t startup_token);
+
+  /// Sets memory.high of the worker's cgroup.
+  ///
+  /// \param pid the worker process id.
+  /// \param memory_high_bytes the memory above which the kernel throttles the worker
+  /// and reclaims its memory aggressively. Values <= 0 remove the limit.
+  void SetMemoryHigh(pid_t pid, int64_t memory_high_bytes);
+
+  /// Removes the cgroup of the worker. Cgroups that still contain processes are retried
+  /// on later calls to this class.
+  ///
+  /// \param pid the worker process id.
+  void RemoveWorker(pid_t pid);
+
+  /// \return the memory stats of all managed workers that could be read, by pid.
+  absl::flat_hash_map<pid_t, WorkerCgroupMemoryStats> GetWorkerMemoryStats() const;
+
+  /// Records the per-worker memory usage and the memory.high throttling events since
+  /// the last call.
+  void RecordMetrics();
+
+ private:
+  explicit WorkerCgroupManager(const std::string &root);
+
+  /// \return the path of the cgroup created for the startup token.
+  std::string GetWorkerCgroupPath(int64_t startup_token) const;
+
+  /// Removes the cgroups whose processes have exited since they were removed.
+  void TryRemovePendingCgroups();
+
+  /// \param path the file to write to.
+  /// \param value the value to write.
+  /// \return true if the value was written.
+  static bool WriteCgroupFile(const std::string &path, const std::string &value);
+
+  /// \param memory_events_path file path to the memory.events file.
+  /// \return the value of the `high` entry, or -1 if it cannot be read.
+  static int64_t ReadMemoryHighEvents(const std::string &memory_events_path);
+
+  /// The cgroup the worker cgroups are created under.
+  const std::string root_;
+
+  struct WorkerCgroup {
+    /// The path of the worker's cgroup.
+    std::string path;
+    /// The `high` count of memory.events at the last RecordMetrics.
+    int64_t last_high_events = 0;
+  };
+
+  /// The cgroups of the managed workers, by pid.
+  absl::flat_hash_map<pid_t, WorkerCgroup> workers_;
+
+  /// The cgroups of removed workers that still had processes in them.
+  std::vector<std::string> pending_removal_;
+
+  FRIEND_TEST(WorkerCgroupManagerTest, TestReadMemoryHighEvents);
+  FRIEND_TEST(WorkerCgroupManagerTest, TestFakeHierarchyWritesInterfaceFiles);
+  FRIEND_TEST(WorkerCgroupManagerTest, TestFailedAddWorkerRemovesCgroup);
+  FRIEND_TEST(WorkerCgroupManagerTest, TestLocalCgroupHierarchyCountsThrottling);
+};
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,231 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_cgroup_manager.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ray/common/id.h"
+
+namespace ray {
+
+namespace raylet {
+
+class WorkerCgroupManagerTest : public ::testing::Test {
+ protected:
+  void WriteFile(const std::string &path, const std::string &content) {
+    std::ofstream file(path);
+    file << content;
+  }
+
+  std::string ReadFile(const std::string &path) {
+    std::ifstream file(path);
+    std::string content;
+    std::getline(file, content);
+    return content;
+  }
+};
+
+TEST_F(WorkerCgroupManagerTest, TestCreateWithoutMemoryControllerReturnsNull) {
+  std::string root = UniqueID::FromRandom().Hex();
+  ASSERT_EQ(WorkerCgroupManager::Create(root), nullptr);
+
+  boost::filesystem::create_directory(root);
+  WriteFile(root + "/cgroup.controllers", "cpuset cpu io pids\n");
+  ASSERT_EQ(WorkerCgroupManager::Create(root), nullptr);
+  boost::filesystem::remove_all(root);
+}
+
+TEST_F(WorkerCgroupManagerTest, TestReadMemoryHighEvents) {
+  std::string events_path = UniqueID::FromRandom().Hex();
+  WriteFile(events_path, "low 0\nhigh 42\nmax 3\noom 1\noom_kill 1\n");
+  ASSERT_EQ(WorkerCgroupManager::ReadMemoryHighEvents(events_path), 42);
+  std::remove(events_path.c_str());
+  ASSERT_EQ(WorkerCgroupManager::ReadMemoryHighEvents(events_path), -1);
+}
+
+TEST_F(WorkerCgroupManagerTest, TestFakeHierarchyWritesInterfaceFiles) {
+  // A plain directory behaves like a cgroup whose interface files are regular files.
+  std::string root = UniqueID::FromRandom().Hex();
+  boost::filesystem::create_directory(root);
+  WriteFile(root + "/cgroup.controllers", "cpu io memory pids\n");
+
+  auto manager = WorkerCgroupManager::Create(root);
+  ASSERT_NE(manager, nullptr);
+  ASSERT_EQ(ReadFile(root + "/cgroup.subtree_control"), "+memory");
+
+  std::string worker_path = manager->GetWorkerCgroupPath(/*startup_token=*/1);
+  ASSERT_EQ(manager->CreateWorkerCgroup(1), worker_path + "/cgroup.procs");
+  ASSERT_TRUE(boost::filesystem::is_directory(worker_path));
+  ASSERT_TRUE(manager->AddWorker(123, 1));
+  ASSERT_EQ(ReadFile(worker_path + "/cgroup.procs"), "123");
+
+  manager->SetMemoryHigh(123, 1024 * 1024 * 1024);
+  ASSERT_EQ(ReadFile(worker_path + "/memory.high"), "1073741824");
+  manager->SetMemoryHigh(123, 0);
+  ASSERT_EQ(ReadFile(worker_path + "/memory.high"), "max");
+  // Unknown workers are ignored.
+  manager->SetMemoryHigh(456, 1024);
+  ASSERT_FALSE(boost::filesystem::exists(manager->GetWorkerCgroupPath(456)));
+  ASSERT_EQ(ReadFile(worker_path + "/memory.high"), "max");
+
+  WriteFile(worker_path + "/memory.current", "4096\n");
+  WriteFile(worker_path + "/memory.events", "low 0\nhigh 7\nmax 0\n");
+  auto stats = manager->GetWorkerMemoryStats();
+  ASSERT_EQ(stats.size(), 1);
+  ASSERT_EQ(stats[123].current_bytes, 4096);
+  ASSERT_EQ(stats[123].high_events, 7);
+
+  manager->RemoveWorker(123);
+  ASSERT_TRUE(manager->GetWorkerMemoryStats().empty());
+
+  manager.reset();
+  boost::filesystem::remove_all(root);
+}
+
+TEST_F(WorkerCgroupManagerTest, TestFailedAddWorkerRemovesCgroup) {
+  std::string root = UniqueID::FromRandom().Hex();
+  boost::filesystem::create_directory(root);
+  WriteFile(root + "/cgroup.controllers", "cpu io memory pids\n");
+  auto manager = WorkerCgroupManager::Create(root);
+  ASSERT_NE(manager, nullptr);
+
+  // The worker can't be moved into a cgroup whose cgroup.procs can't be written.
+  std::string worker_path = manager->GetWorkerCgroupPath(/*startup_token=*/1);
+  ASSERT_FALSE(manager->CreateWorkerCgroup(1).empty());
+  boost::filesystem::create_directory(worker_path + "/cgroup.procs");
+  ASSERT_FALSE(manager->AddWorker(123, 1));
+  ASSERT_TRUE(manager->GetWorkerMemoryStats().empty());
+  // The cgroup isn't empty yet, so its removal is retried later.
+  ASSERT_EQ(manager->pending_removal_, std::vector<std::string>({worker_path}));
+  boost::filesystem::remove(worker_path + "/cgroup.procs");
+  manager->RemoveWorker(123);
+  ASSERT_TRUE(manager->pending_removal_.empty());
+  ASSERT_FALSE(boost::filesystem::exists(worker_path));
+
+  manager.reset();
+  boost::filesystem::remove_all(root);
+}
+
+TEST_F(WorkerCgroupManagerTest, TestLocalCgroupHierarchyCountsThrottling) {
+  // Runs against the real cgroup v2 hierarchy when this process is allowed to create
+  // a child of its own cgroup.
+  std::ifstream self_cgroup("/proc/self/cgroup");
+  std::string line;
+  std::string self_cgroup_path;
+  while (std::getline(self_cgroup, line)) {
+    if (line.rfind("0::", 0) == 0) {
+      self_cgroup_path = "/sys/fs/cgroup" + line.substr(3);
+    }
+  }
+  if (self_cgroup_path.empty() ||
+      !boost::filesystem::exists(self_cgroup_path + "/cgroup.controllers")) {
+    GTEST_SKIP() << "cgroup v2 is not available.";
+  }
+  std::string root = self_cgroup_path + "/ray_test_" + UniqueID::FromRandom().Hex();
+  boost::system::error_code ec;
+  if (!boost::filesystem::create_directory(root, ec) || ec) {
+    GTEST_SKIP() << "Not allowed to create a cgroup under " << self_cgroup_path;
+  }
+  auto manager = WorkerCgroupManager::Create(root);
+  if (manager == nullptr) {
+    rmdir(root.c_str());
+    GTEST_SKIP() << "The memory controller is not delegated to " << root;
+  }
+
+  const int64_t memory_high_bytes = 16 * 1024 * 1024;
+  std::string procs_path = manager->CreateWorkerCgroup(/*startup_token=*/1);
+  ASSERT_FALSE(procs_path.empty());
+  std::string worker_path = manager->GetWorkerCgroupPath(1);
+  // The child waits for memory.high to be set, then allocates until it's throttled.
+  int start_pipe[2];
+  int done_pipe[2];
+  ASSERT_EQ(pipe(start_pipe), 0);
+  ASSERT_EQ(pipe(done_pipe), 0);
+  pid_t pid = fork();
+  if (pid == 0) {
+    // Join the cgroup before allocating anything, as the worker pool's workers do.
+    WriteFile(procs_path, std::to_string(getpid()));
+    char c;
+    if (read(start_pipe[0], &c, 1) != 1) {
+      _exit(1);
+    }
+    // Allocate in small steps so that the usage stays just above memory.high and the
+    // kernel doesn't throttle the child for long.
+    std::vector<std::unique_ptr<char[]>> chunks;
+    const size_t chunk_size = 256 * 1024;
+    for (size_t allocated = 0; allocated < 4 * memory_high_bytes;
+         allocated += chunk_size) {
+      chunks.emplace_back(new char[chunk_size]);
+      memset(chunks.back().get(), 1, chunk_size);
+      if (WorkerCgroupManager::ReadMemoryHighEvents(worker_path + "/memory.events") >
+          0) {
+        break;
+      }
+    }
+    if (write(done_pipe[1], &c, 1) != 1) {
+      _exit(1);
+    }
+    pause();
+    _exit(0);
+  }
+  ASSERT_GT(pid, 0);
+
+  ASSERT_TRUE(manager->AddWorker(pid, 1));
+  std::string proc_cgroup = ReadFile("/proc/" + std::to_string(pid) + "/cgroup");
+  ASSERT_EQ(proc_cgroup.substr(proc_cgroup.rfind('/') + 1), "worker_1");
+
+  manager->SetMemoryHigh(pid, memory_high_bytes);
+  ASSERT_EQ(ReadFile(worker_path + "/memory.high"), std::to_string(memory_high_bytes));
+  char c = 0;
+  ASSERT_EQ(write(start_pipe[1], &c, 1), 1);
+  ASSERT_EQ(read(done_pipe[0], &c, 1), 1);
+
+  auto stats = manager->GetWorkerMemoryStats();
+  ASSERT_EQ(stats.size(), 1);
+  ASSERT_GT(stats[pid].current_bytes, 0);
+  ASSERT_GT(stats[pid].high_events, 0);
+  // The throttling events are counted once.
+  manager->RecordMetrics();
+  ASSERT_EQ(manager->workers_[pid].last_high_events, stats[pid].high_events);
+
+  kill(pid, SIGKILL);
+  waitpid(pid, nullptr, 0);
+  for (int fd : {start_pipe[0], start_pipe[1], done_pipe[0], done_pipe[1]}) {
+    close(fd);
+  }
+  manager->RemoveWorker(pid);
+  ASSERT_FALSE(boost::filesystem::exists(worker_path));
+
+  manager.reset();
+  rmdir(root.c_str());
+}
+
+}  // namespace raylet
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
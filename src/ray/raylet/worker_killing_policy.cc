@@ -19,6 +19,7 @@
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/asio/periodical_runner.h"
 #include "ray/raylet/worker.h"
+#include "ray/raylet/worker_killing_policy_cost_based.h"
 #include "ray/raylet/worker_killing_policy_group_by_owner.h"
 #include "ray/raylet/worker_killing_policy_retriable_fifo.h"
 #include "ray/raylet/worker_pool.h"
@@ -103,6 +104,9 @@ std::shared_ptr<WorkerKillingPolicy> CreateWorkerKillingPolicy(
   } else if (killing_policy_str == kFifoPolicy) {
     RAY_LOG(INFO) << "Running RetriableFIFO policy.";
     return std::make_shared<RetriableFIFOWorkerKillingPolicy>();
+  } else if (killing_policy_str == kCostBasedPolicy) {
+    RAY_LOG(INFO) << "Running CostBased policy.";
+    return std::make_shared<CostBasedWorkerKillingPolicy>();
   } else {
     RAY_LOG(ERROR)
         << killing_policy_str
@@ -29,6 +29,7 @@ namespace raylet {
 constexpr char kLifoPolicy[] = "retriable_lifo";
 constexpr char kGroupByOwner[] = "group_by_owner";
 constexpr char kFifoPolicy[] = "retriable_fifo";
+constexpr char kCostBasedPolicy[] = "cost_based";
 
 /// Provides the policy on which worker to prioritize killing.
 class WorkerKillingPolicy {
@@ -0,0 +1,131 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_killing_policy_cost_based.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "ray/raylet/worker.h"
+#include "ray/raylet/worker_killing_policy.h"
+
+namespace ray {
+
+namespace raylet {
+
+CostBasedWorkerKillingPolicy::CostBasedWorkerKillingPolicy() {}
+
+const std::pair<std::shared_ptr<WorkerInterface>, bool>
+CostBasedWorkerKillingPolicy::SelectWorkerToKill(
+    const std::vector<std::shared_ptr<WorkerInterface>> &workers,
+    const MemorySnapshot &system_memory) const {
+  if (workers.empty()) {
+    RAY_LOG_EVERY_MS(INFO, 5000) << "Worker list is empty. Nothing can be killed";
+    return std::make_pair(nullptr, /*should retry*/ false);
+  }
+
+  const absl::Time now = absl::Now();
+  std::vector<std::pair<double, std::shared_ptr<WorkerInterface>>> scored;
+  scored.reserve(workers.size());
+  for (const auto &worker : workers) {
+    scored.emplace_back(ComputeKillCost(worker, system_memory, now), worker);
+  }
+
+  std::sort(scored.begin(),
+            scored.end(),
+            [](const std::pair<double, std::shared_ptr<WorkerInterface>> &left,
+               const std::pair<double, std::shared_ptr<WorkerInterface>> &right) -> bool {
+              // First sort by retriable tasks and then by kill cost in ascending order.
+              int left_retriable =
+                  left.second->GetAssignedTask().GetTaskSpecification().IsRetriable()
+                      ? 0
+                      : 1;
+              int right_retriable =
+                  right.second->GetAssignedTask().GetTaskSpecification().IsRetriable()
+                      ? 0
+                      : 1;
+              if (left_retriable == right_retriable) {
+                return left.first < right.first;
+              }
+              return left_retriable < right_retriable;
+            });
+
+  std::vector<std::shared_ptr<WorkerInterface>> sorted;
+  sorted.reserve(scored.size());
+  for (const auto &entry : scored) {
+    sorted.push_back(entry.second);
+  }
+
+  const static int32_t max_to_print = 10;
+  RAY_LOG(INFO) << "The top 10 workers to be killed based on the worker killing policy:\n"
+                << WorkerKillingPolicy::WorkersDebugString(
+                       sorted, max_to_print, system_memory);
+
+  return std::make_pair(sorted.front(), /*should retry*/ true);
+}
+
+double CostBasedWorkerKillingPolicy::ComputeKillCost(
+    const std::shared_ptr<WorkerInterface> &worker,
+    const MemorySnapshot &system_memory,
+    absl::Time now) {
+  const auto &task_spec = worker->GetAssignedTask().GetTaskSpecification();
+  double runtime_seconds =
+      std::max(0.0, absl::ToDoubleSeconds(now - worker->GetAssignedTaskTime()));
+  double lost_work =
+      (runtime_seconds + kRestartCostSeconds) * GetRetryBudgetWeight(task_spec);
+
+  int64_t freed_bytes = GetFreedBytes(worker, system_memory);
+  if (freed_bytes <= 0) {
+    // Killing a worker we can't attribute any memory to may not help at all.
+    return std::numeric_limits<double>::max();
+  }
+  return lost_work / static_cast<double>(freed_bytes);
+}
+
+int64_t CostBasedWorkerKillingPolicy::GetFreedBytes(
+    const std::shared_ptr<WorkerInterface> &worker, const MemorySnapshot &system_memory) {
+  int64_t freed_bytes = 0;
+  const auto pid_entry =
+      system_memory.process_used_bytes.find(worker->GetProcess().GetId());
+  if (pid_entry != system_memory.process_used_bytes.end()) {
+    freed_bytes += pid_entry->second;
+  }
+  const auto owner_entry =
+      system_memory.owner_object_store_bytes.find(worker->WorkerId());
+  if (owner_entry != system_memory.owner_object_store_bytes.end()) {
+    freed_bytes += owner_entry->second;
+  }
+  return freed_bytes;
+}
+
+double CostBasedWorkerKillingPolicy::GetRetryBudgetWeight(
+    const TaskSpecification &task_spec) {
+  int64_t max_attempts = 0;
+  if (task_spec.IsActorCreationTask()) {
+    max_attempts = task_spec.MaxActorRestarts();
+  } else if (task_spec.IsNormalTask()) {
+    max_attempts = task_spec.MaxRetries();
+  }
+  if (max_attempts < 0) {
+    return 1.0;
+  }
+  int64_t remaining = std::max<int64_t>(
+      0, max_attempts - static_cast<int64_t>(task_spec.AttemptNumber()));
+  // 2x with no retries left, approaching 1x as the remaining budget grows.
+  return 1.0 + 1.0 / static_cast<double>(remaining + 1);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,66 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gtest/gtest_prod.h>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "ray/common/memory_monitor.h"
+#include "ray/raylet/worker.h"
+#include "ray/raylet/worker_killing_policy.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// Prefers killing retriable workers over non-retriable ones, then the worker that
+/// loses the least work per byte of memory freed by killing it.
+///
+/// The freed memory of a worker is its RSS plus the primary object store bytes it
+/// owns on this node, since those are released once the owner dies. The lost work is
+/// the runtime of the assigned task so far plus a fixed restart cost, weighted up as
+/// the task's retry budget runs out.
+class CostBasedWorkerKillingPolicy : public WorkerKillingPolicy {
+ public:
+  CostBasedWorkerKillingPolicy();
+  const std::pair<std::shared_ptr<WorkerInterface>, bool> SelectWorkerToKill(
+      const std::vector<std::shared_ptr<WorkerInterface>> &workers,
+      const MemorySnapshot &system_memory) const;
+
+ private:
+  /// Seconds of work lost per byte freed if the worker is killed at `now`.
+  static double ComputeKillCost(const std::shared_ptr<WorkerInterface> &worker,
+                                const MemorySnapshot &system_memory,
+                                absl::Time now);
+
+  /// Bytes released by killing the worker: its RSS plus the object store bytes it owns.
+  static int64_t GetFreedBytes(const std::shared_ptr<WorkerInterface> &worker,
+                               const MemorySnapshot &system_memory);
+
+  /// Multiplier on the lost work that grows as the remaining retries shrink. Tasks
+  /// with infinite retries have a weight of 1.
+  static double GetRetryBudgetWeight(const TaskSpecification &task_spec);
+
+  /// Fixed cost in seconds of rescheduling and restarting a killed worker. Keeps
+  /// freshly assigned workers from all scoring zero.
+  static constexpr double kRestartCostSeconds = 1.0;
+
+  FRIEND_TEST(CostBasedWorkerKillingPolicyTest, TestRetryBudgetWeight);
+};
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,183 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_killing_policy_cost_based.h"
+
+#include "gtest/gtest.h"
+#include "ray/common/task/task_spec.h"
+#include "ray/raylet/test/util.h"
+#include "ray/raylet/worker_killing_policy.h"
+#include "ray/raylet/worker_killing_policy_group_by_owner.h"
+#include "ray/raylet/worker_killing_policy_retriable_fifo.h"
+
+namespace ray {
+
+namespace raylet {
+
+constexpr int64_t kGiB = 1024 * 1024 * 1024;
+
+class CostBasedWorkerKillingPolicyTest : public ::testing::Test {
+ protected:
+  int32_t port_ = 2389;
+  CostBasedWorkerKillingPolicy worker_killing_policy_;
+  MemorySnapshot memory_snapshot_;
+
+  /// Create a normal task worker that has been running for `runtime` and whose
+  /// process uses `rss_bytes` and owns `object_store_bytes` of primary copies.
+  std::shared_ptr<MockWorker> CreateTaskWorker(int32_t max_retries,
+                                               absl::Duration runtime,
+                                               int64_t rss_bytes,
+                                               int64_t object_store_bytes) {
+    rpc::TaskSpec message;
+    message.set_max_retries(max_retries);
+    message.set_type(ray::rpc::TaskType::NORMAL_TASK);
+    TaskSpecification task_spec(message);
+    RayTask task(task_spec);
+    auto worker = std::make_shared<MockWorker>(ray::WorkerID::FromRandom(), port_);
+    worker->SetAssignedTask(task);
+    worker->SetAssignedTaskTime(absl::Now() - runtime);
+    // PIDs above the limit are not checked against live processes.
+    pid_t pid = static_cast<pid_t>(PID_MAX_LIMIT + 1 + next_pid_offset_++);
+    worker->SetProcess(Process::FromPid(pid));
+    memory_snapshot_.process_used_bytes[pid] = rss_bytes;
+    if (object_store_bytes > 0) {
+      memory_snapshot_.owner_object_store_bytes[worker->WorkerId()] = object_store_bytes;
+    }
+    return worker;
+  }
+
+  /// Repeatedly kill the worker chosen by `policy` until `bytes_to_free` bytes are
+  /// reclaimed, and return the CPU-seconds of task runtime lost. Each task is
+  /// assumed to use one CPU.
+  double SimulateLostCpuSeconds(const WorkerKillingPolicy &policy,
+                                std::vector<std::shared_ptr<WorkerInterface>> workers,
+                                int64_t bytes_to_free) {
+    const absl::Time now = absl::Now();
+    double lost_cpu_seconds = 0;
+    int64_t freed_bytes = 0;
+    while (freed_bytes < bytes_to_free && !workers.empty()) {
+      auto worker = policy.SelectWorkerToKill(workers, memory_snapshot_).first;
+      RAY_CHECK(worker != nullptr);
+      lost_cpu_seconds += absl::ToDoubleSeconds(now - worker->GetAssignedTaskTime());
+      freed_bytes += memory_snapshot_.process_used_bytes[worker->GetProcess().GetId()];
+      freed_bytes += memory_snapshot_.owner_object_store_bytes[worker->WorkerId()];
+      workers.erase(std::remove(workers.begin(), workers.end(), worker), workers.end());
+    }
+    return lost_cpu_seconds;
+  }
+
+ private:
+  int32_t next_pid_offset_ = 0;
+};
+
+TEST_F(CostBasedWorkerKillingPolicyTest, TestEmptyWorkerPoolSelectsNullWorker) {
+  std::vector<std::shared_ptr<WorkerInterface>> workers;
+  auto worker_to_kill_and_should_retry =
+      worker_killing_policy_.SelectWorkerToKill(workers, MemorySnapshot());
+  auto worker_to_kill = worker_to_kill_and_should_retry.first;
+  ASSERT_TRUE(worker_to_kill == nullptr);
+}
+
+TEST_F(CostBasedWorkerKillingPolicyTest, TestPreferRetriableOverNonRetriable) {
+  auto non_retriable =
+      CreateTaskWorker(0 /* max_retries */, absl::Seconds(1), 8 * kGiB, 0);
+  auto retriable =
+      CreateTaskWorker(3 /* max_retries */, absl::Seconds(600), kGiB / 4, 0);
+  std::vector<std::shared_ptr<WorkerInterface>> workers = {non_retriable, retriable};
+
+  auto worker_to_kill =
+      worker_killing_policy_.SelectWorkerToKill(workers, memory_snapshot_).first;
+  ASSERT_EQ(worker_to_kill->WorkerId(), retriable->WorkerId());
+}
+
+TEST_F(CostBasedWorkerKillingPolicyTest, TestCountsOwnedObjectStoreBytes) {
+  // Same runtime and RSS, but the second worker owns objects pinned in plasma.
+  auto no_objects = CreateTaskWorker(-1, absl::Seconds(60), kGiB, 0);
+  auto owns_objects = CreateTaskWorker(-1, absl::Seconds(60), kGiB, 4 * kGiB);
+  std::vector<std::shared_ptr<WorkerInterface>> workers = {no_objects, owns_objects};
+
+  auto worker_to_kill =
+      worker_killing_policy_.SelectWorkerToKill(workers, memory_snapshot_).first;
+  ASSERT_EQ(worker_to_kill->WorkerId(), owns_objects->WorkerId());
+}
+
+TEST_F(CostBasedWorkerKillingPolicyTest, TestPreferLessLostWorkPerFreedByte) {
+  // 600s per GiB vs 30s per GiB.
+  auto long_running = CreateTaskWorker(-1, absl::Seconds(600), kGiB, 0);
+  auto short_running = CreateTaskWorker(-1, absl::Seconds(60), 2 * kGiB, 0);
+  std::vector<std::shared_ptr<WorkerInterface>> workers = {long_running, short_running};
+
+  auto worker_to_kill =
+      worker_killing_policy_.SelectWorkerToKill(workers, memory_snapshot_).first;
+  ASSERT_EQ(worker_to_kill->WorkerId(), short_running->WorkerId());
+}
+
+TEST_F(CostBasedWorkerKillingPolicyTest, TestRetryBudgetWeight) {
+  rpc::TaskSpec message;
+  message.set_type(ray::rpc::TaskType::NORMAL_TASK);
+  message.set_max_retries(-1);
+  ASSERT_EQ(
+      CostBasedWorkerKillingPolicy::GetRetryBudgetWeight(TaskSpecification(message)),
+      1.0);
+
+  message.set_max_retries(3);
+  message.set_attempt_number(3);
+  double exhausted_weight =
+      CostBasedWorkerKillingPolicy::GetRetryBudgetWeight(TaskSpecification(message));
+  message.set_attempt_number(0);
+  double fresh_weight =
+      CostBasedWorkerKillingPolicy::GetRetryBudgetWeight(TaskSpecification(message));
+  ASSERT_GT(exhausted_weight, fresh_weight);
+  ASSERT_GT(fresh_weight, 1.0);
+}
+
+TEST_F(CostBasedWorkerKillingPolicyTest, TestSimulatedLostCpuSecondsAcrossPolicies) {
+  // An older worker pins most of the object store, while the newest workers are
+  // small. Reclaiming 6 GiB by age alone either kills several small workers or the
+  // oldest worker, while the cost-based policy kills the object store owner.
+  std::vector<std::shared_ptr<WorkerInterface>> workers = {
+      CreateTaskWorker(-1, absl::Seconds(600), kGiB, 0),
+      CreateTaskWorker(-1, absl::Seconds(300), kGiB, 6 * kGiB),
+      CreateTaskWorker(-1, absl::Seconds(120), kGiB / 2, 0),
+      CreateTaskWorker(-1, absl::Seconds(60), kGiB / 2, 0),
+      CreateTaskWorker(-1, absl::Seconds(30), kGiB / 4, 0),
+  };
+  const int64_t bytes_to_free = 6 * kGiB;
+
+  double cost_based_lost =
+      SimulateLostCpuSeconds(worker_killing_policy_, workers, bytes_to_free);
+  double lifo_lost = SimulateLostCpuSeconds(
+      RetriableLIFOWorkerKillingPolicy(), workers, bytes_to_free);
+  double fifo_lost = SimulateLostCpuSeconds(
+      RetriableFIFOWorkerKillingPolicy(), workers, bytes_to_free);
+  double group_by_owner_lost = SimulateLostCpuSeconds(
+      GroupByOwnerIdWorkerKillingPolicy(), workers, bytes_to_free);
+
+  RAY_LOG(INFO) << "Lost CPU-seconds: cost_based " << cost_based_lost << ", lifo "
+                << lifo_lost << ", fifo " << fifo_lost << ", group_by_owner "
+                << group_by_owner_lost;
+  ASSERT_NEAR(cost_based_lost, 300, 1);
+  ASSERT_LT(cost_based_lost, lifo_lost);
+  ASSERT_LT(cost_based_lost, fifo_lost);
+  ASSERT_LT(cost_based_lost, group_by_owner_lost);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -123,6 +123,10 @@ WorkerPool::WorkerPool(instrumented_io_context &io_service,
   stats::NumCachedWorkersSkippedJobMismatch.Record(0);
   stats::NumCachedWorkersSkippedDynamicOptionsMismatch.Record(0);
   stats::NumCachedWorkersSkippedRuntimeEnvironmentMismatch.Record(0);
+  if (!RayConfig::instance().worker_cgroup_root().empty()) {
+    worker_cgroup_manager_ =
+        WorkerCgroupManager::Create(RayConfig::instance().worker_cgroup_root());
+  }
   // We used to ignore SIGCHLD here. The code is moved to raylet main.cc to support the
   // subreaper feature.
   for (const auto &entry : worker_commands) {
@@ -494,14 +498,23 @@ std::tuple<Process, StartupToken> WorkerPool::StartWorkerProcess(
                               serialized_runtime_env_context,
                               state);
 
+  std::string cgroup_procs_path;
+  if (!IsIOWorkerType(worker_type) && worker_cgroup_manager_ != nullptr) {
+    cgroup_procs_path =
+        worker_cgroup_manager_->CreateWorkerCgroup(worker_startup_token_counter_);
+  }
+
   auto start = std::chrono::high_resolution_clock::now();
   // Start a process and measure the startup time.
-  Process proc = StartProcess(worker_command_args, env);
+  Process proc = StartProcess(worker_command_args, env, cgroup_procs_path);
   stats::NumWorkersStarted.Record(1);
   RAY_LOG(INFO) << "Started worker process with pid " << proc.GetId() << ", the token is "
                 << worker_startup_token_counter_;
   if (!IsIOWorkerType(worker_type)) {
     AdjustWorkerOomScore(proc.GetId());
+    if (!cgroup_procs_path.empty()) {
+      worker_cgroup_manager_->AddWorker(proc.GetId(), worker_startup_token_counter_);
+    }
   }
   MonitorStartingWorkerProcess(worker_startup_token_counter_, language, worker_type);
   AddWorkerProcess(state, worker_type, proc, start, runtime_env_info, dynamic_options);
@@ -535,6 +548,19 @@ void WorkerPool::AdjustWorkerOomScore(pid_t pid) const {
 #endif
 }
 
+void WorkerPool::SetWorkerMemoryHigh(const std::shared_ptr<WorkerInterface> &worker,
+                                     const TaskSpecification *task_spec) {
+  if (worker_cgroup_manager_ == nullptr) {
+    return;
+  }
+  int64_t memory_high_bytes = 0;
+  if (task_spec != nullptr) {
+    memory_high_bytes = static_cast<int64_t>(
+        task_spec->GetRequiredResources().Get(scheduling::ResourceID::Memory()).Double());
+  }
+  worker_cgroup_manager_->SetMemoryHigh(worker->GetProcess().GetId(), memory_high_bytes);
+}
+
 void WorkerPool::MonitorStartingWorkerProcess(StartupToken proc_startup_token,
                                               const Language &language,
                                               const rpc::WorkerType worker_type) {
@@ -561,6 +587,9 @@ void WorkerPool::MonitorStartingWorkerProcess(StartupToken proc_startup_token,
       if (it->second.proc.IsAlive()) {
         it->second.proc.Kill();
       }
+      if (worker_cgroup_manager_ != nullptr) {
+        worker_cgroup_manager_->RemoveWorker(it->second.proc.GetId());
+      }
 
       process_failed_pending_registration_++;
       DeleteRuntimeEnvIfPossible(it->second.runtime_env_info.serialized_runtime_env());
@@ -601,7 +630,8 @@ void WorkerPool::MonitorPopWorkerRequestForRegistration(
 }
 
 Process WorkerPool::StartProcess(const std::vector<std::string> &worker_command_args,
-                                 const ProcessEnvironment &env) {
+                                 const ProcessEnvironment &env,
+                                 const std::string &cgroup_procs_path) {
   if (RAY_LOG_ENABLED(DEBUG)) {
     std::string debug_info;
     debug_info.append("Starting worker process with command:");
@@ -632,7 +662,13 @@ Process WorkerPool::StartProcess(const std::vector<std::string> &worker_command_
   }
   argv.push_back(NULL);
 
-  Process child(argv.data(), io_service_, ec, /*decouple=*/false, env);
+  Process child(argv.data(),
+                io_service_,
+                ec,
+                /*decouple=*/false,
+                env,
+                /*pipe_to_stdin=*/false,
+                cgroup_procs_path);
   if (!child.IsValid() || ec) {
     // errorcode 24: Too many files. This is caused by ulimit.
     if (ec.value() == 24) {
@@ -1023,6 +1059,7 @@ void WorkerPool::PushWorker(const std::shared_ptr<WorkerInterface> &worker) {
       return PushWorker(worker);
     }
   } else {
+    SetWorkerMemoryHigh(worker, nullptr);
     state.idle.insert(worker);
     auto now = get_time_();
     if (worker->GetAssignedTaskTime() == absl::Time()) {
@@ -1303,7 +1340,11 @@ void WorkerPool::PopWorker(const TaskSpecification &task_spec,
           // Not used
           return false;
         }
-        return callback(worker, status, runtime_env_setup_error_message);
+        bool used = callback(worker, status, runtime_env_setup_error_message);
+        if (used && worker) {
+          SetWorkerMemoryHigh(worker, &task_spec);
+        }
+        return used;
       });
 
   absl::flat_hash_map<WorkerUnfitForTaskReason, size_t> skip_reason_count;
@@ -1405,6 +1446,12 @@ void WorkerPool::PrestartDefaultCpuWorkers(ray::Language language, int64_t num_n
   }
 }
 
+void WorkerPool::RecordMetrics() {
+  if (worker_cgroup_manager_ != nullptr) {
+    worker_cgroup_manager_->RecordMetrics();
+  }
+}
+
 void WorkerPool::DisconnectWorker(const std::shared_ptr<WorkerInterface> &worker,
                                   rpc::WorkerExitType disconnect_type) {
   MarkPortAsFree(worker->AssignedPort());
@@ -1428,6 +1475,9 @@ void WorkerPool::DisconnectWorker(const std::shared_ptr<WorkerInterface> &worker
     DeleteRuntimeEnvIfPossible(serialized_runtime_env);
     RemoveWorkerProcess(state, worker->GetStartupToken());
   }
+  if (worker_cgroup_manager_ != nullptr) {
+    worker_cgroup_manager_->RemoveWorker(worker->GetProcess().GetId());
+  }
   RAY_CHECK(RemoveWorker(state.registered_workers, worker));
 
   if (IsIOWorkerType(worker->GetWorkerType())) {
@@ -34,6 +34,7 @@
 #include "ray/gcs/gcs_client/gcs_client.h"
 #include "ray/raylet/runtime_env_agent_client.h"
 #include "ray/raylet/worker.h"
+#include "ray/raylet/worker_cgroup_manager.h"
 
 namespace ray {
 
@@ -302,6 +303,9 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   std::shared_ptr<WorkerInterface> GetRegisteredDriver(
       const std::shared_ptr<ClientConnection> &connection) const;
 
+  /// Record metrics.
+  void RecordMetrics();
+
   /// Disconnect a registered worker.
   ///
   /// \param worker The worker to disconnect. The worker must be registered.
@@ -456,9 +460,12 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// \param worker_command_args The command arguments of new worker process.
   /// \param[in] env Additional environment variables to be set on this process besides
   /// the environment variables of the parent process.
+  /// \param[in] cgroup_procs_path The cgroup.procs file of the cgroup the process joins
+  /// before it execs, or empty to start it in the raylet's cgroup.
   /// \return An object representing the started worker process.
   virtual Process StartProcess(const std::vector<std::string> &worker_command_args,
-                               const ProcessEnvironment &env);
+                               const ProcessEnvironment &env,
+                               const std::string &cgroup_procs_path);
 
   /// Push an warning message to user if worker pool is getting to big.
   virtual void WarnAboutSize();
@@ -721,6 +728,14 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// pressure.
   void AdjustWorkerOomScore(pid_t pid) const;
 
+  /// Throttle the worker's memory at what its task requested, if workers are placed in
+  /// per-worker cgroups.
+  ///
+  /// \param worker The worker that the task was assigned to.
+  /// \param task_spec The task, or nullptr if the worker became idle.
+  void SetWorkerMemoryHigh(const std::shared_ptr<WorkerInterface> &worker,
+                           const TaskSpecification *task_spec);
+
   std::pair<std::vector<std::string>, ProcessEnvironment> BuildProcessCommandArgs(
       const Language &language,
       rpc::JobConfig *job_config,
@@ -791,6 +806,9 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// The runner to run function periodically.
   PeriodicalRunner periodical_runner_;
 
+  /// Places workers in per-worker cgroups. Null unless `worker_cgroup_root` is set.
+  std::unique_ptr<WorkerCgroupManager> worker_cgroup_manager_;
+
   /// A callback to get the current time.
   const std::function<double()> get_time_;
   /// Runtime env manager client.
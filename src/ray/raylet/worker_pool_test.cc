@@ -166,7 +166,8 @@ class WorkerPoolMock : public WorkerPool {
   }
 
   Process StartProcess(const std::vector<std::string> &worker_command_args,
-                       const ProcessEnvironment &env) override {
+                       const ProcessEnvironment &env,
+                       const std::string &cgroup_procs_path) override {
     // Use a bogus process ID that won't conflict with those in the system
     auto pid = static_cast<pid_t>(PID_MAX_LIMIT + 1 + worker_commands_by_proc_.size());
     last_worker_process_ = Process::FromPid(pid);
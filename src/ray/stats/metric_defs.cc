@@ -133,6 +133,48 @@ DEFINE_stats(object_store_dist,
                16384_MB}),
              ray::stats::HISTOGRAM);
 
+DEFINE_stats(object_store_create_request_wait_ms,
+             "Time object creation requests spend queued in the object store before "
+             "they are served, by object size class.",
+             ("SizeClass"),
+             ({1, 10, 100, 1000, 10000, 60000}),
+             ray::stats::HISTOGRAM);
+
+/// RESERVED is the object store memory that granted leases reserved for their outputs,
+/// USED is the object store memory in use, to compare reservations against.
+DEFINE_stats(object_store_memory_reservation,
+             "Object store memory reserved for task outputs vs. in use, in bytes.",
+             ("State"),
+             (),
+             ray::stats::GAUGE);
+
+DEFINE_stats(object_store_deduplicated_bytes,
+             "Bytes of sealed objects that share the allocation of another object with "
+             "identical contents instead of holding their own copy.",
+             /*tags=*/(),
+             /*buckets=*/(),
+             ray::stats::GAUGE);
+
+/// ORIGINAL is the size of the objects held compressed in the object store, STORED
+/// is the memory they take up compressed.
+DEFINE_stats(object_store_compressed_bytes,
+             "Bytes of objects held compressed in the object store, by state.",
+             ("State"),
+             (),
+             ray::stats::GAUGE);
+
+DEFINE_stats(object_store_eviction_avoided_bytes,
+             "Bytes of objects the object store compressed instead of evicting them.",
+             (),
+             (),
+             ray::stats::SUM);
+
+DEFINE_stats(object_store_compression_time_ms,
+             "Time the object store spent compressing and decompressing objects.",
+             ("Operation"),
+             (),
+             ray::stats::SUM);
+
 /// Placement group metrics from the GCS.
 DEFINE_stats(placement_groups,
              "Number of placement groups broken down by state.",
@@ -379,6 +421,29 @@ DEFINE_stats(
     (),
     ray::stats::COUNT);
 
+DEFINE_stats(memory_manager_worker_cgroup_memory_bytes,
+             "Memory charged to each worker's cgroup, when workers are placed in "
+             "per-worker cgroups.",
+             (),
+             ({64_MB,
+               128_MB,
+               256_MB,
+               512_MB,
+               1024_MB,
+               2048_MB,
+               4096_MB,
+               8192_MB,
+               16384_MB,
+               32768_MB}),
+             ray::stats::HISTOGRAM);
+
+DEFINE_stats(memory_manager_worker_cgroup_throttled_total,
+             "Number of times a worker was throttled for exceeding the memory its "
+             "task requested, when workers are placed in per-worker cgroups.",
+             (),
+             (),
+             ray::stats::SUM);
+
 /// Core Worker Task Manager
 DEFINE_stats(
     total_lineage_bytes,
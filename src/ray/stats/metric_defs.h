@@ -115,6 +115,12 @@ DECLARE_stats(gcs_task_manager_task_events_reported);
 /// Object Store
 DECLARE_stats(object_store_memory);
 DECLARE_stats(object_store_dist);
+DECLARE_stats(object_store_create_request_wait_ms);
+DECLARE_stats(object_store_memory_reservation);
+DECLARE_stats(object_store_deduplicated_bytes);
+DECLARE_stats(object_store_compressed_bytes);
+DECLARE_stats(object_store_compression_time_ms);
+DECLARE_stats(object_store_eviction_avoided_bytes);
 
 /// Placement Group
 DECLARE_stats(gcs_placement_group_creation_latency_ms);
@@ -125,6 +131,8 @@ DECLARE_stats(gcs_actors_count);
 
 /// Memory Manager
 DECLARE_stats(memory_manager_worker_eviction_total);
+DECLARE_stats(memory_manager_worker_cgroup_memory_bytes);
+DECLARE_stats(memory_manager_worker_cgroup_throttled_total);
 
 /// Core Worker Task Manager
 DECLARE_stats(total_lineage_bytes);
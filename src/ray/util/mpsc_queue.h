@@ -0,0 +1,148 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace ray {
+
+/// An unbounded queue that many threads push items into, and that is drained in
+/// batches. Each pushing thread appends to a buffer of its own, under a lock that only
+/// PopAll ever contends for, so pushing threads don't share any cache line. PopAll
+/// swaps the buffers out one by one.
+///
+/// Items pushed by the same thread are drained in the order they were pushed. Items
+/// pushed by different threads are not ordered with each other.
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : id_(next_id_.fetch_add(1, std::memory_order_relaxed)) {}
+
+  MpscQueue(const MpscQueue &) = delete;
+  MpscQueue &operator=(const MpscQueue &) = delete;
+
+  /// Push an item. Thread-safe.
+  ///
+  /// \return The number of items the calling thread pushed since the last PopAll.
+  size_t Push(T item) {
+    Buffer &buffer = GetBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.items.push_back(std::move(item));
+    return buffer.items.size();
+  }
+
+  /// Take all items pushed so far. Thread-safe; concurrent calls get disjoint
+  /// batches.
+  std::vector<T> PopAll() {
+    std::vector<T> items;
+    absl::MutexLock lock(&mutex_);
+    for (size_t i = 0; i < buffers_.size();) {
+      bool exited;
+      {
+        std::lock_guard<std::mutex> buffer_lock(buffers_[i]->mutex);
+        auto &buffer_items = buffers_[i]->items;
+        std::move(buffer_items.begin(), buffer_items.end(), std::back_inserter(items));
+        buffer_items.clear();
+        exited = buffers_[i]->exited;
+      }
+      if (exited) {
+        // The thread won't push anymore, and its last items were just taken.
+        buffers_[i] = std::move(buffers_.back());
+        buffers_.pop_back();
+      } else {
+        i++;
+      }
+    }
+    return items;
+  }
+
+ private:
+  struct Buffer {
+    /// A std::mutex, which is cheaper than absl::Mutex to take when uncontended.
+    std::mutex mutex;
+    std::vector<T> items;
+    /// Set when the pushing thread exits.
+    bool exited = false;
+  };
+
+  /// The buffers of the calling thread, by queue id.
+  struct ThreadBuffers {
+    /// The raw pointer is only used while the queue, which keeps the buffer alive,
+    /// exists. The weak reference tells whether the queue was destroyed.
+    absl::flat_hash_map<uint64_t, std::pair<Buffer *, std::weak_ptr<Buffer>>> buffers;
+    /// The queue the thread pushed to last, which saves the lookup when pushing to the
+    /// same queue again. Ids aren't reused, so the buffer is valid for as long as a
+    /// queue with that id can push.
+    uint64_t last_id = UINT64_MAX;
+    Buffer *last_buffer = nullptr;
+
+    ~ThreadBuffers() {
+      for (auto &[id, entry] : buffers) {
+        if (auto buffer = entry.second.lock()) {
+          std::lock_guard<std::mutex> lock(buffer->mutex);
+          buffer->exited = true;
+        }
+      }
+    }
+  };
+
+  Buffer &GetBuffer() {
+    static thread_local ThreadBuffers thread_buffers;
+    if (thread_buffers.last_id == id_) {
+      return *thread_buffers.last_buffer;
+    }
+    auto it = thread_buffers.buffers.find(id_);
+    if (it != thread_buffers.buffers.end()) {
+      thread_buffers.last_id = id_;
+      thread_buffers.last_buffer = it->second.first;
+      return *it->second.first;
+    }
+    // Drop the buffers of destroyed queues before growing the map.
+    absl::erase_if(thread_buffers.buffers,
+                   [](const auto &entry) { return entry.second.second.expired(); });
+    auto buffer = std::make_shared<Buffer>();
+    {
+      absl::MutexLock lock(&mutex_);
+      buffers_.push_back(buffer);
+    }
+    thread_buffers.buffers.emplace(
+        id_, std::make_pair(buffer.get(), std::weak_ptr<Buffer>(buffer)));
+    thread_buffers.last_id = id_;
+    thread_buffers.last_buffer = buffer.get();
+    return *buffer;
+  }
+
+  static inline std::atomic<uint64_t> next_id_{0};
+
+  /// Identifies the queue in the thread local buffer maps. Unlike the address, it isn't
+  /// reused by a queue allocated where a destroyed one lived.
+  const uint64_t id_;
+  absl::Mutex mutex_;
+  /// The buffers of the threads that pushed to the queue and didn't exit, or did but
+  /// whose last items weren't taken yet.
+  std::vector<std::shared_ptr<Buffer>> buffers_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace ray
@@ -22,6 +22,7 @@
 #include <Winternl.h>
 #include <process.h>
 #else
+#include <fcntl.h>
 #include <poll.h>
 #include <signal.h>
 #include <stddef.h>
@@ -104,7 +105,8 @@ class ProcessFD {
                             std::error_code &ec,
                             bool decouple,
                             const ProcessEnvironment &env,
-                            bool pipe_to_stdin) {
+                            bool pipe_to_stdin,
+                            const std::string &cgroup_procs_path) {
     ec = std::error_code();
     intptr_t fd;
     pid_t pid;
@@ -125,6 +127,7 @@ class ProcessFD {
 #ifdef _WIN32
 
     (void)decouple;  // Windows doesn't require anything particular for decoupling.
+    (void)cgroup_procs_path;
     std::vector<std::string> args;
     for (size_t i = 0; argv[i]; ++i) {
       args.push_back(argv[i]);
@@ -237,6 +240,18 @@ class ProcessFD {
 
       // This is the spawned process. Any intermediate parent is now dead.
       pid_t my_pid = getpid();
+      if (!cgroup_procs_path.empty()) {
+        // Join the cgroup before exec so that nothing the process allocates escapes
+        // its limits.
+        int cgroup_fd = open(cgroup_procs_path.c_str(), O_WRONLY);
+        if (cgroup_fd != -1) {
+          char pid_str[32];
+          int len = snprintf(pid_str, sizeof(pid_str), "%d", my_pid);
+          ssize_t r = write(cgroup_fd, pid_str, len);
+          (void)r;  // The parent moves the process if this fails.
+          close(cgroup_fd);
+        }
+      }
       if (write(pipefds[1], &my_pid, sizeof(my_pid)) == sizeof(my_pid)) {
         execvpe(
             argv[0], const_cast<char *const *>(argv), const_cast<char *const *>(envp));
@@ -362,19 +377,22 @@ Process::Process(const char *argv[],
                  std::error_code &ec,
                  bool decouple,
                  const ProcessEnvironment &env,
-                 bool pipe_to_stdin) {
+                 bool pipe_to_stdin,
+                 const std::string &cgroup_procs_path) {
   /// TODO: use io_service with boost asio notify_fork.
   (void)io_service;
 #ifdef __linux__
   KnownChildrenTracker::instance().AddKnownChild([&, this]() -> pid_t {
-    ProcessFD procfd = ProcessFD::spawnvpe(argv, ec, decouple, env, pipe_to_stdin);
+    ProcessFD procfd = ProcessFD::spawnvpe(
+        argv, ec, decouple, env, pipe_to_stdin, cgroup_procs_path);
     if (!ec) {
       this->p_ = std::make_shared<ProcessFD>(std::move(procfd));
     }
     return this->GetId();
   });
 #else
-  ProcessFD procfd = ProcessFD::spawnvpe(argv, ec, decouple, env, pipe_to_stdin);
+  ProcessFD procfd =
+      ProcessFD::spawnvpe(argv, ec, decouple, env, pipe_to_stdin, cgroup_procs_path);
   if (!ec) {
     p_ = std::make_shared<ProcessFD>(std::move(procfd));
   }
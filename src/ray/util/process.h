@@ -77,6 +77,9 @@ class Process {
   /// \param[in] pipe_to_stdin If true, it creates a pipe and redirect to child process'
   /// stdin. It is used for health checking from a child process.
   /// Child process can read stdin to detect when the current process dies.
+  /// \param[in] cgroup_procs_path If not empty, the cgroup.procs file of a cgroup v2
+  /// that the child joins before it execs, so that all of its memory is charged to
+  /// that cgroup. Failing to join the cgroup doesn't fail the spawn.
   ///
   // The subprocess is child of this process, so it's caller process's duty to handle
   // SIGCHLD signal and reap the zombie children.
@@ -89,7 +92,8 @@ class Process {
                    std::error_code &ec,
                    bool decouple = false,
                    const ProcessEnvironment &env = {},
-                   bool pipe_to_stdin = false);
+                   bool pipe_to_stdin = false,
+                   const std::string &cgroup_procs_path = "");
   /// Convenience function to run the given command line and wait for it to finish.
   static std::error_code Call(const std::vector<std::string> &args,
                               const ProcessEnvironment &env = {});
@@ -0,0 +1,100 @@
+// Copyright 2024 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/util/mpsc_queue.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+TEST(MpscQueueTest, PopAllInPushOrder) {
+  MpscQueue<std::unique_ptr<int>> queue;
+  EXPECT_TRUE(queue.PopAll().empty());
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(queue.Push(std::make_unique<int>(i)), i + 1);
+  }
+  auto items = queue.PopAll();
+  ASSERT_EQ(items.size(), 5);
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(*items[i], i);
+  }
+  EXPECT_TRUE(queue.PopAll().empty());
+  // Push counts from the last PopAll.
+  EXPECT_EQ(queue.Push(std::make_unique<int>(5)), 1);
+  // Items left in the queue are freed with it.
+}
+
+TEST(MpscQueueTest, ConcurrentPush) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumItemsPerThread = 10000;
+  MpscQueue<std::pair<int, int>> queue;
+  std::vector<std::pair<int, int>> popped;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&queue, t]() {
+      for (int i = 0; i < kNumItemsPerThread; i++) {
+        queue.Push({t, i});
+      }
+    });
+  }
+  std::atomic<bool> done = false;
+  std::thread consumer([&]() {
+    while (!done) {
+      for (auto &item : queue.PopAll()) {
+        popped.push_back(item);
+      }
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  done = true;
+  consumer.join();
+  for (auto &item : queue.PopAll()) {
+    popped.push_back(item);
+  }
+
+  // Every item is popped once, and items from the same thread stay in order.
+  ASSERT_EQ(popped.size(), kNumThreads * kNumItemsPerThread);
+  std::vector<int> next(kNumThreads, 0);
+  for (const auto &[thread, i] : popped) {
+    EXPECT_EQ(i, next[thread]);
+    next[thread]++;
+  }
+}
+
+TEST(MpscQueueTest, PopItemsOfExitedThreads) {
+  MpscQueue<int> queue;
+  std::thread([&queue]() {
+    queue.Push(1);
+    queue.Push(2);
+  }).join();
+  EXPECT_EQ(queue.PopAll(), (std::vector<int>{1, 2}));
+  EXPECT_TRUE(queue.PopAll().empty());
+  // The thread that pushes to many queues uses a buffer per queue.
+  MpscQueue<int> other_queue;
+  queue.Push(3);
+  other_queue.Push(4);
+  queue.Push(5);
+  EXPECT_EQ(queue.PopAll(), (std::vector<int>{3, 5}));
+  EXPECT_EQ(other_queue.PopAll(), (std::vector<int>{4}));
+}
+
+}  // namespace ray